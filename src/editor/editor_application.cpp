@@ -372,6 +372,9 @@ auto Application_impl::initialize_components(
     ) {
         const auto& test_scene_root = scene_builder.get_scene_root();
         test_scene_root->physics_world().enable_physics_updates();
+        if (g_physics_window->config.async_update) {
+            test_scene_root->physics_world().enable_async_updates();
+        }
     }
 
     tools.set_priority_tool(&physics_tool);
@@ -1,7 +1,37 @@
 #include "editor_message_bus.hpp"
 
+#include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
+namespace erhe::message_bus
+{
+
+using editor::Editor_message;
+
+auto Message_traits<Editor_message>::get_type_mask(const Editor_message& message) -> uint64_t
+{
+    return message.update_flags;
+}
+
+auto Message_traits<Editor_message>::get_coalesce_key(const Editor_message& message) -> uint64_t
+{
+    // Only identical messages are coalesced
+    const auto scene_view_bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(message.scene_view));
+    return (scene_view_bits * 0x9e3779b97f4a7c15ull) ^ message.update_flags ^ 1u;
+}
+
+auto Message_traits<Editor_message>::coalesce(
+    Editor_message&       existing,
+    const Editor_message& message
+) -> bool
+{
+    return
+        (existing.update_flags == message.update_flags) &&
+        (existing.scene_view   == message.scene_view);
+}
+
+} // namespace erhe::message_bus
+
 namespace editor
 {
 
@@ -25,4 +55,11 @@ void Editor_message_bus::initialize_component()
     g_editor_message_bus = this;
 }
 
+void Editor_message_bus::update_once_per_frame(const erhe::components::Time_context&)
+{
+    ERHE_PROFILE_FUNCTION
+
+    update();
+}
+
 } // namespace editor
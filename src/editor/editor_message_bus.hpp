@@ -3,14 +3,29 @@
 #include "editor_message.hpp"
 
 #include "erhe/components/components.hpp"
-#include "erhe/message_bus/message_bus.hpp"
+#include "erhe/message_bus/concurrent_message_bus.hpp"
+
+namespace erhe::message_bus
+{
+
+template <>
+class Message_traits<editor::Editor_message>
+{
+public:
+    [[nodiscard]] static auto get_type_mask   (const editor::Editor_message& message) -> uint64_t;
+    [[nodiscard]] static auto get_coalesce_key(const editor::Editor_message& message) -> uint64_t;
+    [[nodiscard]] static auto coalesce        (editor::Editor_message& existing, const editor::Editor_message& message) -> bool;
+};
+
+} // namespace erhe::message_bus
 
 namespace editor
 {
 
 class Editor_message_bus
     : public erhe::components::Component
-    , public erhe::message_bus::Message_bus<Editor_message>
+    , public erhe::components::IUpdate_once_per_frame
+    , public erhe::message_bus::Concurrent_message_bus<Editor_message>
 {
 public:
     static constexpr std::string_view c_type_name{"Editor_bus"};
@@ -28,6 +43,9 @@ public:
     // Implements Component
     [[nodiscard]] auto get_type_hash() const -> uint32_t override { return c_type_hash; }
     void initialize_component       () override;
+
+    // Implements IUpdate_once_per_frame
+    void update_once_per_frame(const erhe::components::Time_context&) override;
 };
 
 extern Editor_message_bus* g_editor_message_bus;
@@ -4,14 +4,19 @@
 #include "erhe/application/configuration.hpp"
 #include "erhe/application/imgui/imgui_window.hpp"
 #include "erhe/application/imgui/imgui_windows.hpp"
+#include "erhe/concurrency/thread_pool.hpp"
 #include "erhe/net/client.hpp"
 #include "erhe/net/server.hpp"
+#include "erhe/physics/iworld.hpp"
 #include "erhe/scene/scene.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 #include <imgui.h>
 #include <misc/cpp/imgui_stdlib.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace editor
 {
 
@@ -26,6 +31,18 @@ public:
 
     Editor_scenes_impl()
         : erhe::application::Imgui_window{c_title}
+        , m_thread_pool{
+            std::min(
+                8U,
+                std::max(std::thread::hardware_concurrency() - 1, 1U)
+            )
+        }
+        , m_render_thread_pool{
+            std::min(
+                4U,
+                std::max(std::thread::hardware_concurrency() - 1, 1U)
+            )
+        }
     {
         ERHE_VERIFY(g_editor_scenes == nullptr);
 
@@ -67,7 +84,9 @@ public:
     void update_network        () override;
     void sanity_check          () override;
 
-    [[nodiscard]] auto get_scene_roots() -> const std::vector<std::shared_ptr<Scene_root>>& override;
+    [[nodiscard]] auto get_scene_roots       () -> const std::vector<std::shared_ptr<Scene_root>>& override;
+    [[nodiscard]] auto get_thread_pool       () -> erhe::concurrency::Thread_pool* override;
+    [[nodiscard]] auto get_render_thread_pool() -> erhe::concurrency::Thread_pool* override;
     [[nodiscard]] auto scene_combo(
         const char*                  label,
         std::shared_ptr<Scene_root>& in_out_selected_entry,
@@ -76,6 +95,8 @@ public:
 
 private:
     std::mutex                               m_mutex;
+    erhe::concurrency::Thread_pool           m_thread_pool;        // Shared by node transform updates, physics and mesh building
+    erhe::concurrency::Thread_pool           m_render_thread_pool; // Culling and light clustering; the render thread helps only with these while it waits
     erhe::net::Client                        m_client;
     erhe::net::Server                        m_server;
     std::vector<std::shared_ptr<Scene_root>> m_scene_roots;
@@ -119,12 +140,15 @@ void Editor_scenes_impl::register_scene_root(
 {
     std::lock_guard<std::mutex> lock{m_mutex};
 
+    scene_root->scene().set_thread_pool(&m_thread_pool);
+    scene_root->physics_world().set_thread_pool(&m_thread_pool);
     m_scene_roots.push_back(scene_root);
 }
 
 void Editor_scenes_impl::update_node_transforms()
 {
     for (const auto& scene_root : m_scene_roots) {
+        scene_root->update_physics_transforms();
         scene_root->scene().update_node_transforms();
     }
 }
@@ -212,6 +236,16 @@ void Editor_scenes_impl::imgui()
     return m_scene_roots;
 }
 
+[[nodiscard]] auto Editor_scenes_impl::get_thread_pool() -> erhe::concurrency::Thread_pool*
+{
+    return &m_thread_pool;
+}
+
+[[nodiscard]] auto Editor_scenes_impl::get_render_thread_pool() -> erhe::concurrency::Thread_pool*
+{
+    return &m_render_thread_pool;
+}
+
 void Editor_scenes_impl::sanity_check()
 {
 #if !defined(NDEBUG)
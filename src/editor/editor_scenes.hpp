@@ -9,6 +9,11 @@
 
 #include <memory>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace editor
 {
 
@@ -24,7 +29,9 @@ public:
     virtual void update_node_transforms() = 0;
     virtual void update_network        () = 0;
 
-    [[nodiscard]] virtual auto get_scene_roots() -> const std::vector<std::shared_ptr<Scene_root>>& = 0;;
+    [[nodiscard]] virtual auto get_scene_roots       () -> const std::vector<std::shared_ptr<Scene_root>>& = 0;;
+    [[nodiscard]] virtual auto get_thread_pool       () -> erhe::concurrency::Thread_pool* = 0;
+    [[nodiscard]] virtual auto get_render_thread_pool() -> erhe::concurrency::Thread_pool* = 0;
     [[nodiscard]] virtual auto scene_combo(
         const char*                  label,
         std::shared_ptr<Scene_root>& in_out_selected_entry,
@@ -2,6 +2,7 @@
 
 #include "editor_rendering.hpp"
 #include "editor_scenes.hpp"
+#include "renderers/mesh_memory.hpp"
 #include "scene/scene_builder.hpp"
 #include "scene/scene_root.hpp"
 #include "scene/viewport_window.hpp"
@@ -19,6 +20,7 @@
 #include "erhe/graphics/buffer_transfer_queue.hpp"
 #include "erhe/graphics/debug.hpp"
 #include "erhe/physics/iworld.hpp"
+#include "erhe/primitive/buffer_sink.hpp"
 #include "erhe/scene/scene.hpp"
 #include "erhe/toolkit/profile.hpp"
 
@@ -64,9 +66,19 @@ void Editor_view_client::update_fixed_step(const erhe::components::Time_context&
 
 void Editor_view_client::update()
 {
+    // Publish motion states from physics update which was running
+    // during previous frame rendering
+    const auto& test_scene_root = g_scene_builder->get_scene_root();
+    if (test_scene_root) {
+        test_scene_root->physics_world().end_async_update();
+    }
+
     {
         // TODO something nicer
         g_scene_builder->buffer_transfer_queue().flush();
+
+        // No primitive builders are running between frames
+        g_mesh_memory->gl_buffer_sink->compact_if_requested();
         // animate_lights(time_context.time);
     }
 
@@ -76,6 +88,9 @@ void Editor_view_client::update()
     g_editor_scenes->update_node_transforms();
     g_editor_scenes->update_network();
     erhe::application::g_imgui_windows ->imgui_windows();
+    if (test_scene_root) {
+        test_scene_root->physics_world().begin_async_update();
+    }
     erhe::application::g_rendergraph   ->execute      ();
     erhe::application::g_imgui_renderer->next_frame   ();
     g_editor_rendering->end_frame();
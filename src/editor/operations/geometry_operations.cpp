@@ -30,7 +30,12 @@ auto Catmull_clark_subdivision_operation::describe() const -> std::string
 Catmull_clark_subdivision_operation::Catmull_clark_subdivision_operation(Parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::catmull_clark_subdivision);
+    make_entries(
+        [thread_pool = get_thread_pool()](erhe::geometry::Geometry& geometry)
+        {
+            return erhe::geometry::operation::catmull_clark_subdivision(geometry, thread_pool);
+        }
+    );
 }
 
 auto Sqrt3_subdivision_operation::describe() const -> std::string
@@ -41,7 +46,12 @@ auto Sqrt3_subdivision_operation::describe() const -> std::string
 Sqrt3_subdivision_operation::Sqrt3_subdivision_operation(Parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::sqrt3_subdivision);
+    make_entries(
+        [thread_pool = get_thread_pool()](erhe::geometry::Geometry& geometry)
+        {
+            return erhe::geometry::operation::sqrt3_subdivision(geometry, thread_pool);
+        }
+    );
 }
 
 auto Triangulate_operation::describe() const -> std::string
@@ -85,7 +95,12 @@ auto Subdivide_operation::describe() const -> std::string
 Subdivide_operation::Subdivide_operation(Parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::subdivide);
+    make_entries(
+        [thread_pool = get_thread_pool()](erhe::geometry::Geometry& geometry)
+        {
+            return erhe::geometry::operation::subdivide(geometry, thread_pool);
+        }
+    );
 }
 
 auto Meta_operation::describe() const -> std::string
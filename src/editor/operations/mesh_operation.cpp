@@ -5,6 +5,7 @@
 #include "tools/selection_tool.hpp"
 
 #include "erhe/geometry/geometry.hpp"
+#include "erhe/primitive/build_info.hpp"
 #include "erhe/primitive/primitive_builder.hpp"
 #include "erhe/scene/scene.hpp"
 
@@ -69,6 +70,11 @@ void Mesh_operation::undo()
     }
 }
 
+auto Mesh_operation::get_thread_pool() const -> erhe::concurrency::Thread_pool*
+{
+    return m_parameters.build_info.thread_pool;
+}
+
 void Mesh_operation::make_entries(
     const std::function<
         erhe::geometry::Geometry(erhe::geometry::Geometry&)
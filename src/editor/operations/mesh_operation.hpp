@@ -7,6 +7,11 @@
 #include <functional>
 #include <vector>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::geometry
 {
     class Geometry;
@@ -57,6 +62,7 @@ protected:
     void make_entries(
         const std::function<erhe::geometry::Geometry(erhe::geometry::Geometry&)> operation
     );
+    [[nodiscard]] auto get_thread_pool() const -> erhe::concurrency::Thread_pool*;
 
 private:
     Parameters         m_parameters;
@@ -1,6 +1,7 @@
 // #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "renderers/draw_indirect_buffer.hpp"
+#include "renderers/primitive_store.hpp"
 #include "renderers/programs.hpp"
 #include "renderers/program_interface.hpp"
 #include "editor_log.hpp"
@@ -32,7 +33,8 @@ Draw_indirect_buffer::Draw_indirect_buffer(const std::size_t max_draw_count)
 auto Draw_indirect_buffer::update(
     const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
     erhe::primitive::Primitive_mode                            primitive_mode,
-    const erhe::scene::Item_filter&                            filter
+    const erhe::scene::Item_filter&                            filter,
+    const Primitive_store* const                               primitive_store
 ) -> Draw_indirect_buffer_range
 {
     ERHE_PROFILE_FUNCTION
@@ -58,21 +60,32 @@ auto Draw_indirect_buffer::update(
     const std::size_t max_byte_count = primitive_count * entry_size;
     const auto        gpu_data       = m_writer.begin(&buffer, max_byte_count);
     uint32_t          instance_count     {1};
-    uint32_t          base_instance      {0};
+    uint32_t          primitive_index    {0};
     std::size_t       draw_indirect_count{0};
-    
+
     for (const auto& mesh : meshes) {
         if (!filter(mesh->get_flag_bits())) {
             continue;
         }
 
+        // Must match meshes written by Primitive_buffer::update()
+        if (mesh->get_node() == nullptr) {
+            continue;
+        }
+
         if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
             log_render->critical("draw indirect buffer capacity {} exceeded", buffer.capacity_byte_count());
             ERHE_FATAL("draw indirect buffer capacity exceeded");
             break;
         }
 
+        if ((primitive_store != nullptr) && !mesh->mesh_data.primitives.empty()) {
+            primitive_index = primitive_store->get_base_slot(mesh.get());
+        }
+
         for (auto& primitive : mesh->mesh_data.primitives) {
+            const uint32_t base_instance = primitive_index++;
+
             const auto& primitive_geometry = primitive.gl_primitive_geometry;
             const auto  index_range        = primitive_geometry.index_range(primitive_mode);
             if (index_range.index_count == 0) {
@@ -12,6 +12,8 @@ namespace erhe::scene
 namespace editor
 {
 
+class Primitive_store;
+
 class Draw_indirect_buffer_range
 {
 public:
@@ -26,10 +28,17 @@ public:
     explicit Draw_indirect_buffer(std::size_t max_draw_count);
 
     // Can discard return value
+    //
+    // Base instance of each draw is the index of the primitive entry in
+    // the bound primitive buffer. Without primitive store, entries are
+    // assumed to have been written by Primitive_buffer::update() using the
+    // same meshes and filter. With primitive store, entries are the slots
+    // of the meshes in the store.
     auto update(
         const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
         erhe::primitive::Primitive_mode                            primitive_mode,
-        const erhe::scene::Item_filter&                            filter
+        const erhe::scene::Item_filter&                            filter,
+        const Primitive_store*                                     primitive_store = nullptr
     ) -> Draw_indirect_buffer_range;
 
     void debug_properties_window();
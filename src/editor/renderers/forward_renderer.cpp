@@ -1,6 +1,7 @@
 #include "renderers/forward_renderer.hpp"
 
 #include "editor_log.hpp"
+#include "editor_scenes.hpp"
 #include "renderers/mesh_memory.hpp"
 #include "renderers/program_interface.hpp"
 #include "renderers/programs.hpp"
@@ -30,6 +31,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <functional>
 
 namespace editor
@@ -57,9 +59,11 @@ void Forward_renderer::deinitialize_component()
     ERHE_VERIFY(g_forward_renderer == this);
     m_material_buffers     .reset();
     m_light_buffers        .reset();
+    m_light_cluster_buffers.reset();
     m_camera_buffers       .reset();
     m_draw_indirect_buffers.reset();
     m_primitive_buffers    .reset();
+    m_primitive_stores     .clear();
     m_dummy_texture        .reset();
     g_forward_renderer = nullptr;
 }
@@ -68,6 +72,7 @@ void Forward_renderer::declare_required_components()
 {
     require<erhe::application::Configuration      >();
     require<erhe::application::Gl_context_provider>();
+    require<Editor_scenes    >();
     require<Mesh_memory      >();
     require<Program_interface>();
     require<Programs         >();
@@ -86,6 +91,7 @@ void Forward_renderer::initialize_component()
     auto& shader_resources  = *g_program_interface->shader_resources.get();
     m_material_buffers      = Material_buffer     {&shader_resources.material_interface};
     m_light_buffers         = Light_buffer        {&shader_resources.light_interface};
+    m_light_cluster_buffers = Light_cluster_buffer{&shader_resources.light_cluster_interface};
     m_camera_buffers        = Camera_buffer       {&shader_resources.camera_interface};
     m_draw_indirect_buffers = Draw_indirect_buffer{
         static_cast<size_t>(g_program_interface->config.max_draw_count)
@@ -94,6 +100,9 @@ void Forward_renderer::initialize_component()
 
     m_dummy_texture = erhe::graphics::create_dummy_texture();
 
+    m_culler.set_thread_pool(g_editor_scenes->get_render_thread_pool());
+    m_light_cluster_buffers->set_thread_pool(g_editor_scenes->get_render_thread_pool());
+
     g_forward_renderer = this;
 }
 
@@ -103,9 +112,22 @@ void Forward_renderer::next_frame()
 {
     m_material_buffers     ->next_frame();
     m_light_buffers        ->next_frame();
+    m_light_cluster_buffers->next_frame();
     m_camera_buffers       ->next_frame();
     m_draw_indirect_buffers->next_frame();
     m_primitive_buffers    ->next_frame();
+    m_culler                .next_frame();
+    for (auto& primitive_store : m_primitive_stores) {
+        primitive_store->next_frame();
+    }
+
+    // Buffer ranges are not valid after next_frame(). Meshes are released.
+    for (std::size_t i = 0; i < m_render_list_count; ++i) {
+        m_render_lists[i]->visible_meshes.clear();
+        m_render_lists[i]->meshes = {};
+    }
+    m_render_list_count = 0;
+    m_call_render_lists.clear();
 }
 
 auto Forward_renderer::primitive_settings() -> Primitive_interface_settings&
@@ -118,17 +140,165 @@ auto Forward_renderer::primitive_settings() const -> const Primitive_interface_s
     return m_primitive_buffers->settings;
 }
 
+auto Forward_renderer::get_render_list(
+    const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    const erhe::scene::Item_filter&                            filter,
+    const std::optional<glm::mat4>&                            clip_from_world
+) -> Render_list&
+{
+    // Mesh lists are matched by content, not by span address, as callers
+    // may pass temporary or modified vectors during the frame
+    const auto same_meshes = [&meshes](const Render_list& render_list) -> bool
+    {
+        return std::equal(
+            render_list.source_meshes.begin(),
+            render_list.source_meshes.end(),
+            meshes.begin(),
+            meshes.end(),
+            [](const erhe::scene::Mesh* lhs, const std::shared_ptr<erhe::scene::Mesh>& rhs)
+            {
+                return lhs == rhs.get();
+            }
+        );
+    };
+
+    for (std::size_t i = 0; i < m_render_list_count; ++i) {
+        Render_list& render_list = *m_render_lists[i].get();
+        if (
+            (render_list.filter          == filter         ) &&
+            (render_list.clip_from_world == clip_from_world) &&
+            same_meshes(render_list)
+        ) {
+            return render_list;
+        }
+    }
+
+    if (m_render_list_count == m_render_lists.size()) {
+        m_render_lists.push_back(std::make_unique<Render_list>());
+    }
+    Render_list& render_list = *m_render_lists[m_render_list_count++].get();
+    render_list.source_meshes.clear();
+    for (const auto& mesh : meshes) {
+        render_list.source_meshes.push_back(mesh.get());
+    }
+    render_list.filter          = filter;
+    render_list.clip_from_world = clip_from_world;
+    render_list.primitive_ranges    .clear();
+    render_list.draw_indirect_ranges.clear();
+    if (clip_from_world.has_value()) {
+        m_culler.cull(
+            erhe::scene::Frustum{clip_from_world.value()},
+            meshes,
+            filter,
+            render_list.visible_meshes
+        );
+        render_list.meshes = render_list.visible_meshes;
+    } else {
+        render_list.visible_meshes.clear();
+        render_list.meshes = meshes;
+    }
+    return render_list;
+}
+
+auto Forward_renderer::get_primitive_store(
+    const Primitive_interface_settings& settings
+) -> Primitive_store*
+{
+    if (settings.color_source == Primitive_color_source::id_offset) {
+        return nullptr;
+    }
+
+    for (auto i = m_primitive_stores.begin(), end = m_primitive_stores.end(); i != end; ++i) {
+        if ((*i)->settings() == settings) {
+            std::rotate(m_primitive_stores.begin(), i, std::next(i));
+            return m_primitive_stores.front().get();
+        }
+    }
+
+    if (m_primitive_stores.size() < c_max_primitive_store_count) {
+        auto& shader_resources = *g_program_interface->shader_resources.get();
+        m_primitive_stores.insert(
+            m_primitive_stores.begin(),
+            std::make_unique<Primitive_store>(&shader_resources.primitive_interface, settings)
+        );
+        return m_primitive_stores.front().get();
+    }
+
+    // Reuse least recently used store, unless ranges from it are in use
+    if (m_primitive_stores.back()->is_used()) {
+        return nullptr;
+    }
+    std::rotate(m_primitive_stores.begin(), std::prev(m_primitive_stores.end()), m_primitive_stores.end());
+    m_primitive_stores.front()->reset(settings);
+    return m_primitive_stores.front().get();
+}
+
+auto Forward_renderer::get_primitive_range(Render_list& render_list) -> Render_list::Primitive_range
+{
+    const auto& settings = m_primitive_buffers->settings;
+    for (const auto& entry : render_list.primitive_ranges) {
+        if (entry.settings == settings) {
+            return entry;
+        }
+    }
+
+    Render_list::Primitive_range entry{
+        .settings = settings
+    };
+    Primitive_store* primitive_store = get_primitive_store(settings);
+    if (
+        (primitive_store != nullptr) &&
+        primitive_store->update(render_list.meshes, render_list.filter)
+    ) {
+        entry.store = primitive_store;
+    } else {
+        entry.range = m_primitive_buffers->update(render_list.meshes, render_list.filter);
+    }
+    render_list.primitive_ranges.push_back(entry);
+    return entry;
+}
+
+auto Forward_renderer::get_draw_indirect_range(
+    Render_list&                          render_list,
+    const erhe::primitive::Primitive_mode primitive_mode,
+    const Primitive_store* const          primitive_store
+) -> Draw_indirect_buffer_range
+{
+    for (const auto& entry : render_list.draw_indirect_ranges) {
+        if (
+            (entry.primitive_mode == primitive_mode) &&
+            (entry.store          == primitive_store)
+        ) {
+            return entry.range;
+        }
+    }
+    const auto range = m_draw_indirect_buffers->update(
+        render_list.meshes,
+        primitive_mode,
+        render_list.filter,
+        primitive_store
+    );
+    render_list.draw_indirect_ranges.push_back(
+        Render_list::Draw_indirect_range{
+            .primitive_mode = primitive_mode,
+            .store          = primitive_store,
+            .range          = range
+        }
+    );
+    return range;
+}
+
 void Forward_renderer::render(const Render_parameters& parameters)
 {
     ERHE_PROFILE_FUNCTION
 
     const auto& viewport       = parameters.viewport;
     const auto* camera         = parameters.camera;
-    const auto& mesh_spans     = parameters.mesh_spans;
     const auto& lights         = parameters.lights;
     const auto& materials      = parameters.materials;
     const auto& passes         = parameters.passes;
     const auto& filter         = parameters.filter;
+    const auto& mesh_spans     = parameters.mesh_spans;
     const bool  enable_shadows =
         (g_shadow_renderer != nullptr) &&
         (!lights.empty()) &&
@@ -146,6 +316,16 @@ void Forward_renderer::render(const Render_parameters& parameters)
         *g_programs->nearest_sampler.get()
     );
 
+    // Render lists are shared by all passes, and by later render() calls
+    // during this frame which use the same meshes, filter and camera
+    const std::optional<glm::mat4> clip_from_world = (camera != nullptr)
+        ? std::optional<glm::mat4>{camera->projection_transforms(viewport).clip_from_world.matrix()}
+        : std::optional<glm::mat4>{};
+    m_call_render_lists.clear();
+    for (const auto& meshes : mesh_spans) {
+        m_call_render_lists.push_back(&get_render_list(meshes, filter, clip_from_world));
+    }
+
     gl::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
     if (camera != nullptr) {
         const auto range = m_camera_buffers->update(
@@ -173,6 +353,14 @@ void Forward_renderer::render(const Render_parameters& parameters)
     );
     m_light_buffers->bind_light_buffer(light_range);
 
+    const auto light_cluster_range = m_light_cluster_buffers->update(
+        lights,
+        parameters.light_projections,
+        camera,
+        viewport
+    );
+    m_light_cluster_buffers->bind(light_cluster_range);
+
     if (erhe::graphics::Instance::info.use_bindless_texture) {
         ERHE_PROFILE_SCOPE("make textures resident");
 
@@ -210,19 +398,23 @@ void Forward_renderer::render(const Render_parameters& parameters)
 
         erhe::graphics::g_opengl_state_tracker->execute(pipeline);
 
-        for (const auto& meshes : mesh_spans) {
+        for (Render_list* render_list : m_call_render_lists) {
             ERHE_PROFILE_SCOPE("mesh span");
             ERHE_PROFILE_GPU_SCOPE(c_forward_renderer_render);
-            if (meshes.empty()) {
+            if (render_list->meshes.empty()) {
                 continue;
             }
 
-            const auto primitive_range            = m_primitive_buffers->update(meshes, filter);
-            const auto draw_indirect_buffer_range = m_draw_indirect_buffers->update(meshes, primitive_mode, filter);
+            const auto primitive_range            = get_primitive_range    (*render_list);
+            const auto draw_indirect_buffer_range = get_draw_indirect_range(*render_list, primitive_mode, primitive_range.store);
             if (draw_indirect_buffer_range.draw_indirect_count == 0) {
                 continue;
             }
-            m_primitive_buffers->bind(primitive_range);
+            if (primitive_range.store != nullptr) {
+                primitive_range.store->bind();
+            } else {
+                m_primitive_buffers->bind(primitive_range.range);
+            }
             m_draw_indirect_buffers->bind(draw_indirect_buffer_range.range);
 
             {
@@ -310,6 +502,10 @@ void Forward_renderer::render_fullscreen(
     {
         const auto light_range = m_light_buffers->update(lights, parameters.light_projections, parameters.ambient_light);
         m_light_buffers->bind_light_buffer(light_range);
+
+        // Lights are not clustered for fullscreen passes
+        const auto light_cluster_range = m_light_cluster_buffers->update(lights, parameters.light_projections, nullptr, viewport);
+        m_light_cluster_buffers->bind(light_cluster_range);
     }
 
     if (enable_shadows) {
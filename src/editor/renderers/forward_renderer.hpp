@@ -3,13 +3,16 @@
 #include "renderers/renderpass.hpp"
 #include "renderers/material_buffer.hpp"
 #include "renderers/light_buffer.hpp"
+#include "renderers/light_cluster_buffer.hpp"
 #include "renderers/camera_buffer.hpp"
 #include "renderers/draw_indirect_buffer.hpp"
 #include "renderers/primitive_buffer.hpp"
+#include "renderers/primitive_store.hpp"
 
 #include "erhe/components/components.hpp"
 #include "erhe/graphics/pipeline.hpp"
 #include "erhe/primitive/primitive.hpp"
+#include "erhe/scene/frustum_culler.hpp"
 #include "erhe/scene/node.hpp"
 
 #include <glm/glm.hpp>
@@ -86,12 +89,75 @@ public:
     auto primitive_settings() const -> const Primitive_interface_settings&;
 
 private:
+    // Visible meshes of a mesh span, with GPU buffer ranges written for it
+    // during the current frame. Render lists are keyed on source span,
+    // filter and camera, so that passes and render() calls which use the
+    // same meshes share buffer data. Scene must not change while a frame
+    // is being rendered.
+    class Render_list
+    {
+    public:
+        // Primitive data is either in a persistent store, or in range
+        // of transient primitive buffer
+        class Primitive_range
+        {
+        public:
+            Primitive_interface_settings    settings;
+            Primitive_store*                store{nullptr};
+            erhe::application::Buffer_range range;
+        };
+
+        class Draw_indirect_range
+        {
+        public:
+            erhe::primitive::Primitive_mode primitive_mode;
+            const Primitive_store*          store{nullptr};
+            Draw_indirect_buffer_range      range;
+        };
+
+        std::vector<const erhe::scene::Mesh*>               source_meshes; // key, compared by content
+        erhe::scene::Item_filter                            filter;
+        std::optional<glm::mat4>                            clip_from_world;
+        std::vector<std::shared_ptr<erhe::scene::Mesh>>     visible_meshes;
+        gsl::span<const std::shared_ptr<erhe::scene::Mesh>> meshes;
+        std::vector<Primitive_range>                        primitive_ranges;
+        std::vector<Draw_indirect_range>                    draw_indirect_ranges;
+    };
+
+    [[nodiscard]] auto get_render_list(
+        const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+        const erhe::scene::Item_filter&                            filter,
+        const std::optional<glm::mat4>&                            clip_from_world
+    ) -> Render_list&;
+    [[nodiscard]] auto get_primitive_store    (const Primitive_interface_settings& settings) -> Primitive_store*;
+    [[nodiscard]] auto get_primitive_range    (Render_list& render_list) -> Render_list::Primitive_range;
+    [[nodiscard]] auto get_draw_indirect_range(
+        Render_list&                    render_list,
+        erhe::primitive::Primitive_mode primitive_mode,
+        const Primitive_store*          primitive_store
+    ) -> Draw_indirect_buffer_range;
+
+    // Primitive stores are kept for a few most recently used settings;
+    // ID offset color source is only written to transient primitive buffer.
+    static constexpr std::size_t c_max_primitive_store_count = 4;
+
     std::optional<Material_buffer     >      m_material_buffers;
     std::optional<Light_buffer        >      m_light_buffers;
+    std::optional<Light_cluster_buffer>      m_light_cluster_buffers;
     std::optional<Camera_buffer       >      m_camera_buffers;
     std::optional<Draw_indirect_buffer>      m_draw_indirect_buffers;
     std::optional<Primitive_buffer    >      m_primitive_buffers;
     std::shared_ptr<erhe::graphics::Texture> m_dummy_texture;
+
+    // Most recently used first
+    std::vector<std::unique_ptr<Primitive_store>> m_primitive_stores;
+
+    // Render lists are kept over frames to reuse allocations;
+    // first m_render_list_count entries are valid for current frame.
+    erhe::scene::Frustum_culler               m_culler{"Forward_renderer"};
+    std::vector<std::unique_ptr<Render_list>> m_render_lists;
+    std::size_t                               m_render_list_count{0};
+    std::vector<Render_list*>                 m_call_render_lists;
 };
 
 extern Forward_renderer* g_forward_renderer;
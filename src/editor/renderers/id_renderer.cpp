@@ -1,6 +1,7 @@
 #include "renderers/id_renderer.hpp"
 
 #include "editor_log.hpp"
+#include "editor_scenes.hpp"
 #include "renderers/mesh_memory.hpp"
 #include "renderers/program_interface.hpp"
 #include "renderers/programs.hpp"
@@ -111,6 +112,7 @@ void Id_renderer::declare_required_components()
 {
     require<erhe::application::Configuration>();
     require<erhe::application::Gl_context_provider>();
+    require<Editor_scenes>();
     require<Mesh_memory>();
     require<Program_interface>();
     require<Programs>();
@@ -166,6 +168,8 @@ void Id_renderer::initialize_component()
     create_id_frame_resources();
 
     m_gpu_timer = std::make_unique<erhe::graphics::Gpu_timer>("Id_renderer");
+
+    m_culler.set_thread_pool(g_editor_scenes->get_render_thread_pool());
 }
 
 void Id_renderer::create_id_frame_resources()
@@ -191,6 +195,7 @@ void Id_renderer::next_frame()
     m_camera_buffers       ->next_frame();
     m_draw_indirect_buffers->next_frame();
     m_primitive_buffers    ->next_frame();
+    m_culler                .next_frame();
 
     m_current_id_frame_resource_slot = (m_current_id_frame_resource_slot + 1) % s_frame_resources_count;
 }
@@ -290,9 +295,11 @@ void Id_renderer::render(
         .require_all_bits_clear         = 0u,
         .require_at_least_one_bit_clear = 0u
     };
-    const auto primitive_range            = m_primitive_buffers->update(meshes, id_filter, true);
+    m_culler.cull(m_frustum, meshes, id_filter, m_visible_meshes);
+
+    const auto primitive_range            = m_primitive_buffers->update(m_visible_meshes, id_filter, true);
     const auto draw_indirect_buffer_range = m_draw_indirect_buffers->update(
-        meshes,
+        m_visible_meshes,
         erhe::primitive::Primitive_mode::polygon_fill,
         id_filter
     );
@@ -361,6 +368,22 @@ void Id_renderer::render(const Render_parameters& parameters)
     idr.y_offset        = std::max(y - (static_cast<int>(s_extent / 2)), 0);
     idr.clip_from_world = clip_from_world;
 
+    if (m_use_scissor) {
+        // Remap scissor rectangle to clip space -w .. w for culling
+        const float x0 = 2.0f * static_cast<float>(idr.x_offset - viewport.x) / static_cast<float>(viewport.width ) - 1.0f;
+        const float y0 = 2.0f * static_cast<float>(idr.y_offset - viewport.y) / static_cast<float>(viewport.height) - 1.0f;
+        const float x1 = x0 + 2.0f * static_cast<float>(s_extent) / static_cast<float>(viewport.width );
+        const float y1 = y0 + 2.0f * static_cast<float>(s_extent) / static_cast<float>(viewport.height);
+        mat4 scissor_from_clip{1.0f};
+        scissor_from_clip[0][0] = 2.0f / (x1 - x0);
+        scissor_from_clip[1][1] = 2.0f / (y1 - y0);
+        scissor_from_clip[3][0] = -(x0 + x1) / (x1 - x0);
+        scissor_from_clip[3][1] = -(y0 + y1) / (y1 - y0);
+        m_frustum = erhe::scene::Frustum{scissor_from_clip * clip_from_world};
+    } else {
+        m_frustum = erhe::scene::Frustum{clip_from_world};
+    }
+
     m_primitive_buffers->settings.color_source = Primitive_color_source::id_offset;
 
     const auto camera_range = m_camera_buffers->update(
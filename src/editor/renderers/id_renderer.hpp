@@ -6,6 +6,7 @@
 
 #include "erhe/components/components.hpp"
 #include "erhe/graphics/pipeline.hpp"
+#include "erhe/scene/frustum_culler.hpp"
 #include "erhe/scene/viewport.hpp"
 
 #include <fmt/format.h>
@@ -155,6 +156,11 @@ private:
     std::unique_ptr<Camera_buffer       > m_camera_buffers;
     std::unique_ptr<Draw_indirect_buffer> m_draw_indirect_buffers;
     std::unique_ptr<Primitive_buffer    > m_primitive_buffers;
+
+    // Frustum covers only the scissor region around the query position
+    erhe::scene::Frustum                            m_frustum;
+    erhe::scene::Frustum_culler                     m_culler{"Id_renderer"};
+    std::vector<std::shared_ptr<erhe::scene::Mesh>> m_visible_meshes;
 };
 
 extern Id_renderer* g_id_renderer;
@@ -0,0 +1,436 @@
+// #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "renderers/light_cluster_buffer.hpp"
+#include "renderers/light_buffer.hpp"
+#include "editor_log.hpp"
+
+#include "erhe/concurrency/task_graph.hpp"
+#include "erhe/scene/camera.hpp"
+#include "erhe/scene/light.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/scene/projection.hpp"
+#include "erhe/scene/transform.hpp"
+#include "erhe/scene/viewport.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace editor
+{
+
+namespace {
+
+// Cluster data is written once per viewport and frame, and there
+// may be multiple viewports
+constexpr std::size_t c_max_update_count_per_frame = 8;
+constexpr std::size_t c_max_alignment_padding      = 256;
+
+}
+
+Light_cluster_interface::Light_cluster_interface()
+    : light_cluster_block{
+        "light_cluster",
+        4,
+        erhe::graphics::Shader_resource::Type::shader_storage_block
+    }
+    , offsets{
+        .view_from_world = light_cluster_block.add_mat4 ("view_from_world")->offset_in_parent(),
+        .viewport        = light_cluster_block.add_vec4 ("viewport"       )->offset_in_parent(),
+        .grid_size       = light_cluster_block.add_uvec4("grid_size"      )->offset_in_parent(),
+        .depth_slice     = light_cluster_block.add_vec4 ("depth_slice"    )->offset_in_parent(),
+        .clusters        = light_cluster_block.add_uvec4("clusters",      c_cluster_count)->offset_in_parent(),
+        .light_indices   = light_cluster_block.add_uvec4("light_indices", erhe::graphics::Shader_resource::unsized_array)->offset_in_parent()
+    }
+{
+}
+
+auto Light_cluster_interface::max_byte_count() const -> std::size_t
+{
+    return offsets.light_indices + c_max_light_index_count * sizeof(uint32_t);
+}
+
+Light_cluster_buffer::Light_cluster_buffer(Light_cluster_interface* light_cluster_interface)
+    : m_light_cluster_interface{light_cluster_interface}
+    , m_buffer                 {"light cluster"}
+{
+    m_buffer.allocate(
+        gl::Buffer_target::shader_storage_buffer,
+        m_light_cluster_interface->light_cluster_block.binding_point(),
+        c_max_update_count_per_frame * (m_light_cluster_interface->max_byte_count() + c_max_alignment_padding)
+    );
+}
+
+void Light_cluster_buffer::set_thread_pool(erhe::concurrency::Thread_pool* thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+auto Light_cluster_buffer::get_slice(const float view_depth) const -> std::size_t
+{
+    const float slice = std::floor(std::log(view_depth) * m_slice_scale + m_slice_bias);
+    return static_cast<std::size_t>(
+        std::clamp(slice, 0.0f, static_cast<float>(Light_cluster_interface::c_grid_size_z - 1))
+    );
+}
+
+void Light_cluster_buffer::update_cluster_bounds(
+    const glm::mat4& camera_from_clip,
+    const float      z_near,
+    const float      z_far
+)
+{
+    if (
+        !m_min_x.empty() &&
+        (m_bounds_camera_from_clip == camera_from_clip) &&
+        (m_z_near                  == z_near) &&
+        (m_z_far                   == z_far)
+    ) {
+        return;
+    }
+
+    ERHE_PROFILE_FUNCTION
+
+    constexpr std::size_t grid_size_x    = Light_cluster_interface::c_grid_size_x;
+    constexpr std::size_t grid_size_y    = Light_cluster_interface::c_grid_size_y;
+    constexpr std::size_t grid_size_z    = Light_cluster_interface::c_grid_size_z;
+    constexpr std::size_t corner_count_x = grid_size_x + 1;
+    constexpr std::size_t corner_count_y = grid_size_y + 1;
+
+    m_bounds_camera_from_clip = camera_from_clip;
+    m_z_near                  = z_near;
+    m_z_far                   = z_far;
+
+    const float log_depth_ratio = std::log(z_far / z_near);
+    m_slice_scale = static_cast<float>(grid_size_z) / log_depth_ratio;
+    m_slice_bias  = -static_cast<float>(grid_size_z) * std::log(z_near) / log_depth_ratio;
+
+    // Two camera space points on view ray through each tile corner.
+    // Any two distinct clip depths work for both perspective and
+    // orthogonal projections, and for reverse depth.
+    std::array<glm::vec3, corner_count_x * corner_count_y> ray_a;
+    std::array<glm::vec3, corner_count_x * corner_count_y> ray_b;
+    for (std::size_t y = 0; y < corner_count_y; ++y) {
+        for (std::size_t x = 0; x < corner_count_x; ++x) {
+            const float     ndc_x = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(grid_size_x);
+            const float     ndc_y = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(grid_size_y);
+            const glm::vec4 a     = camera_from_clip * glm::vec4{ndc_x, ndc_y, 0.25f, 1.0f};
+            const glm::vec4 b     = camera_from_clip * glm::vec4{ndc_x, ndc_y, 0.75f, 1.0f};
+            ray_a[x + y * corner_count_x] = glm::vec3{a} / a.w;
+            ray_b[x + y * corner_count_x] = glm::vec3{b} / b.w;
+        }
+    }
+
+    m_min_x.resize(Light_cluster_interface::c_cluster_count);
+    m_min_y.resize(Light_cluster_interface::c_cluster_count);
+    m_min_z.resize(Light_cluster_interface::c_cluster_count);
+    m_max_x.resize(Light_cluster_interface::c_cluster_count);
+    m_max_y.resize(Light_cluster_interface::c_cluster_count);
+    m_max_z.resize(Light_cluster_interface::c_cluster_count);
+
+    for (std::size_t z = 0; z < grid_size_z; ++z) {
+        const std::array<float, 2> slice_depths{
+            z_near * std::pow(z_far / z_near, static_cast<float>(z    ) / static_cast<float>(grid_size_z)),
+            z_near * std::pow(z_far / z_near, static_cast<float>(z + 1) / static_cast<float>(grid_size_z))
+        };
+        for (std::size_t y = 0; y < grid_size_y; ++y) {
+            for (std::size_t x = 0; x < grid_size_x; ++x) {
+                glm::vec3 box_min{ std::numeric_limits<float>::max()};
+                glm::vec3 box_max{-std::numeric_limits<float>::max()};
+                for (std::size_t corner = 0; corner < 4; ++corner) {
+                    const std::size_t corner_x  = x + (corner & 1u);
+                    const std::size_t corner_y  = y + (corner >> 1u);
+                    const glm::vec3   a         = ray_a[corner_x + corner_y * corner_count_x];
+                    const glm::vec3   direction = ray_b[corner_x + corner_y * corner_count_x] - a;
+                    if (direction.z == 0.0f) {
+                        continue;
+                    }
+                    for (const float depth : slice_depths) {
+                        const float     t = (-depth - a.z) / direction.z;
+                        const glm::vec3 p = a + t * direction;
+                        box_min = glm::min(box_min, p);
+                        box_max = glm::max(box_max, p);
+                    }
+                }
+                const std::size_t cluster = x + grid_size_x * (y + grid_size_y * z);
+                m_min_x[cluster] = box_min.x;
+                m_min_y[cluster] = box_min.y;
+                m_min_z[cluster] = box_min.z;
+                m_max_x[cluster] = box_max.x;
+                m_max_y[cluster] = box_max.y;
+                m_max_z[cluster] = box_max.z;
+            }
+        }
+    }
+}
+
+void Light_cluster_buffer::assign_slices(const std::size_t begin, const std::size_t end)
+{
+    constexpr std::size_t slice_cluster_count = Light_cluster_interface::c_grid_size_x * Light_cluster_interface::c_grid_size_y;
+
+    std::array<uint64_t, slice_cluster_count> hit;
+    const std::size_t light_count = m_light_indices.size();
+    for (std::size_t slice = begin; slice < end; ++slice) {
+        const std::size_t first_cluster = slice * slice_cluster_count;
+        const float* const min_x = m_min_x.data() + first_cluster;
+        const float* const min_y = m_min_y.data() + first_cluster;
+        const float* const min_z = m_min_z.data() + first_cluster;
+        const float* const max_x = m_max_x.data() + first_cluster;
+        const float* const max_y = m_max_y.data() + first_cluster;
+        const float* const max_z = m_max_z.data() + first_cluster;
+        uint64_t* const    masks = m_masks.data() + first_cluster * m_mask_word_count;
+
+        for (std::size_t light = 0; light < light_count; ++light) {
+            if ((slice < m_light_first_slice[light]) || (slice > m_light_last_slice[light])) {
+                continue;
+            }
+
+            // Squared distance from sphere center to box, branchless
+            const float x  = m_light_x[light];
+            const float y  = m_light_y[light];
+            const float z  = m_light_z[light];
+            const float r2 = m_light_radius[light] * m_light_radius[light];
+            for (std::size_t i = 0; i < slice_cluster_count; ++i) {
+                const float dx = std::max(std::max(min_x[i] - x, 0.0f), x - max_x[i]);
+                const float dy = std::max(std::max(min_y[i] - y, 0.0f), y - max_y[i]);
+                const float dz = std::max(std::max(min_z[i] - z, 0.0f), z - max_z[i]);
+                hit[i] = static_cast<uint64_t>(dx * dx + dy * dy + dz * dz <= r2);
+            }
+
+            const std::size_t word  = light / 64;
+            const std::size_t shift = light % 64;
+            for (std::size_t i = 0; i < slice_cluster_count; ++i) {
+                masks[i * m_mask_word_count + word] |= hit[i] << shift;
+            }
+        }
+    }
+}
+
+auto Light_cluster_buffer::write_fallback() -> erhe::application::Buffer_range
+{
+    if (m_fallback_range.has_value()) {
+        return m_fallback_range.value();
+    }
+
+    // Only grid size is read by shaders when clusters are not used
+    const auto&       offsets      = m_light_cluster_interface->offsets;
+    auto&             buffer       = m_buffer.current_buffer();
+    auto&             writer       = m_buffer.writer();
+    const auto        gpu_data     = writer.begin(&buffer, offsets.light_indices);
+    const std::size_t block_offset = writer.write_offset;
+    if ((block_offset + offsets.light_indices) > writer.write_end) {
+        log_render->critical("light cluster buffer capacity {} exceeded", buffer.capacity_byte_count());
+        ERHE_FATAL("light cluster buffer capacity exceeded");
+    }
+
+    const glm::uvec4 grid_size{0u, 0u, 0u, 0u};
+    erhe::graphics::write(gpu_data, block_offset + offsets.grid_size, erhe::graphics::as_span(grid_size));
+    writer.write_offset += offsets.light_indices;
+    writer.end();
+
+    m_fallback_range = writer.range;
+    return writer.range;
+}
+
+auto Light_cluster_buffer::update(
+    const gsl::span<const std::shared_ptr<erhe::scene::Light>>& lights,
+    const Light_projections*                                    light_projections,
+    const erhe::scene::Camera*                                  camera,
+    const erhe::scene::Viewport&                                viewport
+) -> erhe::application::Buffer_range
+{
+    ERHE_PROFILE_FUNCTION
+
+    const erhe::scene::Node*       camera_node = (camera != nullptr) ? camera->get_node()   : nullptr;
+    const erhe::scene::Projection* projection  = (camera != nullptr) ? camera->projection() : nullptr;
+    const bool use_clusters =
+        (camera_node       != nullptr) &&
+        (projection        != nullptr) &&
+        (light_projections != nullptr) &&
+        !lights.empty() &&
+        (projection->z_near > 0.0f) &&
+        (projection->z_far  > projection->z_near);
+    if (!use_clusters) {
+        return write_fallback();
+    }
+
+    const glm::ivec4 viewport_key{viewport.x, viewport.y, viewport.width, viewport.height};
+    if (
+        m_cluster_range.has_value() &&
+        (m_range_camera            == camera) &&
+        (m_range_light_projections == light_projections) &&
+        (m_range_lights_data       == lights.data()) &&
+        (m_range_lights_size       == lights.size()) &&
+        (m_range_viewport          == viewport_key)
+    ) {
+        return m_cluster_range.value();
+    }
+
+    const auto&       offsets        = m_light_cluster_interface->offsets;
+    auto&             buffer         = m_buffer.current_buffer();
+    auto&             writer         = m_buffer.writer();
+    const std::size_t max_byte_count = m_light_cluster_interface->max_byte_count();
+    const auto        gpu_data       = writer.begin(&buffer, max_byte_count);
+    const std::size_t block_offset   = writer.write_offset;
+    if ((block_offset + max_byte_count) > writer.write_end) {
+        log_render->warn("light cluster buffer capacity {} exceeded", buffer.capacity_byte_count());
+        writer.end();
+        return write_fallback();
+    }
+
+    using erhe::graphics::as_span;
+    using erhe::graphics::write;
+
+    const glm::mat4 camera_from_world = camera_node->node_from_world();
+    const glm::mat4 camera_from_clip  = camera->projection_transforms(viewport).clip_from_camera.inverse_matrix();
+    update_cluster_bounds(camera_from_clip, projection->z_near, projection->z_far);
+
+    // Gather lights which range reaches clustered depth range
+    m_point_light_count = 0;
+    m_light_indices    .clear();
+    m_light_x          .clear();
+    m_light_y          .clear();
+    m_light_z          .clear();
+    m_light_radius     .clear();
+    m_light_first_slice.clear();
+    m_light_last_slice .clear();
+    for (const auto light_type : { erhe::scene::Light_type::point, erhe::scene::Light_type::spot }) {
+        for (const auto& light : lights) {
+            if (light->type != light_type) {
+                continue;
+            }
+            const auto* light_projection_transforms = light_projections->get_light_projection_transforms_for_light(light.get());
+            if (light_projection_transforms == nullptr) {
+                continue;
+            }
+
+            const glm::vec4 position   = camera_from_world * light_projection_transforms->world_from_light_camera.matrix() * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+            const float     radius     = (light->range > 0.0f) ? light->range : std::numeric_limits<float>::infinity();
+            const float     view_depth = -position.z;
+            if (
+                (view_depth + radius < m_z_near) ||
+                (view_depth - radius > m_z_far)
+            ) {
+                continue;
+            }
+            m_light_indices    .push_back(static_cast<uint32_t>(light_projection_transforms->index));
+            m_light_x          .push_back(position.x);
+            m_light_y          .push_back(position.y);
+            m_light_z          .push_back(position.z);
+            m_light_radius     .push_back(radius);
+            m_light_first_slice.push_back(get_slice(std::max(view_depth - radius, m_z_near)));
+            m_light_last_slice .push_back(get_slice(std::min(view_depth + radius, m_z_far )));
+        }
+        if (light_type == erhe::scene::Light_type::point) {
+            m_point_light_count = m_light_indices.size();
+        }
+    }
+
+    // Assign lights to clusters
+    m_mask_word_count = (m_light_indices.size() + 63) / 64;
+    m_masks.assign(Light_cluster_interface::c_cluster_count * m_mask_word_count, 0);
+    if (!m_light_indices.empty()) {
+        erhe::concurrency::parallel_for(
+            m_thread_pool,
+            Light_cluster_interface::c_grid_size_z,
+            1,
+            [this](const std::size_t begin, const std::size_t end)
+            {
+                assign_slices(begin, end);
+            }
+        );
+    }
+
+    // Compact light index lists; point lights come first in each list
+    uint32_t light_index_count{0};
+    bool     overflow         {false};
+    for (std::size_t cluster = 0; cluster < Light_cluster_interface::c_cluster_count; ++cluster) {
+        const uint32_t cluster_offset = light_index_count;
+        uint32_t       point_count{0};
+        uint32_t       spot_count {0};
+        for (std::size_t word = 0; word < m_mask_word_count; ++word) {
+            uint64_t bits = m_masks[cluster * m_mask_word_count + word];
+            while (bits != 0) {
+                const std::size_t light = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                if (light_index_count == Light_cluster_interface::c_max_light_index_count) {
+                    overflow = true;
+                    break;
+                }
+                write(
+                    gpu_data,
+                    block_offset + offsets.light_indices + light_index_count * sizeof(uint32_t),
+                    as_span(m_light_indices[light])
+                );
+                ++light_index_count;
+                if (light < m_point_light_count) {
+                    ++point_count;
+                } else {
+                    ++spot_count;
+                }
+            }
+        }
+        const glm::uvec4 cluster_data{cluster_offset, point_count, spot_count, 0u};
+        write(gpu_data, block_offset + offsets.clusters + cluster * 4 * sizeof(uint32_t), as_span(cluster_data));
+    }
+    if (overflow) {
+        log_render->warn("light cluster light index capacity {} exceeded", Light_cluster_interface::c_max_light_index_count);
+    }
+
+    const glm::vec4  viewport_data{
+        static_cast<float>(viewport.x),
+        static_cast<float>(viewport.y),
+        static_cast<float>(viewport.width),
+        static_cast<float>(viewport.height)
+    };
+    const glm::uvec4 grid_size{
+        static_cast<uint32_t>(Light_cluster_interface::c_grid_size_x),
+        static_cast<uint32_t>(Light_cluster_interface::c_grid_size_y),
+        static_cast<uint32_t>(Light_cluster_interface::c_grid_size_z),
+        1u
+    };
+    const glm::vec4  depth_slice{m_slice_scale, m_slice_bias, m_z_near, m_z_far};
+    write(gpu_data, block_offset + offsets.view_from_world, as_span(camera_from_world));
+    write(gpu_data, block_offset + offsets.viewport,        as_span(viewport_data    ));
+    write(gpu_data, block_offset + offsets.grid_size,       as_span(grid_size        ));
+    write(gpu_data, block_offset + offsets.depth_slice,     as_span(depth_slice      ));
+
+    // Light indices are packed four per uvec4
+    const std::size_t light_indices_byte_count = ((light_index_count + 3) / 4) * 4 * sizeof(uint32_t);
+    writer.write_offset += offsets.light_indices + light_indices_byte_count;
+    writer.end();
+
+    m_cluster_range           = writer.range;
+    m_range_camera            = camera;
+    m_range_light_projections = light_projections;
+    m_range_lights_data       = lights.data();
+    m_range_lights_size       = lights.size();
+    m_range_viewport          = viewport_key;
+
+    SPDLOG_LOGGER_TRACE(
+        log_render,
+        "light clusters: {} lights, {} light indices",
+        m_light_indices.size(),
+        light_index_count
+    );
+
+    return writer.range;
+}
+
+void Light_cluster_buffer::next_frame()
+{
+    m_buffer.next_frame();
+    m_cluster_range .reset();
+    m_fallback_range.reset();
+}
+
+void Light_cluster_buffer::bind(const erhe::application::Buffer_range& range)
+{
+    m_buffer.bind(range);
+}
+
+} // namespace editor
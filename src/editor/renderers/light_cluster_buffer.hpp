@@ -0,0 +1,139 @@
+#pragma once
+
+#include "erhe/application/renderers/multi_buffer.hpp"
+
+#include "erhe/graphics/shader_resource.hpp"
+
+#include <glm/glm.hpp>
+
+#include <gsl/gsl>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
+namespace erhe::scene
+{
+    class Camera;
+    class Light;
+    class Viewport;
+}
+
+namespace editor
+{
+
+class Light_projections;
+
+class Light_cluster_block
+{
+public:
+    std::size_t view_from_world; // mat4
+    std::size_t viewport;        // vec4  x, y, width, height
+    std::size_t grid_size;       // uvec4 x, y, z cluster counts, w = 0 when clusters are not used
+    std::size_t depth_slice;     // vec4  slice = log(view depth) * x + y
+    std::size_t clusters;        // uvec4 x = light index offset, y = point light count, z = spot light count
+    std::size_t light_indices;   // uvec4 four light indices per element
+};
+
+class Light_cluster_interface
+{
+public:
+    Light_cluster_interface();
+
+    static constexpr std::size_t c_grid_size_x           = 16;
+    static constexpr std::size_t c_grid_size_y           = 9;
+    static constexpr std::size_t c_grid_size_z           = 24;
+    static constexpr std::size_t c_cluster_count         = c_grid_size_x * c_grid_size_y * c_grid_size_z;
+    static constexpr std::size_t c_max_light_index_count = 8 * c_cluster_count;
+
+    [[nodiscard]] auto max_byte_count() const -> std::size_t; // for one update
+
+    erhe::graphics::Shader_resource light_cluster_block;
+    Light_cluster_block             offsets{};
+};
+
+// Assigns point and spot lights to clusters of view space froxel grid:
+// screen tiles, subdivided to exponentially distributed depth slices.
+// Fragment shader looks up cluster for fragment, and only processes
+// lights in the compact light index list of that cluster.
+//
+// Assignment tests light range spheres against cluster bounding boxes,
+// for each depth slice in parallel. Tests are branchless loops over
+// structure of arrays bounds, which the compiler can vectorize.
+// Directional lights are not clustered.
+class Light_cluster_buffer
+{
+public:
+    explicit Light_cluster_buffer(Light_cluster_interface* light_cluster_interface);
+
+    void set_thread_pool(erhe::concurrency::Thread_pool* thread_pool);
+
+    // Without camera, clusters are not used and shaders process all lights.
+    // Consecutive calls with same camera, lights and viewport return the
+    // same range; scene must not change while a frame is being rendered.
+    auto update(
+        const gsl::span<const std::shared_ptr<erhe::scene::Light>>& lights,
+        const Light_projections*                                    light_projections,
+        const erhe::scene::Camera*                                  camera,
+        const erhe::scene::Viewport&                                viewport
+    ) -> erhe::application::Buffer_range;
+
+    void next_frame();
+    void bind      (const erhe::application::Buffer_range& range);
+
+private:
+    [[nodiscard]] auto write_fallback() -> erhe::application::Buffer_range;
+
+    void update_cluster_bounds(const glm::mat4& camera_from_clip, float z_near, float z_far);
+    void assign_slices        (std::size_t begin, std::size_t end);
+
+    [[nodiscard]] auto get_slice(float view_depth) const -> std::size_t;
+
+    Light_cluster_interface*        m_light_cluster_interface{nullptr};
+    erhe::application::Multi_buffer m_buffer;
+    erhe::concurrency::Thread_pool* m_thread_pool            {nullptr};
+
+    // Ranges written during current frame
+    std::optional<erhe::application::Buffer_range> m_cluster_range;
+    std::optional<erhe::application::Buffer_range> m_fallback_range;
+    const erhe::scene::Camera*                     m_range_camera           {nullptr};
+    const Light_projections*                       m_range_light_projections{nullptr};
+    const std::shared_ptr<erhe::scene::Light>*     m_range_lights_data      {nullptr};
+    std::size_t                                    m_range_lights_size      {0};
+    glm::ivec4                                     m_range_viewport         {0};
+
+    // Cluster bounds in camera space, structure of arrays indexed by cluster
+    glm::mat4          m_bounds_camera_from_clip{0.0f};
+    float              m_z_near                 {0.0f};
+    float              m_z_far                  {0.0f};
+    float              m_slice_scale            {0.0f};
+    float              m_slice_bias             {0.0f};
+    std::vector<float> m_min_x;
+    std::vector<float> m_min_y;
+    std::vector<float> m_min_z;
+    std::vector<float> m_max_x;
+    std::vector<float> m_max_y;
+    std::vector<float> m_max_z;
+
+    // Lights in camera space, point lights first, then spot lights
+    std::size_t              m_point_light_count{0};
+    std::vector<uint32_t>    m_light_indices;    // index in light block
+    std::vector<float>       m_light_x;
+    std::vector<float>       m_light_y;
+    std::vector<float>       m_light_z;
+    std::vector<float>       m_light_radius;
+    std::vector<std::size_t> m_light_first_slice;
+    std::vector<std::size_t> m_light_last_slice; // inclusive
+
+    // Bit mask of assigned lights for each cluster
+    std::size_t           m_mask_word_count{0};
+    std::vector<uint64_t> m_masks;
+};
+
+} // namespace editor
@@ -1,5 +1,6 @@
 #include "renderers/mesh_memory.hpp"
 
+#include "editor_scenes.hpp"
 #include "renderers/program_interface.hpp"
 
 #include "erhe/application/configuration.hpp"
@@ -27,18 +28,23 @@ public:
 
         int vertex_buffer_size{32}; // in megabytes
         int index_buffer_size  {8}; // in megabytes
+        int staging_buffer_size{8}; // in megabytes
         auto ini = erhe::application::get_ini("erhe.ini", "mesh_memory");
-        ini->get("vertex_buffer_size", vertex_buffer_size);
-        ini->get("index_buffer_size",  index_buffer_size);
+        ini->get("vertex_buffer_size",  vertex_buffer_size);
+        ini->get("index_buffer_size",   index_buffer_size);
+        ini->get("staging_buffer_size", staging_buffer_size);
 
         const erhe::application::Scoped_gl_context gl_context;
 
         static constexpr gl::Buffer_storage_mask storage_mask{gl::Buffer_storage_mask::map_write_bit};
 
-        const std::size_t vertex_byte_count = static_cast<std::size_t>(vertex_buffer_size) * 1024 * 1024;
-        const std::size_t index_byte_count  = static_cast<std::size_t>(index_buffer_size) * 1024 * 1024;
+        const std::size_t vertex_byte_count  = static_cast<std::size_t>(vertex_buffer_size) * 1024 * 1024;
+        const std::size_t index_byte_count   = static_cast<std::size_t>(index_buffer_size) * 1024 * 1024;
+        const std::size_t staging_byte_count = static_cast<std::size_t>(staging_buffer_size) * 1024 * 1024;
 
-        gl_buffer_transfer_queue = std::make_unique<erhe::graphics::Buffer_transfer_queue>();
+        gl_buffer_transfer_queue = (staging_byte_count > 0)
+            ? std::make_unique<erhe::graphics::Buffer_transfer_queue>(staging_byte_count)
+            : std::make_unique<erhe::graphics::Buffer_transfer_queue>();
 
         {
             ERHE_PROFILE_SCOPE("GL VBO");
@@ -69,6 +75,7 @@ public:
         );
 
         build_info.buffer.buffer_sink = gl_buffer_sink.get();
+        build_info.thread_pool        = g_editor_scenes->get_thread_pool(); // Used for building large primitives
 
         auto& format_info = build_info.format;
         auto& buffer_info = build_info.buffer;
@@ -119,7 +126,6 @@ public:
     {
         return build_info.buffer.index_type;
     }
-
 };
 
 IMesh_memory* g_mesh_memory{nullptr};
@@ -143,6 +149,7 @@ void Mesh_memory::declare_required_components()
 {
     require<erhe::application::Configuration>();
     require<erhe::application::Gl_context_provider>();
+    require<Editor_scenes>();
     require<Program_interface>();
 }
 
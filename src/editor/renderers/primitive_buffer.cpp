@@ -29,6 +29,45 @@ Primitive_interface::Primitive_interface(const std::size_t max_primitive_count)
     primitive_block.add_struct("primitives", &primitive_struct, erhe::graphics::Shader_resource::unsized_array);
 }
 
+void write_primitive_entry(
+    const Primitive_interface&          primitive_interface,
+    const Primitive_interface_settings& settings,
+    const gsl::span<std::byte>&         gpu_data,
+    const std::size_t                   byte_offset,
+    const erhe::scene::Mesh&            mesh,
+    const erhe::primitive::Primitive&   primitive,
+    const glm::mat4&                    world_from_node,
+    const uint32_t                      id_offset
+)
+{
+    const auto&     offsets         = primitive_interface.offsets;
+    const auto&     mesh_data       = mesh.mesh_data;
+    const glm::vec4 wireframe_color = mesh.get_wireframe_color();
+    const glm::vec3 id_offset_vec3  = erhe::toolkit::vec3_from_uint(id_offset);
+    const glm::vec4 id_offset_vec4  = glm::vec4{id_offset_vec3, 0.0f};
+    const uint32_t  material_index  = (primitive.material != nullptr) ? primitive.material->material_buffer_index : 0u;
+    const uint32_t  extra2          = 0;
+    const uint32_t  extra3          = 0;
+
+    using erhe::graphics::as_span;
+    const auto color_span =
+        (settings.color_source == Primitive_color_source::id_offset           ) ? as_span(id_offset_vec4         ) :
+        (settings.color_source == Primitive_color_source::mesh_wireframe_color) ? as_span(wireframe_color        ) :
+                                                                                  as_span(settings.constant_color);
+    const auto size_span =
+        (settings.size_source == Primitive_size_source::mesh_point_size) ? as_span(mesh_data.point_size   ) :
+        (settings.size_source == Primitive_size_source::mesh_line_width) ? as_span(mesh_data.line_width   ) :
+                                                                           as_span(settings.constant_size);
+
+    using erhe::graphics::write;
+    write(gpu_data, byte_offset + offsets.world_from_node, as_span(world_from_node));
+    write(gpu_data, byte_offset + offsets.color,           color_span              );
+    write(gpu_data, byte_offset + offsets.material_index,  as_span(material_index ));
+    write(gpu_data, byte_offset + offsets.size,            size_span               );
+    write(gpu_data, byte_offset + offsets.extra2,          as_span(extra2         ));
+    write(gpu_data, byte_offset + offsets.extra3,          as_span(extra3         ));
+}
+
 Primitive_buffer::Primitive_buffer(Primitive_interface* primitive_interface)
     : Multi_buffer         {"primitive"}
     , m_primitive_interface{primitive_interface}
@@ -144,34 +183,16 @@ auto Primitive_buffer::update(
                 m_id_offset += add;
             }
 
-            const glm::vec4 wireframe_color = mesh->get_wireframe_color();
-            const glm::vec3 id_offset_vec3  = erhe::toolkit::vec3_from_uint(m_id_offset);
-            const glm::vec4 id_offset_vec4  = glm::vec4{id_offset_vec3, 0.0f};
-            const uint32_t  material_index  = (primitive.material != nullptr) ? primitive.material->material_buffer_index : 0u;
-            const uint32_t  extra2          = 0;
-            const uint32_t  extra3          = 0;
-
-            using erhe::graphics::as_span;
-            const auto color_span =
-                (settings.color_source == Primitive_color_source::id_offset           ) ? as_span(id_offset_vec4         ) :
-                (settings.color_source == Primitive_color_source::mesh_wireframe_color) ? as_span(wireframe_color        ) :
-                                                                                          as_span(settings.constant_color);
-            const auto size_span =
-                (settings.size_source == Primitive_size_source::mesh_point_size) ? as_span(mesh_data.point_size   ) :
-                (settings.size_source == Primitive_size_source::mesh_line_width) ? as_span(mesh_data.line_width   ) :
-                                                                                   as_span(settings.constant_size);
-            //memset(reinterpret_cast<uint8_t*>(model_gpu_data.data()) + offset, 0, entry_size);
-            {
-                //ZoneScopedN("write");
-                using erhe::graphics::write;
-                write(primitive_gpu_data, m_writer.write_offset + offsets.world_from_node, as_span(world_from_node));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.color,           color_span              );
-                write(primitive_gpu_data, m_writer.write_offset + offsets.material_index,  as_span(material_index ));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.size,            size_span               );
-                write(primitive_gpu_data, m_writer.write_offset + offsets.extra2,          as_span(extra2         ));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.extra3,          as_span(extra3         ));
-
-            }
+            write_primitive_entry(
+                *m_primitive_interface,
+                settings,
+                primitive_gpu_data,
+                m_writer.write_offset,
+                *mesh.get(),
+                primitive,
+                world_from_node,
+                m_id_offset
+            );
             m_writer.write_offset += entry_size;
             ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
 
@@ -6,6 +6,11 @@
 
 #include <vector>
 
+namespace erhe::primitive
+{
+    class Primitive;
+}
+
 namespace erhe::scene
 {
     class Mesh;
@@ -71,12 +76,26 @@ public:
         )
     };
 
+    [[nodiscard]] auto operator==(const Primitive_interface_settings& other) const -> bool = default;
+
     Primitive_color_source color_source  {Primitive_color_source::constant_color};
     glm::vec4              constant_color{1.0f, 1.0f, 1.0f, 1.0f};
     Primitive_size_source  size_source   {Primitive_size_source::constant_size};
     float                  constant_size {1.0f};
 };
 
+// Writes one Primitive struct entry at byte_offset in gpu_data
+void write_primitive_entry(
+    const Primitive_interface&          primitive_interface,
+    const Primitive_interface_settings& settings,
+    const gsl::span<std::byte>&         gpu_data,
+    std::size_t                         byte_offset,
+    const erhe::scene::Mesh&            mesh,
+    const erhe::primitive::Primitive&   primitive,
+    const glm::mat4&                    world_from_node,
+    uint32_t                            id_offset
+);
+
 class Primitive_buffer
     : public erhe::application::Multi_buffer
 {
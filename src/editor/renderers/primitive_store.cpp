@@ -0,0 +1,315 @@
+// #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "renderers/primitive_store.hpp"
+#include "editor_log.hpp"
+
+#include "erhe/gl/wrapper_functions.hpp"
+#include "erhe/graphics/range_allocator.hpp"
+#include "erhe/primitive/material.hpp"
+#include "erhe/primitive/primitive.hpp"
+#include "erhe/scene/mesh.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+
+namespace editor
+{
+
+namespace {
+
+// Compares control blocks, so that a new mesh which happens to reuse
+// the address of a destroyed mesh is not mistaken for the old one.
+[[nodiscard]] auto is_same_mesh(
+    const std::weak_ptr<erhe::scene::Mesh>&   lhs,
+    const std::shared_ptr<erhe::scene::Mesh>& rhs
+) -> bool
+{
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+}
+
+[[nodiscard]] auto get_material_index(const erhe::primitive::Primitive& primitive) -> uint32_t
+{
+    return (primitive.material != nullptr) ? primitive.material->material_buffer_index : 0u;
+}
+
+}
+
+Primitive_store::Primitive_store(
+    Primitive_interface*                primitive_interface,
+    const Primitive_interface_settings& settings
+)
+    : m_primitive_interface{primitive_interface}
+    , m_settings           {settings}
+    , m_entry_size         {primitive_interface->primitive_struct.size_bytes()}
+    , m_buffer{
+        gl::Buffer_target::shader_storage_buffer,
+        m_entry_size * primitive_interface->max_primitive_count,
+        gl::Buffer_storage_mask{0}
+    }
+    , m_staging_buffers{"primitive store staging"}
+{
+    m_buffer.set_debug_label("Primitive Store");
+    m_staging_buffers.allocate(
+        gl::Buffer_target::copy_read_buffer,
+        m_entry_size * primitive_interface->max_primitive_count
+    );
+}
+
+Primitive_store::~Primitive_store() noexcept
+{
+    // Release allocations before buffer and its allocator
+    m_mesh_slots.clear();
+}
+
+auto Primitive_store::settings() const -> const Primitive_interface_settings&
+{
+    return m_settings;
+}
+
+auto Primitive_store::is_used() const -> bool
+{
+    return m_used;
+}
+
+void Primitive_store::reset(const Primitive_interface_settings& settings)
+{
+    ERHE_VERIFY(!m_used);
+    m_mesh_slots.clear();
+    m_settings = settings;
+}
+
+auto Primitive_store::get_base_slot(const erhe::scene::Mesh* mesh) const -> uint32_t
+{
+    const auto i = m_mesh_slots.find(mesh);
+    ERHE_VERIFY(i != m_mesh_slots.end());
+    return i->second.base_slot;
+}
+
+auto Primitive_store::is_dirty(
+    const Mesh_slot&         mesh_slot,
+    const erhe::scene::Mesh& mesh,
+    const erhe::scene::Node& node
+) const -> bool
+{
+    const uint64_t transform_serial = node.node_data.transforms.update_serial;
+    if (
+        (mesh_slot.node             != &node) ||
+        (transform_serial           == 0) ||
+        (mesh_slot.transform_serial != transform_serial)
+    ) {
+        return true;
+    }
+
+    const auto& mesh_data = mesh.mesh_data;
+    if (
+        (mesh_slot.point_size      != mesh_data.point_size) ||
+        (mesh_slot.line_width      != mesh_data.line_width) ||
+        (mesh_slot.wireframe_color != mesh.get_wireframe_color())
+    ) {
+        return true;
+    }
+
+    const auto& primitives = mesh_data.primitives;
+    for (std::size_t i = 0, end = primitives.size(); i < end; ++i) {
+        if (mesh_slot.material_indices[i] != get_material_index(primitives[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Primitive_store::capture(
+    Mesh_slot&               mesh_slot,
+    const erhe::scene::Mesh& mesh,
+    const erhe::scene::Node& node
+)
+{
+    const auto& mesh_data = mesh.mesh_data;
+    mesh_slot.node             = &node;
+    mesh_slot.transform_serial = node.node_data.transforms.update_serial;
+    mesh_slot.wireframe_color  = mesh.get_wireframe_color();
+    mesh_slot.point_size       = mesh_data.point_size;
+    mesh_slot.line_width       = mesh_data.line_width;
+    mesh_slot.material_indices.resize(mesh_data.primitives.size());
+    for (std::size_t i = 0, end = mesh_data.primitives.size(); i < end; ++i) {
+        mesh_slot.material_indices[i] = get_material_index(mesh_data.primitives[i]);
+    }
+}
+
+auto Primitive_store::update(
+    const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    const erhe::scene::Item_filter&                            filter
+) -> bool
+{
+    ERHE_PROFILE_FUNCTION
+
+    m_used = true;
+
+    // Find meshes which need upload, and allocate slots for new meshes
+    m_dirty_meshes.clear();
+    std::size_t dirty_slot_count{0};
+    for (const auto& mesh : meshes) {
+        ERHE_VERIFY(mesh);
+        if (!filter(mesh->get_flag_bits())) {
+            continue;
+        }
+
+        const auto* node = mesh->get_node();
+        if (node == nullptr) {
+            continue;
+        }
+
+        const std::size_t primitive_count = mesh->mesh_data.primitives.size();
+        if (primitive_count == 0) {
+            continue;
+        }
+
+        Mesh_slot& mesh_slot = m_mesh_slots[mesh.get()];
+        mesh_slot.last_used_frame = m_frame;
+        if (
+            !is_same_mesh(mesh_slot.mesh, mesh) ||
+            (mesh_slot.slot_count != primitive_count)
+        ) {
+            mesh_slot.allocation.reset();
+            mesh_slot.allocation = m_buffer.allocate_range(primitive_count * m_entry_size, m_entry_size);
+            if (!mesh_slot.allocation) {
+                log_render->warn("primitive store capacity exceeded");
+                m_mesh_slots.erase(mesh.get());
+                return false;
+            }
+            mesh_slot.mesh       = mesh;
+            mesh_slot.base_slot  = static_cast<uint32_t>(mesh_slot.allocation->get_byte_offset() / m_entry_size);
+            mesh_slot.slot_count = static_cast<uint32_t>(primitive_count);
+            mesh_slot.node       = nullptr;
+        } else if (!is_dirty(mesh_slot, *mesh.get(), *node)) {
+            continue;
+        }
+
+        m_dirty_meshes.push_back(mesh.get());
+        dirty_slot_count += primitive_count;
+    }
+
+    if (m_dirty_meshes.empty()) {
+        return true;
+    }
+
+    // Upload in slot order, so that copies of neighbour meshes can be merged
+    std::sort(
+        m_dirty_meshes.begin(),
+        m_dirty_meshes.end(),
+        [this](const erhe::scene::Mesh* lhs, const erhe::scene::Mesh* rhs)
+        {
+            return m_mesh_slots.at(lhs).base_slot < m_mesh_slots.at(rhs).base_slot;
+        }
+    );
+
+    auto&             staging_buffer = m_staging_buffers.current_buffer();
+    auto&             writer         = m_staging_buffers.writer();
+    const std::size_t max_byte_count = dirty_slot_count * m_entry_size;
+    const auto        staging_data   = writer.begin(&staging_buffer, max_byte_count);
+    if ((writer.write_offset + max_byte_count) > writer.write_end) {
+        // Dirty meshes were not captured, they are retried next time
+        log_render->warn("primitive store staging buffer capacity {} exceeded", staging_buffer.capacity_byte_count());
+        writer.end();
+        return false;
+    }
+
+    m_copies.clear();
+    for (const auto* mesh : m_dirty_meshes) {
+        Mesh_slot&      mesh_slot       = m_mesh_slots.at(mesh);
+        const auto&     node            = *mesh->get_node();
+        const glm::mat4 world_from_node = node.world_from_node();
+        const auto      staging_offset  = writer.write_offset;
+        for (const auto& primitive : mesh->mesh_data.primitives) {
+            write_primitive_entry(
+                *m_primitive_interface,
+                m_settings,
+                staging_data,
+                writer.write_offset,
+                *mesh,
+                primitive,
+                world_from_node,
+                0
+            );
+            writer.write_offset += m_entry_size;
+        }
+        capture(mesh_slot, *mesh, node);
+
+        const std::size_t store_offset = mesh_slot.allocation->get_byte_offset();
+        const std::size_t byte_count   = writer.write_offset - staging_offset;
+        if (
+            !m_copies.empty() &&
+            (m_copies.back().store_offset   + m_copies.back().byte_count == store_offset) &&
+            (m_copies.back().staging_offset + m_copies.back().byte_count == staging_offset)
+        ) {
+            m_copies.back().byte_count += byte_count;
+        } else {
+            m_copies.push_back(
+                Copy{
+                    .staging_offset = staging_offset,
+                    .store_offset   = store_offset,
+                    .byte_count     = byte_count
+                }
+            );
+        }
+    }
+    writer.end();
+
+    const std::size_t staging_base = writer.range.first_byte_offset;
+    for (const auto& copy : m_copies) {
+        gl::copy_named_buffer_sub_data(
+            staging_buffer.gl_name(),
+            m_buffer.gl_name(),
+            static_cast<GLintptr>  (staging_base + copy.staging_offset),
+            static_cast<GLintptr>  (copy.store_offset),
+            static_cast<GLsizeiptr>(copy.byte_count)
+        );
+    }
+
+    SPDLOG_LOGGER_TRACE(
+        log_render,
+        "primitive store: uploaded {} meshes, {} slots, {} copies",
+        m_dirty_meshes.size(),
+        dirty_slot_count,
+        m_copies.size()
+    );
+
+    return true;
+}
+
+void Primitive_store::bind()
+{
+    gl::bind_buffer_range(
+        gl::Buffer_target::shader_storage_buffer,
+        static_cast<GLuint>    (m_primitive_interface->primitive_block.binding_point()),
+        static_cast<GLuint>    (m_buffer.gl_name()),
+        static_cast<GLintptr>  (0),
+        static_cast<GLsizeiptr>(m_buffer.capacity_byte_count())
+    );
+}
+
+void Primitive_store::next_frame()
+{
+    ERHE_PROFILE_FUNCTION
+
+    // Release slots of destroyed meshes, and of meshes not drawn recently
+    for (auto i = m_mesh_slots.begin(); i != m_mesh_slots.end();) {
+        const Mesh_slot& mesh_slot = i->second;
+        if (
+            mesh_slot.mesh.expired() ||
+            (m_frame - mesh_slot.last_used_frame > c_release_frame_count)
+        ) {
+            i = m_mesh_slots.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    m_staging_buffers.next_frame();
+    m_used = false;
+    ++m_frame;
+}
+
+} // namespace editor
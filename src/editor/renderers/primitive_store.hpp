@@ -0,0 +1,126 @@
+#pragma once
+
+#include "renderers/primitive_buffer.hpp"
+
+#include "erhe/application/renderers/multi_buffer.hpp"
+#include "erhe/graphics/buffer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <gsl/gsl>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::graphics
+{
+    class Range_allocation;
+}
+
+namespace erhe::scene
+{
+    class Mesh;
+    class Node;
+    class Item_filter;
+}
+
+namespace editor
+{
+
+// Persistent primitive data. Unlike Primitive_buffer, which rewrites all
+// primitive entries every frame, each mesh owns a stable range of primitive
+// slots in a GPU only buffer. Only meshes which node transform serial,
+// materials, or mesh properties have changed are written to a staging
+// buffer and copied to their slots. Draws reference primitive slots with
+// base instance - see Draw_indirect_buffer::update().
+//
+// Slots not used for a number of frames, and slots of destroyed meshes,
+// are released in next_frame().
+class Primitive_store
+{
+public:
+    Primitive_store(
+        Primitive_interface*                primitive_interface,
+        const Primitive_interface_settings& settings
+    );
+    ~Primitive_store() noexcept;
+
+    Primitive_store(const Primitive_store&) = delete;
+    auto operator= (const Primitive_store&) = delete;
+    Primitive_store(Primitive_store&&)      = delete;
+    auto operator= (Primitive_store&&)      = delete;
+
+    // Makes sure all meshes that pass filter have up to date slots.
+    // Returns false if the store ran out of slots; in that case caller
+    // should fall back to Primitive_buffer.
+    [[nodiscard]] auto update(
+        const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+        const erhe::scene::Item_filter&                            filter
+    ) -> bool;
+
+    // Returns first primitive slot of mesh, valid after update() for the mesh
+    [[nodiscard]] auto get_base_slot(const erhe::scene::Mesh* mesh) const -> uint32_t;
+
+    void bind      ();
+    void next_frame();
+
+    [[nodiscard]] auto settings() const -> const Primitive_interface_settings&;
+    [[nodiscard]] auto is_used () const -> bool; // update() called since next_frame()
+
+    // Settings can be changed only by discarding all slots
+    void reset(const Primitive_interface_settings& settings);
+
+    static constexpr uint64_t c_release_frame_count = 16;
+
+private:
+    class Mesh_slot
+    {
+    public:
+        std::weak_ptr<erhe::scene::Mesh>                  mesh;
+        std::shared_ptr<erhe::graphics::Range_allocation> allocation;
+        uint32_t                                          base_slot       {0};
+        uint32_t                                          slot_count      {0};
+        const erhe::scene::Node*                          node            {nullptr};
+        uint64_t                                          transform_serial{0};
+        std::vector<uint32_t>                             material_indices;
+        glm::vec4                                         wireframe_color {0.0f};
+        float                                             point_size      {0.0f};
+        float                                             line_width      {0.0f};
+        uint64_t                                          last_used_frame {0};
+    };
+
+    class Copy
+    {
+    public:
+        std::size_t staging_offset{0}; // relative to staging range
+        std::size_t store_offset  {0};
+        std::size_t byte_count    {0};
+    };
+
+    [[nodiscard]] auto is_dirty(
+        const Mesh_slot&         mesh_slot,
+        const erhe::scene::Mesh& mesh,
+        const erhe::scene::Node& node
+    ) const -> bool;
+
+    void capture(
+        Mesh_slot&               mesh_slot,
+        const erhe::scene::Mesh& mesh,
+        const erhe::scene::Node& node
+    );
+
+    Primitive_interface*                                    m_primitive_interface{nullptr};
+    Primitive_interface_settings                            m_settings;
+    std::size_t                                             m_entry_size{0};
+    erhe::graphics::Buffer                                  m_buffer;
+    erhe::application::Multi_buffer                         m_staging_buffers;
+    std::unordered_map<const erhe::scene::Mesh*, Mesh_slot> m_mesh_slots;
+    std::vector<const erhe::scene::Mesh*>                   m_dirty_meshes;
+    std::vector<Copy>                                       m_copies;
+    uint64_t                                                m_frame{0};
+    bool                                                    m_used {false};
+};
+
+} // namespace editor
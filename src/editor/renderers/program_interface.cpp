@@ -150,10 +150,11 @@ Program_interface::Shader_resources::Shader_resources(
             }
         }
     }
-    , camera_interface   {max_camera_count   }
-    , light_interface    {max_light_count    }
-    , material_interface {max_material_count }
-    , primitive_interface{max_primitive_count}
+    , camera_interface       {max_camera_count   }
+    , light_interface        {max_light_count    }
+    , light_cluster_interface{}
+    , material_interface     {max_material_count }
+    , primitive_interface    {max_primitive_count}
 {
 }
 
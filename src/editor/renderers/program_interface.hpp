@@ -2,6 +2,7 @@
 
 #include "renderers/camera_buffer.hpp"
 #include "renderers/light_buffer.hpp"
+#include "renderers/light_cluster_buffer.hpp"
 #include "renderers/material_buffer.hpp"
 #include "renderers/primitive_buffer.hpp"
 
@@ -58,10 +59,11 @@ public:
         erhe::graphics::Fragment_outputs          fragment_outputs;
         erhe::graphics::Vertex_attribute_mappings attribute_mappings;
 
-        Camera_interface    camera_interface;
-        Light_interface     light_interface;
-        Material_interface  material_interface;
-        Primitive_interface primitive_interface;
+        Camera_interface        camera_interface;
+        Light_interface         light_interface;
+        Light_cluster_interface light_cluster_interface;
+        Material_interface      material_interface;
+        Primitive_interface     primitive_interface;
     };
 
     std::unique_ptr<Shader_resources> shader_resources;
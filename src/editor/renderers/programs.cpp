@@ -229,6 +229,7 @@ auto Programs_impl::make_prototype(
     create_info.add_interface_block(&shader_resources.material_interface.material_block);
     create_info.add_interface_block(&shader_resources.light_interface.light_block);
     create_info.add_interface_block(&shader_resources.light_interface.light_control_block);
+    create_info.add_interface_block(&shader_resources.light_cluster_interface.light_cluster_block);
     create_info.add_interface_block(&shader_resources.camera_interface.camera_block);
     create_info.add_interface_block(&shader_resources.primitive_interface.primitive_block);
     create_info.struct_types.push_back(&shader_resources.material_interface.material_struct);
@@ -247,6 +248,7 @@ auto Programs_impl::make_prototype(
         create_info.extensions.push_back({gl::Shader_type::vertex_shader,   "GL_ARB_shader_draw_parameters"});
         create_info.extensions.push_back({gl::Shader_type::geometry_shader, "GL_ARB_shader_draw_parameters"});
         create_info.defines.push_back({"gl_DrawID", "gl_DrawIDARB"});
+        create_info.defines.push_back({"gl_BaseInstance", "gl_BaseInstanceARB"});
     }
 
     const auto& config = *erhe::application::g_configuration;
@@ -4,6 +4,7 @@
 
 #include "editor_log.hpp"
 #include "editor_message_bus.hpp"
+#include "editor_scenes.hpp"
 
 #include "rendergraph/shadow_render_node.hpp"
 #include "renderers/mesh_memory.hpp"
@@ -35,6 +36,7 @@
 #include "erhe/scene/light.hpp"
 #include "erhe/scene/scene.hpp"
 #include "erhe/toolkit/bit_helpers.hpp"
+#include "erhe/toolkit/hash.hpp"
 #include "erhe/toolkit/math_util.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
@@ -59,6 +61,42 @@ using erhe::graphics::Color_blend_state;
 
 Shadow_renderer* g_shadow_renderer{nullptr};
 
+namespace {
+
+// Identifies shadow casters and their state. Node transform serial
+// changes when node or any of its parents is moved, index ranges
+// change when mesh geometry is replaced.
+[[nodiscard]] auto hash_casters(
+    const std::vector<std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    uint64_t                                               seed
+) -> uint64_t
+{
+    for (const auto& mesh : meshes) {
+        const auto* node = mesh->get_node();
+        const uint64_t mesh_values[] = {
+            static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(mesh.get())),
+            static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(node)),
+            node->node_data.transforms.update_serial,
+            mesh->mesh_data.primitives.size()
+        };
+        seed = erhe::toolkit::hash(mesh_values, sizeof(mesh_values), seed);
+        for (const auto& primitive : mesh->mesh_data.primitives) {
+            const auto&    primitive_geometry = primitive.gl_primitive_geometry;
+            const auto&    index_range        = primitive_geometry.triangle_fill_indices;
+            const uint64_t primitive_values[] = {
+                primitive_geometry.base_index(),
+                primitive_geometry.base_vertex(),
+                index_range.first_index,
+                index_range.index_count
+            };
+            seed = erhe::toolkit::hash(primitive_values, sizeof(primitive_values), seed);
+        }
+    }
+    return seed;
+}
+
+}
+
 Shadow_renderer::Shadow_renderer()
     : Component{c_type_name}
 {
@@ -85,6 +123,7 @@ void Shadow_renderer::declare_required_components()
 {
     require<erhe::application::Gl_context_provider>();
     require<Editor_message_bus>();
+    require<Editor_scenes     >();
     require<Program_interface >();
     require<Programs          >();
 }
@@ -99,6 +138,7 @@ void Shadow_renderer::initialize_component()
     auto ini = erhe::application::get_ini("erhe.ini", "shadow_renderer");
     ini->get("enabled",                    config.enabled);
     ini->get("tight_frustum_fit",          config.tight_frustum_fit);
+    ini->get("cache_shadow_maps",          config.cache_shadow_maps);
     ini->get("shadow_map_resolution",      config.shadow_map_resolution);
     ini->get("shadow_map_max_light_count", config.shadow_map_max_light_count);
 
@@ -145,11 +185,14 @@ void Shadow_renderer::initialize_component()
 
     m_gpu_timer = std::make_unique<erhe::graphics::Gpu_timer>("Shadow_renderer");
 
+    m_culler.set_thread_pool(g_editor_scenes->get_render_thread_pool());
+
     g_editor_message_bus->add_receiver(
         [&](Editor_message& message)
         {
             on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_graphics_settings
     );
 
     g_shadow_renderer = this;
@@ -231,6 +274,7 @@ void Shadow_renderer::next_frame()
     m_light_buffers        ->next_frame();
     m_draw_indirect_buffers->next_frame();
     m_primitive_buffers    ->next_frame();
+    m_culler                .next_frame();
 }
 
 auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
@@ -285,61 +329,89 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
     );
     m_light_buffers->bind_light_buffer(light_range);
 
-    for (const auto& meshes : mesh_spans) {
-        const auto primitive_range = m_primitive_buffers->update(meshes, shadow_filter);
-        const auto draw_indirect_buffer_range = m_draw_indirect_buffers->update(
-            meshes,
-            erhe::primitive::Primitive_mode::polygon_fill,
-            shadow_filter
-        );
-        if (draw_indirect_buffer_range.draw_indirect_count > 0) {
-            m_primitive_buffers->bind(primitive_range);
-            m_draw_indirect_buffers->bind(draw_indirect_buffer_range.range);
+    m_visible_meshes.resize(mesh_spans.size());
+
+    for (const auto& light : lights) {
+        if (!light->cast_shadow) {
+            continue;
         }
 
-        for (const auto& light : lights) {
-            if (!light->cast_shadow) {
-                continue;
-            }
+        auto* light_projection_transform = parameters.light_projections.get_light_projection_transforms_for_light(light.get());
+        if (light_projection_transform == nullptr) {
+            //// log_render->warn("Light {} has no light projection transforms", light->name());
+            continue;
+        }
+        const std::size_t light_index = light_projection_transform->index;
+        if (
+            (light_index >= parameters.framebuffers.size()) ||
+            (light_index >= parameters.layer_caches.size())
+        ) {
+            continue;
+        }
 
-            auto* light_projection_transform = parameters.light_projections.get_light_projection_transforms_for_light(light.get());
-            if (light_projection_transform == nullptr) {
-                //// log_render->warn("Light {} has no light projection transforms", light->name());
-                continue;
-            }
-            const std::size_t light_index = light_projection_transform->index;
-            if (light_index >= parameters.framebuffers.size()) {
-                continue;
-            }
+        // Only casters inside light frustum can affect the shadow map
+        const glm::mat4            clip_from_world = light_projection_transform->clip_from_world.matrix();
+        const erhe::scene::Frustum light_frustum{clip_from_world};
 
-            //Frustum_tiler frustum_tiler{*m_texture.get()};
-            //frustum_tiler.update(
-            //    light_index,
-            //    m_light_projections.projection_transforms[light_index].clip_from_world.matrix(),
-            //    parameters.view_camera,
-            //    parameters.view_camera_viewport
-            //);
+        uint64_t caster_hash = erhe::toolkit::c_seed;
+        std::size_t span_index = 0;
+        for (const auto& meshes : mesh_spans) {
+            auto& visible_meshes = m_visible_meshes[span_index++];
+            m_culler.cull(light_frustum, meshes, shadow_filter, visible_meshes);
+            caster_hash = hash_casters(visible_meshes, caster_hash);
+        }
 
-            {
-                ERHE_PROFILE_SCOPE("bind fbo");
-                gl::bind_framebuffer(gl::Framebuffer_target::draw_framebuffer, parameters.framebuffers[light_index]->gl_name());
-            }
+        // Skip layer if light projection and casters are unchanged
+        Shadow_layer_cache& layer_cache = parameters.layer_caches.at(light_index);
+        if (
+            config.cache_shadow_maps &&
+            layer_cache.valid &&
+            (layer_cache.light           == light.get()) &&
+            (layer_cache.clip_from_world == clip_from_world) &&
+            (layer_cache.caster_hash     == caster_hash)
+        ) {
+            continue;
+        }
+        layer_cache = Shadow_layer_cache{
+            .valid           = true,
+            .light           = light.get(),
+            .clip_from_world = clip_from_world,
+            .caster_hash     = caster_hash
+        };
 
-            {
-                static constexpr std::string_view c_id_clear{"clear"};
+        {
+            ERHE_PROFILE_SCOPE("bind fbo");
+            gl::bind_framebuffer(gl::Framebuffer_target::draw_framebuffer, parameters.framebuffers[light_index]->gl_name());
+        }
+
+        {
+            static constexpr std::string_view c_id_clear{"clear"};
+
+            ERHE_PROFILE_SCOPE("clear fbo");
+            ERHE_PROFILE_GPU_SCOPE(c_id_clear);
 
-                ERHE_PROFILE_SCOPE("clear fbo");
-                ERHE_PROFILE_GPU_SCOPE(c_id_clear);
+            gl::clear_buffer_fv(gl::Buffer::depth, 0, erhe::application::g_configuration->depth_clear_value_pointer());
+        }
 
-                gl::clear_buffer_fv(gl::Buffer::depth, 0, erhe::application::g_configuration->depth_clear_value_pointer());
+        const auto control_range = m_light_buffers->update_control(light_index);
+        m_light_buffers->bind_control_buffer(control_range);
+
+        for (const auto& visible_meshes : m_visible_meshes) {
+            if (visible_meshes.empty()) {
+                continue;
             }
 
+            const auto primitive_range = m_primitive_buffers->update(visible_meshes, shadow_filter);
+            const auto draw_indirect_buffer_range = m_draw_indirect_buffers->update(
+                visible_meshes,
+                erhe::primitive::Primitive_mode::polygon_fill,
+                shadow_filter
+            );
             if (draw_indirect_buffer_range.draw_indirect_count == 0) {
                 continue;
             }
-
-            const auto control_range = m_light_buffers->update_control(light_index);
-            m_light_buffers->bind_control_buffer(control_range);
+            m_primitive_buffers->bind(primitive_range);
+            m_draw_indirect_buffers->bind(draw_indirect_buffer_range.range);
 
             {
                 static constexpr std::string_view c_id_mdi{"mdi"};
@@ -356,6 +428,11 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
             }
         }
     }
+
+    // Visible meshes are not kept alive past render()
+    for (auto& visible_meshes : m_visible_meshes) {
+        visible_meshes.clear();
+    }
     return true;
 }
 
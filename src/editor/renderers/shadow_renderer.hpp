@@ -7,11 +7,15 @@
 #include "erhe/application/rendergraph/rendergraph_node.hpp"
 #include "erhe/components/components.hpp"
 #include "erhe/graphics/pipeline.hpp"
+#include "erhe/scene/frustum_culler.hpp"
 #include "erhe/scene/viewport.hpp"
 
+#include <glm/glm.hpp>
+
 #include <gsl/gsl>
 
 #include <initializer_list>
+#include <vector>
 
 namespace erhe::graphics
 {
@@ -36,6 +40,18 @@ class Scene_root;
 class Scene_view;
 class Shadow_render_node;
 
+// What was last rendered to a shadow map texture layer. Layer needs
+// to be rendered again only if light projection or shadow casters
+// inside light frustum have changed.
+class Shadow_layer_cache
+{
+public:
+    bool                      valid          {false};
+    const erhe::scene::Light* light          {nullptr};
+    glm::mat4                 clip_from_world{0.0f};
+    uint64_t                  caster_hash    {0};
+};
+
 class Shadow_renderer
     : public erhe::components::Component
 {
@@ -45,6 +61,7 @@ public:
     public:
         bool enabled                   {true};
         bool tight_frustum_fit         {true};
+        bool cache_shadow_maps         {true};
         int  shadow_map_resolution     {2048};
         int  shadow_map_max_light_count{8};
     };
@@ -81,6 +98,7 @@ public:
         >&                                                         mesh_spans;
         const gsl::span<const std::shared_ptr<erhe::scene::Light>> lights;
         Light_projections&                                         light_projections;
+        std::vector<Shadow_layer_cache>&                           layer_caches; // one per framebuffer
     };
 
     auto create_node_for_scene_view(Scene_view& scene_view) -> std::shared_ptr<Shadow_render_node>;
@@ -101,6 +119,10 @@ private:
     std::unique_ptr<Light_buffer        >               m_light_buffers;
     std::unique_ptr<Draw_indirect_buffer>               m_draw_indirect_buffers;
     std::unique_ptr<Primitive_buffer    >               m_primitive_buffers;
+    erhe::scene::Frustum_culler                         m_culler{"Shadow_renderer"};
+    std::vector<
+        std::vector<std::shared_ptr<erhe::scene::Mesh>>
+    >                                                   m_visible_meshes; // per mesh span
 };
 
 extern Shadow_renderer* g_shadow_renderer;
@@ -15,6 +15,8 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 namespace editor
 {
 
@@ -80,6 +82,10 @@ void Shadow_render_node::reconfigure(
         }
     }
 
+    // Texture contents are lost
+    m_layer_caches.clear();
+    m_layer_caches.resize(static_cast<std::size_t>(std::max(light_count, 0)));
+
     m_framebuffers.clear();
     for (int i = 0; i < light_count; ++i) {
         ERHE_PROFILE_SCOPE("framebuffer creation");
@@ -130,7 +136,8 @@ void Shadow_render_node::execute_rendergraph_node()
             .framebuffers          = m_framebuffers,
             .mesh_spans            = { layers.content()->meshes },
             .lights                = layers.light()->lights,
-            .light_projections     = m_light_projections
+            .light_projections     = m_light_projections,
+            .layer_caches          = m_layer_caches
         }
     );
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderers/light_buffer.hpp"
+#include "renderers/shadow_renderer.hpp"
 #include "erhe/application/rendergraph/rendergraph_node.hpp"
 
 #include <glm/glm.hpp>
@@ -77,7 +78,8 @@ private:
     std::vector<std::unique_ptr<erhe::graphics::Framebuffer>> m_framebuffers;
     erhe::scene::Viewport                                     m_viewport{0, 0, 0, 0, true};
 
-    Light_projections m_light_projections;
+    Light_projections               m_light_projections;
+    std::vector<Shadow_layer_cache> m_layer_caches;
 };
 
 } // namespace editor
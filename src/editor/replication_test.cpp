@@ -0,0 +1,212 @@
+// Loopback harness for erhe::replication. Runs replication server and
+// client in the same process over a local TCP connection, animates a set
+// of nodes and reports bytes per frame and round trip latency.
+
+#include "erhe/log/log.hpp"
+#include "erhe/net/client.hpp"
+#include "erhe/net/net_log.hpp"
+#include "erhe/net/server.hpp"
+#include "erhe/replication/replication_client.hpp"
+#include "erhe/replication/replication_log.hpp"
+#include "erhe/replication/replication_server.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/scene/scene_log.hpp"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class Options
+{
+public:
+    Options(int argc, char** argv)
+    {
+        cxxopts::Options options{"replication-test", "Erhe scene replication loopback test"};
+
+        options.add_options()
+            ("port",            "Loopback port", cxxopts::value<int>()->default_value("34568"), "<port>")
+            ("nodes",           "Number of replicated nodes", cxxopts::value<int>()->default_value("1000"), "<count>")
+            ("moving",          "Number of nodes moving each frame", cxxopts::value<int>()->default_value("100"), "<count>")
+            ("frames",          "Number of frames to run", cxxopts::value<int>()->default_value("600"), "<count>")
+            ("frame-time",      "Frame time in milliseconds", cxxopts::value<int>()->default_value("16"), "<ms>")
+            ("budget",          "Byte budget per client per frame", cxxopts::value<int>()->default_value("16384"), "<bytes>")
+            ("interest-radius", "Interest radius around viewer, 0 for unlimited", cxxopts::value<float>()->default_value("0"), "<radius>");
+
+        try {
+            auto arguments = options.parse(argc, argv);
+
+            port            = arguments["port"           ].as<int>();
+            node_count      = arguments["nodes"          ].as<int>();
+            moving_count    = arguments["moving"         ].as<int>();
+            frame_count     = arguments["frames"         ].as<int>();
+            frame_time_ms   = arguments["frame-time"     ].as<int>();
+            budget          = arguments["budget"         ].as<int>();
+            interest_radius = arguments["interest-radius"].as<float>();
+        } catch (const std::exception& e) {
+            fmt::print(
+                "Error parsing command line argumenst: {}",
+                e.what()
+            );
+        }
+    }
+
+    int   port           {34568};
+    int   node_count     {1000};
+    int   moving_count   {100};
+    int   frame_count    {600};
+    int   frame_time_ms  {16};
+    int   budget         {16384};
+    float interest_radius{0.0f};
+};
+
+auto main(int argc, char** argv) -> int
+{
+    using Clock = std::chrono::steady_clock;
+
+    Options options{argc, argv};
+
+    erhe::log::console_init();
+    erhe::log::log_to_console();
+    erhe::log::initialize_log_sinks();
+    erhe::net::initialize_logging();
+    erhe::replication::initialize_logging();
+    erhe::scene::initialize_logging();
+    erhe::net::initialize_net();
+
+    erhe::net::Server server;
+    erhe::net::Client client;
+    if (!server.listen("127.0.0.1", options.port)) {
+        fmt::print("listen failed\n");
+        return 1;
+    }
+    client.connect("127.0.0.1", options.port);
+
+    erhe::replication::Replication_server_config config;
+    config.frame_byte_budget = static_cast<std::size_t>(options.budget);
+    config.interest_radius   = options.interest_radius;
+    erhe::replication::Replication_server replication_server{server, config};
+    erhe::replication::Replication_client replication_client{
+        client,
+        [](const uint32_t, const std::string& name)
+        {
+            return std::make_shared<erhe::scene::Node>(name);
+        },
+        config.quantization
+    };
+
+    // Nodes on a grid, 2 units apart
+    std::vector<std::shared_ptr<erhe::scene::Node>> nodes;
+    const int grid_size = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(options.node_count))));
+    for (int i = 0; i < options.node_count; ++i) {
+        auto node = std::make_shared<erhe::scene::Node>(fmt::format("node {}", i));
+        node->set_parent_from_node(
+            glm::translate(
+                glm::mat4{1.0f},
+                glm::vec3{2.0f * static_cast<float>(i % grid_size), 0.0f, 2.0f * static_cast<float>(i / grid_size)}
+            )
+        );
+        replication_server.add_node(node);
+        nodes.push_back(node);
+    }
+
+    // Wait for connection
+    const auto connect_deadline = Clock::now() + std::chrono::seconds{5};
+    while ((replication_server.get_client_count() == 0) && (Clock::now() < connect_deadline)) {
+        server.poll(1);
+        client.poll(1);
+    }
+    if (replication_server.get_client_count() == 0) {
+        fmt::print("client did not connect\n");
+        return 1;
+    }
+    const erhe::net::Socket& server_client_socket = *server.get_clients().front().get();
+
+    std::size_t total_bytes   {0};
+    std::size_t max_bytes     {0};
+    std::size_t active_frames {0};
+    float       max_rtt_ms    {0.0f};
+    const int   moving_count = std::min(options.moving_count, options.node_count);
+    for (int frame = 0; frame < options.frame_count; ++frame) {
+        const auto frame_start = Clock::now();
+
+        // Move a rotating window of nodes up and down
+        const float t = static_cast<float>(frame) * 0.05f;
+        for (int i = 0; i < moving_count; ++i) {
+            const int   index = (frame * moving_count + i) % options.node_count;
+            const auto& node  = nodes[static_cast<std::size_t>(index)];
+            glm::mat4 transform = node->parent_from_node();
+            transform[3].y = std::sin(t + static_cast<float>(index));
+            node->set_parent_from_node(transform);
+        }
+
+        replication_server.update();
+        server.poll(0);
+        client.poll(0);
+
+        const auto* statistics = replication_server.get_client_statistics(server_client_socket);
+        if (statistics == nullptr) {
+            fmt::print("client disconnected\n");
+            return 1;
+        }
+        total_bytes += statistics->last_frame_byte_count;
+        max_bytes    = std::max(max_bytes, statistics->last_frame_byte_count);
+        max_rtt_ms   = std::max(max_rtt_ms, statistics->round_trip_time_ms);
+        if (statistics->last_frame_byte_count > 0) {
+            ++active_frames;
+        }
+
+        const auto frame_end = frame_start + std::chrono::milliseconds{options.frame_time_ms};
+        while (Clock::now() < frame_end) {
+            server.poll(0);
+            client.poll(1);
+        }
+    }
+
+    // Send deferred updates and let the last frames arrive
+    for (int i = 0; i < 100; ++i) {
+        replication_server.update();
+        server.poll(1);
+        client.poll(1);
+    }
+
+    // Verify replicas, within quantization precision
+    const float tolerance = 2.0f * config.quantization.translation_precision;
+    std::size_t mismatch_count{0};
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto replica = replication_client.get_node(static_cast<uint32_t>(i + 1));
+        if (!replica) {
+            ++mismatch_count;
+            continue;
+        }
+        const glm::vec3 expected{nodes[i]->position_in_world()};
+        const glm::vec3 actual  {replica->position_in_world()};
+        if (glm::distance(expected, actual) > tolerance) {
+            ++mismatch_count;
+        }
+    }
+
+    const auto* statistics = replication_server.get_client_statistics(server_client_socket);
+    if (statistics == nullptr) {
+        fmt::print("client disconnected\n");
+        return 1;
+    }
+    const auto& replica_statistics = replication_client.get_statistics();
+    const std::size_t frame_count = static_cast<std::size_t>(std::max(options.frame_count, 1));
+    fmt::print("nodes:                {} ({} moving per frame)\n", options.node_count, moving_count);
+    fmt::print("frames:               {} ({} with changes, {} skipped by flow control)\n", options.frame_count, active_frames, statistics->skipped_frame_count);
+    fmt::print("bytes per frame:      {:.1f} average, {} max\n", static_cast<double>(total_bytes) / static_cast<double>(frame_count), max_bytes);
+    fmt::print("bytes per update:     {:.2f}\n", static_cast<double>(total_bytes) / static_cast<double>(std::max(statistics->update_count + statistics->create_count, std::size_t{1})));
+    fmt::print("creates / updates:    {} / {}\n", statistics->create_count, statistics->update_count);
+    fmt::print("client received:      {} frames, {} bytes, {} errors\n", replica_statistics.frame_count, replica_statistics.total_byte_count, replica_statistics.error_count);
+    fmt::print("round trip time:      {:.3f} ms average, {:.3f} ms max\n", statistics->average_round_trip_time_ms, max_rtt_ms);
+    fmt::print("replica mismatches:   {}\n", mismatch_count);
+
+    return (mismatch_count == 0) && (replica_statistics.error_count == 0) ? 0 : 1;
+}
@@ -6,7 +6,7 @@ out flat uint v_material_index;
 
 void main()
 {
-    mat4 world_from_node = primitive.primitives[gl_DrawID].world_from_node;
+    mat4 world_from_node = primitive.primitives[gl_BaseInstance].world_from_node;
     mat4 clip_from_world = camera.cameras[0].clip_from_world;
 
     vec3 normal      = normalize(vec3(world_from_node * vec4(a_normal,        0.0)));
@@ -19,7 +19,7 @@ void main()
 
     v_position       = position;
     gl_Position      = clip_from_world * position;
-    v_material_index = primitive.primitives[gl_DrawID].material_index;
+    v_material_index = primitive.primitives[gl_BaseInstance].material_index;
     v_texcoord       = a_texcoord;
     v_color          = a_color;
 }
@@ -71,6 +71,11 @@ float get_spot_attenuation(vec3 point_to_light, vec3 spot_direction, float outer
     return 0.0;
 }
 
+uint get_cluster_light_index(uint i)
+{
+    return light_cluster.light_indices[i >> 2u][i & 3u];
+}
+
 float clamped_dot(vec3 x, vec3 y)
 {
     return clamp(dot(x, y), 0.001, 1.0);
@@ -132,10 +137,38 @@ void main()
 
     Material material = material.materials[v_material_index];
 
+    // Lights are sorted: directional lights, point lights, spot lights
     uint  directional_light_count  = light_block.directional_light_count;
+    uint  point_light_count        = light_block.point_light_count;
     uint  spot_light_count         = light_block.spot_light_count;
     uint  directional_light_offset = 0;
-    uint  spot_light_offset        = directional_light_count;
+    uint  point_light_offset       = directional_light_count;
+    uint  spot_light_offset        = directional_light_count + point_light_count;
+
+    // With clusters, point and spot lights come from light index list of
+    // the cluster containing the fragment; point lights are listed first.
+    bool  use_clusters             = (light_cluster.grid_size.w != 0u);
+    if (use_clusters) {
+        uvec4 grid_size   = light_cluster.grid_size;
+        vec4  viewport    = light_cluster.viewport;
+        vec4  depth_slice = light_cluster.depth_slice;
+        float view_depth  = -(light_cluster.view_from_world * vec4(v_position.xyz, 1.0)).z;
+        ivec2 tile        = clamp(
+            ivec2((gl_FragCoord.xy - viewport.xy) * vec2(grid_size.xy) / viewport.zw),
+            ivec2(0),
+            ivec2(grid_size.xy) - ivec2(1)
+        );
+        int   slice       = clamp(
+            int(floor(log(max(view_depth, depth_slice.z)) * depth_slice.x + depth_slice.y)),
+            0,
+            int(grid_size.z) - 1
+        );
+        uvec4 cluster     = light_cluster.clusters[uint(tile.x) + grid_size.x * (uint(tile.y) + grid_size.y * uint(slice))];
+        point_light_offset = cluster.x;
+        point_light_count  = cluster.y;
+        spot_light_offset  = cluster.x + cluster.y;
+        spot_light_count   = cluster.z;
+    }
 
     vec3 color = vec3(0);
     color += (0.5 + 0.5 * N.y) * light_block.ambient_light.rgb * material.base_color.rgb;
@@ -160,8 +193,28 @@ void main()
         }
     }
 
+    for (uint i = 0; i < point_light_count; ++i) {
+        uint  light_index    = use_clusters ? get_cluster_light_index(point_light_offset + i) : point_light_offset + i;
+        Light light          = light_block.lights[light_index];
+        vec3  point_to_light = light.position_and_inner_spot_cos.xyz - v_position.xyz;
+        vec3  L              = normalize(point_to_light);
+        float N_dot_L        = clamped_dot(N, L);
+        if (N_dot_L > 0.0 || N_dot_V > 0.0) {
+            float range_attenuation = get_range_attenuation(light.radiance_and_range.w, length(point_to_light));
+            vec3  intensity         = range_attenuation * light.radiance_and_range.rgb;
+            color += intensity * brdf(
+                material.base_color.rgb,
+                material.roughness.x,
+                material.metallic,
+                L,
+                V,
+                N
+            );
+        }
+    }
+
     for (uint i = 0; i < spot_light_count; ++i) {
-        uint  light_index    = spot_light_offset + i;
+        uint  light_index    = use_clusters ? get_cluster_light_index(spot_light_offset + i) : spot_light_offset + i;
         Light light          = light_block.lights[light_index];
         vec3  point_to_light = light.position_and_inner_spot_cos.xyz - v_position.xyz;
         vec3  L              = normalize(point_to_light);
@@ -3,7 +3,7 @@ out float vs_line_width;
 
 void main()
 {
-    mat4 world_from_node = primitive.primitives[gl_DrawID].world_from_node;
+    mat4 world_from_node = primitive.primitives[gl_BaseInstance].world_from_node;
     mat4 clip_from_world = camera.cameras[0].clip_from_world;
     vec4 position        = world_from_node * vec4(a_position, 1.0);
     vec3 normal          = normalize(vec3(world_from_node * vec4(a_normal_smooth, 0.0)));
@@ -25,12 +25,12 @@ void main()
     float NdotV           = dot(normal, v);
     float d               = distance(view_position_in_world, position.xyz);
     float bias            = 0.0005 * NdotV * NdotV * camera.cameras[0].clip_depth_direction;
-    float max_size        = min(4.0 * primitive.primitives[gl_DrawID].size, 20.0);
+    float max_size        = min(4.0 * primitive.primitives[gl_BaseInstance].size, 20.0);
 
     gl_Position   = clip_from_world * position;
     gl_Position.z -= bias;
-    vs_color      = primitive.primitives[gl_DrawID].color;
+    vs_color      = primitive.primitives[gl_BaseInstance].color;
     //vs_color      = vec4(0.5 * normal + vec3(0.5), 1.0);
     //vs_color      = vec4(0.0, 0.0, 0.0, 1.0);
-    vs_line_width = (1.0 / 1024.0) * viewport_width * max(max_size / d, 1.0) / fov_width; //primitive.primitives[gl_DrawID].size;
+    vs_line_width = (1.0 / 1024.0) * viewport_width * max(max_size / d, 1.0) / fov_width; //primitive.primitives[gl_BaseInstance].size;
 }
@@ -69,17 +69,15 @@ void Node_physics::handle_node_scene_host_update(
     if (old_scene_host != nullptr) {
         Scene_root* old_scene_root = reinterpret_cast<Scene_root*>(old_scene_host);
         ERHE_VERIFY(old_scene_root != nullptr);
-        auto& physics_world = old_scene_root->physics_world();
-        physics_world.remove_rigid_body(rigid_body());
+        old_scene_root->remove_rigid_body(rigid_body());
         m_physics_world = nullptr;
     }
     if (new_scene_host != nullptr) {
         log_physics->trace("attaching {} to physics world", m_rigid_body->get_debug_label());
         Scene_root* new_scene_root = reinterpret_cast<Scene_root*>(new_scene_host);
         ERHE_VERIFY(new_scene_root != nullptr);
-        auto& physics_world = new_scene_root->physics_world();
-        physics_world.add_rigid_body(rigid_body());
-        m_physics_world = &physics_world;
+        new_scene_root->add_rigid_body(rigid_body()); // may be batched, see Scene_builder::setup_scene()
+        m_physics_world = &new_scene_root->physics_world();
     }
 }
 
@@ -92,6 +90,11 @@ void Node_physics::handle_node_transform_update()
         return;
     }
 
+    // Node_transform_store write back of a transform set from physics
+    if ((get_node() != nullptr) && (get_node()->node_data.transforms.update_serial == m_physics_update_serial)) {
+        return;
+    }
+
     const erhe::physics::Transform world_from_node = get_world_from_node();
 
     log_physics->trace(
@@ -108,6 +111,27 @@ void Node_physics::set_rigidbody_from_node(const erhe::physics::Transform rigidb
 {
     m_rigidbody_from_node = rigidbody_from_node;
     m_node_from_rigidbody = inverse(rigidbody_from_node);
+
+    const auto& m = m_rigidbody_from_node.basis;
+    m_rigidbody_from_node_matrix = glm::mat4{m};
+    m_rigidbody_from_node_matrix[3] = glm::vec4{
+        m_rigidbody_from_node.origin.x,
+        m_rigidbody_from_node.origin.y,
+        m_rigidbody_from_node.origin.z,
+        1.0f
+    };
+}
+
+void Node_physics::apply_active_body_transforms(
+    const std::vector<erhe::physics::Active_body_transform>& transforms
+)
+{
+    ERHE_PROFILE_FUNCTION
+
+    for (const auto& entry : transforms) {
+        auto* const node_physics = static_cast<Node_physics*>(entry.motion_state);
+        node_physics->set_world_from_node(entry.world_from_rigidbody * node_physics->m_rigidbody_from_node_matrix);
+    }
 }
 
 // This gets called by Motion_state_adapter
@@ -148,16 +172,7 @@ void Node_physics::set_world_from_rigidbody(
     const glm::mat4& world_from_rigidbody
 )
 {
-    const auto& m = m_rigidbody_from_node.basis;
-    glm::mat4 rigidbody_from_node{m};
-    rigidbody_from_node[3] = glm::vec4{
-        m_rigidbody_from_node.origin.x,
-        m_rigidbody_from_node.origin.y,
-        m_rigidbody_from_node.origin.z,
-        1.0f
-    };
-
-    set_world_from_node(world_from_rigidbody * rigidbody_from_node);
+    set_world_from_node(world_from_rigidbody * m_rigidbody_from_node_matrix);
 }
 
 void Node_physics::set_world_from_rigidbody(
@@ -191,10 +206,13 @@ void Node_physics::set_world_from_node(
 
     m_transform_change_from_physics = true;
 
-    const glm::mat4& matrix{world_from_node};
     // TODO don't unparent, call set_world_from_node() instead?
-    get_node()->set_parent(get_node()->get_scene()->get_root_node());
-    get_node()->set_parent_from_node(matrix);
+    erhe::scene::Node* const node = get_node();
+    if (node->get_depth() != 1) {
+        node->set_parent(node->get_scene()->get_root_node());
+    }
+    node->set_parent_from_node(world_from_node);
+    m_physics_update_serial = node->node_data.transforms.update_serial;
 
     m_transform_change_from_physics = false;
 }
@@ -229,8 +247,12 @@ void Node_physics::set_world_from_node(
         1.0f
     };
     // TODO don't unparent, call set_world_from_node() instead?
-    get_node()->set_parent(get_node()->get_scene()->get_root_node());
-    get_node()->set_parent_from_node(matrix);
+    erhe::scene::Node* const node = get_node();
+    if (node->get_depth() != 1) {
+        node->set_parent(node->get_scene()->get_root_node());
+    }
+    node->set_parent_from_node(matrix);
+    m_physics_update_serial = node->node_data.transforms.update_serial;
 
     m_transform_change_from_physics = false;
 }
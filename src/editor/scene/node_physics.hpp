@@ -3,13 +3,10 @@
 #include "erhe/scene/node.hpp"
 #include "erhe/physics/irigid_body.hpp"
 #include "erhe/physics/imotion_state.hpp"
+#include "erhe/physics/iworld.hpp"
 
 #include <functional>
-
-namespace erhe::physics
-{
-    class IWorld;
-}
+#include <vector>
 
 namespace erhe::scene
 {
@@ -58,10 +55,18 @@ public:
     void set_world_from_node    (const erhe::physics::Transform world_from_node);
     void set_rigidbody_from_node(const erhe::physics::Transform rigidbody_from_node);
 
+    // Applies transforms from erhe::physics::IWorld::take_active_body_transforms()
+    // to nodes in one pass. All motion states must be Node_physics.
+    static void apply_active_body_transforms(
+        const std::vector<erhe::physics::Active_body_transform>& transforms
+    );
+
 private:
     erhe::physics::IWorld*                           m_physics_world      {nullptr};
     erhe::physics::Transform                         m_rigidbody_from_node{};
     erhe::physics::Transform                         m_node_from_rigidbody{};
+    glm::mat4                                        m_rigidbody_from_node_matrix{1.0f};
+    uint64_t                                         m_physics_update_serial{0}; // node update serial set from physics
     erhe::physics::Motion_mode                       m_motion_mode;
     std::shared_ptr<erhe::physics::IRigid_body>      m_rigid_body;
     std::shared_ptr<erhe::physics::ICollision_shape> m_collision_shape;
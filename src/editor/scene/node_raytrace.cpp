@@ -442,7 +442,19 @@ void draw_ray_hit(
     const glm::vec3 local_normal    = local_normal_opt.value();
     const glm::mat4 world_from_node = raytrace_node->get_node()->world_from_node();
     const glm::vec3 N{world_from_node * glm::vec4{local_normal, 0.0f}};
-    const glm::vec3 T = erhe::toolkit::safe_normalize_cross<float>(N, ray.direction);
+
+    draw_ray_hit(line_renderer, position, N, ray.direction, style);
+}
+
+void draw_ray_hit(
+    erhe::application::Line_renderer& line_renderer,
+    const glm::vec3                   position,
+    const glm::vec3                   N,
+    const glm::vec3                   direction,
+    const Ray_hit_style&              style
+)
+{
+    const glm::vec3 T = erhe::toolkit::safe_normalize_cross<float>(N, direction);
     const glm::vec3 B = erhe::toolkit::safe_normalize_cross<float>(T, N);
 
     line_renderer.set_thickness(style.hit_thickness);
@@ -469,7 +481,7 @@ void draw_ray_hit(
         {
             {
                 position,
-                position - style.ray_length * ray.direction
+                position - style.ray_length * direction
             }
         }
     );
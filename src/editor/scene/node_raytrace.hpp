@@ -121,6 +121,15 @@ void draw_ray_hit(
     const Ray_hit_style&              style = {}
 );
 
+// Draws hit position and normal N, and ray_length of the ray before the hit
+void draw_ray_hit(
+    erhe::application::Line_renderer& line_renderer,
+    glm::vec3                         position,
+    glm::vec3                         N,
+    glm::vec3                         direction,
+    const Ray_hit_style&              style = {}
+);
+
 [[nodiscard]] auto project_ray(
     erhe::raytrace::IScene* raytrace_scene,
     erhe::scene::Mesh*      ignore_mesh,
@@ -5,7 +5,6 @@
 #include "editor_scenes.hpp"
 #include "rendertarget_mesh.hpp"
 #include "rendertarget_imgui_viewport.hpp"
-#include "task_queue.hpp"
 
 #include "tools/brushes/brush.hpp"
 #include "tools/brushes/brush_tool.hpp"
@@ -40,6 +39,7 @@
 #include "erhe/application/rendergraph/rendergraph.hpp"
 #include "erhe/application/rendergraph/rendergraph_node.hpp"
 #include "erhe/application/graphics/gl_context_provider.hpp"
+#include "erhe/concurrency/task_graph.hpp"
 #include "erhe/geometry/shapes/box.hpp"
 #include "erhe/geometry/shapes/cone.hpp"
 #include "erhe/geometry/shapes/disc.hpp"
@@ -49,6 +49,7 @@
 #include "erhe/graphics/buffer.hpp"
 #include "erhe/graphics/buffer_transfer_queue.hpp"
 #include "erhe/graphics/renderbuffer.hpp"
+#include "erhe/primitive/buffer_sink.hpp"
 #include "erhe/primitive/primitive.hpp"
 #include "erhe/primitive/primitive_builder.hpp"
 #include "erhe/primitive/material.hpp"
@@ -410,19 +411,15 @@ void Scene_builder::make_brushes()
 {
     ERHE_PROFILE_FUNCTION
 
-    std::unique_ptr<ITask_queue> execution_queue;
-
     const auto& configuration = *erhe::application::g_configuration;
 
-    if (configuration.threading.parallel_initialization) {
-        const std::size_t thread_count = std::min(
-            8U,
-            std::max(std::thread::hardware_concurrency() - 0, 1U)
-        );
-        execution_queue = std::make_unique<Parallel_task_queue>("scene builder", thread_count);
-    } else {
-        execution_queue = std::make_unique<Serial_task_queue>();
-    }
+    // Without thread pool, tasks are executed in Task_graph::wait()
+    erhe::concurrency::Thread_pool* const thread_pool = configuration.threading.parallel_initialization
+        ? g_editor_scenes->get_thread_pool()
+        : nullptr;
+
+    Json_library                  library;
+    erhe::concurrency::Task_graph task_graph{thread_pool, "scene builder"};
 
     // Floor
     if (config.floor) {
@@ -433,8 +430,8 @@ void Scene_builder::make_brushes()
         // Otherwise it will be destructed when leave add_floor() scope
         m_collision_shapes.push_back(floor_box_shape);
 
-        execution_queue->enqueue(
-            [this, &floor_box_shape, &configuration]()
+        task_graph.add(
+            [this, floor_box_shape]()
             {
                 ERHE_PROFILE_SCOPE("Floor brush");
 
@@ -486,7 +483,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.obj_files) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("parse .obj files");
@@ -528,7 +525,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.platonic_solids) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("Platonic solids");
@@ -558,7 +555,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.sphere) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("Sphere");
@@ -587,7 +584,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.torus) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("Torus");
@@ -671,7 +668,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.cylinder) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("Cylinder");
@@ -709,7 +706,7 @@ void Scene_builder::make_brushes()
     }
 
     if (config.cone) {
-        execution_queue->enqueue(
+        task_graph.add(
             [this, &configuration]()
             {
                 ERHE_PROFILE_SCOPE("Cone");
@@ -808,44 +805,52 @@ void Scene_builder::make_brushes()
         make_mesh_node("Z ring", Transform::create_rotation(-glm::pi<float>() / 2.0f, glm::vec3{0.0f, 1.0f, 0.0f}));
     }
 
-    Json_library library;//("res/polyhedra/johnson.json");
     if (config.johnson_solids) {
-        // TODO When tasks can have dependencies we could queue this as well
-        ERHE_PROFILE_SCOPE("Johnson solids");
-
-        library = Json_library("res/polyhedra/johnson.json");
-        for (const auto& key_name : library.names) {
-            execution_queue->enqueue(
-                [this, &library, &key_name, &configuration]()
+        // Brush tasks are added once the library has been parsed
+        task_graph.add(
+            [this, &library, &task_graph]()
+            {
                 {
-                    auto geometry = library.make_geometry(key_name);
-                    if (geometry.get_polygon_count() == 0) {
-                        return;
-                    }
-                    geometry.compute_polygon_normals();
-
-                    const auto shared_geometry = std::make_shared<erhe::geometry::Geometry>(
-                        std::move(geometry)
-                    );
-
-                    make_brush(
-                        Brush_data{
-                            .name               = shared_geometry->name,
-                            .build_info         = build_info(),
-                            .normal_style       = Normal_style::polygon_normals,
-                            .geometry_generator = [shared_geometry](){ return shared_geometry; },
-                            .density            = config.mass_scale
-                        },
-                        false
-                    );
+                    ERHE_PROFILE_SCOPE("Johnson solids");
+                    library = Json_library("res/polyhedra/johnson.json");
                 }
-            );
-        }
+                task_graph.parallel_for(
+                    library.names.size(),
+                    1,
+                    [this, &library](const std::size_t begin, const std::size_t end)
+                    {
+                        for (std::size_t i = begin; i < end; ++i) {
+                            auto geometry = library.make_geometry(library.names[i]);
+                            if (geometry.get_polygon_count() == 0) {
+                                continue;
+                            }
+                            geometry.compute_polygon_normals();
+
+                            const auto shared_geometry = std::make_shared<erhe::geometry::Geometry>(
+                                std::move(geometry)
+                            );
+
+                            make_brush(
+                                Brush_data{
+                                    .name               = shared_geometry->name,
+                                    .build_info         = build_info(),
+                                    .normal_style       = Normal_style::polygon_normals,
+                                    .geometry_generator = [shared_geometry](){ return shared_geometry; },
+                                    .density            = config.mass_scale
+                                },
+                                false
+                            );
+                        }
+                    }
+                );
+            }
+        );
     }
 
-    execution_queue->wait();
+    task_graph.wait();
 
     buffer_transfer_queue().flush();
+    g_mesh_memory->gl_buffer_sink->compact_if_requested();
 }
 
 auto Scene_builder::buffer_transfer_queue() -> erhe::graphics::Buffer_transfer_queue&
@@ -1277,8 +1282,12 @@ void Scene_builder::setup_scene()
     setup_cameras();
     setup_lights();
     make_brushes();
+
+    // Static bodies are inserted to physics world as one batch
+    m_scene_root->begin_static_rigid_body_batch();
     make_mesh_nodes();
     add_room();
+    m_scene_root->end_static_rigid_body_batch();
 }
 
 [[nodiscard]] auto Scene_builder::get_scene_root() const -> std::shared_ptr<Scene_root>
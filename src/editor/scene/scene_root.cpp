@@ -15,6 +15,7 @@
 #include "erhe/graphics/buffer.hpp"
 #include "erhe/graphics/framebuffer.hpp"
 #include "erhe/primitive/material.hpp"
+#include "erhe/physics/irigid_body.hpp"
 #include "erhe/physics/iworld.hpp"
 #include "erhe/raytrace/iscene.hpp"
 #include "erhe/scene/camera.hpp"
@@ -110,6 +111,7 @@ Scene_root::Scene_root(
 
     m_scene->enable_flag_bits(erhe::scene::Item_flags::show_in_ui);
     m_physics_world  = erhe::physics::IWorld::create_unique();
+    m_physics_world->set_bulk_motion_state_updates(true); // see update_physics_transforms()
     m_raytrace_scene = erhe::raytrace::IScene::create_unique("root");
 }
 
@@ -225,6 +227,52 @@ auto Scene_root::physics_world() -> erhe::physics::IWorld&
     return *m_physics_world.get();
 }
 
+void Scene_root::update_physics_transforms()
+{
+    ERHE_PROFILE_FUNCTION
+
+    m_physics_world->take_active_body_transforms(m_active_body_transforms);
+    Node_physics::apply_active_body_transforms(m_active_body_transforms);
+}
+
+void Scene_root::begin_static_rigid_body_batch()
+{
+    ERHE_VERIFY(!m_batch_static_rigid_bodies);
+    m_batch_static_rigid_bodies = true;
+}
+
+void Scene_root::end_static_rigid_body_batch()
+{
+    ERHE_PROFILE_FUNCTION
+
+    ERHE_VERIFY(m_batch_static_rigid_bodies);
+    m_batch_static_rigid_bodies = false;
+    m_physics_world->add_rigid_bodies(m_static_rigid_body_batch);
+    m_static_rigid_body_batch.clear();
+}
+
+void Scene_root::add_rigid_body(erhe::physics::IRigid_body* rigid_body)
+{
+    if (
+        m_batch_static_rigid_bodies &&
+        (rigid_body->get_motion_mode() == erhe::physics::Motion_mode::e_static)
+    ) {
+        m_static_rigid_body_batch.push_back(rigid_body);
+        return;
+    }
+    m_physics_world->add_rigid_body(rigid_body);
+}
+
+void Scene_root::remove_rigid_body(erhe::physics::IRigid_body* rigid_body)
+{
+    const auto i = std::find(m_static_rigid_body_batch.begin(), m_static_rigid_body_batch.end(), rigid_body);
+    if (i != m_static_rigid_body_batch.end()) {
+        m_static_rigid_body_batch.erase(i);
+        return;
+    }
+    m_physics_world->remove_rigid_body(rigid_body);
+}
+
 auto Scene_root::raytrace_scene() -> erhe::raytrace::IScene&
 {
     ERHE_VERIFY(m_raytrace_scene);
@@ -8,6 +8,7 @@
 #include "erhe/components/components.hpp"
 #include "erhe/gl/wrapper_enums.hpp"
 #include "erhe/message_bus/message_bus.hpp"
+#include "erhe/physics/iworld.hpp"
 #include "erhe/primitive/material.hpp"
 #include "erhe/primitive/enums.hpp"
 #include "erhe/primitive/format_info.hpp"
@@ -35,11 +36,6 @@ namespace erhe::graphics
     class Vertex_format;
 }
 
-namespace erhe::physics
-{
-    class IWorld;
-}
-
 namespace erhe::raytrace
 {
     class IScene;
@@ -168,19 +164,33 @@ public:
 
     void update_pointer_for_rendertarget_meshes(Scene_view* scene_view);
 
+    // Applies transforms of active physics bodies to scene nodes
+    void update_physics_transforms();
+
+    // Static rigid bodies added between begin_static_rigid_body_batch() and
+    // end_static_rigid_body_batch() are inserted to the physics world with
+    // a single IWorld::add_rigid_bodies() call. Used when scene is built.
+    void begin_static_rigid_body_batch();
+    void end_static_rigid_body_batch  ();
+    void add_rigid_body               (erhe::physics::IRigid_body* rigid_body);
+    void remove_rigid_body            (erhe::physics::IRigid_body* rigid_body);
+
     void sanity_check();
 
 private:
-    mutable std::mutex                              m_mutex;
-    std::mutex                                      m_rendertarget_meshes_mutex;
-    std::vector<std::shared_ptr<Rendertarget_mesh>> m_rendertarget_meshes;
-    std::unique_ptr<erhe::physics::IWorld>          m_physics_world;
-    std::unique_ptr<erhe::raytrace::IScene>         m_raytrace_scene;
-    std::shared_ptr<erhe::scene::Camera>            m_camera;
-    std::shared_ptr<Content_library>                m_content_library;
-    std::shared_ptr<Frame_controller>               m_camera_controls;
-    std::shared_ptr<erhe::scene::Scene>             m_scene;
-    Scene_layers                                    m_layers;
+    mutable std::mutex                                m_mutex;
+    std::mutex                                        m_rendertarget_meshes_mutex;
+    std::vector<std::shared_ptr<Rendertarget_mesh>>   m_rendertarget_meshes;
+    std::unique_ptr<erhe::physics::IWorld>            m_physics_world;
+    std::vector<erhe::physics::Active_body_transform> m_active_body_transforms;
+    bool                                              m_batch_static_rigid_bodies{false};
+    std::vector<erhe::physics::IRigid_body*>          m_static_rigid_body_batch;
+    std::unique_ptr<erhe::raytrace::IScene>           m_raytrace_scene;
+    std::shared_ptr<erhe::scene::Camera>              m_camera;
+    std::shared_ptr<Content_library>                  m_content_library;
+    std::shared_ptr<Frame_controller>                 m_camera_controls;
+    std::shared_ptr<erhe::scene::Scene>               m_scene;
+    Scene_layers                                      m_layers;
 };
 
 } // namespace editor
@@ -253,36 +253,52 @@ void Scene_view::update_hover_with_raytrace()
     const glm::vec3 ray_origin    = get_control_ray_origin_in_world   ().value();
     const glm::vec3 ray_direction = get_control_ray_direction_in_world().value();
 
-    Scene_root* tool_scene_root = g_tools->get_tool_scene_root().get();
+    // Rays of all slots except tool slot are traced in scene as one batch.
+    // Tool slot ray is last, and it is traced in tool scene.
+    std::array<std::size_t,         Hover_entry::slot_count> ray_slots;
+    std::array<erhe::raytrace::Ray, Hover_entry::slot_count> rays;
+    std::array<erhe::raytrace::Hit, Hover_entry::slot_count> hits;
+    std::size_t scene_ray_count{0};
     for (std::size_t slot = 0; slot < Hover_entry::slot_count; ++slot)
     {
-        const uint32_t slot_mask = Hover_entry::raytrace_slot_masks[slot];
-        Hover_entry entry {
-            .slot = slot,
-            .mask = slot_mask
-        };
-        erhe::raytrace::Ray ray{
+        if (slot != Hover_entry::tool_slot)
+        {
+            ray_slots[scene_ray_count++] = slot;
+        }
+    }
+    ray_slots[scene_ray_count] = Hover_entry::tool_slot;
+    for (std::size_t i = 0; i < Hover_entry::slot_count; ++i)
+    {
+        rays[i] = erhe::raytrace::Ray{
             .origin    = ray_origin,
             .t_near    = 0.0f,
             .direction = ray_direction,
             .time      = 0.0f,
             .t_far     = 9999.0f,
-            .mask      = slot_mask,
+            .mask      = Hover_entry::raytrace_slot_masks[ray_slots[i]],
             .id        = 0,
             .flags     = 0
         };
-        erhe::raytrace::Hit hit;
-        if (slot == Hover_entry::tool_slot)
-        {
-            if (tool_scene_root != nullptr)
-            {
-                tool_scene_root->raytrace_scene().intersect(ray, hit);
-            }
-        }
-        else
-        {
-            scene.intersect(ray, hit);
-        }
+    }
+    scene.intersect(
+        gsl::span<erhe::raytrace::Ray>{rays.data(), scene_ray_count},
+        gsl::span<erhe::raytrace::Hit>{hits.data(), scene_ray_count}
+    );
+    Scene_root* tool_scene_root = g_tools->get_tool_scene_root().get();
+    if (tool_scene_root != nullptr)
+    {
+        tool_scene_root->raytrace_scene().intersect(rays[scene_ray_count], hits[scene_ray_count]);
+    }
+
+    for (std::size_t i = 0; i < Hover_entry::slot_count; ++i)
+    {
+        const std::size_t          slot = ray_slots[i];
+        const erhe::raytrace::Ray& ray  = rays[i];
+        const erhe::raytrace::Hit& hit  = hits[i];
+        Hover_entry entry {
+            .slot = slot,
+            .mask = Hover_entry::raytrace_slot_masks[slot]
+        };
         entry.valid = (hit.instance != nullptr);
         if (entry.valid)
         {
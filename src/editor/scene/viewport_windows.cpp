@@ -125,7 +125,8 @@ void Viewport_windows::initialize_component()
         [&](Editor_message& message)
         {
             on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_graphics_settings
     );
 
     m_open_new_viewport_window_command.set_host(this);
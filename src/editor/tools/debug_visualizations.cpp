@@ -76,7 +76,8 @@ void Debug_visualizations::initialize_component()
         [&](Editor_message& message)
         {
             Tool::on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     g_debug_visualizations = this;
@@ -291,7 +291,8 @@ void Fly_camera_tool::initialize_component()
         [&](Editor_message& message)
         {
             Tool::on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     m_turn_command                  .set_host(this);
@@ -73,7 +73,8 @@ void Hover_tool::initialize_component()
         [&](Editor_message& message)
         {
             Tool::on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     g_hover_tool = this;
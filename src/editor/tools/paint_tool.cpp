@@ -222,7 +222,8 @@ void Paint_tool::initialize_component()
         [&](Editor_message& message)
         {
             Tool::on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     m_paint_vertex_command.set_host(this);
@@ -299,7 +300,7 @@ void Paint_tool::paint_vertex(
 
     for (const auto& primitive : mesh->mesh_data.primitives) {
         if (primitive.source_geometry.get() == &geometry) {
-            const std::size_t range_byte_offset = primitive.gl_primitive_geometry.vertex_buffer_range.byte_offset;
+            const std::size_t range_byte_offset = primitive.gl_primitive_geometry.vertex_buffer_range.get_byte_offset();
             g_mesh_memory->gl_buffer_transfer_queue->enqueue(
                 *g_mesh_memory->gl_vertex_buffer.get(),
                 range_byte_offset + vertex_offset,
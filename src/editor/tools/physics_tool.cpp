@@ -21,12 +21,11 @@
 #include "erhe/log/log_glm.hpp"
 #include "erhe/physics/iconstraint.hpp"
 #include "erhe/physics/icollision_shape.hpp"
+#include "erhe/physics/irigid_body.hpp"
 #include "erhe/physics/iworld.hpp"
-#include "erhe/raytrace/iinstance.hpp"
-#include "erhe/raytrace/iscene.hpp"
-#include "erhe/raytrace/ray.hpp"
 #include "erhe/scene/mesh.hpp"
 #include "erhe/toolkit/bit_helpers.hpp"
+#include "erhe/toolkit/math_util.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
@@ -201,7 +200,8 @@ void Physics_tool::initialize_component()
         [&](Editor_message& message)
         {
             on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     m_drag_command.set_host(this);
@@ -230,16 +230,6 @@ void Physics_tool::on_message(Editor_message& message)
     return reinterpret_cast<Scene_root*>(m_target_mesh->get_node()->node_data.host);
 }
 
-[[nodiscard]] auto Physics_tool::get_raytrace_scene() const -> erhe::raytrace::IScene*
-{
-    auto* scene_root = get_scene_root();
-    if (scene_root == nullptr) {
-        return nullptr;
-    }
-    auto& raytrace_scene = scene_root->raytrace_scene();
-    return &raytrace_scene;
-}
-
 [[nodiscard]] auto Physics_tool::get_physics_world() const -> erhe::physics::IWorld*
 {
     auto* scene_root = get_scene_root();
@@ -442,6 +432,7 @@ void Physics_tool::release_target()
     }
 
     m_target_mesh.reset();
+    m_drag_ray_hit_valid = false;
 
     m_target_distance         = 1.0;
     m_target_position_in_mesh = glm::vec3{0.0, 0.0, 0.0};
@@ -563,34 +554,49 @@ void Physics_tool::handle_priority_update(int old_priority, int new_priority)
     }
 }
 
+void Physics_tool::update_once_per_frame(const erhe::components::Time_context&)
+{
+    ERHE_PROFILE_FUNCTION
+
+    // Physics world ray cast from published node transform. Async physics
+    // update has completed at this point, so the query does not wait.
+    m_drag_ray_hit_valid = false;
+    if (!m_target_node_physics || !m_target_mesh) {
+        return;
+    }
+    auto* world = get_physics_world();
+    if (world == nullptr) {
+        return;
+    }
+    const erhe::scene::Node* node = m_target_mesh->get_node();
+    if (node == nullptr) {
+        return;
+    }
+
+    m_drag_ray = erhe::physics::Ray_cast{
+        .origin       = glm::vec3{node->position_in_world()},
+        .direction    = glm::vec3{0.0f, -1.0f, 0.0f},
+        .max_distance = 9999.0f
+    };
+    const erhe::physics::Query_filter filter{
+        .object_layer_mask = ~erhe::physics::Collision_layers::mask(erhe::physics::Layers::NON_COLLIDING),
+        .ignore_rigid_body = m_target_node_physics->rigid_body()
+    };
+    m_drag_ray_hit_valid = world->cast_ray(m_drag_ray, filter, m_drag_ray_hit);
+}
+
 void Physics_tool::tool_render(const Render_context& /*context*/)
 {
     ERHE_PROFILE_FUNCTION
 
     erhe::application::Line_renderer& line_renderer = *erhe::application::g_line_renderer_set->hidden.at(2).get();
 
-#if 0 // This is currently too slow, at least in debug build
-    if (m_target_mesh) {
-        auto* raytrace_scene = get_raytrace_scene();
-        if (raytrace_scene != nullptr) {
-            erhe::raytrace::Ray ray{
-                .origin    = m_target_mesh->get_node()->position_in_world(),
-                .t_near    = 0.0f,
-                .direction = glm::vec3{0.0f, -1.0f, 0.0f},
-                .time      = 0.0f,
-                .t_far     = 9999.0f,
-                .mask      = Raytrace_node_mask::content,
-                .id        = 0,
-                .flags     = 0
-            };
-
-            erhe::raytrace::Hit hit;
-            if (project_ray(raytrace_scene, m_target_mesh.get(), ray, hit)) {
-                draw_ray_hit(line_renderer, ray, hit, m_ray_hit_style);
-            }
-        }
+    // Show where the dragged body is above
+    if (m_drag_ray_hit_valid) {
+        Ray_hit_style style = m_ray_hit_style;
+        style.ray_length = m_drag_ray_hit.distance;
+        draw_ray_hit(line_renderer, m_drag_ray_hit.position, m_drag_ray_hit.normal, m_drag_ray.direction, style);
     }
-#endif
 
     if (m_target_constraint) {
         constexpr glm::vec4 white{1.0f, 1.0f, 1.0f, 1.0f};
@@ -629,7 +635,8 @@ void Physics_tool::tool_render(const Render_context& /*context*/)
     //}
 
     if (m_show_drag_body) {
-        const erhe::physics::Transform transform = m_constraint_world_point_rigid_body->get_world_transform();
+        // Drag body is kept at m_target_position_end, see move_drag_point_kinematic()
+        const erhe::physics::Transform transform = get_world_from_rigidbody();
         {
             const glm::vec4 half_red  {0.5f, 0.0f, 0.0f, 0.5f};
             const glm::vec4 half_green{0.0f, 0.5f, 0.0f, 0.5f};
@@ -7,17 +7,13 @@
 #include "erhe/application/imgui/imgui_window.hpp"
 #include "erhe/components/components.hpp"
 #include "erhe/physics/imotion_state.hpp"
+#include "erhe/physics/spatial_query.hpp"
 
 #include <glm/glm.hpp>
 
 #include <functional>
 #include <memory>
 
-namespace erhe::raytrace
-{
-    class IScene;
-}
-
 namespace erhe::scene
 {
     class Mesh;
@@ -56,6 +52,7 @@ public:
 
 class Physics_tool
     : public erhe::components::Component
+    , public erhe::components::IUpdate_once_per_frame
     , public erhe::physics::IMotion_state
     , public Tool
 {
@@ -74,6 +71,9 @@ public:
     void initialize_component       () override;
     void deinitialize_component     () override;
 
+    // Implements IUpdate_once_per_frame
+    void update_once_per_frame(const erhe::components::Time_context& time_context) override;
+
     // Implements Tool
     void handle_priority_update(int old_priority, int new_priority) override;
     void tool_render    (const Render_context& context) override;
@@ -103,9 +103,8 @@ private:
     void move_drag_point_instant  (glm::vec3 position);
     void move_drag_point_kinematic(glm::vec3 position);
 
-    [[nodiscard]] auto get_scene_root    () const -> Scene_root*;
-    [[nodiscard]] auto get_raytrace_scene() const -> erhe::raytrace::IScene*;
-    [[nodiscard]] auto get_physics_world () const -> erhe::physics::IWorld*;
+    [[nodiscard]] auto get_scene_root   () const -> Scene_root*;
+    [[nodiscard]] auto get_physics_world() const -> erhe::physics::IWorld*;
 
     // Commands
     Physics_tool_drag_command                    m_drag_command;
@@ -151,6 +150,12 @@ private:
 
     bool       m_show_drag_body{false};
 
+    // Ray cast below dragged body, done in update_once_per_frame() and
+    // drawn in tool_render(), so that rendering does not access physics.
+    bool                     m_drag_ray_hit_valid{false};
+    erhe::physics::Ray_cast  m_drag_ray;
+    erhe::physics::Ray_hit   m_drag_ray_hit;
+
     Ray_hit_style m_ray_hit_style
     {
         .ray_color     = glm::vec4{1.0f, 0.0f, 1.0f, 1.0f},
@@ -310,7 +310,8 @@ void Selection_tool::initialize_component()
         [&](Editor_message& message)
         {
             Tool::on_message(message);
-        }
+        },
+        Message_flag_bit::c_flag_bit_hover_scene_view
     );
 
     m_select_command.set_host(this);
@@ -680,7 +681,8 @@ void Selection_tool::sanity_check()
 
 void Selection_tool::send_selection_change_message() const
 {
-    g_editor_message_bus->send_message(
+    // Queued; selection changes within a frame are coalesced to one message
+    g_editor_message_bus->queue_message(
         Editor_message{
             .update_flags = Message_flag_bit::c_flag_bit_selection
         }
@@ -60,6 +60,7 @@ void Physics_window::initialize_component()
     auto ini = erhe::application::get_ini("erhe.ini", "physics");
     ini->get("static_enable",  config.static_enable);
     ini->get("dynamic_enable", config.dynamic_enable);
+    ini->get("async_update",   config.async_update);
 
     erhe::application::g_imgui_windows->register_imgui_window(this, "physics");
     m_min_size[0] = 120.0f;
@@ -138,6 +139,16 @@ void Physics_window::imgui()
             physics_world.disable_physics_updates();
         }
     }
+    const bool async_updates         = physics_world.is_async_updates_enabled();
+    bool       updated_async_updates = async_updates;
+    ImGui::Checkbox("Async updates", &updated_async_updates);
+    if (updated_async_updates != async_updates) {
+        if (updated_async_updates) {
+            physics_world.enable_async_updates();
+        } else {
+            physics_world.disable_async_updates();
+        }
+    }
 
     if (g_debug_draw != nullptr) {
         if (ImGui::CollapsingHeader("Visualizations")) {
@@ -22,6 +22,7 @@ public:
     public:
         bool static_enable {false};
         bool dynamic_enable{false};
+        bool async_update  {false}; // physics steps run overlapped with rendering
     };
     Config config;
 
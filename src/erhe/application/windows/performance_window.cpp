@@ -5,6 +5,8 @@
 #include "erhe/application/configuration.hpp"
 #include "erhe/application/application_log.hpp"
 #include "erhe/graphics/gpu_timer.hpp"
+#include "erhe/graphics/range_allocator.hpp"
+#include "erhe/scene/frustum_culler.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/timer.hpp"
 
@@ -116,6 +118,9 @@ public:
     void imgui() override;
 
 private:
+    void range_allocator_imgui();
+    void frustum_culler_imgui ();
+
     Frame_time_plot             m_frame_time_plot;
     std::vector<Gpu_timer_plot> m_gpu_timer_plots;
     std::vector<Cpu_timer_plot> m_cpu_timer_plots;
@@ -619,6 +624,87 @@ void Performance_window_impl::imgui()
     for (auto& plot : m_gpu_timer_plots) {
         plot.imgui();
     }
+
+    range_allocator_imgui();
+    frustum_culler_imgui();
+#endif
+}
+
+void Performance_window_impl::range_allocator_imgui()
+{
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+    ERHE_PROFILE_FUNCTION
+
+    if (!ImGui::CollapsingHeader("Buffer Allocators")) {
+        return;
+    }
+
+    const auto all_range_allocators = erhe::graphics::Range_allocator::all_range_allocators();
+    for (const auto* allocator : all_range_allocators) {
+        const auto stats = allocator->get_stats();
+        const float used_ratio = (stats.capacity_byte_count > 0)
+            ? static_cast<float>(stats.used_byte_count) / static_cast<float>(stats.capacity_byte_count)
+            : 0.0f;
+        const float fragmentation = (stats.free_byte_count > 0)
+            ? 1.0f - static_cast<float>(stats.largest_free_byte_count) / static_cast<float>(stats.free_byte_count)
+            : 0.0f;
+        const auto overlay = fmt::format(
+            "{:.1f} / {:.1f} MB",
+            static_cast<float>(stats.used_byte_count)     / (1024.0f * 1024.0f),
+            static_cast<float>(stats.capacity_byte_count) / (1024.0f * 1024.0f)
+        );
+        ImGui::TextUnformatted(allocator->get_name().c_str());
+        ImGui::ProgressBar(used_ratio, ImVec2{-1.0f, 0.0f}, overlay.c_str());
+        ImGui::Text(
+            "Allocations: %zu (%zu pinned), free blocks: %zu, largest free: %zu bytes, fragmentation: %.1f %%",
+            stats.allocation_count,
+            stats.pinned_allocation_count,
+            stats.free_block_count,
+            stats.largest_free_byte_count,
+            100.0f * fragmentation
+        );
+        ImGui::Text(
+            "Allocated: %zu, freed: %zu, failed: %zu, compactions: %zu (%zu bytes moved)",
+            stats.total_allocate_count,
+            stats.total_free_count,
+            stats.failed_allocate_count,
+            stats.compact_count,
+            stats.compact_moved_bytes
+        );
+    }
+#endif
+}
+
+void Performance_window_impl::frustum_culler_imgui()
+{
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+    ERHE_PROFILE_FUNCTION
+
+    if (!ImGui::CollapsingHeader("Frustum Culling")) {
+        return;
+    }
+
+    const auto all_frustum_cullers = erhe::scene::Frustum_culler::all_frustum_cullers();
+    for (const auto* culler : all_frustum_cullers) {
+        const auto stats = culler->get_stats();
+        const float culled_ratio = (stats.mesh_count > 0)
+            ? static_cast<float>(stats.culled_count) / static_cast<float>(stats.mesh_count)
+            : 0.0f;
+        const auto overlay = fmt::format(
+            "{} / {} culled",
+            stats.culled_count,
+            stats.mesh_count
+        );
+        ImGui::TextUnformatted(culler->label());
+        ImGui::ProgressBar(culled_ratio, ImVec2{-1.0f, 0.0f}, overlay.c_str());
+        ImGui::Text(
+            "Visible: %zu, culled: %zu, tested: %zu, cull calls: %zu",
+            stats.visible_count,
+            stats.culled_count,
+            stats.mesh_count,
+            stats.cull_count
+        );
+    }
 #endif
 }
 
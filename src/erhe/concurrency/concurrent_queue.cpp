@@ -23,6 +23,11 @@ Concurrent_queue::~Concurrent_queue() noexcept
     wait();
 }
 
+void Concurrent_queue::enqueue_batch(std::vector<std::function<void()>>&& functions)
+{
+    m_pool.enqueue(&m_queue, std::move(functions));
+}
+
 void Concurrent_queue::steal()
 {
     m_pool.dequeue_and_process();
@@ -60,6 +60,9 @@ public:
         );
     }
 
+    // Enqueues multiple tasks with a single wakeup of parked workers
+    void enqueue_batch(std::vector<std::function<void()>>&& functions);
+
     void steal ();
     void cancel();
     void wait  ();
@@ -0,0 +1,237 @@
+#include "erhe/concurrency/task_graph.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::concurrency {
+
+Task_graph::Task_graph(Thread_pool* thread_pool, const std::string_view name)
+    : m_thread_pool{thread_pool}
+{
+    if ((m_thread_pool != nullptr) && (m_thread_pool->size() > 0)) {
+        m_queue = std::make_unique<Concurrent_queue>(*m_thread_pool, name);
+    }
+}
+
+Task_graph::~Task_graph() noexcept
+{
+    wait();
+}
+
+auto Task_graph::add(
+    std::function<void()>&&     function,
+    const std::vector<Task_id>& predecessors
+) -> Task_id
+{
+    Node*   ready_node{nullptr};
+    Task_id id{0};
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        ready_node = add_node(std::move(function), predecessors, id);
+    }
+    if (ready_node != nullptr) {
+        submit(ready_node);
+    }
+    return id;
+}
+
+auto Task_graph::add_node(
+    std::function<void()>&&     function,
+    const std::vector<Task_id>& predecessors,
+    Task_id&                    out_id
+) -> Node*
+{
+    const Task_id id = m_first_id + m_nodes.size();
+    m_nodes.push_back(std::make_unique<Node>());
+    Node* const node = m_nodes.back().get();
+    node->function = std::move(function);
+    for (const Task_id predecessor_id : predecessors) {
+        ERHE_VERIFY(predecessor_id < id);
+        if (predecessor_id < m_first_id) {
+            continue; // completed and released
+        }
+        Node* const predecessor = m_nodes[predecessor_id - m_first_id].get();
+        if (!predecessor->completed) {
+            predecessor->successors.push_back(node);
+            ++node->pending_predecessor_count;
+        }
+    }
+    out_id = id;
+    return (node->pending_predecessor_count == 0) ? node : nullptr;
+}
+
+auto Task_graph::parallel_for(
+    const std::size_t                                       count,
+    const std::size_t                                       grain_size,
+    std::function<void(std::size_t begin, std::size_t end)> function,
+    const std::vector<Task_id>&                             predecessors
+) -> Task_id
+{
+    const std::size_t step = std::max(grain_size, std::size_t{1});
+    auto shared_function = std::make_shared<std::function<void(std::size_t, std::size_t)>>(std::move(function));
+
+    // All range tasks and the join task are added under a single lock, and
+    // the ready range tasks are submitted as one batch.
+    std::vector<Node*>   ready;
+    std::vector<Task_id> range_tasks;
+    range_tasks.reserve((count + step - 1) / step);
+    Task_id join_id{0};
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        for (std::size_t begin = 0; begin < count; begin += step) {
+            const std::size_t end = std::min(begin + step, count);
+            Task_id range_id{0};
+            Node* const ready_node = add_node(
+                [shared_function, begin, end]()
+                {
+                    (*shared_function)(begin, end);
+                },
+                predecessors,
+                range_id
+            );
+            range_tasks.push_back(range_id);
+            if (ready_node != nullptr) {
+                ready.push_back(ready_node);
+            }
+        }
+        Node* const ready_join = add_node(
+            [](){},
+            range_tasks.empty() ? predecessors : range_tasks,
+            join_id
+        );
+        if (ready_join != nullptr) {
+            ready.push_back(ready_join);
+        }
+    }
+    submit_batch(ready);
+    return join_id;
+}
+
+void Task_graph::submit(Node* node)
+{
+    if (m_queue) {
+        m_queue->enqueue(
+            [this, node]()
+            {
+                execute(node);
+            }
+        );
+    } else {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_ready.push_back(node);
+    }
+}
+
+void Task_graph::submit_batch(const std::vector<Node*>& nodes)
+{
+    if (!m_queue || (nodes.size() < 2)) {
+        for (Node* node : nodes) {
+            submit(node);
+        }
+        return;
+    }
+
+    std::vector<std::function<void()>> functions;
+    functions.reserve(nodes.size());
+    for (Node* node : nodes) {
+        functions.emplace_back(
+            [this, node]()
+            {
+                execute(node);
+            }
+        );
+    }
+    m_queue->enqueue_batch(std::move(functions));
+}
+
+void Task_graph::execute(Node* node)
+{
+    node->function();
+    node->function = {}; // release captures early
+
+    std::vector<Node*> ready;
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        node->completed = true;
+        ++m_completed_count;
+        for (Node* successor : node->successors) {
+            if (--successor->pending_predecessor_count == 0) {
+                ready.push_back(successor);
+            }
+        }
+        node->successors.clear();
+    }
+
+    // Successors are submitted before this task is counted as done in the
+    // queue, so Concurrent_queue::wait() cannot return in between.
+    submit_batch(ready);
+}
+
+void Task_graph::wait()
+{
+    if (m_queue) {
+        m_queue->wait();
+        release_completed();
+        return;
+    }
+
+    for (;;) {
+        Node* node{nullptr};
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_ready.empty()) {
+                break;
+            }
+            node = m_ready.front();
+            m_ready.pop_front();
+        }
+        execute(node);
+    }
+    release_completed();
+}
+
+void Task_graph::release_completed()
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Tasks may have been added from other threads after wait() returned
+    if (m_completed_count != m_nodes.size()) {
+        return;
+    }
+    m_first_id += m_nodes.size();
+    m_completed_count = 0;
+    m_nodes.clear();
+}
+
+void parallel_for(
+    Thread_pool*                                                    thread_pool,
+    const std::size_t                                               count,
+    const std::size_t                                               grain_size,
+    const std::function<void(std::size_t begin, std::size_t end)>& function
+)
+{
+    const std::size_t step = std::max(grain_size, std::size_t{1});
+    if ((thread_pool == nullptr) || (thread_pool->size() < 2) || (count <= step)) {
+        if (count > 0) {
+            function(0, count);
+        }
+        return;
+    }
+
+    std::vector<std::function<void()>> functions;
+    functions.reserve((count + step - 1) / step);
+    for (std::size_t begin = 0; begin < count; begin += step) {
+        const std::size_t end = std::min(begin + step, count);
+        functions.emplace_back(
+            [&function, begin, end]()
+            {
+                function(begin, end);
+            }
+        );
+    }
+    Concurrent_queue queue{*thread_pool, "parallel_for"};
+    queue.enqueue_batch(std::move(functions));
+    queue.wait();
+}
+
+} // namespace erhe::concurrency
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "erhe/concurrency/concurrent_queue.hpp"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace erhe::concurrency {
+
+/*
+    Task_graph runs tasks with dependencies in the Thread_pool. Each task
+    can list predecessor tasks; a task is submitted to the pool once all
+    of its predecessors have completed. Predecessors must have been added
+    before the task, so the graph is always acyclic.
+
+    Tasks can be added from any thread, including from other tasks of the
+    same graph. If thread pool is nullptr (or it has no threads), tasks
+    are executed on the thread calling wait().
+
+    Usage example:
+
+    Task_graph graph{&thread_pool, "content"};
+
+    auto geometry  = graph.async([]{ return make_geometry(); });
+    auto primitive = graph.then(geometry, [](const Geometry& g){ return make_primitive(g); });
+    auto upload    = graph.add([&]{ flush_uploads(); }, {primitive.id});
+
+    graph.parallel_for(count, 64, [](std::size_t begin, std::size_t end){ ... });
+
+    graph.wait(); // cooperative, blocking (helps pool until all tasks are complete)
+*/
+class Task_graph
+{
+public:
+    using Task_id = std::size_t;
+
+    template <typename T>
+    class Future
+    {
+    public:
+        [[nodiscard]] auto get() const -> decltype(auto)
+        {
+            return future.get();
+        }
+
+        Task_id               id;
+        std::shared_future<T> future;
+    };
+
+    Task_graph(Thread_pool* thread_pool, std::string_view name);
+    ~Task_graph() noexcept;
+
+    Task_graph    (const Task_graph&) = delete;
+    void operator=(const Task_graph&) = delete;
+
+    // Adds task which runs after all predecessors have completed.
+    auto add(
+        std::function<void()>&&     function,
+        const std::vector<Task_id>& predecessors = {}
+    ) -> Task_id;
+
+    // Adds task with a return value.
+    template <typename Function>
+    auto async(
+        Function&&                  function,
+        const std::vector<Task_id>& predecessors = {}
+    ) -> Future<std::invoke_result_t<Function>>
+    {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::shared_future<Result> future = task->get_future().share();
+        const Task_id id = add(
+            [task]()
+            {
+                (*task)();
+            },
+            predecessors
+        );
+        return Future<Result>{id, std::move(future)};
+    }
+
+    // Adds continuation task, which is passed the value of future.
+    template <typename T, typename Function>
+    auto then(const Future<T>& future, Function&& function)
+    {
+        if constexpr (std::is_void_v<T>) {
+            return async(std::forward<Function>(function), {future.id});
+        } else {
+            return async(
+                [future, function = std::forward<Function>(function)]() mutable
+                {
+                    return function(future.get());
+                },
+                {future.id}
+            );
+        }
+    }
+
+    // Adds tasks calling function(begin, end) for subranges of [0, count),
+    // each at most grain_size long. Returns id of a task which completes
+    // when all subranges have completed.
+    auto parallel_for(
+        std::size_t                                             count,
+        std::size_t                                             grain_size,
+        std::function<void(std::size_t begin, std::size_t end)> function,
+        const std::vector<Task_id>&                             predecessors = {}
+    ) -> Task_id;
+
+    // Waits until all tasks, including tasks added while waiting, have
+    // completed. Must not be called from tasks of this graph. Completed
+    // tasks are released, so a long lived graph does not grow; their ids
+    // stay valid as predecessors of tasks added later.
+    void wait();
+
+private:
+    class Node
+    {
+    public:
+        std::function<void()> function;
+        std::vector<Node*>    successors;
+        std::size_t           pending_predecessor_count{0};
+        bool                  completed{false};
+    };
+
+    // Adds node, m_mutex must be locked. Returns node if it has no pending
+    // predecessors and must be submitted by the caller, otherwise nullptr.
+    [[nodiscard]] auto add_node(
+        std::function<void()>&&     function,
+        const std::vector<Task_id>& predecessors,
+        Task_id&                    out_id
+    ) -> Node*;
+
+    void submit           (Node* node);
+    void submit_batch     (const std::vector<Node*>& nodes);
+    void execute          (Node* node);
+    void release_completed();
+
+    Thread_pool*                       m_thread_pool{nullptr};
+    std::unique_ptr<Concurrent_queue>  m_queue;
+    std::mutex                         m_mutex;
+    Task_id                            m_first_id       {0}; // id of m_nodes[0]
+    std::size_t                        m_completed_count{0};
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::deque<Node*>                  m_ready; // used when there is no thread pool
+};
+
+// Calls function(begin, end) for subranges of [0, count), each at most
+// grain_size long, and waits for completion. Runs on the calling thread
+// if thread_pool is nullptr or count fits in a single subrange.
+void parallel_for(
+    Thread_pool*                                                    thread_pool,
+    std::size_t                                                     count,
+    std::size_t                                                     grain_size,
+    const std::function<void(std::size_t begin, std::size_t end)>& function
+);
+
+} // namespace erhe::concurrency
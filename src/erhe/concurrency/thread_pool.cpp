@@ -2,20 +2,31 @@
 
 #include <concurrentqueue.h>
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <mutex>
 
 namespace erhe::concurrency {
 
-using std::chrono::high_resolution_clock;
 using std::chrono::duration_cast;
-using std::chrono::microseconds;
-using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace {
+
+constexpr std::size_t priority_count = 3;
+
+// Worker index of the current thread, if it is a worker of t_pool
+thread_local const Thread_pool* t_pool  {nullptr};
+thread_local std::size_t        t_worker{0};
+
+}
 
 // ------------------------------------------------------------
 // Thread_pool
 // ------------------------------------------------------------
 
-
 struct Thread_pool::Task_queue
 {
     using Task = Thread_pool::Task;
@@ -23,12 +34,42 @@ struct Thread_pool::Task_queue
     moodycamel::ConcurrentQueue<Task> tasks;
 };
 
+// Each worker pushes and pops tasks it enqueues at the back of its own
+// deques (LIFO, cache warm). Idle workers steal from the front (FIFO).
+struct Thread_pool::Worker
+{
+    std::mutex       mutex;
+    std::deque<Task> tasks[priority_count];
+
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
+#endif
+    alignas(64) std::atomic<int> task_count[priority_count]{}; // lets thieves skip empty deques without locking
+
+    alignas(64) std::atomic<uint64_t> tasks_run     {0};
+    std::atomic<uint64_t>             steals        {0};
+    std::atomic<uint64_t>             parks         {0};
+    std::atomic<int64_t>              idle_time_ns  {0};
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+    uint32_t random_state{1};
+};
+
 Thread_pool::Thread_pool(size_t size)
     : m_queues      {nullptr}
     , m_static_queue{this, int(Priority::NORMAL), "static"}
     , m_threads     {size}
 {
-    m_queues = new Task_queue[3];
+    m_queues = new Task_queue[priority_count];
+
+    m_workers.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->random_state = static_cast<uint32_t>(i * 2654435761u) | 1u;
+    }
 
     // NOTE: let OS scheduler shuffle tasks as it sees fit
     //       this gives better performance overall UNTIL we have some practical
@@ -65,7 +106,7 @@ Thread_pool::Thread_pool(size_t size)
 Thread_pool::~Thread_pool() noexcept
 {
     m_stop = true;
-    m_condition.notify_all();
+    m_park_semaphore.release(static_cast<std::ptrdiff_t>(m_threads.size()));
 
     for (auto& thread : m_threads) {
         thread.join();
@@ -83,31 +124,172 @@ int Thread_pool::size() const
     return int(m_threads.size());
 }
 
+auto Thread_pool::get_thread_statistics() const -> std::vector<Thread_statistics>
+{
+    std::vector<Thread_statistics> result;
+    result.reserve(m_workers.size());
+    for (const auto& worker : m_workers) {
+        result.push_back(
+            Thread_statistics{
+                .tasks_run = worker->tasks_run.load(std::memory_order_relaxed),
+                .steals    = worker->steals   .load(std::memory_order_relaxed),
+                .parks     = worker->parks    .load(std::memory_order_relaxed),
+                .idle_time = nanoseconds{worker->idle_time_ns.load(std::memory_order_relaxed)}
+            }
+        );
+    }
+    return result;
+}
+
+void Thread_pool::reset_thread_statistics()
+{
+    for (const auto& worker : m_workers) {
+        worker->tasks_run   .store(0, std::memory_order_relaxed);
+        worker->steals      .store(0, std::memory_order_relaxed);
+        worker->parks       .store(0, std::memory_order_relaxed);
+        worker->idle_time_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
 void Thread_pool::thread(size_t threadID)
 {
-    static_cast<void>(threadID);
+    t_pool   = this;
+    t_worker = threadID;
 
-    auto time0 = high_resolution_clock::now();
+    Worker& worker     = *m_workers[threadID];
+    int     idle_count = 0;
+    auto    idle_start = steady_clock::now();
 
     while (!m_stop.load(std::memory_order_relaxed)) {
         if (dequeue_and_process()) {
-            // remember the last time we processed a task
-            time0 = high_resolution_clock::now();
+            if (idle_count > 0) {
+                const auto idle_time = steady_clock::now() - idle_start;
+                worker.idle_time_ns.fetch_add(duration_cast<nanoseconds>(idle_time).count(), std::memory_order_relaxed);
+                idle_count = 0;
+            }
+            continue;
+        }
+
+        if (idle_count == 0) {
+            idle_start = steady_clock::now();
+        }
+        if (++idle_count < s_spin_count) {
+            std::this_thread::yield();
         } else {
-            const auto time1   = high_resolution_clock::now();
-            const auto elapsed = time1 - time0;
-            if (elapsed >= microseconds(1200)) {
-                std::unique_lock<std::mutex> lock{m_queue_mutex};
-
-                m_condition.wait_for(lock, milliseconds(120));
-            } else { // if (elapsed >= microseconds(2))
-                std::this_thread::yield();
+            park(worker);
+        }
+    }
+
+    t_pool = nullptr;
+}
+
+void Thread_pool::park(Worker& worker)
+{
+    // Announce sleeping before checking for work. enqueue() updates
+    // m_queued_count before checking m_sleeping_count, so at least one
+    // side sees the other and no wakeup is lost.
+    m_sleeping_count.fetch_add(1);
+    if ((m_queued_count.load() <= 0) && !m_stop.load()) {
+        worker.parks.fetch_add(1, std::memory_order_relaxed);
+        if (m_park_semaphore.try_acquire_for(s_park_timeout)) {
+            return; // wake() already removed this worker from m_sleeping_count
+        }
+    }
+
+    // Leaving without a permit. If wake() has already claimed this worker,
+    // its permit is on the way and must be consumed, so that permits never
+    // accumulate in the semaphore.
+    int sleeping_count = m_sleeping_count.load();
+    while (sleeping_count > 0) {
+        if (m_sleeping_count.compare_exchange_weak(sleeping_count, sleeping_count - 1)) {
+            return;
+        }
+    }
+    m_park_semaphore.acquire();
+}
+
+void Thread_pool::wake(const int count)
+{
+    // Claims up to count sleeping workers, and releases exactly one
+    // permit for each claimed worker
+    int sleeping_count = m_sleeping_count.load();
+    while (sleeping_count > 0) {
+        const int wake_count = std::min(count, sleeping_count);
+        if (m_sleeping_count.compare_exchange_weak(sleeping_count, sleeping_count - wake_count)) {
+            m_park_semaphore.release(wake_count);
+            return;
+        }
+    }
+}
+
+void Thread_pool::push(Task&& task)
+{
+    const std::size_t priority = static_cast<std::size_t>(task.queue->priority);
+    if (t_pool == this) {
+        Worker& worker = *m_workers[t_worker];
+        {
+            const std::lock_guard<std::mutex> lock{worker.mutex};
+            worker.tasks[priority].push_back(std::move(task));
+        }
+        worker.task_count[priority].fetch_add(1, std::memory_order_release);
+    } else {
+        m_queues[priority].tasks.enqueue(std::move(task));
+    }
+}
+
+auto Thread_pool::try_pop(Task& task, bool& stolen) -> bool
+{
+    Worker* const self = (t_pool == this) ? m_workers[t_worker].get() : nullptr;
+
+    const std::size_t worker_count = m_workers.size();
+    std::size_t       first_victim = 0;
+    if ((self != nullptr) && (worker_count > 1)) {
+        // xorshift32
+        uint32_t x = self->random_state;
+        x ^= x << 13u;
+        x ^= x >> 17u;
+        x ^= x << 5u;
+        self->random_state = x;
+        first_victim = x % worker_count;
+    }
+
+    // scan task queues in priority order
+    for (std::size_t priority = 0; priority < priority_count; ++priority) {
+        if ((self != nullptr) && (self->task_count[priority].load(std::memory_order_acquire) > 0)) {
+            const std::lock_guard<std::mutex> lock{self->mutex};
+            auto& tasks = self->tasks[priority];
+            if (!tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                self->task_count[priority].fetch_sub(1, std::memory_order_relaxed);
+                stolen = false;
+                return true;
+            }
+        }
+
+        if (m_queues[priority].tasks.try_dequeue(task)) {
+            stolen = false;
+            return true;
+        }
+
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            Worker* const victim = m_workers[(first_victim + i) % worker_count].get();
+            if ((victim == self) || (victim->task_count[priority].load(std::memory_order_acquire) <= 0)) {
+                continue;
+            }
+            const std::lock_guard<std::mutex> lock{victim->mutex};
+            auto& tasks = victim->tasks[priority];
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                victim->task_count[priority].fetch_sub(1, std::memory_order_relaxed);
+                stolen = true;
+                return true;
             }
-            //else {
-            //    pause();
-            //}
         }
     }
+
+    return false;
 }
 
 void Thread_pool::enqueue(Queue* queue, std::function<void()>&& func)
@@ -117,37 +299,64 @@ void Thread_pool::enqueue(Queue* queue, std::function<void()>&& func)
     task.func = std::move(func);
 
     ++queue->task_counter;
-    m_queues[queue->priority].tasks.enqueue(std::move(task));
+    push(std::move(task));
+    m_queued_count.fetch_add(1);
+
+    wake(1);
+}
+
+void Thread_pool::enqueue(Queue* queue, std::vector<std::function<void()>>&& funcs)
+{
+    if (funcs.empty()) {
+        return;
+    }
+
+    const int count = static_cast<int>(funcs.size());
+    queue->task_counter += count;
+    for (auto& func : funcs) {
+        push(Task{queue, std::move(func)});
+    }
+    m_queued_count.fetch_add(count);
 
-    m_condition.notify_one();
+    // One wakeup for the whole batch
+    wake(count);
 }
 
 bool Thread_pool::dequeue_and_process()
 {
-    // scan task queues in priority order
-    for (size_t priority = 0; priority < 3; ++priority) {
-        Task task;
-        if (m_queues[priority].tasks.try_dequeue(task)) {
-            Queue* const queue = task.queue;
+    Task task;
+    bool stolen{false};
+    if (!try_pop(task, stolen)) {
+        return false;
+    }
+    m_queued_count.fetch_sub(1);
 
-            // check if the task is cancelled
-            if (!queue->cancelled) {
-                // process task
-                task.func();
-            }
+    Queue* const queue = task.queue;
 
-            --queue->task_counter;
-            return true;
+    // check if the task is cancelled
+    if (!queue->cancelled) {
+        // process task
+        task.func();
+    }
+
+    if (t_pool == this) {
+        Worker& worker = *m_workers[t_worker];
+        worker.tasks_run.fetch_add(1, std::memory_order_relaxed);
+        if (stolen) {
+            worker.steals.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
-    return false;
+    --queue->task_counter;
+    return true;
 }
 
 void Thread_pool::wait(Queue* queue)
 {
     while (queue->task_counter > 0) {
-        dequeue_and_process();
+        if (!dequeue_and_process()) {
+            std::this_thread::yield();
+        }
     }
 }
 
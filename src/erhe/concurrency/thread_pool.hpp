@@ -1,9 +1,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <semaphore>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -54,6 +58,16 @@ private:
     };
 
 public:
+    // Counters of a single worker thread, for profiling
+    class Thread_statistics
+    {
+    public:
+        uint64_t                 tasks_run{0}; // including stolen tasks
+        uint64_t                 steals   {0}; // tasks taken from other workers
+        uint64_t                 parks    {0}; // times parked waiting for work
+        std::chrono::nanoseconds idle_time{0};
+    };
+
     explicit Thread_pool(std::size_t size);
     ~Thread_pool() noexcept;
 
@@ -64,30 +78,49 @@ public:
         enqueue(&m_static_queue, std::move(func));
     }
 
+    [[nodiscard]] auto get_thread_statistics() const -> std::vector<Thread_statistics>;
+    void reset_thread_statistics();
+
 protected:
     void thread             (size_t threadID);
     void enqueue            (Queue* queue, std::function<void()>&& func);
+    void enqueue            (Queue* queue, std::vector<std::function<void()>>&& funcs);
     bool dequeue_and_process();
     void cancel             (Queue* queue);
     void wait               (Queue* queue);
 
 private:
     struct Task_queue;
-    alignas(64) Task_queue* m_queues;
+    struct Worker;
+
+    void push    (Task&& task);
+    auto try_pop (Task& task, bool& stolen) -> bool;
+    void wake    (int count);
+    void park    (Worker& worker);
+
+    // Number of yield() rounds without work before a worker parks
+    static constexpr int s_spin_count = 64;
+
+    // Parked workers also wake up periodically, as a safety net
+    static constexpr std::chrono::milliseconds s_park_timeout{100};
+
+    alignas(64) Task_queue* m_queues; // shared queues for tasks enqueued from non-worker threads
 
 #if defined(_MSC_VER)
 #   pragma warning(push)
 #   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
 #endif
-    alignas(64) std::atomic<bool> m_stop { false };
+    alignas(64) std::atomic<bool>    m_stop          { false };
+    alignas(64) std::atomic<int64_t> m_queued_count  { 0 };
+    alignas(64) std::atomic<int>     m_sleeping_count{ 0 };
 #if defined(_MSC_VER)
 #   pragma warning(pop)
 #endif
 
-    std::mutex               m_queue_mutex;
-    std::condition_variable  m_condition;
-    Queue                    m_static_queue;
-    std::vector<std::thread> m_threads;
+    std::counting_semaphore<>            m_park_semaphore{0};
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    Queue                                m_static_queue;
+    std::vector<std::thread>             m_threads;
 };
 
 enum class Priority
@@ -0,0 +1,131 @@
+#include "erhe/geometry/edge_hash.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace erhe::geometry
+{
+
+namespace {
+
+constexpr std::size_t min_slot_count = 64;
+
+}
+
+auto Edge_hash::make_key(Point_id a, Point_id b) -> uint64_t
+{
+    if (b < a) {
+        std::swap(a, b);
+    }
+    return (static_cast<uint64_t>(a) << 32u) | static_cast<uint64_t>(b);
+}
+
+auto Edge_hash::hash(uint64_t key) -> std::size_t
+{
+    // splitmix64 finalizer
+    key ^= key >> 30u;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27u;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31u;
+    return static_cast<std::size_t>(key);
+}
+
+void Edge_hash::clear()
+{
+    m_slots.clear();
+    m_size       = 0;
+    m_edge_count = 0;
+}
+
+void Edge_hash::reserve(const std::size_t edge_count)
+{
+    // Keep load factor at or below 1/2
+    std::size_t slot_count = min_slot_count;
+    while (slot_count < 2 * edge_count) {
+        slot_count *= 2;
+    }
+    if (slot_count > m_slots.size()) {
+        rehash(slot_count);
+    }
+}
+
+void Edge_hash::rehash(const std::size_t slot_count)
+{
+    std::vector<Slot> old_slots;
+    std::swap(old_slots, m_slots);
+    m_slots.resize(slot_count);
+
+    const std::size_t mask = slot_count - 1;
+    for (const Slot& old_slot : old_slots) {
+        if (old_slot.key == empty_key) {
+            continue;
+        }
+        std::size_t i = hash(old_slot.key) & mask;
+        while (m_slots[i].key != empty_key) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = old_slot;
+    }
+}
+
+void Edge_hash::insert(const Point_id a, const Point_id b, const Edge_id edge_id)
+{
+    ERHE_VERIFY(a != b);
+
+    ++m_edge_count;
+    if (2 * (m_size + 1) > m_slots.size()) {
+        rehash(std::max(min_slot_count, 2 * m_slots.size()));
+    }
+
+    const uint64_t    key  = make_key(a, b);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t i = hash(key) & mask;
+    for (;;) {
+        Slot& slot = m_slots[i];
+        if (slot.key == key) {
+            return;
+        }
+        if (slot.key == empty_key) {
+            slot.key     = key;
+            slot.edge_id = edge_id;
+            ++m_size;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+auto Edge_hash::find(const Point_id a, const Point_id b) const -> std::optional<Edge_id>
+{
+    if (m_slots.empty() || (a == b)) {
+        return {};
+    }
+
+    const uint64_t    key  = make_key(a, b);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t i = hash(key) & mask;
+    for (;;) {
+        const Slot& slot = m_slots[i];
+        if (slot.key == key) {
+            return slot.edge_id;
+        }
+        if (slot.key == empty_key) {
+            return {};
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+auto Edge_hash::size() const -> std::size_t
+{
+    return m_size;
+}
+
+auto Edge_hash::edge_count() const -> std::size_t
+{
+    return m_edge_count;
+}
+
+} // namespace erhe::geometry
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "erhe/geometry/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+// Open addressing (linear probing) hash table from ordered point
+// pairs to edge ids. Used by Geometry::find_edge().
+class Edge_hash
+{
+public:
+    void clear  ();
+    void reserve(std::size_t edge_count);
+
+    // If the same point pair is inserted more than once,
+    // the first edge id is kept.
+    void insert(Point_id a, Point_id b, Edge_id edge_id);
+
+    [[nodiscard]] auto find      (Point_id a, Point_id b) const -> std::optional<Edge_id>;
+    [[nodiscard]] auto size      () const -> std::size_t; // unique point pairs
+    [[nodiscard]] auto edge_count() const -> std::size_t; // insert() calls since clear()
+
+private:
+    class Slot
+    {
+    public:
+        uint64_t key    {empty_key};
+        Edge_id  edge_id{0};
+    };
+
+    static constexpr uint64_t empty_key = ~uint64_t{0};
+
+    [[nodiscard]] static auto make_key(Point_id a, Point_id b) -> uint64_t;
+    [[nodiscard]] static auto hash    (uint64_t key) -> std::size_t;
+
+    void rehash(std::size_t slot_count);
+
+    std::vector<Slot> m_slots;
+    std::size_t       m_size      {0};
+    std::size_t       m_edge_count{0};
+};
+
+} // namespace erhe::geometry
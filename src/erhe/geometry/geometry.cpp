@@ -70,6 +70,7 @@ Geometry::Geometry(Geometry&& other) noexcept
     , m_corner_property_map_collection    {std::move(other.m_corner_property_map_collection)}
     , m_polygon_property_map_collection   {std::move(other.m_polygon_property_map_collection)}
     , m_edge_property_map_collection      {std::move(other.m_edge_property_map_collection)}
+    , m_edge_hash                         {std::move(other.m_edge_hash)}
     , m_serial                            {other.m_serial}
     , m_serial_edges                      {other.m_serial_edges                      }
     , m_serial_polygon_normals            {other.m_serial_polygon_normals            }
@@ -190,6 +191,7 @@ auto Geometry::compute_polygon_normals() -> bool
     {
         i.polygon.compute_normal(i.polygon_id, *this, *polygon_normals, *point_locations);
     });
+    static_cast<void>(polygon_normals->make_dense(get_polygon_count()));
 
     m_serial_polygon_normals = m_serial;
 
@@ -231,6 +233,7 @@ auto Geometry::compute_polygon_centroids() -> bool
     {
         i.polygon.compute_centroid(i.polygon_id, *this, *polygon_centroids, *point_locations);
     });
+    static_cast<void>(polygon_centroids->make_dense(get_polygon_count()));
 
     m_serial_polygon_centroids = m_serial;
 
@@ -259,9 +262,22 @@ void Geometry::build_edges(bool is_manifold)
 
     edges.clear();
     m_next_edge_id = 0;
+    m_edge_hash.clear();
+    m_edge_hash.reserve(get_corner_count() / 2);
 
     log_build_edges->info("{} build_edges() : {} polygons", name, m_next_polygon_id);
 
+    // Previous point of each corner in its polygon, so that edges
+    // of point corners can be found without searching polygons.
+    std::vector<Point_id> corner_prev_point_ids(get_corner_count());
+    for_each_polygon_const([&](auto& i)
+    {
+        i.polygon.for_each_corner_neighborhood_const(*this, [&](auto& j)
+        {
+            corner_prev_point_ids[j.corner_id] = j.prev_corner.point_id;
+        });
+    });
+
     //const erhe::log::Indenter scope_indent;
     std::size_t polygon_index{0};
 
@@ -291,10 +307,7 @@ void Geometry::build_edges(bool is_manifold)
                     pa.for_each_corner_const(*this, [&](auto& k)
                     {
                          const Polygon_id polygon_id_in_point = k.corner.polygon_id;
-                         const Polygon&   polygon_in_point    = polygons[polygon_id_in_point];
-                         const Corner_id  prev_corner_id      = polygon_in_point.prev_corner(*this, k.corner_id);
-                         const Corner&    prev_corner         = corners[prev_corner_id];
-                         const Point_id   prev_point_id       = prev_corner.point_id;
+                         const Point_id   prev_point_id       = corner_prev_point_ids[k.corner_id];
                          if (prev_point_id == b) {
                              make_edge_polygon(edge_id, polygon_id_in_point);
                              ++polygon_index;
@@ -321,8 +334,8 @@ void Geometry::build_edges(bool is_manifold)
                     return;
                 }
 
-                auto edge = find_edge(a_, b_);
-                if (!edge) {
+                const auto edge_id_opt = find_edge_id(a_, b_);
+                if (!edge_id_opt.has_value()) {
                     // ERHE_VERIFY(b < a); This does not hold for non-manifold objects
                     {
                         const Point_id a = std::max(a_, b_);
@@ -334,10 +347,7 @@ void Geometry::build_edges(bool is_manifold)
                         pb.for_each_corner_const(*this, [&](auto& k)
                         {
                              const Polygon_id polygon_id_in_point = k.corner.polygon_id;
-                             const Polygon&   polygon_in_point    = polygons[polygon_id_in_point];
-                             const Corner_id  prev_corner_id      = polygon_in_point.prev_corner(*this, k.corner_id);
-                             const Corner&    prev_corner         = corners[prev_corner_id];
-                             const Point_id   prev_point_id       = prev_corner.point_id;
+                             const Point_id   prev_point_id       = corner_prev_point_ids[k.corner_id];
                              if (prev_point_id == a) {
                                  make_edge_polygon(edge_id, polygon_id_in_point);
                                  ++polygon_index;
@@ -352,6 +362,42 @@ void Geometry::build_edges(bool is_manifold)
     m_serial_edges = m_serial;
 }
 
+void Geometry::update_edge_hash()
+{
+    // Edges may have been copied or cleared directly
+    if (m_edge_hash.edge_count() > m_next_edge_id) {
+        m_edge_hash.clear();
+    }
+    if (m_edge_hash.edge_count() == m_next_edge_id) {
+        return;
+    }
+
+    m_edge_hash.reserve(m_next_edge_id);
+    for (
+        Edge_id edge_id = static_cast<Edge_id>(m_edge_hash.edge_count());
+        edge_id < m_next_edge_id;
+        ++edge_id
+    ) {
+        const Edge& edge = edges[edge_id];
+        m_edge_hash.insert(edge.a, edge.b, edge_id);
+    }
+}
+
+auto Geometry::find_edge_id(const Point_id a, const Point_id b) -> std::optional<Edge_id>
+{
+    update_edge_hash();
+    return m_edge_hash.find(a, b);
+}
+
+auto Geometry::find_edge(const Point_id a, const Point_id b) -> std::optional<Edge>
+{
+    const auto edge_id = find_edge_id(a, b);
+    if (!edge_id.has_value()) {
+        return {};
+    }
+    return edges[edge_id.value()];
+}
+
 void Geometry::debug_trace() const
 {
     ERHE_PROFILE_FUNCTION
@@ -492,6 +538,7 @@ auto Geometry::compute_point_normals(const Property_map_descriptor& descriptor)
         });
         point_normals->put(i.point_id, normalize(normal_sum));
     });
+    static_cast<void>(point_normals->make_dense(get_point_count()));
 
     m_serial_point_normals = m_serial;
     return true;
@@ -507,6 +554,9 @@ auto Geometry::transform(const mat4& m) -> Geometry&
 
     //const mat4 it = glm::transpose(glm::inverse(m));
 
+    // Dense maps are transformed without unused padding values
+    make_dense_attributes();
+
     polygon_attributes().transform(m);
     point_attributes  ().transform(m);
     corner_attributes ().transform(m);
@@ -520,6 +570,16 @@ auto Geometry::transform(const mat4& m) -> Geometry&
     return *this;
 }
 
+void Geometry::make_dense_attributes()
+{
+    ERHE_PROFILE_FUNCTION
+
+    m_point_property_map_collection  .make_dense(get_point_count  ());
+    m_corner_property_map_collection .make_dense(get_corner_count ());
+    m_polygon_property_map_collection.make_dense(get_polygon_count());
+    m_edge_property_map_collection   .make_dense(get_edge_count   ());
+}
+
 void Geometry::reverse_polygons()
 {
     ERHE_PROFILE_FUNCTION
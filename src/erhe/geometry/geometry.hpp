@@ -1,5 +1,6 @@
 #pragma once
 
+#include "erhe/geometry/edge_hash.hpp"
 #include "erhe/geometry/property_map.hpp"
 #include "erhe/geometry/property_map_collection.hpp"
 #include "erhe/geometry/remapper.hpp"
@@ -92,9 +93,10 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_corner(
-        Geometry&                                          geometry,
-        std::function<void(Point_corner_context& context)> callback
+        Geometry&  geometry,
+        Callback&& callback
     );
 
     class Point_corner_context_const
@@ -112,9 +114,10 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_corner_const(
-        const Geometry&                                          geometry,
-        std::function<void(Point_corner_context_const& context)> callback
+        const Geometry& geometry,
+        Callback&&      callback
     ) const;
 
     class Point_corner_neighborhood_context
@@ -159,14 +162,16 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_corner_neighborhood(
-        Geometry&                                                       geometry,
-        std::function<void(Point_corner_neighborhood_context& context)> callback
+        Geometry&  geometry,
+        Callback&& callback
     );
 
+    template <typename Callback>
     void for_each_corner_neighborhood_const(
-        const Geometry&                                                       geometry,
-        std::function<void(Point_corner_neighborhood_context_const& context)> callback
+        const Geometry& geometry,
+        Callback&&      callback
     ) const;
 
     Point_corner_id first_point_corner_id{0};
@@ -297,14 +302,16 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_corner(
-        Geometry&                                            geometry,
-        std::function<void(Polygon_corner_context& context)> callback
+        Geometry&  geometry,
+        Callback&& callback
     );
 
+    template <typename Callback>
     void for_each_corner_const(
-        const Geometry&                                            geometry,
-        std::function<void(Polygon_corner_context_const& context)> callback
+        const Geometry& geometry,
+        Callback&&      callback
     ) const;
 
     class Polygon_corner_neighborhood_context
@@ -349,14 +356,16 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_corner_neighborhood(
-        Geometry&                                                         geometry,
-        std::function<void(Polygon_corner_neighborhood_context& context)> callback
+        Geometry&  geometry,
+        Callback&& callback
     );
 
+    template <typename Callback>
     void for_each_corner_neighborhood_const(
-        const Geometry&                                                         geometry,
-        std::function<void(Polygon_corner_neighborhood_context_const& context)> callback
+        const Geometry& geometry,
+        Callback&&      callback
     ) const;
 };
 
@@ -398,14 +407,16 @@ public:
         }
     };
 
+    template <typename Callback>
     void for_each_polygon(
-        Geometry&                                          geometry,
-        std::function<void(Edge_polygon_context& context)> callback
+        Geometry&  geometry,
+        Callback&& callback
     );
 
+    template <typename Callback>
     void for_each_polygon_const(
-        const Geometry&                                          geometry,
-        std::function<void(Edge_polygon_context_const& context)> callback
+        const Geometry& geometry,
+        Callback&&      callback
     ) const;
 };
 
@@ -503,18 +514,11 @@ public:
     auto get_polygon_corner_count() const -> uint32_t { return m_next_polygon_corner_id; }
     auto get_edge_count          () const -> uint32_t { return m_next_edge_id; }
 
-    [[nodiscard]] auto find_edge(Point_id a, Point_id b) -> std::optional<Edge>
-    {
-        if (b < a) {
-            std::swap(a, b);
-        }
-        for (const auto& edge : edges) {
-            if (edge.a == a && edge.b == b) {
-                return edge;
-            }
-        }
-        return {};
-    }
+    // Uses edge hash, which is updated lazily for edges
+    // that have been added without make_edge().
+    [[nodiscard]] auto find_edge   (Point_id a, Point_id b) -> std::optional<Edge>;
+    [[nodiscard]] auto find_edge_id(Point_id a, Point_id b) -> std::optional<Edge_id>;
+    void update_edge_hash();
 
     // Allocates new Corner / Corner_id
     // - Point must be allocated.
@@ -686,6 +690,9 @@ public:
 
     [[nodiscard]] auto has_edges() const -> bool;
 
+    // Switches attribute maps which have values for all keys to dense mode
+    void make_dense_attributes();
+
     // returns *this, discard ok
     auto transform(const glm::mat4& m) -> Geometry&;
 
@@ -809,14 +816,16 @@ public:
         }
     };
 
-    void for_each_corner       (std::function<void(Corner_context&       )> callback);
-    void for_each_corner_const (std::function<void(Corner_context_const& )> callback) const;
-    void for_each_point        (std::function<void(Point_context&        )> callback);
-    void for_each_point_const  (std::function<void(Point_context_const&  )> callback) const;
-    void for_each_polygon      (std::function<void(Polygon_context&      )> callback);
-    void for_each_polygon_const(std::function<void(Polygon_context_const&)> callback) const;
-    void for_each_edge         (std::function<void(Edge_context&         )> callback);
-    void for_each_edge_const   (std::function<void(Edge_context_const&   )> callback) const;
+    // Callbacks are called with context reference. Iteration stops
+    // when callback calls context.break_iteration().
+    template <typename Callback> void for_each_corner       (Callback&& callback);
+    template <typename Callback> void for_each_corner_const (Callback&& callback) const;
+    template <typename Callback> void for_each_point        (Callback&& callback);
+    template <typename Callback> void for_each_point_const  (Callback&& callback) const;
+    template <typename Callback> void for_each_polygon      (Callback&& callback);
+    template <typename Callback> void for_each_polygon_const(Callback&& callback) const;
+    template <typename Callback> void for_each_edge         (Callback&& callback);
+    template <typename Callback> void for_each_edge_const   (Callback&& callback) const;
 
     constexpr static std::size_t s_grow = 4096;
     Corner_id                       m_next_corner_id           {0};
@@ -832,6 +841,7 @@ public:
     Corner_property_map_collection  m_corner_property_map_collection;
     Polygon_property_map_collection m_polygon_property_map_collection;
     Edge_property_map_collection    m_edge_property_map_collection;
+    Edge_hash                       m_edge_hash;
     uint64_t                        m_serial                            {1};
     uint64_t                        m_serial_edges                      {0};
     uint64_t                        m_serial_polygon_normals            {0};
@@ -852,6 +862,7 @@ public:
 
 } // namespace erhe::geometry
 
+#include "geometry_iterators.inl"
 #include "corner.inl"
 #include "polygon.inl"
 #include "geometry.inl"
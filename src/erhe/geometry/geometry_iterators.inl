@@ -1,10 +1,11 @@
-#include "erhe/geometry/geometry.hpp"
+#pragma once
 
 namespace erhe::geometry
 {
 
+template <typename Callback>
 void Geometry::for_each_corner(
-    std::function<void(Corner_context&)> callback
+    Callback&& callback
 )
 {
     for (
@@ -24,8 +25,9 @@ void Geometry::for_each_corner(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_corner_const(
-    std::function<void(Corner_context_const&)> callback
+    Callback&& callback
 ) const
 {
     for (
@@ -45,8 +47,9 @@ void Geometry::for_each_corner_const(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_point(
-    std::function<void(Point_context&)> callback
+    Callback&& callback
 )
 {
     for (
@@ -66,8 +69,9 @@ void Geometry::for_each_point(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_point_const(
-    std::function<void(Point_context_const&)> callback
+    Callback&& callback
 ) const
 {
     for (
@@ -87,8 +91,9 @@ void Geometry::for_each_point_const(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_polygon(
-    std::function<void(Polygon_context&)> callback
+    Callback&& callback
 )
 {
     for (
@@ -108,8 +113,9 @@ void Geometry::for_each_polygon(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_polygon_const(
-    std::function<void(Polygon_context_const&)> callback
+    Callback&& callback
 ) const
 {
     for (
@@ -129,8 +135,9 @@ void Geometry::for_each_polygon_const(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_edge(
-    std::function<void(Edge_context&)> callback
+    Callback&& callback
 )
 {
     for (
@@ -150,8 +157,9 @@ void Geometry::for_each_edge(
     }
 }
 
+template <typename Callback>
 void Geometry::for_each_edge_const(
-    std::function<void(Edge_context_const&)> callback
+    Callback&& callback
 ) const
 {
     for (
@@ -171,9 +179,10 @@ void Geometry::for_each_edge_const(
     }
 }
 
+template <typename Callback>
 void Point::for_each_corner(
-    Geometry&                                  geometry,
-    std::function<void(Point_corner_context&)> callback
+    Geometry&  geometry,
+    Callback&& callback
 )
 {
     for (
@@ -196,9 +205,10 @@ void Point::for_each_corner(
     }
 }
 
+template <typename Callback>
 void Point::for_each_corner_const(
-    const Geometry&                                  geometry,
-    std::function<void(Point_corner_context_const&)> callback
+    const Geometry& geometry,
+    Callback&&      callback
 ) const
 {
     for (
@@ -221,9 +231,10 @@ void Point::for_each_corner_const(
     }
 }
 
+template <typename Callback>
 void Point::for_each_corner_neighborhood(
-    Geometry&                                               geometry,
-    std::function<void(Point_corner_neighborhood_context&)> callback
+    Geometry&  geometry,
+    Callback&& callback
 )
 {
     for (uint32_t i = 0; i < corner_count; ++i) {
@@ -252,9 +263,10 @@ void Point::for_each_corner_neighborhood(
     }
 }
 
+template <typename Callback>
 void Point::for_each_corner_neighborhood_const(
-    const Geometry&                                               geometry,
-    std::function<void(Point_corner_neighborhood_context_const&)> callback
+    const Geometry& geometry,
+    Callback&&      callback
 ) const
 {
     for (uint32_t i = 0; i < corner_count; ++i) {
@@ -283,9 +295,10 @@ void Point::for_each_corner_neighborhood_const(
     }
 }
 
+template <typename Callback>
 void Polygon::for_each_corner(
-    Geometry&                                    geometry,
-    std::function<void(Polygon_corner_context&)> callback
+    Geometry&  geometry,
+    Callback&& callback
 )
 {
     for (
@@ -308,9 +321,10 @@ void Polygon::for_each_corner(
     }
 }
 
+template <typename Callback>
 void Polygon::for_each_corner_const(
-    const Geometry&                                    geometry,
-    std::function<void(Polygon_corner_context_const&)> callback
+    const Geometry& geometry,
+    Callback&&      callback
 ) const
 {
     for (
@@ -333,9 +347,10 @@ void Polygon::for_each_corner_const(
     }
 }
 
+template <typename Callback>
 void Polygon::for_each_corner_neighborhood(
-    Geometry&                                                 geometry,
-    std::function<void(Polygon_corner_neighborhood_context&)> callback
+    Geometry&  geometry,
+    Callback&& callback
 )
 {
     for (uint32_t i = 0; i < corner_count; ++i) {
@@ -364,9 +379,10 @@ void Polygon::for_each_corner_neighborhood(
     }
 }
 
+template <typename Callback>
 void Polygon::for_each_corner_neighborhood_const(
-    const Geometry&                                                 geometry,
-    std::function<void(Polygon_corner_neighborhood_context_const&)> callback
+    const Geometry& geometry,
+    Callback&&      callback
 ) const
 {
     for (uint32_t i = 0; i < corner_count; ++i) {
@@ -395,9 +411,11 @@ void Polygon::for_each_corner_neighborhood_const(
     }
 }
 
+template <typename Callback>
 void Edge::for_each_polygon(
-    Geometry&                                  geometry,
-    std::function<void(Edge_polygon_context&)> callback)
+    Geometry&  geometry,
+    Callback&& callback
+)
 {
     for (
         Edge_polygon_id edge_polygon_id = first_edge_polygon_id,
@@ -419,9 +437,10 @@ void Edge::for_each_polygon(
     }
 }
 
+template <typename Callback>
 void Edge::for_each_polygon_const(
-    const Geometry&                                  geometry,
-    std::function<void(Edge_polygon_context_const&)> callback
+    const Geometry& geometry,
+    Callback&&      callback
 ) const
 {
     for (
@@ -444,4 +463,4 @@ void Edge::for_each_polygon_const(
     }
 }
 
-}
+} // namespace erhe::geometry
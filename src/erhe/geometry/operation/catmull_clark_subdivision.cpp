@@ -3,7 +3,9 @@
 #include "erhe/geometry/geometry_log.hpp"
 #include "erhe/toolkit/profile.hpp"
 
-#include <gsl/assert>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace erhe::geometry::operation
 {
@@ -23,98 +25,177 @@ namespace erhe::geometry::operation
 // For each corner in the old polygon, add one quad
 // (centroid, previous edge 'edge midpoint', corner, next edge 'edge midpoint')
 Catmull_clark_subdivision::Catmull_clark_subdivision(
-    Geometry& src,
-    Geometry& destination
+    Geometry&                       src,
+    Geometry&                       destination,
+    erhe::concurrency::Thread_pool* thread_pool
 )
-    : Geometry_operation{src, destination}
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION
 
-    //                       (n-3)P
-    // Make initial P's with ------
-    //                          n
+    // New point ids are allocated serially, in order: old points, edge
+    // midpoints, polygon centroids. After that sources of new points are
+    // added in parallel; each new point gathers its own sources.
+    const std::size_t point_count   = source.get_point_count();
+    const std::size_t edge_count    = source.get_edge_count();
+    const std::size_t polygon_count = source.get_polygon_count();
+
+    std::vector<Point_id> edge_new_points(edge_count, std::numeric_limits<Point_id>::max());
+    std::vector<Edge_id>  shared_edge_ids; // edges with same end points as a previous edge
+    Point_id              first_polygon_point{0};
     {
-        ERHE_PROFILE_SCOPE("initial points");
+        ERHE_PROFILE_SCOPE("make points");
+
+        const Point_id first_point = make_new_points(point_count);
+        point_old_to_new.resize(point_count);
+        for (Point_id old_point = 0; old_point < point_count; ++old_point) {
+            point_old_to_new[old_point] = first_point + old_point;
+        }
 
-        source.for_each_point_const([&](auto& i)
+        reserve_edge_to_new_points();
+        source.for_each_edge_const([&](auto& i)
         {
-            const auto n = static_cast<float>(i.point.corner_count);
-            if (i.point.corner_count >= 3) {
-                // n = 0   -> centroid points, safe to skip
-                // n = 1,2 -> ?
-                // n = 3   -> ?
-                const float weight = (n - 3.0f) / n;
-                make_new_point_from_point(weight, i.point_id);
+            const Point_id next_point_id = destination.get_point_count();
+            const Point_id new_point_id  = find_or_make_point_from_edge(i.edge.a, i.edge.b);
+            if (new_point_id >= next_point_id) {
+                edge_new_points[i.edge_id] = new_point_id;
             } else {
-                make_new_point_from_point(1.0f, i.point_id);
+                shared_edge_ids.push_back(i.edge_id);
             }
         });
+
+        first_polygon_point = make_new_points(polygon_count);
+        old_polygon_centroid_to_new_points.resize(polygon_count);
+        for (Polygon_id old_polygon = 0; old_polygon < polygon_count; ++old_polygon) {
+            old_polygon_centroid_to_new_points[old_polygon] = first_polygon_point + old_polygon;
+        }
+
+        reserve_point_sources();
     }
 
-    // Make new edge midpoints
+    // Edge midpoints
     // "average of two neighboring face points and original endpoints"
-    // Add midpoint (R) to each new end points
-    //   R = average R of all n edge midpoints for edges touching P
-    //  2R  we add both edge end points with weight 1 so total edge weight is 2
-    //  --
-    //   n
+    const auto add_edge_point_sources = [this](const Edge_id edge_id, const Point_id new_point_id)
     {
-        ERHE_PROFILE_SCOPE("edge midpoints");
-
-        reserve_edge_to_new_points();
-        source.for_each_edge_const([&](auto& i)
+        const Edge& edge = source.edges[edge_id];
+        add_point_source(new_point_id, 1.0f, edge.a);
+        add_point_source(new_point_id, 1.0f, edge.b);
+        edge.for_each_polygon_const(source, [&](auto& j)
         {
-            const Point& src_point_a  = source.points[i.edge.a];
-            const Point& src_point_b  = source.points[i.edge.b];
-            const auto   new_point_id = find_or_make_point_from_edge(i.edge.a, i.edge.b);
-            add_point_source(new_point_id, 1.0f, i.edge.a);
-            add_point_source(new_point_id, 1.0f, i.edge.b);
+            const auto weight = 1.0f / static_cast<float>(j.polygon.corner_count);
+            add_polygon_centroid(new_point_id, weight, j.polygon_id);
+        });
+    };
 
-            i.edge.for_each_polygon_const(source, [&](auto& j)
+    {
+        ERHE_PROFILE_SCOPE("edge midpoints");
+
+        for_each_source_range(
+            edge_count,
+            [&add_edge_point_sources, &edge_new_points](const std::size_t range_begin, const std::size_t range_end)
             {
-                const auto weight = 1.0f / static_cast<float>(j.polygon.corner_count);
-                add_polygon_centroid(new_point_id, weight, j.polygon_id);
-            });
-            const Point_id new_point_a_id = point_old_to_new.at(i.edge.a);
-            const Point_id new_point_b_id = point_old_to_new.at(i.edge.b);
-
-            const float n_a = static_cast<float>(src_point_a.corner_count);
-            const float n_b = static_cast<float>(src_point_b.corner_count);
-            Expects(n_a != 0.0f);
-            Expects(n_b != 0.0f);
-            const float weight_a = 1.0f / n_a;
-            const float weight_b = 1.0f / n_b;
-            add_point_source(new_point_a_id, weight_a, i.edge.a);
-            add_point_source(new_point_a_id, weight_a, i.edge.b);
-            add_point_source(new_point_b_id, weight_b, i.edge.a);
-            add_point_source(new_point_b_id, weight_b, i.edge.b);
-        });
+                for (Edge_id edge_id = static_cast<Edge_id>(range_begin); edge_id < range_end; ++edge_id) {
+                    const Point_id new_point_id = edge_new_points[edge_id];
+                    if (new_point_id != std::numeric_limits<Point_id>::max()) {
+                        add_edge_point_sources(edge_id, new_point_id);
+                    }
+                }
+            }
+        );
+
+        // Edges sharing a midpoint would race on its sources
+        for (const Edge_id edge_id : shared_edge_ids) {
+            const Edge& edge = source.edges[edge_id];
+            add_edge_point_sources(edge_id, get_edge_new_point(edge.a, edge.b));
+        }
     }
 
     {
         ERHE_PROFILE_SCOPE("face points");
 
-        source.for_each_polygon_const([&](auto& i)
-        {
-            const Polygon& src_polygon = source.polygons[i.polygon_id];
+        for_each_source_range(
+            polygon_count,
+            [this, first_polygon_point](const std::size_t range_begin, const std::size_t range_end)
+            {
+                for (Polygon_id old_polygon = static_cast<Polygon_id>(range_begin); old_polygon < range_end; ++old_polygon) {
+                    add_polygon_centroid(first_polygon_point + old_polygon, 1.0f, old_polygon);
+                }
+            }
+        );
+    }
 
-            make_new_point_from_polygon_centroid(i.polygon_id);
+    // New locations for old points
+    //
+    //          (n-3)P
+    // Initial ------
+    //            n
+    //
+    // Add edge midpoints (R) of all n edges touching P
+    //   R = average R of all n edge midpoints for edges touching P
+    //  2R  we add both edge end points with weight 1 so total edge weight is 2
+    //  --
+    //   n
+    //
+    // Add polygon centroids (F) of all polygons touching P
+    // F = average F of all n face points for faces touching P
+    //  F    <- because F is average of all centroids, it adds extra /n
+    // ---
+    //  n
+    {
+        ERHE_PROFILE_SCOPE("old points");
 
-            // Add polygon centroids (F) to all corners' point sources
-            // F = average F of all n face points for faces touching P
-            //  F    <- because F is average of all centroids, it adds extra /n
-            // ---
-            //  n
-            i.polygon.for_each_corner_const(source, [&](auto& j)
+        for_each_source_range(
+            point_count,
+            [this](const std::size_t range_begin, const std::size_t range_end)
             {
-                const Point_id src_point_id = j.corner.point_id;
-                const Point&   src_point    = source.points[src_point_id];
-                const Point_id new_point_id = point_old_to_new[src_point_id];
-                const auto point_weight  = 1.0f / static_cast<float>(src_point.corner_count);
-                const auto corner_weight = 1.0f / static_cast<float>(src_polygon.corner_count);
-                add_polygon_centroid(new_point_id, point_weight * point_weight * corner_weight, i.polygon_id);
-            });
-        });
+                std::vector<Point_id> neighbor_point_ids;
+                for (Point_id old_point_id = static_cast<Point_id>(range_begin); old_point_id < range_end; ++old_point_id) {
+                    const Point&   old_point    = source.points[old_point_id];
+                    const Point_id new_point_id = point_old_to_new[old_point_id];
+                    const auto     n            = static_cast<float>(old_point.corner_count);
+                    if (old_point.corner_count < 3) {
+                        // n = 0   -> centroid points, safe to skip
+                        // n = 1,2 -> ?
+                        add_point_source(new_point_id, 1.0f, old_point_id);
+                        if (old_point.corner_count == 0) {
+                            continue;
+                        }
+                    } else {
+                        add_point_source(new_point_id, (n - 3.0f) / n, old_point_id);
+                    }
+
+                    // Each point connected by an edge, once
+                    neighbor_point_ids.clear();
+                    old_point.for_each_corner_const(source, [&](auto& i)
+                    {
+                        const Polygon& polygon = source.polygons[i.corner.polygon_id];
+                        for (const Corner_id corner_id : { polygon.prev_corner(source, i.corner_id), polygon.next_corner(source, i.corner_id) }) {
+                            const Point_id neighbor_point_id = source.corners[corner_id].point_id;
+                            if (
+                                (neighbor_point_id != old_point_id) &&
+                                (std::find(neighbor_point_ids.begin(), neighbor_point_ids.end(), neighbor_point_id) == neighbor_point_ids.end())
+                            ) {
+                                neighbor_point_ids.push_back(neighbor_point_id);
+                            }
+                        }
+                    });
+
+                    const float point_weight = 1.0f / n;
+                    for (const Point_id neighbor_point_id : neighbor_point_ids) {
+                        add_point_source(new_point_id, point_weight, old_point_id);
+                        add_point_source(new_point_id, point_weight, neighbor_point_id);
+                    }
+
+                    old_point.for_each_corner_const(source, [&](auto& i)
+                    {
+                        const Polygon_id polygon_id    = i.corner.polygon_id;
+                        const Polygon&   polygon       = source.polygons[polygon_id];
+                        const auto       corner_weight = 1.0f / static_cast<float>(polygon.corner_count);
+                        add_polygon_centroid(new_point_id, point_weight * point_weight * corner_weight, polygon_id);
+                    });
+                }
+            }
+        );
     }
 
     // Subdivide polygons, clone (and corners);
@@ -141,13 +222,16 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(
     log_catmull_clark->trace("Done");
 }
 
-auto catmull_clark_subdivision(Geometry& source) -> Geometry
+auto catmull_clark_subdivision(
+    Geometry&                       source,
+    erhe::concurrency::Thread_pool* thread_pool
+) -> Geometry
 {
     return Geometry{
         fmt::format("catmull_clark({})", source.name),
-        [&source](auto& result)
+        [&source, thread_pool](auto& result)
         {
-            Catmull_clark_subdivision operation{source, result};
+            Catmull_clark_subdivision operation{source, result, thread_pool};
         }
     };
 }
@@ -8,11 +8,17 @@ class Catmull_clark_subdivision
     : public Geometry_operation
 {
 public:
-    Catmull_clark_subdivision(Geometry& src, Geometry& destination);
+    Catmull_clark_subdivision(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
+// Interpolates property maps in parallel when thread_pool is not nullptr.
 [[nodiscard]] auto catmull_clark_subdivision(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
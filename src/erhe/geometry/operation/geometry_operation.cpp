@@ -1,10 +1,14 @@
 #include "erhe/geometry/operation/geometry_operation.hpp"
 #include "erhe/geometry/geometry.hpp"
 #include "erhe/geometry/geometry_log.hpp"
+#include "erhe/concurrency/concurrent_queue.hpp"
+#include "erhe/concurrency/task_graph.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 #include <gsl/assert>
+
+#include <algorithm>
 #include <set>
 
 namespace erhe::geometry::operation
@@ -27,22 +31,72 @@ void Geometry_operation::make_points_from_points()
 {
     ERHE_PROFILE_FUNCTION
 
-    point_old_to_new.reserve(source.get_point_count());
-    source.for_each_point_const([&](auto& i)
-    {
-        make_new_point_from_point(i.point_id);
-    });
+    const std::size_t point_count = source.get_point_count();
+    const Point_id    first_point = make_new_points(point_count);
+    point_old_to_new.resize(std::max(point_old_to_new.size(), point_count));
+    reserve_point_sources();
+
+    for_each_source_range(
+        point_count,
+        [this, first_point](const std::size_t range_begin, const std::size_t range_end)
+        {
+            for (Point_id old_point = static_cast<Point_id>(range_begin); old_point < range_end; ++old_point) {
+                const Point_id new_point = first_point + old_point;
+                point_old_to_new[old_point] = new_point;
+                add_point_source(new_point, 1.0f, old_point);
+            }
+        }
+    );
 }
 
 void Geometry_operation::make_polygon_centroids()
 {
     ERHE_PROFILE_FUNCTION
 
-    old_polygon_centroid_to_new_points.reserve(source.get_polygon_count());
-    source.for_each_polygon_const([&](auto& i)
-    {
-        make_new_point_from_polygon_centroid(i.polygon_id);
-    });
+    const std::size_t polygon_count = source.get_polygon_count();
+    const Point_id    first_point   = make_new_points(polygon_count);
+    old_polygon_centroid_to_new_points.resize(std::max(old_polygon_centroid_to_new_points.size(), polygon_count));
+    reserve_point_sources();
+
+    for_each_source_range(
+        polygon_count,
+        [this, first_point](const std::size_t range_begin, const std::size_t range_end)
+        {
+            for (Polygon_id old_polygon = static_cast<Polygon_id>(range_begin); old_polygon < range_end; ++old_polygon) {
+                const Point_id new_point = first_point + old_polygon;
+                old_polygon_centroid_to_new_points[old_polygon] = new_point;
+                add_polygon_centroid(new_point, 1.0f, old_polygon);
+            }
+        }
+    );
+}
+
+auto Geometry_operation::make_new_points(const std::size_t count) -> Point_id
+{
+    const Point_id first_point = destination.get_point_count();
+    for (std::size_t i = 0; i < count; ++i) {
+        destination.make_point();
+    }
+    return first_point;
+}
+
+void Geometry_operation::reserve_point_sources()
+{
+    const std::size_t point_count = destination.get_point_count();
+    if (new_point_sources.size() < point_count) {
+        new_point_sources.resize(point_count);
+    }
+    if (new_point_corner_sources.size() < point_count) {
+        new_point_corner_sources.resize(point_count);
+    }
+}
+
+void Geometry_operation::for_each_source_range(
+    const std::size_t                                              count,
+    const std::function<void(std::size_t begin, std::size_t end)>& function
+)
+{
+    erhe::concurrency::parallel_for(thread_pool, count, s_parallel_source_grain, function);
 }
 
 void Geometry_operation::reserve_edge_to_new_points()
@@ -537,10 +591,47 @@ void Geometry_operation::interpolate_all_property_maps()
     new_polygon_sources.resize(destination.get_polygon_count());
     new_corner_sources .resize(destination.get_corner_count());
     new_edge_sources   .resize(destination.get_edge_count());
-    source.point_attributes()  .interpolate(destination.point_attributes(),   new_point_sources);
-    source.polygon_attributes().interpolate(destination.polygon_attributes(), new_polygon_sources);
-    source.corner_attributes() .interpolate(destination.corner_attributes(),  new_corner_sources);
-    source.edge_attributes()   .interpolate(destination.edge_attributes(),    new_edge_sources);
+
+    if (
+        (thread_pool == nullptr) ||
+        (thread_pool->size() < 2) ||
+        (destination.get_corner_count() < s_parallel_corner_threshold)
+    ) {
+        source.point_attributes()  .interpolate(destination.point_attributes(),   new_point_sources);
+        source.polygon_attributes().interpolate(destination.polygon_attributes(), new_polygon_sources);
+        source.corner_attributes() .interpolate(destination.corner_attributes(),  new_corner_sources);
+        source.edge_attributes()   .interpolate(destination.edge_attributes(),    new_edge_sources);
+        return;
+    }
+
+    ERHE_PROFILE_SCOPE("parallel interpolate");
+
+    // Destination maps are created and sized up front. After that each
+    // task only writes its own key range, so no map is resized concurrently.
+    erhe::concurrency::Concurrent_queue queue{*thread_pool, "interpolate property maps"};
+    const auto enqueue_maps = [&queue](auto& source_attributes, auto& destination_attributes, const auto& key_new_to_olds)
+    {
+        const std::size_t key_count = key_new_to_olds.size();
+        const auto        maps      = source_attributes.make_interpolation_targets(destination_attributes, key_count);
+        for (const auto& map : maps) {
+            for (std::size_t begin = 0; begin < key_count; begin += s_parallel_chunk_size) {
+                const std::size_t end             = std::min(begin + s_parallel_chunk_size, key_count);
+                auto* const       source_map      = map.first;
+                auto* const       destination_map = map.second;
+                queue.enqueue(
+                    [source_map, destination_map, &key_new_to_olds, begin, end]()
+                    {
+                        source_map->interpolate_range(destination_map, key_new_to_olds, begin, end);
+                    }
+                );
+            }
+        }
+    };
+    enqueue_maps(source.point_attributes()  , destination.point_attributes()  , new_point_sources  );
+    enqueue_maps(source.polygon_attributes(), destination.polygon_attributes(), new_polygon_sources);
+    enqueue_maps(source.corner_attributes() , destination.corner_attributes() , new_corner_sources );
+    enqueue_maps(source.edge_attributes()   , destination.edge_attributes()   , new_edge_sources   );
+    queue.wait();
 }
 
 } // namespace erhe::geometry::operation
@@ -2,9 +2,15 @@
 
 #include "erhe/geometry/types.hpp"
 
+#include <functional>
 #include <set>
 #include <vector>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::geometry
 {
     class Geometry;
@@ -17,17 +23,20 @@ class Geometry_operation
 {
 public:
     Geometry_operation(
-        Geometry& source,
-        Geometry& destination
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
     )
         : source     {source}
         , destination{destination}
+        , thread_pool{thread_pool}
     {
     }
 
     static constexpr std::size_t s_grow_size = 4096;
     Geometry&                                              source;
     Geometry&                                              destination;
+    erhe::concurrency::Thread_pool*                        thread_pool{nullptr}; // optional, used for point sources and interpolation
     std::vector<Point_id  >                                point_old_to_new;
     std::vector<Polygon_id>                                polygon_old_to_new;
     std::vector<Corner_id >                                corner_old_to_new;
@@ -40,7 +49,10 @@ public:
     std::vector<std::vector<std::pair<float, Edge_id   >>> new_edge_sources;
 
 private:
-    static constexpr std::size_t s_max_edge_point_slots = 300;
+    static constexpr std::size_t s_max_edge_point_slots      = 300;
+    static constexpr std::size_t s_parallel_corner_threshold = 16384;
+    static constexpr std::size_t s_parallel_chunk_size       = 4096;
+    static constexpr std::size_t s_parallel_source_grain     = 1024;
     std::vector<Point_id> m_old_edge_to_new_points;
 
 public:
@@ -49,6 +61,23 @@ public:
     void make_polygon_centroids    ();
     void reserve_edge_to_new_points();
 
+    // Makes count new points to destination, and returns the first new point.
+    // New point ids are consecutive.
+    auto make_new_points(std::size_t count) -> Point_id;
+
+    // Sizes new point source tables to destination point count. After this
+    // add_point_source() and add_point_corner_source() do not resize them,
+    // and sources of different new points can be added concurrently.
+    void reserve_point_sources();
+
+    // Calls function(begin, end) for subranges of [0, count), in parallel
+    // if thread_pool is set. Function must only add sources to new points
+    // it owns, and reserve_point_sources() must have been called.
+    void for_each_source_range(
+        std::size_t                                                    count,
+        const std::function<void(std::size_t begin, std::size_t end)>& function
+    );
+
     [[nodiscard]] auto find_or_make_point_from_edge(
         Point_id    a,
         Point_id    b,
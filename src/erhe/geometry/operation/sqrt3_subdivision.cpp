@@ -22,19 +22,40 @@ namespace erhe::geometry::operation
 //  (2) S(p) := (1 - alpha_n) p + alpha_n 1/n SUM p_i
 //
 //  (6) alpha_n = (4 - 2 cos(2Pi/n)) / 9
-Sqrt3_subdivision::Sqrt3_subdivision(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Sqrt3_subdivision::Sqrt3_subdivision(
+    Geometry&                       src,
+    Geometry&                       destination,
+    erhe::concurrency::Thread_pool* thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION
 
-    source.for_each_point_const([&](auto& i)
     {
-        const float    alpha            = (4.0f - 2.0f * std::cos(2.0f * glm::pi<float>() / i.point.corner_count)) / 9.0f;
-        const float    alpha_per_n      = alpha / static_cast<float>(i.point.corner_count);
-        const float    alpha_complement = 1.0f - alpha;
-        const Point_id new_point        = make_new_point_from_point(alpha_complement, i.point_id);
-        add_point_ring(new_point, alpha_per_n, i.point_id);
-    });
+        ERHE_PROFILE_SCOPE("refine old points");
+
+        const std::size_t point_count = source.get_point_count();
+        const Point_id    first_point = make_new_points(point_count);
+        point_old_to_new.resize(point_count);
+        reserve_point_sources();
+
+        for_each_source_range(
+            point_count,
+            [this, first_point](const std::size_t range_begin, const std::size_t range_end)
+            {
+                for (Point_id old_point = static_cast<Point_id>(range_begin); old_point < range_end; ++old_point) {
+                    const Point&   point            = source.points[old_point];
+                    const float    alpha            = (4.0f - 2.0f * std::cos(2.0f * glm::pi<float>() / point.corner_count)) / 9.0f;
+                    const float    alpha_per_n      = alpha / static_cast<float>(point.corner_count);
+                    const float    alpha_complement = 1.0f - alpha;
+                    const Point_id new_point        = first_point + old_point;
+                    point_old_to_new[old_point] = new_point;
+                    add_point_source(new_point, alpha_complement, old_point);
+                    add_point_ring  (new_point, alpha_per_n,      old_point);
+                }
+            }
+        );
+    }
 
     make_polygon_centroids();
 
@@ -71,16 +92,18 @@ Sqrt3_subdivision::Sqrt3_subdivision(Geometry& src, Geometry& destination)
     post_processing();
 }
 
-auto sqrt3_subdivision(Geometry& source) -> Geometry
+auto sqrt3_subdivision(
+    Geometry&                       source,
+    erhe::concurrency::Thread_pool* thread_pool
+) -> Geometry
 {
     return Geometry(
         fmt::format("sqrt3({})", source.name),
-        [&source](auto& result)
+        [&source, thread_pool](auto& result)
         {
-            Sqrt3_subdivision operation{source, result};
+            Sqrt3_subdivision operation{source, result, thread_pool};
         }
     );
 }
 
-
 } // namespace erhe::geometry::operation
@@ -8,11 +8,17 @@ class Sqrt3_subdivision
     : public Geometry_operation
 {
 public:
-    Sqrt3_subdivision(Geometry& src, Geometry& destination);
+    Sqrt3_subdivision(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
+// Interpolates property maps in parallel when thread_pool is not nullptr.
 [[nodiscard]] auto sqrt3_subdivision(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
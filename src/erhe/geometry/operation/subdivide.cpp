@@ -12,8 +12,12 @@
 namespace erhe::geometry::operation
 {
 
-Subdivide::Subdivide(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Subdivide::Subdivide(
+    Geometry&                       src,
+    Geometry&                       destination,
+    erhe::concurrency::Thread_pool* thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION
 
@@ -68,16 +72,18 @@ Subdivide::Subdivide(Geometry& src, Geometry& destination)
     post_processing();
 }
 
-auto subdivide(Geometry& source) -> Geometry
+auto subdivide(
+    Geometry&                       source,
+    erhe::concurrency::Thread_pool* thread_pool
+) -> Geometry
 {
     return Geometry{
         fmt::format("subdivide({})", source.name),
-        [&source](auto& result)
+        [&source, thread_pool](auto& result)
         {
-            Subdivide operation{source, result};
+            Subdivide operation{source, result, thread_pool};
         }
     };
 }
 
-
 } // namespace erhe::geometry::operation
@@ -10,11 +10,17 @@ class Subdivide
     : public Geometry_operation
 {
 public:
-    Subdivide(Geometry& src, Geometry& destination);
+    Subdivide(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
+// Interpolates property maps in parallel when thread_pool is not nullptr.
 [[nodiscard]] auto subdivide(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -25,17 +25,30 @@ auto Polygon::compute_normal(
     }
 
     vec3 newell_normal{0.0f};
-    for_each_corner_neighborhood_const(
-        geometry,
-        [&newell_normal, &point_locations](const Polygon_corner_neighborhood_context_const& i)
-        {
-            const Point_id a     = i.corner     .point_id;
-            const Point_id b     = i.next_corner.point_id;
-            const auto     pos_a = point_locations.get(a);
-            const auto     pos_b = point_locations.get(b);
-            newell_normal += glm::cross(pos_a, pos_b);
-        }
-    );
+    if (point_locations.is_dense()) {
+        const auto locations = point_locations.dense_values();
+        for_each_corner_neighborhood_const(
+            geometry,
+            [&newell_normal, &locations](const Polygon_corner_neighborhood_context_const& i)
+            {
+                const auto& pos_a = locations[i.corner     .point_id];
+                const auto& pos_b = locations[i.next_corner.point_id];
+                newell_normal += glm::cross(pos_a, pos_b);
+            }
+        );
+    } else {
+        for_each_corner_neighborhood_const(
+            geometry,
+            [&newell_normal, &point_locations](const Polygon_corner_neighborhood_context_const& i)
+            {
+                const Point_id a     = i.corner     .point_id;
+                const Point_id b     = i.next_corner.point_id;
+                const auto     pos_a = point_locations.get(a);
+                const auto     pos_b = point_locations.get(b);
+                newell_normal += glm::cross(pos_a, pos_b);
+            }
+        );
+    }
 
     newell_normal = glm::normalize(newell_normal);
     return newell_normal;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <gsl/span>
 
 #include <algorithm>
 #include <cassert>
@@ -51,6 +52,8 @@ public:
     virtual auto empty     () const -> bool = 0;
     virtual auto size      () const -> std::size_t = 0;
     virtual auto has       (Key_type key) const -> bool = 0;
+    virtual auto is_dense  () const -> bool = 0;
+    virtual auto make_dense(std::size_t key_count) -> bool = 0;
     virtual void trim      (std::size_t size) = 0;
     virtual void remap_keys(const std::vector<Key_type>& key_old_to_new) = 0;
 
@@ -59,6 +62,16 @@ public:
         const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
     ) const = 0;
 
+    // Interpolates destination keys [begin, end). Destination must already
+    // be trimmed to key_new_to_olds.size(). Disjoint key ranges can be
+    // interpolated from multiple threads concurrently.
+    virtual void interpolate_range(
+        Property_map_base<Key_type>*                                destination,
+        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+        std::size_t                                                 begin,
+        std::size_t                                                 end
+    ) const = 0;
+
     virtual void transform  (const glm::mat4 matrix) = 0;
     virtual void import_from(Property_map_base<Key_type>* source) = 0;
     virtual void import_from(Property_map_base<Key_type>* source, const glm::mat4 transform) = 0;
@@ -87,6 +100,9 @@ public:
     auto get       (Key_type key) const -> Value_type;
     auto maybe_get (Key_type key, Value_type& out_value) const -> bool;
     auto has       (Key_type key) const -> bool final;
+    auto is_dense  () const -> bool final;
+    auto make_dense(std::size_t key_count) -> bool final;
+    void make_sparse();
     void clear     () final;
     auto empty     () const -> bool final;
     auto size      () const -> std::size_t final;
@@ -98,18 +114,35 @@ public:
         const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
     ) const final;
 
+    void interpolate_range(
+        Property_map_base<Key_type>*                                destination,
+        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+        std::size_t                                                 begin,
+        std::size_t                                                 end
+    ) const final;
+
     void transform  (const glm::mat4 matrix) final;
     void import_from(Property_map_base<Key_type>* source) final;
     void import_from(Property_map_base<Key_type>* source, const glm::mat4 transform) final;
     auto constructor(const Property_map_descriptor& descriptor) const -> Property_map_base<Key_type>* final;
 
+    // Values of dense map. Only valid in dense mode.
+    [[nodiscard]] auto dense_values()       -> gsl::span<Value_type>;
+    [[nodiscard]] auto dense_values() const -> gsl::span<const Value_type>;
+
     static constexpr std::size_t s_grow_size = 4096;
 
     std::vector<Value_type> values;
-    std::vector<bool>       present; // Yes, I know vector<bool> has limitations
+    std::vector<uint8_t>    present; // Empty in dense mode
 
 private:
+    void import_presence_from(const Property_map<Key_type, Value_type>& source);
+
     Property_map_descriptor m_descriptor;
+
+    // In dense mode all keys below values.size() are present, and presence is
+    // not tracked. Changes which would leave missing keys switch to sparse mode.
+    bool                    m_dense{false};
 };
 
 } // namespace erhe::geometry
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "erhe/geometry/vec3_soa.hpp"
+
 #include <algorithm>
 
 #ifndef ERHE_PROFILE_FUNCTION
@@ -33,6 +35,7 @@ Property_map<Key_type, Value_type>::clear()
 
     values.clear();
     present.clear();
+    m_dense = false;
 }
 
 template <typename Key_type, typename Value_type>
@@ -53,8 +56,77 @@ template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::trim(std::size_t size)
 {
+    if (m_dense && (size > values.size())) {
+        make_sparse();
+    }
     values.resize(size);
-    present.resize(size);
+    if (!m_dense) {
+        present.resize(size);
+    }
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::is_dense() const -> bool
+{
+    return m_dense;
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::make_dense(const std::size_t key_count) -> bool
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (m_dense) {
+        if (values.size() < key_count) {
+            return false;
+        }
+        values.resize(key_count);
+        return true;
+    }
+
+    if (values.size() < key_count) {
+        return false;
+    }
+    for (std::size_t i = 0; i < key_count; ++i) {
+        if (present[i] == 0) {
+            return false;
+        }
+    }
+    values.resize(key_count);
+    values.shrink_to_fit();
+    present.clear();
+    present.shrink_to_fit();
+    m_dense = true;
+    return true;
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::make_sparse()
+{
+    if (!m_dense) {
+        return;
+    }
+    present.assign(values.size(), 1);
+    m_dense = false;
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::dense_values() -> gsl::span<Value_type>
+{
+    ERHE_VERIFY(m_dense);
+    return gsl::span<Value_type>{values.data(), values.size()};
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::dense_values() const -> gsl::span<const Value_type>
+{
+    ERHE_VERIFY(m_dense);
+    return gsl::span<const Value_type>{values.data(), values.size()};
 }
 
 template <typename Key_type, typename Value_type>
@@ -66,8 +138,10 @@ Property_map<Key_type, Value_type>::remap_keys(const std::vector<Key_type>& key_
     for (Key_type new_key = 0, end = static_cast<Key_type>(key_new_to_old.size()); new_key < end; ++new_key)
     {
         Key_type old_key = key_new_to_old[new_key];
-        values [new_key] = old_values[old_key];
-        present[new_key] = old_present[old_key];
+        values[new_key] = old_values[old_key];
+        if (!m_dense) {
+            present[new_key] = old_present[old_key];
+        }
     }
 }
 
@@ -75,25 +149,28 @@ template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::put(Key_type key, Value_type value)
 {
-    ERHE_PROFILE_FUNCTION
-
     const std::size_t i = static_cast<std::size_t>(key);
+    if (m_dense) {
+        if (i < values.size()) {
+            values[i] = value;
+            return;
+        }
+        make_sparse();
+    }
     if (values.size() <= i) {
         values.resize(i + s_grow_size);
         present.resize(i + s_grow_size);
     }
     values[i] = value;
-    present[i] = true;
+    present[i] = 1;
 }
 
 template <typename Key_type, typename Value_type>
 inline auto
 Property_map<Key_type, Value_type>::get(Key_type key) const -> Value_type
 {
-    ERHE_PROFILE_FUNCTION
-
     const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || (!m_dense && (present[i] == 0))) {
         ERHE_FATAL("Value not found");
     }
     return values[i];
@@ -103,24 +180,22 @@ template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::erase(Key_type key)
 {
-    ERHE_PROFILE_FUNCTION
+    make_sparse();
 
     const std::size_t i = static_cast<std::size_t>(key);
     if (values.size() <= i) {
         values.resize(i + s_grow_size);
         present.resize(i + s_grow_size);
     }
-    present[i] = false;
+    present[i] = 0;
 }
 
 template <typename Key_type, typename Value_type>
 inline auto
 Property_map<Key_type, Value_type>::maybe_get(Key_type key, Value_type& out_value) const -> bool
 {
-    ERHE_PROFILE_FUNCTION
-
     const std::size_t i = static_cast<size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || (!m_dense && (present[i] == 0))) {
         return false;
     }
     out_value = values[i];
@@ -132,10 +207,8 @@ template <typename Key_type, typename Value_type>
 inline auto
 Property_map<Key_type, Value_type>::has(Key_type key) const -> bool
 {
-    ERHE_PROFILE_FUNCTION
-
     const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || (!m_dense && (present[i] == 0))) {
         return false;
     }
     return true;
@@ -163,19 +236,33 @@ Property_map<Key_type, Value_type>::interpolate(
 {
     ERHE_PROFILE_FUNCTION
 
+    if (m_descriptor.interpolation_mode == Interpolation_mode::none) {
+        SPDLOG_LOGGER_TRACE(log_interpolate, "\tinterpolation mode none, skipping this map");
+        return;
+    }
+
+    destination_base->trim(key_new_to_olds.size());
+    interpolate_range(destination_base, key_new_to_olds, 0, key_new_to_olds.size());
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::interpolate_range(
+    Property_map_base<Key_type>*                                destination_base,
+    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+    const std::size_t                                           begin,
+    const std::size_t                                           end
+) const
+{
     auto* destination = dynamic_cast<Property_map<Key_type, Value_type>*>(destination_base);
     ERHE_VERIFY(destination != nullptr);
+    ERHE_VERIFY(destination->size() >= end);
 
     if (m_descriptor.interpolation_mode == Interpolation_mode::none) {
-        SPDLOG_LOGGER_TRACE(log_interpolate, "\tinterpolation mode none, skipping this map");
         return;
     }
 
-    for (
-        std::size_t new_key = 0, end = key_new_to_olds.size();
-        new_key < end;
-        ++new_key
-    ) {
+    for (std::size_t new_key = begin; new_key < end; ++new_key) {
         const std::vector<std::pair<float, Key_type>>& old_keys = key_new_to_olds[new_key];
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "\tkey = {} from", new_key);
@@ -262,6 +349,33 @@ template <>           struct transform_properties<glm::vec2> { static const bool
 template <>           struct transform_properties<glm::vec3> { static const bool is_transformable = true;  };
 template <>           struct transform_properties<glm::vec4> { static const bool is_transformable = true;  };
 
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::import_presence_from(
+    const Property_map<Key_type, Value_type>& source
+)
+{
+    ERHE_VERIFY(m_dense || (values.size() == present.size()));
+    ERHE_VERIFY(source.m_dense || (source.values.size() == source.present.size()));
+
+    // Importing to empty map keeps source mode
+    if (values.empty()) {
+        present.clear();
+        m_dense = source.m_dense;
+    }
+    if (m_dense && source.m_dense) {
+        return;
+    }
+
+    make_sparse();
+    present.reserve(present.size() + source.values.size());
+    if (source.m_dense) {
+        present.insert(present.end(), source.values.size(), 1);
+    } else {
+        present.insert(present.end(), source.present.begin(), source.present.end());
+    }
+}
+
 template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::import_from(
@@ -273,12 +387,7 @@ Property_map<Key_type, Value_type>::import_from(
     const auto* const source = dynamic_cast<Property_map<Key_type, Value_type>*>(source_base);
     ERHE_VERIFY(source != nullptr);
 
-    ERHE_VERIFY(values.size() == present.size());
-    ERHE_VERIFY(source->values.size() == source->present.size());
-
-    values .reserve(values.size()  + source->values.size());
-    present.reserve(present.size() + source->present.size());
-    present.insert(present.end(), source->present.begin(), source->present.end());
+    import_presence_from(*source);
     values.insert(values.end(), source->values.begin(), source->values.end());
 }
 
@@ -290,7 +399,7 @@ Property_map<Key_type, Value_type>::transform(
 {
     ERHE_PROFILE_FUNCTION
 
-    ERHE_VERIFY(values.size() == present.size());
+    ERHE_VERIFY(m_dense || (values.size() == present.size()));
 
     if constexpr(transform_properties<Value_type>::is_transformable) {
         switch (m_descriptor.transform_mode) {
@@ -301,8 +410,15 @@ Property_map<Key_type, Value_type>::transform(
             }
 
             case Transform_mode::matrix: {
-                for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                    values[i] = apply_transform(values[i], transform, 1.0f);
+                if constexpr (std::is_same_v<Value_type, glm::vec3>) {
+                    Vec3_soa soa;
+                    soa.load(values);
+                    soa.transform_points(transform);
+                    soa.store(values);
+                } else {
+                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
+                        values[i] = apply_transform(values[i], transform, 1.0f);
+                    }
                 }
                 break;
             }
@@ -311,15 +427,11 @@ Property_map<Key_type, Value_type>::transform(
             case Transform_mode::normalize_inverse_transpose_matrix: {
                 if constexpr (std::is_same_v<Value_type, glm::vec3>) {
                     const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                        values[i] = glm::normalize(
-                            apply_transform(
-                                values[i],
-                                inverse_transpose_transform,
-                                0.0f
-                            )
-                        );
-                    }
+                    Vec3_soa soa;
+                    soa.load(values);
+                    soa.transform_directions(inverse_transpose_transform);
+                    soa.normalize();
+                    soa.store(values);
                 }
                 break;
             }
@@ -361,14 +473,8 @@ Property_map<Key_type, Value_type>::import_from(
     auto* source = dynamic_cast<Property_map<Key_type, Value_type>*>(source_base);
     ERHE_VERIFY(source != nullptr);
 
-    ERHE_VERIFY(values.size() == present.size());
-    ERHE_VERIFY(source->values.size() == source->present.size());
-
-    const auto combined_values_size = values.size()  + source->values.size();
-    const auto combined_present_size = present.size() + source->present.size();
-    values .reserve(combined_values_size);
-    present.reserve(combined_present_size);
-    present.insert(present.end(), source->present.begin(), source->present.end());
+    import_presence_from(*source);
+    values.reserve(values.size() + source->values.size());
     if constexpr(!transform_properties<Value_type>::is_transformable) {
         values.insert(values.end(), source->values.begin(), source->values.end());
     } else {
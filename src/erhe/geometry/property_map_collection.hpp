@@ -80,12 +80,21 @@ public:
     ) -> Property_map<Key_type, Value_type>*;
 
     void trim      (size_t size);
+    void make_dense(size_t key_count);
     void remap_keys(const std::vector<Key_type>& key_new_to_old);
     void interpolate(
         Property_map_collection<Key_type>&                          destination,
         const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
     );
 
+    // Creates and inserts destination maps for all interpolated maps, sized
+    // for key_count keys. Returns (source, destination) map pairs, to be
+    // filled with Property_map_base::interpolate_range().
+    auto make_interpolation_targets(
+        Property_map_collection<Key_type>& destination,
+        std::size_t                        key_count
+    ) -> std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>>;
+
     void merge_to            (Property_map_collection<Key_type>& source, const glm::mat4 transform);
     auto clone               () -> Property_map_collection<Key_type>;
     void transform           (const glm::mat4 matrix);
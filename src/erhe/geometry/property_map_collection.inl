@@ -184,6 +184,17 @@ Property_map_collection<Key_type>::trim(size_t size)
     }
 }
 
+template <typename Key_type>
+inline void
+Property_map_collection<Key_type>::make_dense(size_t key_count)
+{
+    ERHE_PROFILE_FUNCTION
+
+    for (auto& entry : m_entries) {
+        static_cast<void>(entry.value->make_dense(key_count));
+    }
+}
+
 template <typename Key_type>
 inline void
 Property_map_collection<Key_type>::remap_keys(const std::vector<Key_type>& key_new_to_old)
@@ -203,6 +214,21 @@ Property_map_collection<Key_type>::interpolate(
 {
     ERHE_PROFILE_FUNCTION
 
+    const auto maps = make_interpolation_targets(destination, key_new_to_olds.size());
+    for (const auto& map : maps) {
+        SPDLOG_LOGGER_TRACE(log_interpolate, "interpolating {}", map.first->descriptor().name);
+        map.first->interpolate(map.second, key_new_to_olds);
+    }
+}
+
+template <typename Key_type>
+inline auto
+Property_map_collection<Key_type>::make_interpolation_targets(
+    Property_map_collection<Key_type>& destination,
+    const std::size_t                  key_count
+) -> std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>>
+{
+    std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>> result;
     for (auto& entry : m_entries) {
         Property_map_base<Key_type>* src_map    = entry.value.get();
         const auto&                  descriptor = src_map->descriptor();
@@ -210,12 +236,11 @@ Property_map_collection<Key_type>::interpolate(
             continue;
         }
         Property_map_base<Key_type>* destination_map = src_map->constructor(descriptor);
-
-        SPDLOG_LOGGER_TRACE(log_interpolate, "interpolating {}", src_map->descriptor().name);
-        src_map->interpolate(destination_map, key_new_to_olds);
-
+        destination_map->trim(key_count);
         destination.insert(destination_map);
+        result.emplace_back(src_map, destination_map);
     }
+    return result;
 }
 
 template <typename Key_type>
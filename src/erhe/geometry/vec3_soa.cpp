@@ -0,0 +1,120 @@
+#include "erhe/geometry/vec3_soa.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <cmath>
+
+namespace erhe::geometry
+{
+
+void Vec3_soa::resize(const std::size_t size)
+{
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+}
+
+auto Vec3_soa::size() const -> std::size_t
+{
+    return x.size();
+}
+
+void Vec3_soa::load(const gsl::span<const glm::vec3> values)
+{
+    ERHE_PROFILE_FUNCTION
+
+    const std::size_t count = values.size();
+    resize(count);
+    float* const     px  = x.data();
+    float* const     py  = y.data();
+    float* const     pz  = z.data();
+    const glm::vec3* src = values.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        px[i] = src[i].x;
+        py[i] = src[i].y;
+        pz[i] = src[i].z;
+    }
+}
+
+void Vec3_soa::store(const gsl::span<glm::vec3> values) const
+{
+    ERHE_PROFILE_FUNCTION
+
+    const std::size_t count = values.size();
+    ERHE_VERIFY(count == size());
+    const float* const px  = x.data();
+    const float* const py  = y.data();
+    const float* const pz  = z.data();
+    glm::vec3*         dst = values.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i].x = px[i];
+        dst[i].y = py[i];
+        dst[i].z = pz[i];
+    }
+}
+
+void Vec3_soa::transform_points(const glm::mat4& m)
+{
+    ERHE_PROFILE_FUNCTION
+
+    const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+    const float m30 = m[3][0], m31 = m[3][1], m32 = m[3][2];
+
+    const std::size_t count = size();
+    float* const px = x.data();
+    float* const py = y.data();
+    float* const pz = z.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        const float vx = px[i];
+        const float vy = py[i];
+        const float vz = pz[i];
+        px[i] = (m00 * vx + m10 * vy) + (m20 * vz + m30);
+        py[i] = (m01 * vx + m11 * vy) + (m21 * vz + m31);
+        pz[i] = (m02 * vx + m12 * vy) + (m22 * vz + m32);
+    }
+}
+
+void Vec3_soa::transform_directions(const glm::mat4& m)
+{
+    ERHE_PROFILE_FUNCTION
+
+    const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+
+    const std::size_t count = size();
+    float* const px = x.data();
+    float* const py = y.data();
+    float* const pz = z.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        const float vx = px[i];
+        const float vy = py[i];
+        const float vz = pz[i];
+        px[i] = (m00 * vx + m10 * vy) + m20 * vz;
+        py[i] = (m01 * vx + m11 * vy) + m21 * vz;
+        pz[i] = (m02 * vx + m12 * vy) + m22 * vz;
+    }
+}
+
+void Vec3_soa::normalize()
+{
+    ERHE_PROFILE_FUNCTION
+
+    const std::size_t count = size();
+    float* const px = x.data();
+    float* const py = y.data();
+    float* const pz = z.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        const float vx    = px[i];
+        const float vy    = py[i];
+        const float vz    = pz[i];
+        const float scale = 1.0f / std::sqrt(vx * vx + vy * vy + vz * vz);
+        px[i] = vx * scale;
+        py[i] = vy * scale;
+        pz[i] = vz * scale;
+    }
+}
+
+} // namespace erhe::geometry
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <gsl/span>
+
+#include <cstddef>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+// Structure of arrays storage for vec3 values. Loops over separate
+// x, y and z arrays can be vectorized by the compiler, unlike loops
+// over interleaved glm::vec3 values.
+class Vec3_soa
+{
+public:
+    void resize(std::size_t size);
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    void load (gsl::span<const glm::vec3> values);
+    void store(gsl::span<glm::vec3> values) const;
+
+    // vec3{m * vec4{v, 1}}
+    void transform_points(const glm::mat4& m);
+
+    // vec3{m * vec4{v, 0}}
+    void transform_directions(const glm::mat4& m);
+
+    void normalize();
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+} // namespace erhe::geometry
@@ -6,11 +6,13 @@
 #include "erhe/gl/wrapper_functions.hpp"
 #include "erhe/graphics/graphics_log.hpp"
 #include "erhe/graphics/instance.hpp"
+#include "erhe/graphics/range_allocator.hpp"
 #include "erhe/toolkit/bit_helpers.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -168,7 +170,7 @@ Buffer::Buffer(Buffer&& other) noexcept
     m_debug_label            = std::move(other.m_debug_label);
     m_target                 = other.m_target;
     m_capacity_byte_count    = other.m_capacity_byte_count;
-    m_next_free_byte         = other.m_next_free_byte;
+    m_allocator              = std::move(other.m_allocator);
     m_storage_mask           = other.m_storage_mask;
     m_access_mask            = other.m_access_mask;
     m_map                    = other.m_map;
@@ -183,7 +185,7 @@ auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
     m_debug_label            = std::move(other.m_debug_label);
     m_target                 = other.m_target;
     m_capacity_byte_count    = other.m_capacity_byte_count;
-    m_next_free_byte         = other.m_next_free_byte;
+    m_allocator              = std::move(other.m_allocator);
     m_storage_mask           = other.m_storage_mask;
     m_access_mask            = other.m_access_mask;
     m_map                    = other.m_map;
@@ -219,6 +221,23 @@ auto Buffer::debug_label() const noexcept -> const std::string&
     return m_debug_label;
 }
 
+auto Buffer::get_or_create_allocator() -> Range_allocator&
+{
+    // Caller must hold m_allocate_mutex
+    if (!m_allocator) {
+        m_allocator = std::make_unique<Range_allocator>(
+            m_capacity_byte_count,
+            m_debug_label.empty() ? fmt::format("(B) {}", gl_name()) : m_debug_label
+        );
+    }
+    return *m_allocator.get();
+}
+
+auto Buffer::get_allocator() const noexcept -> Range_allocator*
+{
+    return m_allocator.get();
+}
+
 auto Buffer::allocate_bytes(
     const std::size_t byte_count,
     const std::size_t alignment
@@ -228,17 +247,89 @@ auto Buffer::allocate_bytes(
 
     const std::lock_guard<std::mutex> lock{m_allocate_mutex};
 
-    while ((m_next_free_byte % alignment) != 0) {
-        ++m_next_free_byte;
-    }
-    const auto offset = m_next_free_byte;
-    m_next_free_byte += byte_count;
-    ERHE_VERIFY(m_next_free_byte <= m_capacity_byte_count);
+    const auto offset = get_or_create_allocator().allocate_pinned(byte_count, alignment);
+    ERHE_VERIFY(offset != Range_allocator::invalid_offset);
 
     log_buffer->trace("buffer {}: allocated {} bytes at offset {}", gl_name(), byte_count, offset);
     return offset;
 }
 
+auto Buffer::allocate_range(
+    const std::size_t byte_count,
+    const std::size_t alignment
+) noexcept -> std::shared_ptr<Range_allocation>
+{
+    ERHE_VERIFY(alignment > 0);
+
+    const std::lock_guard<std::mutex> lock{m_allocate_mutex};
+
+    return get_or_create_allocator().allocate(byte_count, alignment);
+}
+
+auto Buffer::compact_ranges() noexcept -> std::size_t
+{
+    const std::lock_guard<std::mutex> lock{m_allocate_mutex};
+
+    if (!m_allocator) {
+        return 0;
+    }
+
+    const auto moves = m_allocator->compact();
+    if (moves.empty()) {
+        return 0;
+    }
+
+    // Copy within same buffer is not allowed to overlap; moves which
+    // overlap with their own source go through a scratch buffer.
+    std::size_t scratch_byte_count{0};
+    for (const auto& move : moves) {
+        if (move.src_byte_offset - move.dst_byte_offset < move.byte_count) {
+            scratch_byte_count = std::max(scratch_byte_count, move.byte_count);
+        }
+    }
+    std::unique_ptr<Buffer> scratch_buffer;
+    if (scratch_byte_count > 0) {
+        scratch_buffer = std::make_unique<Buffer>(
+            gl::Buffer_target::copy_write_buffer,
+            scratch_byte_count,
+            gl::Buffer_storage_mask{0}
+        );
+    }
+
+    std::size_t moved_byte_count{0};
+    for (const auto& move : moves) {
+        const bool overlaps = move.src_byte_offset - move.dst_byte_offset < move.byte_count;
+        if (overlaps) {
+            gl::copy_named_buffer_sub_data(
+                gl_name(),
+                scratch_buffer->gl_name(),
+                static_cast<GLintptr>  (move.src_byte_offset),
+                0,
+                static_cast<GLsizeiptr>(move.byte_count)
+            );
+            gl::copy_named_buffer_sub_data(
+                scratch_buffer->gl_name(),
+                gl_name(),
+                0,
+                static_cast<GLintptr>  (move.dst_byte_offset),
+                static_cast<GLsizeiptr>(move.byte_count)
+            );
+        } else {
+            gl::copy_named_buffer_sub_data(
+                gl_name(),
+                gl_name(),
+                static_cast<GLintptr>  (move.src_byte_offset),
+                static_cast<GLintptr>  (move.dst_byte_offset),
+                static_cast<GLsizeiptr>(move.byte_count)
+            );
+        }
+        moved_byte_count += move.byte_count;
+    }
+
+    log_buffer->info("buffer {}: compacted, moved {} ranges, {} bytes", gl_name(), moves.size(), moved_byte_count);
+    return moved_byte_count;
+}
+
 auto Buffer::begin_write(const std::size_t byte_offset, std::size_t byte_count) noexcept -> gsl::span<std::byte>
 {
     Expects(gl_name() != 0);
@@ -567,7 +658,9 @@ void Buffer::flush_and_unmap_bytes(const std::size_t byte_count) noexcept
 
 auto Buffer::free_capacity_bytes() const noexcept -> std::size_t
 {
-    return m_capacity_byte_count - m_next_free_byte;
+    return m_allocator
+        ? m_allocator->get_stats().free_byte_count
+        : m_capacity_byte_count;
 }
 
 auto Buffer::capacity_byte_count() const noexcept -> std::size_t
@@ -5,6 +5,7 @@
 
 #include <gsl/span>
 
+#include <memory>
 #include <string_view>
 #include <mutex>
 #include <vector>
@@ -12,6 +13,9 @@
 namespace erhe::graphics
 {
 
+class Range_allocation;
+class Range_allocator;
+
 class Buffer final
 {
 public:
@@ -48,7 +52,9 @@ public:
     [[nodiscard]] auto debug_label        () const noexcept -> const std::string&;
     [[nodiscard]] auto capacity_byte_count() const noexcept -> std::size_t;
     [[nodiscard]] auto allocate_bytes     (std::size_t byte_count, std::size_t alignment = 64) noexcept -> std::size_t;
+    [[nodiscard]] auto allocate_range     (std::size_t byte_count, std::size_t alignment = 64) noexcept -> std::shared_ptr<Range_allocation>;
     [[nodiscard]] auto free_capacity_bytes() const noexcept -> std::size_t;
+    [[nodiscard]] auto get_allocator      () const noexcept -> Range_allocator*;
     [[nodiscard]] auto target             () const noexcept -> gl::Buffer_target;
     [[nodiscard]] auto gl_name            () const noexcept -> unsigned int;
     void unmap                () noexcept;
@@ -57,6 +63,11 @@ public:
     void set_debug_label      (const std::string_view label) noexcept;
     void dump                 () const noexcept;
 
+    // Moves ranges allocated with allocate_range() towards the start of the
+    // buffer, using GPU side copies. Pending writes to the buffer must have
+    // been flushed before calling this. Returns number of bytes moved.
+    auto compact_ranges() noexcept -> std::size_t;
+
     auto begin_write(std::size_t byte_offset, std::size_t byte_count) noexcept -> gsl::span<std::byte>;
     void end_write  (std::size_t byte_offset, std::size_t byte_count) noexcept;
 
@@ -94,21 +105,22 @@ private:
     void allocate_storage();
     void capability_check(gl::Buffer_storage_mask storage_mask);
     void capability_check(gl::Map_buffer_access_mask access_mask);
+    [[nodiscard]] auto get_or_create_allocator() -> Range_allocator&;
 
-    Gl_buffer                  m_handle;
-    std::string                m_debug_label;
-    gl::Buffer_target          m_target             {gl::Buffer_target::array_buffer};
-    std::size_t                m_capacity_byte_count{0};
-    std::size_t                m_next_free_byte     {0};
-    gl::Buffer_storage_mask    m_storage_mask       {0};
-    gl::Map_buffer_access_mask m_access_mask        {0};
-    std::mutex                 m_allocate_mutex;
+    Gl_buffer                        m_handle;
+    std::string                      m_debug_label;
+    gl::Buffer_target                m_target             {gl::Buffer_target::array_buffer};
+    std::size_t                      m_capacity_byte_count{0};
+    gl::Buffer_storage_mask          m_storage_mask       {0};
+    gl::Map_buffer_access_mask       m_access_mask        {0};
+    std::mutex                       m_allocate_mutex;
+    std::unique_ptr<Range_allocator> m_allocator;
 
     // Last MapBuffer
-    gsl::span<std::byte>       m_map;
-    std::size_t                m_map_byte_offset       {0};
-    gl::Map_buffer_access_mask m_map_buffer_access_mask{0};
-    //std::vector<uint8_t>       m_cpu_copy;
+    gsl::span<std::byte>             m_map;
+    std::size_t                      m_map_byte_offset       {0};
+    gl::Map_buffer_access_mask       m_map_buffer_access_mask{0};
+    //std::vector<uint8_t>           m_cpu_copy;
 };
 
 class Buffer_hash
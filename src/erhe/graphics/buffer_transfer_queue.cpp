@@ -1,23 +1,78 @@
 #include "erhe/graphics/buffer_transfer_queue.hpp"
 #include "erhe/gl/enum_bit_mask_operators.hpp"
+#include "erhe/gl/wrapper_functions.hpp"
 #include "erhe/graphics/buffer.hpp"
 #include "erhe/graphics/graphics_log.hpp"
+#include "erhe/graphics/instance.hpp"
 #include "erhe/graphics/scoped_buffer_mapping.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 namespace erhe::graphics
 {
 
+namespace {
+
+constexpr std::size_t staging_alignment = 16;
+constexpr std::size_t invalid_offset    = static_cast<std::size_t>(-1);
+
+}
+
 Buffer_transfer_queue::Buffer_transfer_queue()
 {
 }
 
+Buffer_transfer_queue::Buffer_transfer_queue(const std::size_t staging_byte_count)
+{
+    if (!Instance::info.use_persistent_buffers) {
+        log_buffer->info("Persistent buffers are not in use, buffer transfer queue will not use staging buffer");
+        return;
+    }
+
+    static constexpr gl::Buffer_storage_mask storage_mask{
+        gl::Buffer_storage_mask::map_coherent_bit   |
+        gl::Buffer_storage_mask::map_persistent_bit |
+        gl::Buffer_storage_mask::map_write_bit
+    };
+    static constexpr gl::Map_buffer_access_mask access_mask{
+        gl::Map_buffer_access_mask::map_coherent_bit   |
+        gl::Map_buffer_access_mask::map_persistent_bit |
+        gl::Map_buffer_access_mask::map_write_bit
+    };
+
+    m_staging_buffer = std::make_unique<Buffer>(
+        gl::Buffer_target::copy_read_buffer,
+        staging_byte_count,
+        storage_mask,
+        access_mask,
+        "Buffer_transfer_queue staging"
+    );
+    const auto map = m_staging_buffer->map();
+    m_staging_map = gsl::span<std::uint8_t>{
+        reinterpret_cast<std::uint8_t*>(map.data()),
+        map.size_bytes()
+    };
+    ERHE_VERIFY(m_staging_map.size() == staging_byte_count);
+}
+
 Buffer_transfer_queue::~Buffer_transfer_queue() noexcept
 {
     flush();
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    for (const auto& fence : m_fences) {
+        gl::delete_sync(fence.sync);
+    }
+    m_fences.clear();
+}
+
+auto Buffer_transfer_queue::has_staging() const -> bool
+{
+    return static_cast<bool>(m_staging_buffer);
 }
 
 void Buffer_transfer_queue::enqueue(
@@ -34,7 +89,236 @@ void Buffer_transfer_queue::enqueue(
         offset,
         data.size()
     );
-    m_queued.emplace_back(buffer, offset, std::move(data));
+    m_queued.emplace_back(buffer, offset, std::move(data), m_sequence++);
+}
+
+auto Buffer_transfer_queue::reserve_staging(std::size_t byte_count) -> std::size_t
+{
+    // Caller must hold m_mutex
+    const std::size_t capacity = m_staging_map.size();
+    byte_count = ((byte_count + staging_alignment - 1) / staging_alignment) * staging_alignment;
+    if (byte_count > capacity) {
+        return invalid_offset;
+    }
+
+    if (m_staging_entries.empty()) {
+        m_staging_head = 0;
+    }
+
+    // Ring is full when head would reach tail, so head == tail only when empty
+    const std::size_t tail = m_staging_entries.empty()
+        ? m_staging_head
+        : m_staging_entries.front().staging_offset;
+
+    std::size_t offset{invalid_offset};
+    if (m_staging_head >= tail) {
+        if (m_staging_head + byte_count <= capacity) {
+            offset = m_staging_head;
+        } else if (byte_count < tail) {
+            offset = 0;
+        }
+    } else if (m_staging_head + byte_count < tail) {
+        offset = m_staging_head;
+    }
+
+    if (offset != invalid_offset) {
+        m_staging_head = offset + byte_count;
+    }
+    return offset;
+}
+
+void Buffer_transfer_queue::reclaim_staging()
+{
+    // Caller must hold m_mutex
+    while (!m_fences.empty()) {
+        auto& fence = m_fences.front();
+        GLint sync_status = GL_UNSIGNALED;
+        gl::get_sync_iv(fence.sync, gl::Sync_parameter_name::sync_status, 1, nullptr, &sync_status);
+        if (sync_status != GL_SIGNALED) {
+            break;
+        }
+        m_completed_fence_serial = fence.serial;
+        gl::delete_sync(fence.sync);
+        m_fences.pop_front();
+    }
+
+    while (
+        !m_staging_entries.empty() &&
+        (m_staging_entries.front().state == Staging_state::submitted) &&
+        (m_staging_entries.front().fence_serial <= m_completed_fence_serial)
+    ) {
+        m_staging_entries.pop_front();
+    }
+}
+
+auto Buffer_transfer_queue::acquire_staging(const std::size_t byte_count) -> Staging_range
+{
+    if (!m_staging_buffer || (byte_count == 0)) {
+        return {};
+    }
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    const std::size_t staging_offset = reserve_staging(byte_count);
+    if (staging_offset == invalid_offset) {
+        log_buffer->trace("staging buffer full, {} bytes requested", byte_count);
+        return {};
+    }
+
+    const std::size_t id = m_next_staging_id++;
+    m_staging_entries.push_back(
+        Staging_entry{
+            .id             = id,
+            .staging_offset = staging_offset,
+            .byte_count     = byte_count,
+            .state          = Staging_state::writing
+        }
+    );
+    return Staging_range{
+        .id   = id,
+        .span = m_staging_map.subspan(staging_offset, byte_count)
+    };
+}
+
+void Buffer_transfer_queue::enqueue(
+    Buffer&           buffer,
+    const std::size_t offset,
+    const std::size_t staging_id
+)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Entries are in id order
+    const auto i = std::lower_bound(
+        m_staging_entries.begin(),
+        m_staging_entries.end(),
+        staging_id,
+        [](const Staging_entry& entry, const std::size_t id)
+        {
+            return entry.id < id;
+        }
+    );
+    ERHE_VERIFY(i != m_staging_entries.end());
+    ERHE_VERIFY(i->id == staging_id);
+    ERHE_VERIFY(i->state == Staging_state::writing);
+
+    log_buffer->trace(
+        "queued buffer {} staged transfer offset = {} size = {}",
+        buffer.gl_name(),
+        offset,
+        i->byte_count
+    );
+    i->state         = Staging_state::queued;
+    i->target        = &buffer;
+    i->target_offset = offset;
+    i->sequence      = m_sequence++;
+}
+
+void Buffer_transfer_queue::execute(std::vector<Copy>& copies)
+{
+    // Sort copies by target so that adjacent copies can be coalesced,
+    // unless that would reorder overlapping writes.
+    bool keep_order = std::any_of(
+        copies.begin(),
+        copies.end(),
+        [](const Copy& copy)
+        {
+            return copy.data != nullptr;
+        }
+    );
+    if (!keep_order) {
+        std::stable_sort(
+            copies.begin(),
+            copies.end(),
+            [](const Copy& lhs, const Copy& rhs)
+            {
+                const auto lhs_name = lhs.target->gl_name();
+                const auto rhs_name = rhs.target->gl_name();
+                return (lhs_name != rhs_name)
+                    ? lhs_name < rhs_name
+                    : lhs.target_offset < rhs.target_offset;
+            }
+        );
+        for (std::size_t i = 1, end = copies.size(); i < end; ++i) {
+            const Copy& prev = copies[i - 1];
+            const Copy& copy = copies[i];
+            if (
+                (copy.target == prev.target) &&
+                (copy.target_offset < prev.target_offset + prev.byte_count) &&
+                (copy.sequence < prev.sequence)
+            ) {
+                keep_order = true;
+                break;
+            }
+        }
+    }
+    if (keep_order) {
+        std::sort(
+            copies.begin(),
+            copies.end(),
+            [](const Copy& lhs, const Copy& rhs)
+            {
+                return lhs.sequence < rhs.sequence;
+            }
+        );
+    }
+
+    std::size_t copy_count{0};
+    for (std::size_t i = 0, end = copies.size(); i < end;) {
+        const Copy& copy = copies[i];
+        if (copy.data != nullptr) {
+            log_buffer->trace(
+                "buffer upload {} transfer offset = {} size = {}",
+                copy.target->gl_name(),
+                copy.target_offset,
+                copy.byte_count
+            );
+            Scoped_buffer_mapping<uint8_t> scoped_mapping{
+                *copy.target,
+                copy.target_offset,
+                copy.byte_count,
+                gl::Map_buffer_access_mask::map_invalidate_range_bit |
+                gl::Map_buffer_access_mask::map_write_bit
+            };
+            auto& destination = scoped_mapping.span();
+            memcpy(destination.data(), copy.data->data(), copy.byte_count);
+            ++i;
+            continue;
+        }
+
+        std::size_t byte_count = copy.byte_count;
+        std::size_t j = i + 1;
+        for (; j < end; ++j) {
+            const Copy& next = copies[j];
+            if (
+                (next.data           != nullptr) ||
+                (next.target         != copy.target) ||
+                (next.target_offset  != copy.target_offset  + byte_count) ||
+                (next.staging_offset != copy.staging_offset + byte_count)
+            ) {
+                break;
+            }
+            byte_count += next.byte_count;
+        }
+
+        log_buffer->trace(
+            "buffer upload {} staged transfer offset = {} size = {}",
+            copy.target->gl_name(),
+            copy.target_offset,
+            byte_count
+        );
+        gl::copy_named_buffer_sub_data(
+            m_staging_buffer->gl_name(),
+            copy.target->gl_name(),
+            static_cast<GLintptr>  (copy.staging_offset),
+            static_cast<GLintptr>  (copy.target_offset),
+            static_cast<GLsizeiptr>(byte_count)
+        );
+        ++copy_count;
+        i = j;
+    }
+
+    log_buffer->trace("buffer transfer queue: {} entries, {} copies", copies.size(), copy_count);
 }
 
 void Buffer_transfer_queue::flush()
@@ -43,23 +327,91 @@ void Buffer_transfer_queue::flush()
 
     const std::lock_guard<std::mutex> lock{m_mutex};
 
-    for (const auto& entry : m_queued) {
-        log_buffer->trace(
-            "buffer upload {} transfer offset = {} size = {}",
-            entry.target.gl_name(),
-            entry.target_offset,
-            entry.data.size()
+    if (m_staging_buffer) {
+        reclaim_staging();
+    }
+
+    const uint64_t    fence_serial = m_fence_serial + 1;
+    std::vector<Copy> copies;
+    bool              use_fence{false};
+
+    for (auto& entry : m_staging_entries) {
+        if (entry.state != Staging_state::queued) {
+            continue;
+        }
+        copies.push_back(
+            Copy{
+                .target         = entry.target,
+                .target_offset  = entry.target_offset,
+                .staging_offset = entry.staging_offset,
+                .byte_count     = entry.byte_count,
+                .sequence       = entry.sequence
+            }
+        );
+        entry.state        = Staging_state::submitted;
+        entry.fence_serial = fence_serial;
+        use_fence          = true;
+    }
+
+    for (auto& entry : m_queued) {
+        const std::size_t byte_count = entry.data.size();
+        if (byte_count == 0) {
+            continue;
+        }
+        const std::size_t staging_offset = m_staging_buffer
+            ? reserve_staging(byte_count)
+            : invalid_offset;
+        if (staging_offset == invalid_offset) {
+            copies.push_back(
+                Copy{
+                    .target        = &entry.target,
+                    .target_offset = entry.target_offset,
+                    .byte_count    = byte_count,
+                    .sequence      = entry.sequence,
+                    .data          = &entry.data
+                }
+            );
+            continue;
+        }
+        memcpy(m_staging_map.data() + staging_offset, entry.data.data(), byte_count);
+        m_staging_entries.push_back(
+            Staging_entry{
+                .id             = m_next_staging_id++,
+                .staging_offset = staging_offset,
+                .byte_count     = byte_count,
+                .state          = Staging_state::submitted,
+                .target         = &entry.target,
+                .target_offset  = entry.target_offset,
+                .sequence       = entry.sequence,
+                .fence_serial   = fence_serial
+            }
+        );
+        copies.push_back(
+            Copy{
+                .target         = &entry.target,
+                .target_offset  = entry.target_offset,
+                .staging_offset = staging_offset,
+                .byte_count     = byte_count,
+                .sequence       = entry.sequence
+            }
         );
-        Scoped_buffer_mapping<uint8_t> scoped_mapping{
-            entry.target,
-            entry.target_offset,
-            entry.data.size(),
-            gl::Map_buffer_access_mask::map_invalidate_range_bit |
-            gl::Map_buffer_access_mask::map_write_bit
-        };
-        auto& destination = scoped_mapping.span();
-        memcpy(destination.data(), entry.data.data(), entry.data.size());
+        use_fence = true;
     }
+
+    if (!copies.empty()) {
+        execute(copies);
+    }
+
+    if (use_fence) {
+        m_fence_serial = fence_serial;
+        m_fences.push_back(
+            Fence{
+                .serial = fence_serial,
+                .sync   = gl::fence_sync(gl::Sync_condition::sync_gpu_commands_complete, 0)
+            }
+        );
+    }
+
     m_queued.clear();
 }
 
@@ -1,18 +1,34 @@
 #pragma once
 
+#include <gsl/span>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
+typedef struct __GLsync *GLsync;
 
 namespace erhe::graphics
 {
 
 class Buffer;
 
+// Queues uploads to GPU buffers.
+//
+// When constructed with staging buffer size, uploads go through a
+// persistently mapped staging ring buffer. Producers can reserve staging
+// memory with acquire_staging(), write to it directly from any thread,
+// and queue the copy with enqueue(). flush() issues GPU side copies,
+// coalescing copies which are contiguous in both staging and target
+// buffers, and a fence which is used to reclaim staging memory.
 class Buffer_transfer_queue final
 {
 public:
     Buffer_transfer_queue ();
+    explicit Buffer_transfer_queue(std::size_t staging_byte_count);
     ~Buffer_transfer_queue() noexcept;
     Buffer_transfer_queue (Buffer_transfer_queue&) = delete;
     auto operator=        (Buffer_transfer_queue&) -> Buffer_transfer_queue& = delete;
@@ -23,11 +39,13 @@ public:
         Transfer_entry(
             Buffer&                target,
             const std::size_t      target_offset,
-            std::vector<uint8_t>&& data
+            std::vector<uint8_t>&& data,
+            const std::size_t      sequence
         )
             : target       {target}
             , target_offset{target_offset}
-            , data         {data}
+            , data         {std::move(data)}
+            , sequence     {sequence}
         {
         }
 
@@ -38,6 +56,7 @@ public:
             : target       {other.target}
             , target_offset{other.target_offset}
             , data         {std::move(other.data)}
+            , sequence     {other.sequence}
         {
         }
 
@@ -46,6 +65,14 @@ public:
         Buffer&              target;
         std::size_t          target_offset{0};
         std::vector<uint8_t> data;
+        std::size_t          sequence     {0};
+    };
+
+    class Staging_range
+    {
+    public:
+        std::size_t             id{0}; // 0 when no staging memory was available
+        gsl::span<std::uint8_t> span;
     };
 
     void flush();
@@ -56,10 +83,77 @@ public:
         std::vector<uint8_t>&& data
     );
 
+    // Reserves staging memory. Does not make GL calls, so this can be used
+    // from worker threads. Returns empty range if staging is not in use or
+    // if the staging buffer is full; use enqueue() with data then.
+    [[nodiscard]] auto acquire_staging(std::size_t byte_count) -> Staging_range;
+
+    // Queues copy from staging range, which must have been written, to buffer.
+    // Every acquired staging range must be enqueued, as staging memory is
+    // reclaimed in order.
+    void enqueue(
+        Buffer&           buffer,
+        std::size_t       offset,
+        const std::size_t staging_id
+    );
+
+    [[nodiscard]] auto has_staging() const -> bool;
+
 private:
+    enum class Staging_state : unsigned int
+    {
+        writing = 0,
+        queued,
+        submitted
+    };
+
+    class Staging_entry
+    {
+    public:
+        std::size_t   id            {0};
+        std::size_t   staging_offset{0};
+        std::size_t   byte_count    {0};
+        Staging_state state         {Staging_state::writing};
+        Buffer*       target        {nullptr};
+        std::size_t   target_offset {0};
+        std::size_t   sequence      {0};
+        uint64_t      fence_serial  {0};
+    };
+
+    class Fence
+    {
+    public:
+        uint64_t serial{0};
+        GLsync   sync  {nullptr};
+    };
+
+    class Copy
+    {
+    public:
+        Buffer*                     target        {nullptr};
+        std::size_t                 target_offset {0};
+        std::size_t                 staging_offset{0};
+        std::size_t                 byte_count    {0};
+        std::size_t                 sequence      {0};
+        const std::vector<uint8_t>* data          {nullptr}; // for direct writes when staging is full
+    };
+
+    [[nodiscard]] auto reserve_staging(std::size_t byte_count) -> std::size_t;
+    void reclaim_staging();
+    void execute(std::vector<Copy>& copies);
+
     std::mutex                  m_mutex;
     std::vector<Transfer_entry> m_queued;
-};
+    std::size_t                 m_sequence{0};
 
+    std::unique_ptr<Buffer>     m_staging_buffer;
+    gsl::span<std::uint8_t>     m_staging_map;
+    std::size_t                 m_staging_head          {0};
+    std::size_t                 m_next_staging_id       {1};
+    std::deque<Staging_entry>   m_staging_entries; // in staging ring order
+    std::deque<Fence>           m_fences;
+    uint64_t                    m_fence_serial          {0};
+    uint64_t                    m_completed_fence_serial{0};
+};
 
 } // namespace erhe::graphics
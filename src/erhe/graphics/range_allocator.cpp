@@ -0,0 +1,325 @@
+#include "erhe/graphics/range_allocator.hpp"
+#include "erhe/graphics/graphics_log.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::graphics
+{
+
+namespace {
+
+[[nodiscard]] auto align_up(const std::size_t value, const std::size_t alignment) -> std::size_t
+{
+    return ((value + alignment - 1) / alignment) * alignment;
+}
+
+}
+
+Range_allocation::Range_allocation(
+    Range_allocator*  allocator,
+    const std::size_t byte_offset,
+    const std::size_t byte_count
+)
+    : m_allocator  {allocator}
+    , m_byte_offset{byte_offset}
+    , m_byte_count {byte_count}
+{
+}
+
+Range_allocation::~Range_allocation() noexcept
+{
+    if (m_allocator != nullptr) {
+        m_allocator->release(*this);
+    }
+}
+
+auto Range_allocation::get_byte_offset() const -> std::size_t
+{
+    return m_byte_offset;
+}
+
+auto Range_allocation::get_byte_count() const -> std::size_t
+{
+    return m_byte_count;
+}
+
+std::mutex                    Range_allocator::s_mutex;
+std::vector<Range_allocator*> Range_allocator::s_all_range_allocators;
+
+Range_allocator::Range_allocator(
+    const std::size_t      capacity_byte_count,
+    const std::string_view name
+)
+    : m_name               {name}
+    , m_capacity_byte_count{capacity_byte_count}
+{
+    if (capacity_byte_count > 0) {
+        insert_free_block(0, capacity_byte_count);
+    }
+
+    const std::lock_guard<std::mutex> lock{s_mutex};
+    s_all_range_allocators.push_back(this);
+}
+
+Range_allocator::~Range_allocator() noexcept
+{
+    {
+        const std::lock_guard<std::mutex> lock{s_mutex};
+        s_all_range_allocators.erase(
+            std::remove(
+                s_all_range_allocators.begin(),
+                s_all_range_allocators.end(),
+                this
+            ),
+            s_all_range_allocators.end()
+        );
+    }
+
+    // Outstanding allocations must not call back to this allocator
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    for (auto& [byte_offset, entry] : m_allocations) {
+        if (entry.allocation != nullptr) {
+            entry.allocation->m_allocator = nullptr;
+        }
+    }
+}
+
+auto Range_allocator::all_range_allocators() -> std::vector<Range_allocator*>
+{
+    const std::lock_guard<std::mutex> lock{s_mutex};
+    return s_all_range_allocators;
+}
+
+auto Range_allocator::get_name() const -> const std::string&
+{
+    return m_name;
+}
+
+void Range_allocator::insert_free_block(const std::size_t byte_offset, const std::size_t byte_count)
+{
+    ERHE_VERIFY(byte_count > 0);
+    m_free_blocks.emplace(byte_offset, byte_count);
+    m_free_blocks_by_size.emplace(byte_count, byte_offset);
+}
+
+auto Range_allocator::erase_free_block(
+    std::map<std::size_t, std::size_t>::iterator i
+) -> std::map<std::size_t, std::size_t>::iterator
+{
+    m_free_blocks_by_size.erase(std::make_pair(i->second, i->first));
+    return m_free_blocks.erase(i);
+}
+
+void Range_allocator::free_range(const std::size_t byte_offset, const std::size_t byte_count)
+{
+    std::size_t begin = byte_offset;
+    std::size_t end   = byte_offset + byte_count;
+
+    // Coalesce with following free block
+    auto next = m_free_blocks.lower_bound(begin);
+    if ((next != m_free_blocks.end()) && (next->first == end)) {
+        end += next->second;
+        next = erase_free_block(next);
+    }
+
+    // Coalesce with preceding free block
+    if (next != m_free_blocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == begin) {
+            begin = prev->first;
+            erase_free_block(prev);
+        }
+    }
+
+    insert_free_block(begin, end - begin);
+}
+
+auto Range_allocator::allocate_range(
+    std::size_t       byte_count,
+    const std::size_t alignment
+) -> std::size_t
+{
+    ERHE_VERIFY(alignment > 0);
+
+    // Zero sized ranges still get a unique offset
+    byte_count = std::max(byte_count, std::size_t{1});
+
+    // Best fit: smallest free block which can hold the aligned range
+    for (
+        auto i = m_free_blocks_by_size.lower_bound(std::make_pair(byte_count, std::size_t{0}));
+        i != m_free_blocks_by_size.end();
+        ++i
+    ) {
+        const std::size_t block_byte_count  = i->first;
+        const std::size_t block_byte_offset = i->second;
+        const std::size_t aligned_offset    = align_up(block_byte_offset, alignment);
+        const std::size_t padding           = aligned_offset - block_byte_offset;
+        if (padding + byte_count > block_byte_count) {
+            continue;
+        }
+
+        erase_free_block(m_free_blocks.find(block_byte_offset));
+        if (padding > 0) {
+            insert_free_block(block_byte_offset, padding);
+        }
+        const std::size_t tail_byte_count = block_byte_count - padding - byte_count;
+        if (tail_byte_count > 0) {
+            insert_free_block(aligned_offset + byte_count, tail_byte_count);
+        }
+
+        m_used_byte_count += byte_count;
+        ++m_total_allocate_count;
+        return aligned_offset;
+    }
+
+    ++m_failed_allocate_count;
+    return invalid_offset;
+}
+
+auto Range_allocator::allocate(
+    const std::size_t byte_count,
+    const std::size_t alignment
+) -> std::shared_ptr<Range_allocation>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    const std::size_t byte_offset = allocate_range(byte_count, alignment);
+    if (byte_offset == invalid_offset) {
+        log_buffer->warn("{}: failed to allocate {} bytes", m_name, byte_count);
+        return {};
+    }
+
+    auto allocation = std::make_shared<Range_allocation>(this, byte_offset, byte_count);
+    m_allocations.emplace(
+        byte_offset,
+        Entry{
+            .byte_count = std::max(byte_count, std::size_t{1}),
+            .alignment  = alignment,
+            .allocation = allocation.get()
+        }
+    );
+    log_buffer->trace("{}: allocated {} bytes at offset {}", m_name, byte_count, byte_offset);
+    return allocation;
+}
+
+auto Range_allocator::allocate_pinned(
+    const std::size_t byte_count,
+    const std::size_t alignment
+) -> std::size_t
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    const std::size_t byte_offset = allocate_range(byte_count, alignment);
+    if (byte_offset == invalid_offset) {
+        log_buffer->warn("{}: failed to allocate {} bytes", m_name, byte_count);
+        return invalid_offset;
+    }
+
+    m_allocations.emplace(
+        byte_offset,
+        Entry{
+            .byte_count = std::max(byte_count, std::size_t{1}),
+            .alignment  = alignment,
+            .allocation = nullptr
+        }
+    );
+    log_buffer->trace("{}: allocated {} pinned bytes at offset {}", m_name, byte_count, byte_offset);
+    return byte_offset;
+}
+
+void Range_allocator::release(Range_allocation& allocation)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    const auto i = m_allocations.find(allocation.m_byte_offset);
+    ERHE_VERIFY(i != m_allocations.end());
+    ERHE_VERIFY(i->second.allocation == &allocation);
+
+    const std::size_t byte_count = i->second.byte_count;
+    log_buffer->trace("{}: freed {} bytes at offset {}", m_name, byte_count, i->first);
+    free_range(i->first, byte_count);
+    m_allocations.erase(i);
+    m_used_byte_count -= byte_count;
+    ++m_total_free_count;
+}
+
+auto Range_allocator::compact() -> std::vector<Range_move>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    std::vector<Range_move>      moves;
+    std::map<std::size_t, Entry> packed;
+    std::size_t                  cursor{0};
+    for (const auto& [byte_offset, entry] : m_allocations) {
+        if (entry.allocation == nullptr) {
+            // Pinned entries stay in place; cursor never passes them
+            packed.emplace(byte_offset, entry);
+            cursor = std::max(cursor, byte_offset + entry.byte_count);
+            continue;
+        }
+        const std::size_t new_byte_offset = align_up(cursor, entry.alignment);
+        ERHE_VERIFY(new_byte_offset <= byte_offset);
+        if (new_byte_offset != byte_offset) {
+            moves.push_back(
+                Range_move{
+                    .src_byte_offset = byte_offset,
+                    .dst_byte_offset = new_byte_offset,
+                    .byte_count      = entry.byte_count
+                }
+            );
+            entry.allocation->m_byte_offset = new_byte_offset;
+            m_compact_moved_bytes += entry.byte_count;
+        }
+        packed.emplace(new_byte_offset, entry);
+        cursor = new_byte_offset + entry.byte_count;
+    }
+    m_allocations = std::move(packed);
+
+    // Rebuild free blocks from gaps between allocations
+    m_free_blocks.clear();
+    m_free_blocks_by_size.clear();
+    std::size_t free_begin{0};
+    for (const auto& [byte_offset, entry] : m_allocations) {
+        if (byte_offset > free_begin) {
+            insert_free_block(free_begin, byte_offset - free_begin);
+        }
+        free_begin = byte_offset + entry.byte_count;
+    }
+    if (m_capacity_byte_count > free_begin) {
+        insert_free_block(free_begin, m_capacity_byte_count - free_begin);
+    }
+
+    ++m_compact_count;
+    log_buffer->info("{}: compacted, {} ranges moved", m_name, moves.size());
+    return moves;
+}
+
+auto Range_allocator::get_stats() const -> Range_allocator_stats
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    std::size_t pinned_allocation_count{0};
+    for (const auto& [byte_offset, entry] : m_allocations) {
+        if (entry.allocation == nullptr) {
+            ++pinned_allocation_count;
+        }
+    }
+
+    return Range_allocator_stats{
+        .capacity_byte_count     = m_capacity_byte_count,
+        .used_byte_count         = m_used_byte_count,
+        .free_byte_count         = m_capacity_byte_count - m_used_byte_count,
+        .largest_free_byte_count = m_free_blocks_by_size.empty() ? 0 : m_free_blocks_by_size.rbegin()->first,
+        .free_block_count        = m_free_blocks.size(),
+        .allocation_count        = m_allocations.size(),
+        .pinned_allocation_count = pinned_allocation_count,
+        .total_allocate_count    = m_total_allocate_count,
+        .total_free_count        = m_total_free_count,
+        .failed_allocate_count   = m_failed_allocate_count,
+        .compact_count           = m_compact_count,
+        .compact_moved_bytes     = m_compact_moved_bytes
+    };
+}
+
+} // namespace erhe::graphics
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace erhe::graphics
+{
+
+class Range_allocator;
+
+// Reference to a range allocated from Range_allocator. The range is freed
+// when the last reference is released. Byte offset may change when the
+// allocator is compacted.
+class Range_allocation
+{
+public:
+    Range_allocation(Range_allocator* allocator, std::size_t byte_offset, std::size_t byte_count);
+    ~Range_allocation() noexcept;
+    Range_allocation (const Range_allocation&) = delete;
+    void operator=   (const Range_allocation&) = delete;
+    Range_allocation (Range_allocation&&)      = delete;
+    void operator=   (Range_allocation&&)      = delete;
+
+    [[nodiscard]] auto get_byte_offset() const -> std::size_t;
+    [[nodiscard]] auto get_byte_count () const -> std::size_t;
+
+private:
+    friend class Range_allocator;
+
+    Range_allocator* m_allocator  {nullptr};
+    std::size_t      m_byte_offset{0};
+    std::size_t      m_byte_count {0};
+};
+
+class Range_allocator_stats
+{
+public:
+    std::size_t capacity_byte_count    {0};
+    std::size_t used_byte_count        {0};
+    std::size_t free_byte_count        {0};
+    std::size_t largest_free_byte_count{0};
+    std::size_t free_block_count       {0};
+    std::size_t allocation_count       {0};
+    std::size_t pinned_allocation_count{0};
+    std::size_t total_allocate_count   {0};
+    std::size_t total_free_count       {0};
+    std::size_t failed_allocate_count  {0};
+    std::size_t compact_count          {0};
+    std::size_t compact_moved_bytes    {0};
+};
+
+class Range_move
+{
+public:
+    std::size_t src_byte_offset{0};
+    std::size_t dst_byte_offset{0};
+    std::size_t byte_count     {0};
+};
+
+// Best fit free list suballocator for a fixed size range, such as
+// a GPU buffer. Adjacent free blocks are coalesced when ranges are
+// freed. Ranges allocated with allocate() can be moved by compact();
+// ranges allocated with allocate_pinned() are never moved nor freed.
+class Range_allocator
+{
+public:
+    Range_allocator(std::size_t capacity_byte_count, std::string_view name);
+    ~Range_allocator() noexcept;
+    Range_allocator(const Range_allocator&) = delete;
+    void operator= (const Range_allocator&) = delete;
+    Range_allocator(Range_allocator&&)      = delete;
+    void operator= (Range_allocator&&)      = delete;
+
+    // Returns nullptr if there is no free block large enough
+    [[nodiscard]] auto allocate(
+        std::size_t byte_count,
+        std::size_t alignment
+    ) -> std::shared_ptr<Range_allocation>;
+
+    // Returns invalid_offset if there is no free block large enough
+    [[nodiscard]] auto allocate_pinned(
+        std::size_t byte_count,
+        std::size_t alignment
+    ) -> std::size_t;
+
+    // Packs movable allocations towards the start of the range and updates
+    // their Range_allocation offsets. Returns moves in ascending offset
+    // order; the caller must apply them to the underlying storage in order.
+    // Destination never overlaps later moves, but a move may overlap
+    // with its own source. Must not be called while other threads are
+    // reading Range_allocation offsets.
+    [[nodiscard]] auto compact() -> std::vector<Range_move>;
+
+    [[nodiscard]] auto get_stats() const -> Range_allocator_stats;
+    [[nodiscard]] auto get_name () const -> const std::string&;
+
+    [[nodiscard]] static auto all_range_allocators() -> std::vector<Range_allocator*>;
+
+    static constexpr std::size_t invalid_offset = static_cast<std::size_t>(-1);
+
+private:
+    friend class Range_allocation;
+
+    class Entry
+    {
+    public:
+        std::size_t       byte_count{0};
+        std::size_t       alignment {1};
+        Range_allocation* allocation{nullptr}; // nullptr for pinned entries
+    };
+
+    [[nodiscard]] auto allocate_range(std::size_t byte_count, std::size_t alignment) -> std::size_t;
+    void release          (Range_allocation& allocation);
+    void insert_free_block(std::size_t byte_offset, std::size_t byte_count);
+    void free_range       (std::size_t byte_offset, std::size_t byte_count);
+    auto erase_free_block (std::map<std::size_t, std::size_t>::iterator i) -> std::map<std::size_t, std::size_t>::iterator;
+
+    static std::mutex                    s_mutex;
+    static std::vector<Range_allocator*> s_all_range_allocators;
+
+    mutable std::mutex                            m_mutex;
+    std::string                                   m_name;
+    std::size_t                                   m_capacity_byte_count{0};
+    std::size_t                                   m_used_byte_count    {0};
+    std::map<std::size_t, Entry>                  m_allocations;        // offset -> entry
+    std::map<std::size_t, std::size_t>            m_free_blocks;        // offset -> size
+    std::set<std::pair<std::size_t, std::size_t>> m_free_blocks_by_size; // size, offset
+    std::size_t                                   m_total_allocate_count {0};
+    std::size_t                                   m_total_free_count     {0};
+    std::size_t                                   m_failed_allocate_count{0};
+    std::size_t                                   m_compact_count        {0};
+    std::size_t                                   m_compact_moved_bytes  {0};
+};
+
+} // namespace erhe::graphics
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace erhe::message_bus
+{
+
+// Specialize for message types to enable receiver filtering and coalescing.
+template <typename Message_type>
+class Message_traits
+{
+public:
+    // Bits which are tested against receiver masks. Receiver is called
+    // only when its mask and the message type mask have common bits.
+    [[nodiscard]] static auto get_type_mask(const Message_type&) -> uint64_t
+    {
+        return ~uint64_t{0};
+    }
+
+    // Queued messages with the same non-zero key may be coalesced during update().
+    [[nodiscard]] static auto get_coalesce_key(const Message_type&) -> uint64_t
+    {
+        return 0;
+    }
+
+    // Merges message into an earlier queued message with the same key.
+    // Returns false if the messages cannot be merged (key collision).
+    [[nodiscard]] static auto coalesce(Message_type&, const Message_type&) -> bool
+    {
+        return false;
+    }
+};
+
+/*
+    Message bus which can be posted to from any thread.
+
+    - queue_message() can be called from any thread. Posting is lock-free;
+      messages are pushed to an intrusive multi-producer stack.
+    - update() must be called from a single thread (main thread), usually
+      once per frame. It takes all queued messages, restores posting order,
+      coalesces redundant messages and dispatches them to receivers.
+      Messages queued by receivers during update() are dispatched on the
+      next update().
+    - send_message() dispatches immediately on the calling thread.
+    - add_receiver() is not thread-safe; receivers are expected to be
+      added during initialization.
+*/
+template <typename Message_type, typename Traits = Message_traits<Message_type>>
+class Concurrent_message_bus
+{
+public:
+    using Receiver = std::function<void(Message_type&)>;
+
+    static constexpr uint64_t c_all_messages = ~uint64_t{0};
+
+    Concurrent_message_bus() = default;
+
+    ~Concurrent_message_bus() noexcept
+    {
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr) {
+            Node* const next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    Concurrent_message_bus(const Concurrent_message_bus&) = delete;
+    void operator=        (const Concurrent_message_bus&) = delete;
+
+    void add_receiver(Receiver message_receiver, const uint64_t type_mask = c_all_messages)
+    {
+        m_receivers.push_back(
+            Receiver_entry{
+                .receiver  = std::move(message_receiver),
+                .type_mask = type_mask
+            }
+        );
+    }
+
+    void send_message(Message_type message)
+    {
+        dispatch(message);
+    }
+
+    void queue_message(Message_type message)
+    {
+        Node* const node = new Node{std::move(message), nullptr};
+        node->next = m_head.load(std::memory_order_relaxed);
+        while (
+            !m_head.compare_exchange_weak(
+                node->next,
+                node,
+                std::memory_order_release,
+                std::memory_order_relaxed
+            )
+        ) {
+        }
+    }
+
+    void update()
+    {
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        if (node == nullptr) {
+            return;
+        }
+
+        // Stack is in reverse posting order
+        m_batch.clear();
+        while (node != nullptr) {
+            m_batch.push_back(node);
+            node = node->next;
+        }
+
+        m_messages.clear();
+        m_coalesce_slots.clear();
+        for (auto i = m_batch.rbegin(), end = m_batch.rend(); i != end; ++i) {
+            Message_type& message = (*i)->message;
+            const uint64_t key = Traits::get_coalesce_key(message);
+            if (key != 0) {
+                const auto slot = m_coalesce_slots.find(key);
+                if (slot != m_coalesce_slots.end()) {
+                    if (Traits::coalesce(m_messages[slot->second], message)) {
+                        ++m_coalesced_count;
+                        continue;
+                    }
+                    slot->second = m_messages.size();
+                } else {
+                    m_coalesce_slots.emplace(key, m_messages.size());
+                }
+            }
+            m_messages.push_back(std::move(message));
+        }
+        for (Node* batch_node : m_batch) {
+            delete batch_node;
+        }
+        m_batch.clear();
+
+        for (auto& message : m_messages) {
+            dispatch(message);
+        }
+        m_dispatched_count += m_messages.size();
+        m_messages.clear();
+    }
+
+    [[nodiscard]] auto get_dispatched_count() const -> std::size_t
+    {
+        return m_dispatched_count;
+    }
+
+    [[nodiscard]] auto get_coalesced_count() const -> std::size_t
+    {
+        return m_coalesced_count;
+    }
+
+private:
+    class Node
+    {
+    public:
+        Message_type message;
+        Node*        next{nullptr};
+    };
+
+    class Receiver_entry
+    {
+    public:
+        Receiver receiver;
+        uint64_t type_mask{c_all_messages};
+    };
+
+    void dispatch(Message_type& message)
+    {
+        const uint64_t type_mask = Traits::get_type_mask(message);
+        for (const auto& entry : m_receivers) {
+            if ((entry.type_mask & type_mask) != 0) {
+                entry.receiver(message);
+            }
+        }
+    }
+
+    std::atomic<Node*>                        m_head{nullptr};
+    std::vector<Receiver_entry>               m_receivers;
+
+    // Used by update() only; kept to reuse allocations
+    std::vector<Node*>                        m_batch;
+    std::vector<Message_type>                 m_messages;
+    std::unordered_map<uint64_t, std::size_t> m_coalesce_slots;
+    std::size_t                               m_dispatched_count{0};
+    std::size_t                               m_coalesced_count {0};
+};
+
+} // namespace erhe::message_bus
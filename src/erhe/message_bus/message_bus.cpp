@@ -1 +1,2 @@
 #include "erhe/message_bus/message_bus.hpp"
+#include "erhe/message_bus/concurrent_message_bus.hpp"
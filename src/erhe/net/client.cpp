@@ -1,13 +1,16 @@
 #include "erhe/net/client.hpp"
 #include "erhe/net/net_log.hpp"
 #include "erhe/net/net_os.hpp"
-#include "erhe/net/select_sockets.hpp"
 
 
 namespace erhe::net
 {
 
-Client::Client() = default;
+Client::Client()
+    : m_socket{std::make_unique<Socket>()}
+    , m_poller{std::make_unique<Socket_poller>()}
+{
+}
 
 Client::~Client()
 {
@@ -16,58 +19,62 @@ Client::~Client()
 
 Client::Client(Client&& other) noexcept
     : m_socket{std::move(other.m_socket)}
+    , m_poller{std::move(other.m_poller)}
 {
     log_client->trace("Client move constructor");
+    other.m_socket = std::make_unique<Socket>();
+    other.m_poller = std::make_unique<Socket_poller>();
 }
 
 auto Client::operator=(Client&& other) noexcept -> Client&
 {
     log_client->trace("Client move assignment");
     m_socket = std::move(other.m_socket);
+    m_poller = std::move(other.m_poller);
+    other.m_socket = std::make_unique<Socket>();
+    other.m_poller = std::make_unique<Socket_poller>();
     return *this;
 }
 
 auto Client::connect(const char* address, const int port) -> bool
 {
-    return m_socket.connect(address, port);
+    return m_socket->connect(address, port);
 }
 
 void Client::disconnect()
 {
-    log_socket->trace("Socket move assignment");
-    m_socket.close();
+    m_poller->remove(*m_socket.get());
+    m_socket->close();
 }
 
 auto Client::poll(const int timeout_ms) -> bool
 {
-    if (m_socket.get_state() == Socket::State::CLOSED) {
+    if (m_socket->get_state() == Socket::State::CLOSED) {
         return true; // NOP
     }
-    Select_sockets select_sockets;
 
-    m_socket.pre_select(select_sockets);
+    m_poller->update(*m_socket.get());
 
-    // Call select() to find out if there is work to do
-    const int select_res = select_sockets.select(timeout_ms);
-    if (select_res == SOCKET_ERROR) {
-        log_client->trace("client select() returned error {}", get_net_last_error_message());
+    // Wait until there is work to do
+    const int poll_res = m_poller->poll(timeout_ms, m_events);
+    if (poll_res == SOCKET_ERROR) {
+        log_client->trace("client poll returned error {}", get_net_last_error_message());
         return false; // TODO
     }
-    if (select_res == 0) {
-        return true; // NOP
-    }
 
-    switch (m_socket.get_state()) {
-        case Socket::State::CLIENT_CONNECTING: {
-            m_socket.post_select_connect(select_sockets);
-            break;
-        }
-        case Socket::State::CONNECTED: {
-            m_socket.post_select_send_recv(select_sockets);
-            break;
-        }
-        default: {
-            //log_client->info("client socket is not connecting nor connected");
+    for (const Poll_event& event : m_events) {
+        switch (event.socket->get_state()) {
+            case Socket::State::CLIENT_CONNECTING: {
+                event.socket->post_poll_connect(event.flags);
+                break;
+            }
+            case Socket::State::CONNECTED: {
+                event.socket->post_poll_send_recv(event.flags);
+                break;
+            }
+            default: {
+                //log_client->info("client socket is not connecting nor connected");
+            }
         }
     }
 
@@ -76,20 +83,28 @@ auto Client::poll(const int timeout_ms) -> bool
 
 auto Client::send(const std::string& message) -> bool
 {
-    return m_socket.send(
+    return m_socket->send(
         message.data(),
         static_cast<int>(message.size())
     );
 }
 
+auto Client::send(const uint8_t* data, const std::size_t length) -> bool
+{
+    return m_socket->send(
+        reinterpret_cast<const char*>(data),
+        static_cast<int>(length)
+    );
+}
+
 void Client::set_receive_handler(Receive_handler receive_handler)
 {
-    m_socket.set_receive_handler(receive_handler);
+    m_socket->set_receive_handler(receive_handler);
 }
 
 auto Client::get_state() -> Socket::State
 {
-    return m_socket.get_state();
+    return m_socket->get_state();
 }
 
 }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "erhe/net/socket.hpp"
+#include "erhe/net/socket_poller.hpp"
+
+#include <memory>
+#include <vector>
 
 namespace erhe::net
 {
@@ -18,12 +22,16 @@ public:
     auto connect            (const char* address, int port) -> bool;
     void disconnect         ();
     auto send               (const std::string& message) -> bool;
+    auto send               (const uint8_t* data, std::size_t length) -> bool;
     void set_receive_handler(Receive_handler receive_handler);
     auto poll               (int timeout_ms) -> bool;
     auto get_state          () -> Socket::State;
 
 private:
-    Socket m_socket;
+    // Heap allocated, so that socket address stays valid while registered to poller
+    std::unique_ptr<Socket>        m_socket;
+    std::unique_ptr<Socket_poller> m_poller;
+    std::vector<Poll_event>        m_events;
 };
 
 } // namespace erhe::net
@@ -2,6 +2,8 @@
 #include "erhe/net/net_log.hpp"
 #include <string.h>
 
+#include <algorithm>
+
 #include <fmt/format.h>
  
 namespace erhe::net
@@ -189,7 +191,7 @@ auto is_error_busy(const int error_code) -> bool
 
 auto is_socket_good(const SOCKET socket) -> bool
 {
-    return (socket >= 0) && (socket <= FD_SETSIZE);
+    return socket >= 0;
 }
 
 auto set_socket_option(
@@ -213,7 +215,7 @@ auto set_socket_option(
             if (flags == -1) {
                 return false;
             }
-            flags = (value != 0) ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+            flags = (value != 0) ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
             result = fcntl(socket, F_SETFL, flags);
             break;
         }
@@ -290,6 +292,27 @@ auto get_socket_option(
     return value;
 }
 
+auto send_gather(
+    const SOCKET           socket,
+    const Send_span* const spans,
+    const std::size_t      span_count
+) -> int
+{
+    iovec iov[c_max_send_span_count];
+    const std::size_t count = (std::min)(span_count, c_max_send_span_count);
+    for (std::size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<uint8_t*>(spans[i].data);
+        iov[i].iov_len  = spans[i].byte_count;
+    }
+    msghdr message{};
+    message.msg_iov    = iov;
+    message.msg_iovlen = count;
+
+    // MSG_NOSIGNAL: Report EPIPE instead of raising SIGPIPE
+    const ssize_t result = sendmsg(socket, &message, MSG_NOSIGNAL);
+    return (result < 0) ? SOCKET_ERROR : static_cast<int>(result);
+}
+
 auto get_net_hints(const int flags, const int family, const int socktype, const int protocol) -> addrinfo
 {
     return addrinfo{
@@ -16,9 +16,11 @@ static constexpr int ERHE_NET_ERROR_CODE_CONNECTED = WSAEISCONN;
 #   include <fcntl.h>
 #   include <netdb.h>
 #   include <netinet/tcp.h>
+#   include <sys/epoll.h>
 #   include <sys/select.h>
 #   include <sys/socket.h>
 #   include <sys/types.h>
+#   include <sys/uio.h>
 #   include <unistd.h>
 
 // For now, pretent Windows like API... TODO fix
@@ -33,6 +35,7 @@ static constexpr int    SD_BOTH        = SHUT_RDWR;
 inline auto closesocket(const SOCKET s) -> int { return close(s); }
 #endif
 
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -65,6 +68,19 @@ auto c_str(Socket_option) -> const char*;
 auto set_socket_option(SOCKET socket, Socket_option option, int value) -> bool;
 auto get_socket_option(SOCKET socket, Socket_option option) -> std::optional<int>;
 
+class Send_span
+{
+public:
+    const uint8_t* data      {nullptr};
+    std::size_t    byte_count{0};
+};
+
+static constexpr std::size_t c_max_send_span_count = 64;
+
+// Sends spans with a single system call (sendmsg() / WSASend()).
+// Returns number of bytes sent, or SOCKET_ERROR like send().
+auto send_gather(SOCKET socket, const Send_span* spans, std::size_t span_count) -> int;
+
 auto initialize_net() -> bool;
 
 }
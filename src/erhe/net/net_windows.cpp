@@ -3,6 +3,7 @@
 
 #include "fmt/format.h"
 
+#include <algorithm>
 #include <cstdio>
 
 namespace erhe::net
@@ -189,6 +190,23 @@ auto is_socket_good(const SOCKET socket) -> bool
     return socket != INVALID_SOCKET;
 }
 
+auto send_gather(
+    const SOCKET           socket,
+    const Send_span* const spans,
+    const std::size_t      span_count
+) -> int
+{
+    WSABUF buffers[c_max_send_span_count];
+    const std::size_t count = (std::min)(span_count, c_max_send_span_count);
+    for (std::size_t i = 0; i < count; ++i) {
+        buffers[i].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(spans[i].data));
+        buffers[i].len = static_cast<ULONG>(spans[i].byte_count);
+    }
+    DWORD sent_byte_count{0};
+    const int result = WSASend(socket, buffers, static_cast<DWORD>(count), &sent_byte_count, 0, nullptr, nullptr);
+    return (result == SOCKET_ERROR) ? SOCKET_ERROR : static_cast<int>(sent_byte_count);
+}
+
 auto set_socket_option(
     const SOCKET        socket,
     const Socket_option option,
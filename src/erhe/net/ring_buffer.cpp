@@ -1,5 +1,6 @@
 #include "erhe/net/ring_buffer.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 
@@ -168,6 +169,23 @@ auto Ring_buffer::begin_consume(
     return &m_buffer[m_read_offset];
 }
 
+void Ring_buffer::begin_consume(
+    std::span<const uint8_t>& before_wrap,
+    std::span<const uint8_t>& after_wrap
+) const
+{
+    const std::size_t can_read_count = size_available_for_read();
+    if (can_read_count == 0) {
+        before_wrap = {};
+        after_wrap  = {};
+        return;
+    }
+    const std::size_t max_count_before_wrap = m_max_size - m_read_offset;
+    const std::size_t count_before_wrap     = std::min(can_read_count, max_count_before_wrap);
+    before_wrap = std::span<const uint8_t>{&m_buffer[m_read_offset], count_before_wrap};
+    after_wrap  = std::span<const uint8_t>{m_buffer.data(), can_read_count - count_before_wrap};
+}
+
 void Ring_buffer::end_consume(std::size_t byte_count)
 {
     m_read_offset = (m_read_offset + byte_count) % m_max_size;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace erhe::net
@@ -38,6 +39,13 @@ public:
         std::size_t& readable_byte_count_before_wrap,
         std::size_t& readable_byte_count_after_wrap
     ) -> const uint8_t*;
+
+    // For scatter-gather send - before_wrap starts at read position,
+    // after_wrap (empty unless readable data wraps) at buffer start.
+    void begin_consume           (
+        std::span<const uint8_t>& before_wrap,
+        std::span<const uint8_t>& after_wrap
+    ) const;
     void end_consume             (std::size_t byte_count);
 
     auto read                    (uint8_t* dst, std::size_t byte_count) -> std::size_t;
@@ -1,9 +1,27 @@
 #include "erhe/net/select_sockets.hpp"
+#include "erhe/net/net_log.hpp"
+
 #include <algorithm>
 
 namespace erhe::net
 {
 
+namespace {
+
+// On Linux fd_set is a bitmap, descriptors beyond FD_SETSIZE can not be
+// used with select(). Socket_poller uses epoll there and has no such limit.
+[[nodiscard]] auto is_selectable(const SOCKET socket) -> bool
+{
+#if defined(ERHE_OS_LINUX)
+    return (socket >= 0) && (socket < FD_SETSIZE);
+#else
+    static_cast<void>(socket);
+    return true;
+#endif
+}
+
+} // anonymous namespace
+
 Select_sockets::Select_sockets()
 {
     FD_ZERO(&read_fds);
@@ -28,21 +46,34 @@ auto Select_sockets::has_except() const -> bool
 
 auto Select_sockets::has_read(const SOCKET socket) const -> bool
 {
+    if (!is_selectable(socket)) {
+        return false;
+    }
     return FD_ISSET(socket, &read_fds) == TRUE;
 }
 
 auto Select_sockets::has_write(const SOCKET socket) const -> bool
 {
+    if (!is_selectable(socket)) {
+        return false;
+    }
     return FD_ISSET(socket, &write_fds) == TRUE;
 }
 
 auto Select_sockets::has_except(const SOCKET socket) const -> bool
 {
+    if (!is_selectable(socket)) {
+        return false;
+    }
     return FD_ISSET(socket, &except_fds) == TRUE;
 }
 
 void Select_sockets::set_read(const SOCKET socket)
 {
+    if (!is_selectable(socket)) {
+        log_net->error("socket {} can not be used with select()", socket);
+        return;
+    }
     FD_SET(socket, &read_fds);
     nfds = std::max(nfds, static_cast<int>(socket + 1));
     flags = flags | flag_read;
@@ -50,6 +81,10 @@ void Select_sockets::set_read(const SOCKET socket)
 
 void Select_sockets::set_write(const SOCKET socket)
 {
+    if (!is_selectable(socket)) {
+        log_net->error("socket {} can not be used with select()", socket);
+        return;
+    }
     FD_SET(socket, &write_fds );
     nfds = std::max(nfds, static_cast<int>(socket + 1));
     flags = flags | flag_write;
@@ -57,6 +92,10 @@ void Select_sockets::set_write(const SOCKET socket)
 
 void Select_sockets::set_except(const SOCKET socket)
 {
+    if (!is_selectable(socket)) {
+        log_net->error("socket {} can not be used with select()", socket);
+        return;
+    }
     FD_SET(socket, &except_fds);
     nfds = std::max(nfds, static_cast<int>(socket + 1));
     flags = flags | flag_except;
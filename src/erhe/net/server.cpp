@@ -1,16 +1,22 @@
 #include "erhe/net/server.hpp"
 #include "erhe/net/net_log.hpp"
-#include "erhe/net/select_sockets.hpp"
 
 #include "erhe/toolkit/verify.hpp"
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 
 namespace erhe::net
 {
 
-Server::Server() = default;
+Server::Server()
+    : m_listen_socket         {std::make_unique<Socket>()}
+    , m_client_receive_handler{std::make_shared<Client_receive_handler>()}
+    , m_poller                {std::make_unique<Socket_poller>()}
+{
+}
 
 Server::~Server()
 {
@@ -18,51 +24,73 @@ Server::~Server()
 }
 
 Server::Server(Server&& other) noexcept
-    : m_listen_socket  {std::move(other.m_listen_socket)}
-    , m_receive_handler{std::move(other.m_receive_handler)}
-    , m_clients        {std::move(other.m_clients)}
+    : m_listen_socket        {std::move(other.m_listen_socket)}
+    , m_receive_handler      {std::move(other.m_receive_handler)}
+    , m_client_receive_handler{std::move(other.m_client_receive_handler)}
+    , m_connect_handler      {std::move(other.m_connect_handler)}
+    , m_disconnect_handler   {std::move(other.m_disconnect_handler)}
+    , m_clients              {std::move(other.m_clients)}
+    , m_poller               {std::move(other.m_poller)}
 {
     log_server->trace("Server move constructor");
+    other.m_listen_socket          = std::make_unique<Socket>();
+    other.m_poller                 = std::make_unique<Socket_poller>();
+    other.m_client_receive_handler = std::make_shared<Client_receive_handler>();
 }
 
 auto Server::operator=(Server&& other) noexcept -> Server&
 {
     log_server->trace("Server move assignment");
-    m_listen_socket   = std::move(other.m_listen_socket);
-    m_receive_handler = std::move(other.m_receive_handler);
-    m_clients         = std::move(other.m_clients);
+    m_listen_socket          = std::move(other.m_listen_socket);
+    m_receive_handler        = std::move(other.m_receive_handler);
+    m_client_receive_handler = std::move(other.m_client_receive_handler);
+    m_connect_handler        = std::move(other.m_connect_handler);
+    m_disconnect_handler     = std::move(other.m_disconnect_handler);
+    m_clients                = std::move(other.m_clients);
+    m_poller                 = std::move(other.m_poller);
+    other.m_listen_socket          = std::make_unique<Socket>();
+    other.m_poller                 = std::make_unique<Socket_poller>();
+    other.m_client_receive_handler = std::make_shared<Client_receive_handler>();
     return *this;
 }
 
 auto Server::listen(const char* address, const int port) -> bool
 {
-    return m_listen_socket.bind(address, port);
+    return m_listen_socket->bind(address, port);
+}
+
+void Server::register_sockets()
+{
+    m_poller->update(*m_listen_socket.get());
+    for (auto& client : m_clients) {
+        m_poller->update(*client.get());
+    }
 }
 
 auto Server::poll(const int timeout_ms) -> bool
 {
-    if (m_listen_socket.get_state() == Socket::State::CLOSED) {
+    if (m_listen_socket->get_state() == Socket::State::CLOSED) {
         return true; // NOP
     }
 
-    Select_sockets select_sockets;
+    // Interest flags change when clients have pending writes
+    register_sockets();
 
-    // Collect fds for select
-    m_listen_socket.pre_select(select_sockets);
-    for (auto& client : m_clients) {
-        client.pre_select(select_sockets);
-    }
-
-    // Call select() to find out if there is work to do
-    const int select_res = select_sockets.select(timeout_ms);
-    if (select_res == SOCKET_ERROR) {
-        log_net->trace("server select() returned error {}", get_net_last_error_message());
+    // Wait for ready sockets
+    const int poll_res = m_poller->poll(timeout_ms, m_events);
+    if (poll_res == SOCKET_ERROR) {
+        log_net->trace("server poll returned error {}", get_net_last_error_message());
         return false; // TODO
     }
 
-    // Perform send and receive for client sockets, collect closed sockets
-    for (auto& client : m_clients) {
-        client.post_select_send_recv(select_sockets);
+    // Perform send and receive for ready client sockets, check for new clients
+    std::optional<Socket> new_socket;
+    for (const Poll_event& event : m_events) {
+        if (event.socket == m_listen_socket.get()) {
+            new_socket = m_listen_socket->post_poll_listen(event.flags);
+            continue;
+        }
+        static_cast<void>(event.socket->post_poll_send_recv(event.flags));
     }
 
     // Remove closed sockets
@@ -70,30 +98,62 @@ auto Server::poll(const int timeout_ms) -> bool
         std::remove_if(
             m_clients.begin(),
             m_clients.end(),
-            [](Socket& client)
+            [this](std::unique_ptr<Socket>& client)
             {
-                return client.get_state() == Socket::State::CLOSED;
+                if (client->get_state() != Socket::State::CLOSED) {
+                    return false;
+                }
+                if (m_disconnect_handler) {
+                    m_disconnect_handler(*client.get());
+                }
+                m_poller->remove(*client.get());
+                return true;
             }
         ),
         m_clients.end()
     );
 
-    // Check for new clients
-    auto new_socket = m_listen_socket.post_select_listen(select_sockets);
     if (new_socket.has_value()) {
         log_net->info("new client is connecting to server");
-        new_socket.value().set_receive_handler(m_receive_handler);
-        m_clients.push_back(std::move(new_socket.value()));
+        m_clients.push_back(std::make_unique<Socket>(std::move(new_socket.value())));
+        Socket* const client = m_clients.back().get();
+        if (*m_client_receive_handler) {
+            client->set_receive_handler(
+                [handler = m_client_receive_handler, client](const uint8_t* data, const std::size_t length)
+                {
+                    if (*handler) {
+                        (*handler)(*client, data, length);
+                    }
+                }
+            );
+        } else {
+            client->set_receive_handler(m_receive_handler);
+        }
+        if (m_connect_handler) {
+            m_connect_handler(*client);
+        }
     }
 
     return true;
 }
 
+// Message is framed once and shared by all clients
 auto Server::broadcast(const std::string& message) -> bool
+{
+    if (m_clients.empty()) {
+        return true;
+    }
+    return broadcast(make_packet(message));
+}
+
+auto Server::broadcast(const std::shared_ptr<const Packet>& packet) -> bool
 {
     std::size_t error_count = 0;
     for (auto& client : m_clients) {
-        if (!client.send(message.data(), static_cast<int>(message.length()))) {
+        if (client->get_state() != Socket::State::CONNECTED) {
+            continue;
+        }
+        if (!client->send(packet)) {
             ++error_count;
         }
     }
@@ -105,15 +165,36 @@ void Server::set_receive_handler(Receive_handler receive_handler)
     m_receive_handler = receive_handler;
 }
 
+void Server::set_receive_handler(Client_receive_handler receive_handler)
+{
+    *m_client_receive_handler = receive_handler;
+}
+
+void Server::set_connect_handler(Client_handler connect_handler)
+{
+    m_connect_handler = connect_handler;
+}
+
+void Server::set_disconnect_handler(Client_handler disconnect_handler)
+{
+    m_disconnect_handler = disconnect_handler;
+}
+
 void Server::disconnect()
 {
-    m_listen_socket.close();
+    m_poller->clear();
+    m_listen_socket->close();
+    if (m_disconnect_handler) {
+        for (auto& client : m_clients) {
+            m_disconnect_handler(*client.get());
+        }
+    }
     m_clients.clear();
 }
 
 auto Server::get_state() const -> Socket::State
 {
-    return m_listen_socket.get_state();
+    return m_listen_socket->get_state();
 }
 
 auto Server::get_client_count() const -> std::size_t
@@ -121,4 +202,9 @@ auto Server::get_client_count() const -> std::size_t
     return m_clients.size();
 }
 
+auto Server::get_clients() const -> const std::vector<std::unique_ptr<Socket>>&
+{
+    return m_clients;
+}
+
 }
@@ -1,10 +1,20 @@
 #pragma once
 
 #include "erhe/net/socket.hpp"
+#include "erhe/net/socket_poller.hpp"
+
+#include <memory>
+#include <vector>
 
 namespace erhe::net
 {
 
+// Receive handler which also identifies the client socket
+using Client_receive_handler = std::function<void(Socket& client, const uint8_t* data, std::size_t length)>;
+
+// Called when client is accepted, and before closed client socket is destroyed
+using Client_handler = std::function<void(Socket& client)>;
+
 class Server
 {
 public:
@@ -16,17 +26,31 @@ public:
     auto operator=(Server&& other) noexcept -> Server&;
 
     auto broadcast          (const std::string& message) -> bool;
+    auto broadcast          (const std::shared_ptr<const Packet>& packet) -> bool;
     void set_receive_handler(Receive_handler receive_handler);
+    void set_receive_handler(Client_receive_handler receive_handler);
+    void set_connect_handler(Client_handler connect_handler);
+    void set_disconnect_handler(Client_handler disconnect_handler);
     void disconnect         ();
     auto listen             (const char* address, int port) -> bool;
     auto poll               (int timeout_ms) -> bool;
     auto get_state          () const -> Socket::State;
     auto get_client_count   () const -> std::size_t;
+    auto get_clients        () const -> const std::vector<std::unique_ptr<Socket>>&;
 
 private:
-    Socket              m_listen_socket;
-    Receive_handler     m_receive_handler;
-    std::vector<Socket> m_clients;
+    void register_sockets();
+
+    // Sockets are heap allocated, so that their addresses stay valid
+    // while registered to poller
+    std::unique_ptr<Socket>                 m_listen_socket;
+    Receive_handler                         m_receive_handler;
+    std::shared_ptr<Client_receive_handler> m_client_receive_handler; // shared with accepted client sockets
+    Client_handler                          m_connect_handler;
+    Client_handler                          m_disconnect_handler;
+    std::vector<std::unique_ptr<Socket>>    m_clients;
+    std::unique_ptr<Socket_poller>          m_poller;
+    std::vector<Poll_event>                 m_events;
 };
 
 }
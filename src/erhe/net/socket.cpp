@@ -6,6 +6,9 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace erhe::net
 {
@@ -44,6 +47,46 @@ Packet_header::Packet_header(const uint32_t length)
 {
 }
 
+Packet::Packet(const uint8_t* const payload, const std::size_t payload_length)
+{
+    const Packet_header header{static_cast<uint32_t>(payload_length)};
+    m_bytes.resize(sizeof(Packet_header) + payload_length);
+    memcpy(m_bytes.data(), &header, sizeof(Packet_header));
+    if (payload_length > 0) {
+        memcpy(m_bytes.data() + sizeof(Packet_header), payload, payload_length);
+    }
+}
+
+auto make_packet(const std::string& message) -> std::shared_ptr<const Packet>
+{
+    return std::make_shared<const Packet>(
+        reinterpret_cast<const uint8_t*>(message.data()),
+        message.size()
+    );
+}
+
+namespace {
+
+[[nodiscard]] auto get_ready_flags(
+    const Select_sockets& select_sockets,
+    const SOCKET          socket
+) -> unsigned int
+{
+    unsigned int flags{0};
+    if (select_sockets.has_read(socket)) {
+        flags |= c_poll_read;
+    }
+    if (select_sockets.has_write(socket)) {
+        flags |= c_poll_write;
+    }
+    if (select_sockets.has_except(socket)) {
+        flags |= c_poll_except;
+    }
+    return flags;
+}
+
+} // anonymous namespace
+
 Socket::Socket()
 {
     log_socket->trace("Socket default constructor");
@@ -86,13 +129,16 @@ Socket::Socket(Socket&& other) noexcept
     , m_address        {std::move(other.m_address)}
     , m_state          {other.m_state}
     , m_send_buffer    {std::move(other.m_send_buffer)}
+    , m_send_segments  {std::move(other.m_send_segments)}
+    , m_send_queue_byte_count{other.m_send_queue_byte_count}
     , m_receive_buffer {std::move(other.m_receive_buffer)}
     , m_receive_handler{std::move(other.m_receive_handler)}
 {
     log_socket->trace("Socket move constructor");
-    other.m_socket    = INVALID_SOCKET;
-    other.m_state     = State::CLOSED;
-    other.m_addr_info = nullptr;
+    other.m_socket                = INVALID_SOCKET;
+    other.m_state                 = State::CLOSED;
+    other.m_addr_info             = nullptr;
+    other.m_send_queue_byte_count = 0;
 }
 
 auto Socket::operator=(Socket&& other) noexcept -> Socket&
@@ -104,11 +150,14 @@ auto Socket::operator=(Socket&& other) noexcept -> Socket&
     m_address         = std::move(other.m_address);
     m_state           = other.m_state;
     m_send_buffer     = std::move(other.m_send_buffer);
+    m_send_segments   = std::move(other.m_send_segments);
+    m_send_queue_byte_count = other.m_send_queue_byte_count;
     m_receive_buffer  = std::move(other.m_receive_buffer);
     m_receive_handler = std::move(other.m_receive_handler);
     other.m_socket    = INVALID_SOCKET;
     other.m_state     = State::CLOSED;
     other.m_addr_info = nullptr;
+    other.m_send_queue_byte_count = 0;
     return *this;
 }
 
@@ -120,6 +169,8 @@ void Socket::close()
         m_addr_info = nullptr;
     }
     m_send_buffer.reset();
+    m_send_segments.clear();
+    m_send_queue_byte_count = 0;
     m_receive_buffer.reset();
     if (is_socket_good(m_socket)) {
         log_socket->info("Closing socket");
@@ -248,29 +299,53 @@ auto Socket::send_pending() -> bool
     ERHE_VERIFY(m_state == State::CONNECTED);
     ERHE_VERIFY(m_send_buffer);
 
-    // Loop (at most) twice, for the case where the ring buffer
-    // wraps around, in which case two send() calls are needed.
-    for (;;) {
-        if (m_send_buffer->empty()) {
-            return true;
-        }
+    std::array<Send_span, c_max_send_span_count> spans;
+    while (m_send_queue_byte_count > 0) {
+        // Gather queued segments, so that everything which fits can be
+        // sent with one system call. Ring buffer data may wrap around.
+        std::span<const uint8_t> ring_before_wrap;
+        std::span<const uint8_t> ring_after_wrap;
+        m_send_buffer->begin_consume(ring_before_wrap, ring_after_wrap);
+
+        std::size_t span_count       {0};
+        std::size_t gather_byte_count{0};
+        std::size_t ring_offset      {0};
+        for (const auto& segment : m_send_segments) {
+            if (segment.packet) {
+                if (span_count == spans.size()) {
+                    break;
+                }
+                spans[span_count++] = Send_span{segment.packet->data() + segment.offset, segment.byte_count};
+                gather_byte_count += segment.byte_count;
+                continue;
+            }
 
-        std::size_t          can_send_byte_count_before_wrap{0};
-        std::size_t          can_send_byte_count_after_wrap {0};
-        const uint8_t* const read_pointer    = m_send_buffer->begin_consume(can_send_byte_count_before_wrap, can_send_byte_count_after_wrap);
-        const int            send_result     = ::send(m_socket, reinterpret_cast<const char*>(read_pointer), static_cast<int>(can_send_byte_count_before_wrap), 0);
-        const int            sent_byte_count = (std::max)(0, send_result);
-        if (can_send_byte_count_after_wrap > 0) {
-            log_socket->info("send() before wrap {} bytes, after wrap {} bytes", can_send_byte_count_before_wrap, can_send_byte_count_after_wrap);
+            std::size_t remaining = segment.byte_count;
+            if ((ring_offset < ring_before_wrap.size()) && (span_count < spans.size())) {
+                const std::size_t count = (std::min)(remaining, ring_before_wrap.size() - ring_offset);
+                spans[span_count++] = Send_span{ring_before_wrap.data() + ring_offset, count};
+                ring_offset += count;
+                remaining   -= count;
+            }
+            if ((remaining > 0) && (span_count < spans.size())) {
+                const std::size_t after_wrap_offset = ring_offset - ring_before_wrap.size();
+                spans[span_count++] = Send_span{ring_after_wrap.data() + after_wrap_offset, remaining};
+                ring_offset += remaining;
+                remaining    = 0;
+            }
+            gather_byte_count += segment.byte_count - remaining;
+            if (remaining > 0) {
+                break;
+            }
         }
+
+        const int send_result = send_gather(m_socket, spans.data(), span_count);
         if (send_result < 0) {
-            m_send_buffer->end_consume(0);
             const int error_code = get_net_last_error();
-            if (is_error_fatal(error_code))
-            {
+            if (is_error_fatal(error_code)) {
                 log_socket->error(
                     "send({} bytes) failed with error {}",
-                    can_send_byte_count_before_wrap,
+                    gather_byte_count,
                     get_net_error_message(error_code)
                 );
                 close();
@@ -278,17 +353,37 @@ auto Socket::send_pending() -> bool
             }
             return true;
         }
-        m_send_buffer->end_consume(sent_byte_count);
-        if (
-            (sent_byte_count < can_send_byte_count_before_wrap) ||
-            (can_send_byte_count_after_wrap == 0)
-        ) {
-            break;
+
+        const std::size_t sent_byte_count = static_cast<std::size_t>(send_result);
+        consume_sent(sent_byte_count);
+        if (sent_byte_count < gather_byte_count) {
+            break; // Socket send buffer is full
         }
     }
     return true;
 }
 
+void Socket::consume_sent(std::size_t byte_count)
+{
+    ERHE_VERIFY(byte_count <= m_send_queue_byte_count);
+
+    m_send_queue_byte_count -= byte_count;
+    while (byte_count > 0) {
+        Send_segment&     segment = m_send_segments.front();
+        const std::size_t count   = (std::min)(byte_count, segment.byte_count);
+        if (segment.packet) {
+            segment.offset += count;
+        } else {
+            m_send_buffer->end_consume(count);
+        }
+        segment.byte_count -= count;
+        byte_count         -= count;
+        if (segment.byte_count == 0) {
+            m_send_segments.pop_front();
+        }
+    }
+}
+
 // Sends a packet. Returns true if there was no error, false if there was an error.
 auto Socket::send(const char* const data, const int length) -> bool
 {
@@ -312,7 +407,7 @@ auto Socket::send(const char* const data, const int length) -> bool
     }
 
     // Write header to send buffer
-    const Packet_header header{static_cast<size_t>(length)};
+    const Packet_header header{static_cast<uint32_t>(length)};
     const auto header_byte_write_count = m_send_buffer->write(reinterpret_cast<const uint8_t*>(&header), sizeof(Packet_header));
     ERHE_VERIFY(header_byte_write_count == sizeof(Packet_header));
 
@@ -320,10 +415,48 @@ auto Socket::send(const char* const data, const int length) -> bool
     const auto payload_byte_write_count = m_send_buffer->write(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(length));
     ERHE_VERIFY(payload_byte_write_count == length);
 
+    // Queue written bytes, extending previous ring buffer segment if possible
+    const std::size_t byte_count = sizeof(Packet_header) + static_cast<std::size_t>(length);
+    if (!m_send_segments.empty() && !m_send_segments.back().packet) {
+        m_send_segments.back().byte_count += byte_count;
+    } else {
+        m_send_segments.push_back(Send_segment{.packet = {}, .offset = 0, .byte_count = byte_count});
+    }
+    m_send_queue_byte_count += byte_count;
+
     // Try to send some or all of the queued send buffer
     return send_pending();
 }
 
+// Queues a shared packet, without copying it.
+// Returns true if there was no error, false if there was an error.
+auto Socket::send(const std::shared_ptr<const Packet>& packet) -> bool
+{
+    ERHE_VERIFY(m_state == State::CONNECTED);
+    ERHE_VERIFY(packet);
+
+    // Queued packets are limited by send buffer capacity, like copied messages
+    const std::size_t max_queue_byte_count = m_send_buffer->max_size();
+    if (m_send_queue_byte_count + packet->size() > max_queue_byte_count) {
+        const auto send_pending_result = send_pending();
+        if (!send_pending_result) {
+            return false;
+        }
+        if (m_send_queue_byte_count + packet->size() > max_queue_byte_count) {
+            log_socket->warn(
+                "packet ({} bytes) does not fit to send queue ({} bytes queued)",
+                packet->size(),
+                m_send_queue_byte_count
+            );
+            return false;
+        }
+    }
+
+    m_send_segments.push_back(Send_segment{.packet = packet, .offset = 0, .byte_count = packet->size()});
+    m_send_queue_byte_count += packet->size();
+    return send_pending();
+}
+
 auto Socket::receive_packet_length() -> uint32_t
 {
     ERHE_VERIFY(m_state == State::CONNECTED);
@@ -421,46 +554,69 @@ auto Socket::recv() -> bool
     return true;
 }
 
-void Socket::pre_select(Select_sockets& select_sockets)
+auto Socket::get_poll_flags() const -> unsigned int
 {
     switch (m_state) {
         case State::CLOSED: {
-            return;
+            return 0;
         }
 
         case State::CLIENT_CONNECTING: {
-            select_sockets.set_write (m_socket);
-            select_sockets.set_except(m_socket); // For connect errors
-            return;
+            return c_poll_write | c_poll_except; // except for connect errors
         }
 
         case State::SERVER_LISTENING: {
-            select_sockets.set_read(m_socket);
-            return;
+            return c_poll_read;
         }
 
         default: {
-            // Check socket writability
-            if (has_pending_writes()) {
-                select_sockets.set_write(m_socket);
-            }
-
-            // Check socket readability
-            select_sockets.set_read(m_socket);
+            // Check socket writability only when there is something to send
+            return has_pending_writes()
+                ? (c_poll_read | c_poll_write)
+                : c_poll_read;
         }
     }
 }
 
-// returns false in case of error, true if ok
+void Socket::pre_select(Select_sockets& select_sockets)
+{
+    const unsigned int flags = get_poll_flags();
+    if ((flags & c_poll_read) != 0) {
+        select_sockets.set_read(m_socket);
+    }
+    if ((flags & c_poll_write) != 0) {
+        select_sockets.set_write(m_socket);
+    }
+    if ((flags & c_poll_except) != 0) {
+        select_sockets.set_except(m_socket);
+    }
+}
+
 auto Socket::post_select_send_recv(Select_sockets& select_sockets) -> bool
 {
-    if (select_sockets.has_write(m_socket)) {
+    return post_poll_send_recv(get_ready_flags(select_sockets, m_socket));
+}
+
+auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
+{
+    return post_poll_connect(get_ready_flags(select_sockets, m_socket));
+}
+
+auto Socket::post_select_listen(Select_sockets& select_sockets) -> std::optional<Socket>
+{
+    return post_poll_listen(get_ready_flags(select_sockets, m_socket));
+}
+
+// returns false in case of error, true if ok
+auto Socket::post_poll_send_recv(const unsigned int ready_flags) -> bool
+{
+    if ((ready_flags & c_poll_write) != 0) {
         const bool send_ok = send_pending();
         if (!send_ok) {
             return false;
         }
     }
-    if (select_sockets.has_read(m_socket)) {
+    if ((ready_flags & c_poll_read) != 0) {
         const bool recv_ok = recv();
         if (!recv_ok) {
             return false;
@@ -516,9 +672,9 @@ auto Socket::connect() -> bool
 }
 
 // returns false in case of error, true if ok
-auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
+auto Socket::post_poll_connect(const unsigned int ready_flags) -> bool
 {
-    if (select_sockets.has_except(m_socket)) {
+    if ((ready_flags & c_poll_except) != 0) {
         // connection attempt failed. retry
         connect();
 
@@ -534,7 +690,7 @@ auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
         return false;
     }
 
-    const bool is_writable = select_sockets.has_write(m_socket);
+    const bool is_writable = (ready_flags & c_poll_write) != 0;
     if (is_writable) {
         // man connect:
         // > After select(2) indicates writability, use getsockopt(2) to read the SO_ERROR option at
@@ -565,10 +721,10 @@ auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
     return true;
 }
 
-auto Socket::post_select_listen(Select_sockets& select_sockets) -> std::optional<Socket>
+auto Socket::post_poll_listen(const unsigned int ready_flags) -> std::optional<Socket>
 {
-    if (select_sockets.has_read(m_socket)) {
-        log_socket->info("Server post_select_listen() has readable socket");
+    if ((ready_flags & c_poll_read) != 0) {
+        log_socket->info("Server post_poll_listen() has readable socket");
 
         sockaddr_in  address{};
         socklen_t    len        = sizeof(address);
@@ -583,6 +739,9 @@ auto Socket::post_select_listen(Select_sockets& select_sockets) -> std::optional
             // TODO check if already added
             // TODO set buffer sizes
             log_socket->info("Server accept(): new connection");
+
+            // Accepted socket does not inherit non-blocking mode on all platforms
+            static_cast<void>(set_socket_option(accept_res, Socket_option::NonBlocking, true));
             return Socket{accept_res, address};
         }
     }
@@ -3,6 +3,7 @@
 #include "erhe/net/ring_buffer.hpp"
 #include "erhe/net/net_os.hpp"
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -16,6 +17,27 @@ using Receive_handler = std::function<void(const uint8_t* data, std::size_t leng
 
 class Select_sockets;
 
+// Socket readiness flags, see Socket_poller
+static constexpr unsigned int c_poll_read   = (1u << 0u);
+static constexpr unsigned int c_poll_write  = (1u << 1u);
+static constexpr unsigned int c_poll_except = (1u << 2u);
+
+// Framed message (packet header and payload), serialized once. The same
+// packet can be queued to any number of sockets without copying.
+class Packet
+{
+public:
+    Packet(const uint8_t* payload, std::size_t payload_length);
+
+    [[nodiscard]] auto data() const -> const uint8_t* { return m_bytes.data(); }
+    [[nodiscard]] auto size() const -> std::size_t    { return m_bytes.size(); }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+[[nodiscard]] auto make_packet(const std::string& message) -> std::shared_ptr<const Packet>;
+
 class Socket
 {
 public:
@@ -42,13 +64,20 @@ public:
     auto get_socket          () const -> SOCKET                { return m_socket; }
     auto get_sockaddr_in     () const -> const sockaddr_in&    { return m_address_in; }
     auto get_address_string  () const -> const std::string&    { return m_address; }
-    auto get_send_buffer_size() const -> size_t                { return m_send_buffer ? m_send_buffer->size() : 0; }
+    auto get_send_buffer_size() const -> size_t                { return m_send_queue_byte_count; }
     auto send                (const char* data, int length) -> bool;
+    auto send                (const std::shared_ptr<const Packet>& packet) -> bool;
     auto send_pending        () -> bool;
     auto recv                () -> bool;
     auto get_receive_buffer  () -> Ring_buffer* { return m_receive_buffer.get(); }
     void close               ();
-    auto has_pending_writes  () -> bool         { return m_send_buffer ? !m_send_buffer->empty() : false; }
+    auto has_pending_writes  () const -> bool   { return m_send_queue_byte_count > 0; }
+
+    // Readiness flags (c_poll_*) the socket is waiting for in current state
+    auto get_poll_flags       () const -> unsigned int;
+    auto post_poll_send_recv  (unsigned int ready_flags) -> bool;
+    auto post_poll_connect    (unsigned int ready_flags) -> bool;
+    auto post_poll_listen     (unsigned int ready_flags) -> std::optional<Socket>;
 
     void pre_select           (Select_sockets& select_sockets);
     auto post_select_send_recv(Select_sockets& select_sockets) -> bool;
@@ -59,10 +88,21 @@ public:
     auto bind   (const char* address, int port) -> bool; // for server
 
 private:
+    // Queued data is sent in segment order. Segments without packet refer
+    // to bytes in the send ring buffer, others to a shared packet.
+    class Send_segment
+    {
+    public:
+        std::shared_ptr<const Packet> packet;
+        std::size_t                   offset    {0}; // sent bytes of packet
+        std::size_t                   byte_count{0}; // unsent bytes
+    };
+
     auto connect              () -> bool;
     void set_state            (State state);
     void on_state_changed     (State old_state, State new_state);
     auto receive_packet_length() -> uint32_t;
+    void consume_sent         (std::size_t byte_count);
 
     SOCKET                       m_socket   {INVALID_SOCKET};
     sockaddr_in                  m_address_in;
@@ -70,6 +110,8 @@ private:
     std::string                  m_address;
     State                        m_state    {State::CLOSED};
     std::unique_ptr<Ring_buffer> m_send_buffer;
+    std::deque<Send_segment>     m_send_segments;
+    std::size_t                  m_send_queue_byte_count{0};
     std::unique_ptr<Ring_buffer> m_receive_buffer;
     Receive_handler              m_receive_handler;
 };
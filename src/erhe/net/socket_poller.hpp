@@ -0,0 +1,59 @@
+#pragma once
+
+#include "erhe/net/net_os.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::net
+{
+
+class Socket;
+
+class Poll_event
+{
+public:
+    Socket*      socket{nullptr};
+    unsigned int flags {0}; // c_poll_read, c_poll_write, c_poll_except
+};
+
+// Waits for readiness of a set of sockets. On Linux sockets are kept
+// registered to a persistent epoll instance, so cost of poll() depends on
+// number of ready sockets only, and there is no FD_SETSIZE limit. Other
+// platforms use select().
+//
+// Sockets must not move in memory while registered. Call update() when
+// socket state or pending writes change (in practice, before each poll()).
+class Socket_poller
+{
+public:
+    Socket_poller();
+    ~Socket_poller() noexcept;
+    Socket_poller (const Socket_poller&) = delete;
+    void operator=(const Socket_poller&) = delete;
+
+    // Registers socket, or updates its interest flags from Socket::get_poll_flags().
+    // Closed sockets are removed.
+    void update(Socket& socket);
+    void remove(Socket& socket);
+    void clear ();
+
+    // Returns number of events, or SOCKET_ERROR
+    auto poll(int timeout_ms, std::vector<Poll_event>& events) -> int;
+
+private:
+    class Registration
+    {
+    public:
+        SOCKET       socket{INVALID_SOCKET};
+        unsigned int flags {0};
+    };
+
+    std::unordered_map<Socket*, Registration> m_registrations;
+#if defined(ERHE_OS_LINUX)
+    int                                       m_epoll_fd{-1};
+    std::vector<epoll_event>                  m_epoll_events;
+#endif
+};
+
+} // namespace erhe::net
@@ -0,0 +1,164 @@
+#include "erhe/net/socket_poller.hpp"
+#include "erhe/net/net_log.hpp"
+#include "erhe/net/socket.hpp"
+
+namespace erhe::net
+{
+
+namespace {
+
+[[nodiscard]] auto get_epoll_events(const unsigned int flags) -> uint32_t
+{
+    uint32_t events{0};
+    if ((flags & c_poll_read) != 0) {
+        events |= EPOLLIN;
+    }
+    if ((flags & c_poll_write) != 0) {
+        events |= EPOLLOUT;
+    }
+    if ((flags & c_poll_except) != 0) {
+        events |= EPOLLPRI;
+    }
+    return events; // EPOLLERR and EPOLLHUP are always reported
+}
+
+[[nodiscard]] auto get_poll_flags(const uint32_t events) -> unsigned int
+{
+    unsigned int flags{0};
+    if ((events & EPOLLIN) != 0) {
+        flags |= c_poll_read;
+    }
+    if ((events & EPOLLOUT) != 0) {
+        flags |= c_poll_write;
+    }
+    if ((events & EPOLLPRI) != 0) {
+        flags |= c_poll_except;
+    }
+    if ((events & (EPOLLERR | EPOLLHUP)) != 0) {
+        // Let recv() / send() / connect completion observe the error
+        flags |= c_poll_read | c_poll_write | c_poll_except;
+    }
+    return flags;
+}
+
+} // anonymous namespace
+
+Socket_poller::Socket_poller()
+    : m_epoll_fd{::epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (m_epoll_fd < 0) {
+        log_net->error("epoll_create1() failed with error {}", get_net_last_error_message());
+    }
+}
+
+Socket_poller::~Socket_poller() noexcept
+{
+    if (m_epoll_fd >= 0) {
+        ::close(m_epoll_fd);
+    }
+}
+
+void Socket_poller::update(Socket& socket)
+{
+    const SOCKET       fd    = socket.get_socket();
+    const unsigned int flags = socket.get_poll_flags();
+    if (!is_socket_good(fd) || (flags == 0)) {
+        remove(socket);
+        return;
+    }
+
+    epoll_event event{};
+    event.events   = get_epoll_events(flags);
+    event.data.ptr = &socket;
+
+    const auto i = m_registrations.find(&socket);
+    if (i != m_registrations.end()) {
+        Registration& registration = i->second;
+        if (registration.socket == fd) {
+            if (registration.flags == flags) {
+                return;
+            }
+            if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0) {
+                registration.flags = flags;
+                return;
+            }
+            if (errno != ENOENT) {
+                log_net->error("epoll_ctl(MOD) failed with error {}", get_net_last_error_message());
+                return;
+            }
+            // Socket was closed and reopened with the same descriptor number
+        }
+
+        // Socket was closed and reopened (client reconnect); the old
+        // descriptor is already removed from epoll set by close().
+        m_registrations.erase(i);
+    }
+
+    if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        log_net->error("epoll_ctl(ADD) failed with error {}", get_net_last_error_message());
+        return;
+    }
+    m_registrations.emplace(&socket, Registration{.socket = fd, .flags = flags});
+}
+
+void Socket_poller::remove(Socket& socket)
+{
+    const auto i = m_registrations.find(&socket);
+    if (i == m_registrations.end()) {
+        return;
+    }
+
+    // Closing the descriptor removes it from epoll set
+    if (i->second.socket == socket.get_socket()) {
+        epoll_event event{};
+        static_cast<void>(::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, i->second.socket, &event));
+    }
+    m_registrations.erase(i);
+}
+
+void Socket_poller::clear()
+{
+    for (const auto& [socket, registration] : m_registrations) {
+        if (registration.socket == socket->get_socket()) {
+            epoll_event event{};
+            static_cast<void>(::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, registration.socket, &event));
+        }
+    }
+    m_registrations.clear();
+}
+
+auto Socket_poller::poll(const int timeout_ms, std::vector<Poll_event>& events) -> int
+{
+    events.clear();
+    if (m_registrations.empty()) {
+        return 0;
+    }
+
+    m_epoll_events.resize(m_registrations.size());
+    const int result = ::epoll_wait(
+        m_epoll_fd,
+        m_epoll_events.data(),
+        static_cast<int>(m_epoll_events.size()),
+        timeout_ms
+    );
+    if (result < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        return SOCKET_ERROR;
+    }
+
+    events.reserve(static_cast<std::size_t>(result));
+    for (int i = 0; i < result; ++i) {
+        const epoll_event& event = m_epoll_events[static_cast<std::size_t>(i)];
+        events.push_back(
+            Poll_event{
+                .socket = static_cast<Socket*>(event.data.ptr),
+                .flags  = get_poll_flags(event.events)
+            }
+        );
+    }
+    return result;
+}
+
+} // namespace erhe::net
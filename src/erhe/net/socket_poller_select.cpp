@@ -0,0 +1,80 @@
+#include "erhe/net/socket_poller.hpp"
+#include "erhe/net/select_sockets.hpp"
+#include "erhe/net/socket.hpp"
+
+namespace erhe::net
+{
+
+Socket_poller::Socket_poller() = default;
+
+Socket_poller::~Socket_poller() noexcept = default;
+
+void Socket_poller::update(Socket& socket)
+{
+    const SOCKET       fd    = socket.get_socket();
+    const unsigned int flags = socket.get_poll_flags();
+    if (!is_socket_good(fd) || (flags == 0)) {
+        remove(socket);
+        return;
+    }
+    m_registrations[&socket] = Registration{.socket = fd, .flags = flags};
+}
+
+void Socket_poller::remove(Socket& socket)
+{
+    m_registrations.erase(&socket);
+}
+
+void Socket_poller::clear()
+{
+    m_registrations.clear();
+}
+
+// Descriptor sets are rebuilt for each select() call
+auto Socket_poller::poll(const int timeout_ms, std::vector<Poll_event>& events) -> int
+{
+    events.clear();
+    if (m_registrations.empty()) {
+        return 0;
+    }
+
+    Select_sockets select_sockets;
+    for (const auto& [socket, registration] : m_registrations) {
+        if ((registration.flags & c_poll_read) != 0) {
+            select_sockets.set_read(registration.socket);
+        }
+        if ((registration.flags & c_poll_write) != 0) {
+            select_sockets.set_write(registration.socket);
+        }
+        if ((registration.flags & c_poll_except) != 0) {
+            select_sockets.set_except(registration.socket);
+        }
+    }
+
+    const int select_res = select_sockets.select(timeout_ms);
+    if (select_res == SOCKET_ERROR) {
+        return SOCKET_ERROR;
+    }
+    if (select_res == 0) {
+        return 0;
+    }
+
+    for (const auto& [socket, registration] : m_registrations) {
+        unsigned int flags{0};
+        if (select_sockets.has_read(registration.socket)) {
+            flags |= c_poll_read;
+        }
+        if (select_sockets.has_write(registration.socket)) {
+            flags |= c_poll_write;
+        }
+        if (select_sockets.has_except(registration.socket)) {
+            flags |= c_poll_except;
+        }
+        if (flags != 0) {
+            events.push_back(Poll_event{.socket = socket, .flags = flags});
+        }
+    }
+    return static_cast<int>(events.size());
+}
+
+} // namespace erhe::net
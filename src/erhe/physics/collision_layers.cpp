@@ -0,0 +1,105 @@
+#include "erhe/physics/collision_layers.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+namespace erhe::physics
+{
+
+namespace Layers {
+
+[[nodiscard]] auto get_layer(const Motion_mode motion_mode) -> Object_layer
+{
+    switch (motion_mode) {
+        case Motion_mode::e_static:                 return Layers::NON_MOVING;
+        case Motion_mode::e_kinematic_non_physical: return Layers::MOVING;
+        case Motion_mode::e_kinematic_physical:     return Layers::MOVING;
+        case Motion_mode::e_dynamic:                return Layers::MOVING;
+        default:                                    return Layers::MOVING;
+    }
+}
+
+} // namespace Layers
+
+auto Collision_layers::get_default() -> Collision_layers
+{
+    Collision_layers layers;
+    layers.broad_phase_layer_names = {
+        "NON_MOVING",
+        "MOVING",
+        "NON_COLLIDING",
+        "DEBRIS"
+    };
+    layers.add_object_layer("NON_MOVING",    0, mask(Layers::MOVING) | mask(Layers::DEBRIS));
+    layers.add_object_layer("MOVING",        1, mask(Layers::NON_MOVING) | mask(Layers::MOVING) | mask(Layers::DEBRIS));
+    layers.add_object_layer("NON_COLLIDING", 2, 0u);
+    layers.add_object_layer("DEBRIS",        3, mask(Layers::NON_MOVING) | mask(Layers::MOVING));
+    return layers;
+}
+
+auto Collision_layers::add_object_layer(
+    const std::string&      name,
+    const Broad_phase_layer broad_phase_layer,
+    const uint32_t          collision_mask
+) -> Object_layer
+{
+    ERHE_VERIFY(object_layers.size() < c_max_object_layers);
+    ERHE_VERIFY(broad_phase_layer < c_max_broad_phase_layers);
+
+    object_layers.push_back(
+        Object_layer_entry{
+            .name              = name,
+            .broad_phase_layer = broad_phase_layer,
+            .collision_mask    = collision_mask
+        }
+    );
+    return static_cast<Object_layer>(object_layers.size() - 1);
+}
+
+void Collision_layers::set_layer_collision(
+    const Object_layer lhs,
+    const Object_layer rhs,
+    const bool         enable
+)
+{
+    ERHE_VERIFY(lhs < object_layers.size());
+    ERHE_VERIFY(rhs < object_layers.size());
+
+    if (enable) {
+        object_layers[lhs].collision_mask |= mask(rhs);
+        object_layers[rhs].collision_mask |= mask(lhs);
+    } else {
+        object_layers[lhs].collision_mask &= ~mask(rhs);
+        object_layers[rhs].collision_mask &= ~mask(lhs);
+    }
+}
+
+auto Collision_layers::should_collide(
+    const Object_layer lhs,
+    const Object_layer rhs
+) const -> bool
+{
+    if ((lhs >= object_layers.size()) || (rhs >= object_layers.size())) {
+        return false;
+    }
+    return (object_layers[lhs].collision_mask & mask(rhs)) != 0;
+}
+
+void Collision_layers::make_symmetric()
+{
+    const std::size_t count = object_layers.size();
+    const uint32_t valid_mask = (count >= 32)
+        ? ~uint32_t{0}
+        : (uint32_t{1} << count) - 1u;
+
+    for (auto& layer : object_layers) {
+        layer.collision_mask &= valid_mask;
+    }
+    for (std::size_t lhs = 0; lhs < count; ++lhs) {
+        for (std::size_t rhs = 0; rhs < count; ++rhs) {
+            if ((object_layers[lhs].collision_mask & mask(static_cast<Object_layer>(rhs))) != 0) {
+                object_layers[rhs].collision_mask |= mask(static_cast<Object_layer>(lhs));
+            }
+        }
+    }
+}
+
+} // namespace erhe::physics
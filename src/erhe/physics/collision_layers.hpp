@@ -0,0 +1,88 @@
+#pragma once
+
+#include "erhe/physics/imotion_state.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace erhe::physics
+{
+
+using Object_layer      = uint8_t;
+using Broad_phase_layer = uint8_t;
+
+// Collision masks have one bit for each object layer
+static constexpr std::size_t c_max_object_layers      = 32;
+static constexpr std::size_t c_max_broad_phase_layers = 32;
+
+// Object layers of the default configuration
+namespace Layers
+{
+
+static constexpr Object_layer NON_MOVING    = 0u;
+static constexpr Object_layer MOVING        = 1u;
+static constexpr Object_layer NON_COLLIDING = 2u;
+static constexpr Object_layer DEBRIS        = 3u;
+static constexpr Object_layer NUM_LAYERS    = 4u;
+
+// Default object layer for bodies which do not specify one
+[[nodiscard]] auto get_layer(const Motion_mode motion_mode) -> Object_layer;
+
+};
+
+// Each rigid body is in one object layer. Two bodies can collide only if
+// the collision mask of one object layer contains the other object layer.
+// World keeps collision masks symmetric.
+//
+// Each object layer is assigned to a broad phase layer. Each broad phase
+// layer is a separate bounding volume tree in the broad phase. Keeping large
+// static geometry and numerous small bodies (debris) in separate broad phase
+// layers keeps pair generation from traversing a tree full of bodies which
+// cannot collide anyway.
+//
+// Broad phase layers are fixed when the world is created. Collision masks
+// can be changed with IWorld::set_layer_collision(). Bodies which do not
+// specify an object layer use Layers::get_layer() or NON_COLLIDING, so
+// custom configurations should keep the first three layers.
+class Collision_layers
+{
+public:
+    class Object_layer_entry
+    {
+    public:
+        std::string       name;
+        Broad_phase_layer broad_phase_layer{0};
+        uint32_t          collision_mask   {0};
+    };
+
+    // NON_MOVING, MOVING, NON_COLLIDING and DEBRIS object layers, each in
+    // a broad phase layer of their own. Static bodies collide with moving
+    // bodies and debris, debris does not collide with debris.
+    [[nodiscard]] static auto get_default() -> Collision_layers;
+
+    [[nodiscard]] static constexpr auto mask(const Object_layer layer) -> uint32_t
+    {
+        return uint32_t{1} << layer;
+    }
+
+    // Adds object layer, returns index of the new layer
+    auto add_object_layer(
+        const std::string& name,
+        Broad_phase_layer  broad_phase_layer,
+        uint32_t           collision_mask
+    ) -> Object_layer;
+
+    // Sets or clears collision between two object layers, in both masks
+    void set_layer_collision(Object_layer lhs, Object_layer rhs, bool enable);
+
+    [[nodiscard]] auto should_collide(Object_layer lhs, Object_layer rhs) const -> bool;
+
+    // Makes collision masks symmetric and clears bits of nonexistent layers
+    void make_symmetric();
+
+    std::vector<std::string>        broad_phase_layer_names;
+    std::vector<Object_layer_entry> object_layers;
+};
+
+} // namespace erhe::physics
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "erhe/physics/collision_layers.hpp"
 #include "erhe/physics/transform.hpp"
 #include "erhe/physics/imotion_state.hpp"
 
@@ -34,6 +35,7 @@ public:
     std::optional<glm::mat4>          inertia_override {};
     const char*                       debug_label      {nullptr};
     bool                              enable_collisions{true};
+    std::optional<Object_layer>       object_layer     {}; // default is based on motion mode and enable_collisions
 };
 
 class IRigid_body
@@ -63,6 +65,7 @@ public:
     [[nodiscard]] virtual auto get_local_inertia           () const -> glm::mat4                         = 0;
     [[nodiscard]] virtual auto get_mass                    () const -> float                             = 0;
     [[nodiscard]] virtual auto get_motion_mode             () const -> Motion_mode                       = 0;
+    [[nodiscard]] virtual auto get_object_layer            () const -> Object_layer                      = 0;
     [[nodiscard]] virtual auto get_restitution             () const -> float                             = 0;
     [[nodiscard]] virtual auto get_world_transform         () const -> Transform                         = 0;
     virtual void begin_move                  ()                                             = 0;
@@ -76,6 +79,7 @@ public:
     virtual void set_linear_velocity         (const glm::vec3& velocity)                    = 0;
     virtual void set_mass_properties         (float mass, const glm::mat4& local_inertia)   = 0;
     virtual void set_motion_mode             (Motion_mode motion_mode)                      = 0;
+    virtual void set_object_layer            (Object_layer object_layer)                    = 0;
     virtual void set_restitution             (float restitution)                            = 0;
     virtual void set_world_transform         (const Transform& transform)                   = 0;
 };
@@ -1,26 +1,65 @@
 #pragma once
 
+#include "erhe/physics/collision_layers.hpp"
+#include "erhe/physics/spatial_query.hpp"
+
 #include <glm/glm.hpp>
 
 #include <memory>
+#include <vector>
+
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
 
 namespace erhe::physics
 {
 
+class ICollision_shape;
 class IConstraint;
 class IDebug_draw;
 class IMotion_state;
 class IRigid_body;
 class IRigid_body_create_info;
 
+// Transform of a rigid body which was active (not sleeping) after a step
+class Active_body_transform
+{
+public:
+    IRigid_body*   rigid_body;
+    IMotion_state* motion_state;
+    glm::mat4      world_from_rigidbody;
+};
+
+// With async updates enabled, update_fixed_step() only queues steps.
+// begin_async_update() runs queued steps in the thread pool, overlapped
+// with rendering. end_async_update() waits for the steps to complete and
+// publishes motion states; call it at frame start. Rigid body accessors
+// complete a running async update first, so they are safe to call at any
+// time, but calling them during rendering removes the overlap; read
+// motion states or cached results there instead.
+//
+// With bulk motion state updates enabled, IMotion_state is not updated for
+// each body after each step. Instead, take_active_body_transforms() returns
+// latest transforms of bodies which were active in steps since the previous
+// call, one entry per body. Sleeping bodies are not included.
+//
+// add_rigid_bodies() inserts a batch of bodies with a single broad phase
+// update. Prefer it over add_rigid_body() when adding many bodies at once,
+// for example static geometry when a scene is loaded.
+//
+// Spatial queries use the broad phase maintained by the physics world, so
+// tools do not need a separate acceleration structure. Queries wait for a
+// running async update to complete. cast_rays() runs in the thread pool.
 class IWorld
 {
 public:
     virtual ~IWorld() noexcept;
 
-    [[nodiscard]] static auto create       () -> IWorld*;
-    [[nodiscard]] static auto create_shared() -> std::shared_ptr<IWorld>;
-    [[nodiscard]] static auto create_unique() -> std::unique_ptr<IWorld>;
+    [[nodiscard]] static auto create       (const Collision_layers& collision_layers = Collision_layers::get_default()) -> IWorld*;
+    [[nodiscard]] static auto create_shared(const Collision_layers& collision_layers = Collision_layers::get_default()) -> std::shared_ptr<IWorld>;
+    [[nodiscard]] static auto create_unique(const Collision_layers& collision_layers = Collision_layers::get_default()) -> std::unique_ptr<IWorld>;
 
     [[nodiscard]] virtual auto is_physics_updates_enabled() const -> bool      = 0;
     [[nodiscard]] virtual auto get_gravity               () const -> glm::vec3 = 0;
@@ -35,6 +74,48 @@ public:
     virtual void set_debug_drawer       (IDebug_draw* debug_draw)  = 0;
     virtual void debug_draw             ()                         = 0;
     virtual void sanity_check           ()                         = 0;
+    virtual void set_thread_pool        (erhe::concurrency::Thread_pool* thread_pool) = 0;
+
+    [[nodiscard]] virtual auto is_async_updates_enabled() const -> bool = 0;
+    virtual void enable_async_updates   () = 0;
+    virtual void disable_async_updates  () = 0;
+    virtual void begin_async_update     () = 0;
+    virtual void end_async_update       () = 0;
+    virtual void set_bulk_motion_state_updates(bool enable) = 0;
+    virtual void take_active_body_transforms  (std::vector<Active_body_transform>& transforms) = 0;
+
+    [[nodiscard]] virtual auto get_collision_layers() const -> const Collision_layers& = 0;
+    virtual void set_layer_collision(Object_layer lhs, Object_layer rhs, bool enable) = 0;
+    virtual void add_rigid_bodies   (const std::vector<IRigid_body*>& rigid_bodies) = 0;
+
+    [[nodiscard]] virtual auto cast_ray(
+        const Ray_cast&     ray,
+        const Query_filter& filter,
+        Ray_hit&            hit
+    ) -> bool = 0;
+
+    // hits are resized to match rays; rigid_body is nullptr for misses
+    virtual void cast_rays(
+        const std::vector<Ray_cast>& rays,
+        const Query_filter&          filter,
+        std::vector<Ray_hit>&        hits
+    ) = 0;
+
+    [[nodiscard]] virtual auto cast_shape(
+        const ICollision_shape& shape,
+        const Transform&        start,
+        const glm::vec3&        displacement,
+        const Query_filter&     filter,
+        Shape_cast_hit&         hit
+    ) -> bool = 0;
+
+    // Collects bodies which overlap shape, each body once
+    virtual void overlap_shape(
+        const ICollision_shape&    shape,
+        const Transform&           transform,
+        const Query_filter&        filter,
+        std::vector<IRigid_body*>& rigid_bodies
+    ) = 0;
 };
 
 } // namespace erhe::physics
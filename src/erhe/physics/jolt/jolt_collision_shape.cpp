@@ -359,7 +359,7 @@ auto Jolt_collision_shape::is_convex() const -> bool
     return true;
 }
 
-auto Jolt_collision_shape::get_jolt_shape() -> JPH::ShapeRefC
+auto Jolt_collision_shape::get_jolt_shape() const -> JPH::ShapeRefC
 {
     return m_jolt_shape;
 }
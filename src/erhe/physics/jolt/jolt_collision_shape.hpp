@@ -33,7 +33,7 @@ public:
     [[nodiscard]] auto get_center_of_mass () const -> glm::vec3 override;
     [[nodiscard]] auto get_mass_properties() const -> Mass_properties override;
 
-    [[nodiscard]] auto get_jolt_shape() -> JPH::ShapeRefC;
+    [[nodiscard]] auto get_jolt_shape() const -> JPH::ShapeRefC;
 
     virtual auto get_shape_settings() -> JPH::ShapeSettings& = 0;
 
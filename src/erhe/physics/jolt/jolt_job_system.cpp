@@ -0,0 +1,102 @@
+#include "erhe/physics/jolt/jolt_job_system.hpp"
+#include "erhe/physics/physics_log.hpp"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace erhe::physics
+{
+
+Jolt_job_system::Jolt_job_system(
+    erhe::concurrency::Thread_pool& thread_pool,
+    const JPH::uint                 max_jobs,
+    const JPH::uint                 max_barriers
+)
+    : JPH::JobSystemWithBarrier{max_barriers}
+    , m_thread_pool{thread_pool}
+    , m_queue      {thread_pool, "Jolt", erhe::concurrency::Priority::HIGH}
+{
+    m_jobs.Init(max_jobs, max_jobs);
+}
+
+Jolt_job_system::~Jolt_job_system() noexcept
+{
+    // Queued tasks hold references to jobs
+    m_queue.wait();
+}
+
+auto Jolt_job_system::GetMaxConcurrency() const -> int
+{
+    // Pool workers and the thread waiting for the barrier
+    return m_thread_pool.size() + 1;
+}
+
+auto Jolt_job_system::CreateJob(
+    const char*        inName,
+    JPH::ColorArg      inColor,
+    const JobFunction& inJobFunction,
+    JPH::uint32        inNumDependencies
+) -> JobHandle
+{
+    JPH::uint32 index{Available_jobs::cInvalidObjectIndex};
+    for (;;) {
+        index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        if (index != Available_jobs::cInvalidObjectIndex) {
+            break;
+        }
+        log_physics->warn("Jolt job system: No jobs available");
+        std::this_thread::yield();
+    }
+
+    Job* const job = &m_jobs.Get(index);
+
+    // Construct handle to keep a reference, the job could be queued
+    // below and will immediately complete
+    JobHandle handle{job};
+
+    if (inNumDependencies == 0) {
+        QueueJob(job);
+    }
+    return handle;
+}
+
+void Jolt_job_system::QueueJob(Job* inJob)
+{
+    // Reference is released by the task after the job has been executed
+    inJob->AddRef();
+    m_queue.enqueue(
+        [inJob]()
+        {
+            // Execute() does nothing if the job was already executed
+            // by a thread waiting for a barrier.
+            inJob->Execute();
+            inJob->Release();
+        }
+    );
+}
+
+void Jolt_job_system::QueueJobs(Job** inJobs, const JPH::uint inNumJobs)
+{
+    std::vector<std::function<void()>> functions;
+    functions.reserve(inNumJobs);
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+        Job* const job = inJobs[i];
+        job->AddRef();
+        functions.emplace_back(
+            [job]()
+            {
+                job->Execute();
+                job->Release();
+            }
+        );
+    }
+    m_queue.enqueue_batch(std::move(functions));
+}
+
+void Jolt_job_system::FreeJob(Job* inJob)
+{
+    m_jobs.DestructObject(inJob);
+}
+
+} // namespace erhe::physics
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "erhe/concurrency/concurrent_queue.hpp"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+namespace erhe::physics
+{
+
+// Runs Jolt jobs in erhe::concurrency::Thread_pool, so that physics does
+// not need threads of its own competing with the engine worker threads.
+// Thread waiting for a barrier also executes jobs of that barrier.
+class Jolt_job_system
+    : public JPH::JobSystemWithBarrier
+{
+public:
+    Jolt_job_system(
+        erhe::concurrency::Thread_pool& thread_pool,
+        JPH::uint                       max_jobs,
+        JPH::uint                       max_barriers
+    );
+    ~Jolt_job_system() noexcept override;
+
+    // Implements JPH::JobSystem
+    auto GetMaxConcurrency() const -> int override;
+    auto CreateJob(
+        const char*        inName,
+        JPH::ColorArg      inColor,
+        const JobFunction& inJobFunction,
+        JPH::uint32        inNumDependencies = 0
+    ) -> JobHandle override;
+
+protected:
+    // Implements JPH::JobSystem
+    void QueueJob (Job* inJob) override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob  (Job* inJob) override;
+
+private:
+    using Available_jobs = JPH::FixedSizeFreeList<Job>;
+
+    erhe::concurrency::Thread_pool&     m_thread_pool;
+    erhe::concurrency::Concurrent_queue m_queue;
+    Available_jobs                      m_jobs;
+};
+
+} // namespace erhe::physics
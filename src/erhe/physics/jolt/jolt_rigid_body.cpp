@@ -62,14 +62,19 @@ Jolt_rigid_body::Jolt_rigid_body(
     const IRigid_body_create_info& create_info,
     IMotion_state*                 motion_state
 )
-    : m_motion_state   {motion_state}
-    , m_body_interface {
-        reinterpret_cast<Jolt_world&>(create_info.world)
-            .get_physics_system()
-            .GetBodyInterface()
-    }
+    : m_world          {reinterpret_cast<Jolt_world&>(create_info.world)}
+    , m_motion_state   {motion_state}
+    , m_body_interface {m_world.get_physics_system().GetBodyInterface()}
     , m_collision_shape{std::static_pointer_cast<Jolt_collision_shape>(create_info.collision_shape)}
     , m_motion_mode    {motion_state->get_motion_mode()}
+    , m_object_layer   {
+        create_info.object_layer.has_value()
+            ? create_info.object_layer.value()
+            : create_info.enable_collisions
+                ? Layers::get_layer(m_motion_mode)
+                : Layers::NON_COLLIDING
+    }
+    , m_automatic_object_layer{!create_info.object_layer.has_value() && create_info.enable_collisions}
 {
     if (!m_collision_shape) {
         return;
@@ -94,9 +99,7 @@ Jolt_rigid_body::Jolt_rigid_body(
         position,
         rotation,
         to_jolt(motion_mode),
-        create_info.enable_collisions
-            ? Layers::get_layer(motion_mode)
-            : Layers::NON_COLLIDING
+        m_object_layer
     };
 
     m_mass_properties = jolt_shape->GetMassProperties();
@@ -155,11 +158,15 @@ auto Jolt_rigid_body::get_collision_shape() const -> std::shared_ptr<ICollision_
 
 auto Jolt_rigid_body::get_friction() const -> float
 {
+    m_world.sync_body_access();
+
     return m_body->GetFriction();
 }
 
 void Jolt_rigid_body::set_friction(const float friction)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -175,6 +182,8 @@ void Jolt_rigid_body::set_friction(const float friction)
 
 auto Jolt_rigid_body::get_gravity_factor() const -> float
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return 0.0f;
     }
@@ -183,6 +192,8 @@ auto Jolt_rigid_body::get_gravity_factor() const -> float
 
 void Jolt_rigid_body::set_gravity_factor(const float gravity_factor)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -198,11 +209,15 @@ void Jolt_rigid_body::set_gravity_factor(const float gravity_factor)
 
 auto Jolt_rigid_body::get_restitution() const -> float
 {
+    m_world.sync_body_access();
+
     return m_body->GetRestitution();
 }
 
 void Jolt_rigid_body::set_restitution(float restitution)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -212,6 +227,8 @@ void Jolt_rigid_body::set_restitution(float restitution)
 
 void Jolt_rigid_body::begin_move()
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -223,6 +240,8 @@ void Jolt_rigid_body::begin_move()
 
 void Jolt_rigid_body::end_move()
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -250,6 +269,8 @@ auto c_str(const Motion_mode motion_mode) -> const char*
 
 void Jolt_rigid_body::set_motion_mode(const Motion_mode motion_mode)
 {
+    m_world.sync_body_access();
+
     log_physics->info("{} set_motion_mode({})", get_debug_label(), c_str(motion_mode));
 
     if (m_body == nullptr) {
@@ -267,13 +288,49 @@ void Jolt_rigid_body::set_motion_mode(const Motion_mode motion_mode)
     m_motion_mode = motion_mode;
     m_body->SetMotionType(to_jolt(motion_mode));
 
+    // Keep default object layer in sync with motion mode, so that moving
+    // bodies are not left in the static broad phase layer
+    if (m_automatic_object_layer) {
+        const Object_layer object_layer = Layers::get_layer(motion_mode);
+        if (object_layer != m_object_layer) {
+            m_object_layer = object_layer;
+            m_body_interface.SetObjectLayer(m_body->GetID(), object_layer);
+        }
+    }
+
     if (motion_mode == Motion_mode::e_dynamic) {
         m_body_interface.ActivateBody(m_body->GetID());
     }
 }
 
+auto Jolt_rigid_body::get_object_layer() const -> Object_layer
+{
+    return m_object_layer;
+}
+
+void Jolt_rigid_body::set_object_layer(const Object_layer object_layer)
+{
+    m_world.sync_body_access();
+
+    if (m_body == nullptr) {
+        log_physics->error("Fixed world body cannot be modified");
+        return;
+    }
+
+    // Explicitly set layer is no longer changed by set_motion_mode()
+    m_automatic_object_layer = false;
+    if (m_object_layer == object_layer) {
+        return;
+    }
+    SPDLOG_LOGGER_TRACE(log_physics, "{} set object layer = {}", m_debug_label, object_layer);
+    m_object_layer = object_layer;
+    m_body_interface.SetObjectLayer(m_body->GetID(), object_layer);
+}
+
 auto Jolt_rigid_body::get_center_of_mass_transform() const -> Transform
 {
+    m_world.sync_body_access();
+
     const auto rotation = from_jolt(m_body->GetRotation());
     const auto position = from_jolt(m_body->GetCenterOfMassPosition());
     return Transform{
@@ -284,6 +341,8 @@ auto Jolt_rigid_body::get_center_of_mass_transform() const -> Transform
 
 void Jolt_rigid_body::set_center_of_mass_transform(const Transform& transform)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -297,6 +356,8 @@ void Jolt_rigid_body::set_center_of_mass_transform(const Transform& transform)
 
 void Jolt_rigid_body::move_world_transform(const Transform& transform, const float delta_time)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -323,6 +384,8 @@ void Jolt_rigid_body::move_world_transform(const Transform& transform, const flo
 
 auto Jolt_rigid_body::get_world_transform() const -> Transform
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return erhe::physics::Transform{};
     }
@@ -342,6 +405,8 @@ auto Jolt_rigid_body::get_world_transform() const -> Transform
 
 void Jolt_rigid_body::set_world_transform(const Transform& transform)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -401,6 +466,8 @@ void Jolt_rigid_body::set_world_transform(const Transform& transform)
 
 auto Jolt_rigid_body::get_linear_velocity() const -> glm::vec3
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return {};
     }
@@ -410,6 +477,8 @@ auto Jolt_rigid_body::get_linear_velocity() const -> glm::vec3
 
 void Jolt_rigid_body::set_linear_velocity(const glm::vec3& velocity)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -422,6 +491,8 @@ void Jolt_rigid_body::set_linear_velocity(const glm::vec3& velocity)
 
 auto Jolt_rigid_body::get_angular_velocity() const -> glm::vec3
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return {};
     }
@@ -431,6 +502,8 @@ auto Jolt_rigid_body::get_angular_velocity() const -> glm::vec3
 
 void Jolt_rigid_body::set_angular_velocity(const glm::vec3& velocity)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -443,6 +516,8 @@ void Jolt_rigid_body::set_angular_velocity(const glm::vec3& velocity)
 
 auto Jolt_rigid_body::get_linear_damping() const -> float
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return 0.0f;
     }
@@ -455,6 +530,8 @@ auto Jolt_rigid_body::get_linear_damping() const -> float
 
 void Jolt_rigid_body::set_damping(const float linear_damping, const float angular_damping)
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         log_physics->error("Fixed world body cannot be modified");
         return;
@@ -473,6 +550,8 @@ void Jolt_rigid_body::set_damping(const float linear_damping, const float angula
 
 auto Jolt_rigid_body::get_angular_damping() const -> float
 {
+    m_world.sync_body_access();
+
     if (m_body == nullptr) {
         return 0.0f;
     }
@@ -499,6 +578,8 @@ void Jolt_rigid_body::set_mass_properties(
     const glm::mat4& inertia_tensor
 )
 {
+    m_world.sync_body_access();
+
     m_mass_properties.mMass    = mass;
     m_mass_properties.mInertia = to_jolt(inertia_tensor);
 
@@ -528,24 +609,41 @@ auto Jolt_rigid_body::get_jolt_body() const -> JPH::Body*
         : &JPH::Body::sFixedToWorld;
 }
 
+auto Jolt_rigid_body::get_motion_state() const -> IMotion_state*
+{
+    return m_motion_state;
+}
+
 void Jolt_rigid_body::update_motion_state() const
+{
+    glm::mat4 world_from_rigidbody;
+    if (capture_motion_state(world_from_rigidbody)) {
+        publish_motion_state(world_from_rigidbody);
+    }
+}
+
+auto Jolt_rigid_body::capture_motion_state(glm::mat4& world_from_rigidbody) const -> bool
 {
     if (m_body == nullptr) {
-        return;
+        return false;
     }
 
     if (m_motion_mode != Motion_mode::e_dynamic) {
-        return;
+        return false;
     }
 
     if (!m_body->IsActive()) {
-        return;
+        return false;
     }
 
     const JPH::Mat44 jolt_transform = m_body->GetWorldTransform();
-    const glm::mat4  transform      = from_jolt(jolt_transform);
+    world_from_rigidbody = from_jolt(jolt_transform);
+    return true;
+}
 
-    m_motion_state->set_world_from_rigidbody(transform);
+void Jolt_rigid_body::publish_motion_state(const glm::mat4& world_from_rigidbody) const
+{
+    m_motion_state->set_world_from_rigidbody(world_from_rigidbody);
 }
 
 } // namespace erhe::physics
@@ -5,6 +5,8 @@
 #include <Jolt/Jolt.h>
 #include <Jolt/Physics/Body/Body.h>
 
+#include <limits>
+
 namespace JPH
 {
     class Body;
@@ -15,6 +17,7 @@ namespace erhe::physics
 {
 
 class Jolt_collision_shape;
+class Jolt_world;
 
 class Jolt_rigid_body
     : public IRigid_body
@@ -39,6 +42,7 @@ public:
     auto get_local_inertia           () const -> glm::mat4                         override;
     auto get_mass                    () const -> float                             override;
     auto get_motion_mode             () const -> Motion_mode                       override;
+    auto get_object_layer            () const -> Object_layer                      override;
     auto get_restitution             () const -> float                             override;
     auto get_world_transform         () const -> Transform                         override;
 
@@ -53,20 +57,30 @@ public:
     void set_linear_velocity         (const glm::vec3& velocity)                    override;
     void set_mass_properties         (float mass, const glm::mat4& local_inertia)   override;
     void set_motion_mode             (Motion_mode motion_mode)                      override;
+    void set_object_layer            (Object_layer object_layer)                    override;
     void set_restitution             (float restitution)                            override;
     void set_world_transform         (const Transform& transform)                   override;
 
     // Public API
-    auto get_jolt_body      () const -> JPH::Body*;
-    void update_motion_state() const;
+    auto get_jolt_body       () const -> JPH::Body*;
+    auto get_motion_state    () const -> IMotion_state*;
+    void update_motion_state () const;
+    auto capture_motion_state(glm::mat4& world_from_rigidbody) const -> bool; // false if motion state needs no update
+    void publish_motion_state(const glm::mat4& world_from_rigidbody) const;
+
+    // Index of this body in Jolt_world published active body transforms
+    std::size_t active_transform_index{std::numeric_limits<std::size_t>::max()};
 
 private:
+    Jolt_world&                           m_world;
     JPH::Body*                            m_body            {nullptr};
     JPH::MassProperties                   m_mass_properties;
     IMotion_state*                        m_motion_state    {nullptr};
     JPH::BodyInterface&                   m_body_interface;
     std::shared_ptr<Jolt_collision_shape> m_collision_shape;
     Motion_mode                           m_motion_mode     {Motion_mode::e_kinematic_non_physical};
+    Object_layer                          m_object_layer    {Layers::NON_COLLIDING};
+    bool                                  m_automatic_object_layer{true}; // object layer follows motion mode
     std::string                           m_debug_label;
 };
 
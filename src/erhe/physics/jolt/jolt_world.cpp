@@ -1,7 +1,11 @@
 #include "erhe/physics/jolt/jolt_world.hpp"
+#include "erhe/concurrency/concurrent_queue.hpp"
+#include "erhe/concurrency/task_graph.hpp"
 #include "erhe/log/log_glm.hpp"
+#include "erhe/physics/jolt/jolt_collision_shape.hpp"
 #include "erhe/physics/jolt/jolt_constraint.hpp"
 #include "erhe/physics/jolt/jolt_debug_renderer.hpp"
+#include "erhe/physics/jolt/jolt_job_system.hpp"
 #include "erhe/physics/jolt/jolt_rigid_body.hpp"
 #include "erhe/physics/jolt/glm_conversions.hpp"
 #include "erhe/physics/idebug_draw.hpp"
@@ -13,6 +17,16 @@
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Body/BodyInterface.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+
+#include <algorithm>
 
 namespace erhe::physics
 {
@@ -51,58 +65,37 @@ static auto AssertFailedImpl(
 
 #endif // JPH_ENABLE_ASSERTS
 
-namespace Layers {
-
-[[nodiscard]] auto get_layer(const Motion_mode motion_mode) -> uint8_t
-{
-    switch (motion_mode) {
-        case Motion_mode::e_static:                 return Layers::NON_MOVING;
-        case Motion_mode::e_kinematic_non_physical: return Layers::MOVING;
-        case Motion_mode::e_kinematic_physical:     return Layers::MOVING;
-        case Motion_mode::e_dynamic:                return Layers::MOVING;
-        default:                                    return Layers::MOVING;
-    }
-}
-
-} // namespace Layers
-
 // Each broadphase layer results in a separate bounding volume tree in the broad phase. You at least want to have
 // a layer for non-moving and moving objects to avoid having to update a tree full of static objects every frame.
-// You can have a 1-on-1 mapping between object layers and broadphase layers (like in this case) but if you have
-// many object layers you'll be creating many broad phase trees, which is not efficient. If you want to fine tune
-// your broadphase layers define JPH_TRACK_BROADPHASE_STATS and look at the stats reported on the TTY.
-namespace BroadPhaseLayers
-{
-    static constexpr JPH::BroadPhaseLayer NON_MOVING   {0};
-    static constexpr JPH::BroadPhaseLayer MOVING       {1};
-    static constexpr JPH::BroadPhaseLayer NON_COLLIDING{2};
-    static constexpr unsigned int         NUM_LAYERS   {3};
-};
-
-// BroadPhaseLayerInterface implementation
-// This defines a mapping between object and broadphase layers.
+// If you want to fine tune your broadphase layers define JPH_TRACK_BROADPHASE_STATS and look at the stats reported
+// on the TTY.
+//
+// This defines a mapping between object and broadphase layers, from Collision_layers.
 class Broad_phase_layer_interface_impl final
     : public JPH::BroadPhaseLayerInterface
 {
 public:
-    Broad_phase_layer_interface_impl()
+    explicit Broad_phase_layer_interface_impl(const Collision_layers& collision_layers)
+        : m_broad_phase_layer_names{collision_layers.broad_phase_layer_names}
     {
         // Create a mapping table from object to broad phase layer
-        m_object_to_broad_phase[Layers::NON_MOVING   ] = BroadPhaseLayers::NON_MOVING;
-        m_object_to_broad_phase[Layers::MOVING       ] = BroadPhaseLayers::MOVING;
-        m_object_to_broad_phase[Layers::NON_COLLIDING] = BroadPhaseLayers::NON_COLLIDING;
+        m_object_to_broad_phase.reserve(collision_layers.object_layers.size());
+        for (const auto& object_layer : collision_layers.object_layers) {
+            ERHE_VERIFY(object_layer.broad_phase_layer < m_broad_phase_layer_names.size());
+            m_object_to_broad_phase.push_back(JPH::BroadPhaseLayer{object_layer.broad_phase_layer});
+        }
     }
 
     auto GetNumBroadPhaseLayers() const -> unsigned int override
     {
-        return BroadPhaseLayers::NUM_LAYERS;
+        return static_cast<unsigned int>(m_broad_phase_layer_names.size());
     }
 
     auto GetBroadPhaseLayer(
         const JPH::ObjectLayer inLayer
     ) const -> JPH::BroadPhaseLayer override
     {
-        ERHE_VERIFY(inLayer < Layers::NUM_LAYERS);
+        ERHE_VERIFY(inLayer < m_object_to_broad_phase.size());
         return m_object_to_broad_phase[inLayer];
     }
 
@@ -111,32 +104,50 @@ public:
         const JPH::BroadPhaseLayer inLayer
     ) const -> const char* override
     {
-        switch ((JPH::BroadPhaseLayer::Type)inLayer) {
-            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING:    return "NON_MOVING";
-            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::MOVING:        return "MOVING";
-            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::NON_COLLIDING: return "NON_COLLIDING";
-            default:                                                          return "?";
-        }
+        const auto index = static_cast<std::size_t>(static_cast<JPH::BroadPhaseLayer::Type>(inLayer));
+        return (index < m_broad_phase_layer_names.size())
+            ? m_broad_phase_layer_names[index].c_str()
+            : "?";
     }
 //#endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
 
 private:
-    JPH::BroadPhaseLayer m_object_to_broad_phase[Layers::NUM_LAYERS];
+    std::vector<std::string>          m_broad_phase_layer_names;
+    std::vector<JPH::BroadPhaseLayer> m_object_to_broad_phase;
 };
 
+void Jolt_collision_filter::set_collision_layers(const Collision_layers& collision_layers)
+{
+    const auto& object_layers = collision_layers.object_layers;
+    ERHE_VERIFY(object_layers.size() <= c_max_object_layers);
+
+    m_object_layer_count = object_layers.size();
+    m_collision_masks.fill(0u);
+    m_broad_phase_layer_masks.fill(0u);
+    for (std::size_t i = 0; i < m_object_layer_count; ++i) {
+        const uint32_t collision_mask = object_layers[i].collision_mask;
+        m_collision_masks[i] = collision_mask;
+
+        // Object layer can collide with broad phase layer if it
+        // can collide with any object layer in that broad phase layer
+        for (std::size_t j = 0; j < m_object_layer_count; ++j) {
+            if ((collision_mask & Collision_layers::mask(static_cast<Object_layer>(j))) != 0) {
+                m_broad_phase_layer_masks[i] |= uint32_t{1} << object_layers[j].broad_phase_layer;
+            }
+        }
+    }
+}
+
 bool Jolt_collision_filter::ShouldCollide(
     JPH::ObjectLayer     inLayer1,
     JPH::BroadPhaseLayer inLayer2
 ) const
 {
-    switch (inLayer1) {
-        case Layers::NON_MOVING:    return inLayer2 == BroadPhaseLayers::MOVING;
-        case Layers::MOVING:        return inLayer2 != BroadPhaseLayers::NON_COLLIDING;
-        case Layers::NON_COLLIDING: return false;
-        default: {
-            return false;
-        }
+    if (inLayer1 >= m_object_layer_count) {
+        return false;
     }
+    const auto broad_phase_layer = static_cast<JPH::BroadPhaseLayer::Type>(inLayer2);
+    return (m_broad_phase_layer_masks[inLayer1] & (uint32_t{1} << broad_phase_layer)) != 0;
 }
 
 bool Jolt_collision_filter::ShouldCollide(
@@ -144,31 +155,186 @@ bool Jolt_collision_filter::ShouldCollide(
     JPH::ObjectLayer inLayer2
 ) const
 {
-    switch (inLayer1) {
-        case Layers::NON_MOVING:    return inLayer2 == Layers::MOVING;        // Non moving only collides with moving
-        case Layers::MOVING:        return inLayer2 != Layers::NON_COLLIDING;
-        case Layers::NON_COLLIDING: return false; // Does not collide with anything
-        default:                    ERHE_VERIFY(false); return false;
+    if ((inLayer1 >= m_object_layer_count) || (inLayer2 >= m_object_layer_count)) {
+        return false;
+    }
+    return (m_collision_masks[inLayer1] & (uint32_t{1} << inLayer2)) != 0;
+}
+
+namespace {
+
+// Query filters from Query_filter
+class Query_broad_phase_layer_filter final
+    : public JPH::BroadPhaseLayerFilter
+{
+public:
+    explicit Query_broad_phase_layer_filter(const uint32_t broad_phase_layer_mask)
+        : m_broad_phase_layer_mask{broad_phase_layer_mask}
+    {
+    }
+
+    auto ShouldCollide(const JPH::BroadPhaseLayer inLayer) const -> bool override
+    {
+        const auto broad_phase_layer = static_cast<JPH::BroadPhaseLayer::Type>(inLayer);
+        return
+            (broad_phase_layer < c_max_broad_phase_layers) &&
+            ((m_broad_phase_layer_mask & (uint32_t{1} << broad_phase_layer)) != 0);
+    }
+
+private:
+    uint32_t m_broad_phase_layer_mask;
+};
+
+class Query_object_layer_filter final
+    : public JPH::ObjectLayerFilter
+{
+public:
+    explicit Query_object_layer_filter(const uint32_t object_layer_mask)
+        : m_object_layer_mask{object_layer_mask}
+    {
+    }
+
+    auto ShouldCollide(const JPH::ObjectLayer inLayer) const -> bool override
+    {
+        return
+            (inLayer < c_max_object_layers) &&
+            ((m_object_layer_mask & (uint32_t{1} << inLayer)) != 0);
+    }
+
+private:
+    uint32_t m_object_layer_mask;
+};
+
+class Query_body_filter final
+    : public JPH::BodyFilter
+{
+public:
+    explicit Query_body_filter(const JPH::BodyID ignore_body_id)
+        : m_ignore_body_id{ignore_body_id}
+    {
+    }
+
+    auto ShouldCollide(const JPH::BodyID& inBodyID) const -> bool override
+    {
+        return inBodyID != m_ignore_body_id;
+    }
+
+private:
+    JPH::BodyID m_ignore_body_id;
+};
+
+class Query_filters
+{
+public:
+    Query_filters(const Collision_layers& collision_layers, const Query_filter& filter)
+        : broad_phase_layer_filter{get_broad_phase_layer_mask(collision_layers, filter.object_layer_mask)}
+        , object_layer_filter     {filter.object_layer_mask}
+        , body_filter{
+            (filter.ignore_rigid_body != nullptr)
+                ? static_cast<const Jolt_rigid_body*>(filter.ignore_rigid_body)->get_jolt_body()->GetID()
+                : JPH::BodyID{}
+        }
+    {
+    }
+
+    Query_broad_phase_layer_filter broad_phase_layer_filter;
+    Query_object_layer_filter      object_layer_filter;
+    Query_body_filter              body_filter;
+
+private:
+    [[nodiscard]] static auto get_broad_phase_layer_mask(
+        const Collision_layers& collision_layers,
+        const uint32_t          object_layer_mask
+    ) -> uint32_t
+    {
+        uint32_t broad_phase_layer_mask{0};
+        const auto& object_layers = collision_layers.object_layers;
+        for (std::size_t i = 0, end = object_layers.size(); i < end; ++i) {
+            if ((object_layer_mask & Collision_layers::mask(static_cast<Object_layer>(i))) != 0) {
+                broad_phase_layer_mask |= uint32_t{1} << object_layers[i].broad_phase_layer;
+            }
+        }
+        return broad_phase_layer_mask;
+    }
+};
+
+[[nodiscard]] auto get_world_transform(const Transform& transform) -> JPH::RMat44
+{
+    return JPH::RMat44::sRotationTranslation(
+        to_jolt(glm::quat{transform.basis}),
+        to_jolt(transform.origin)
+    );
+}
+
+[[nodiscard]] auto get_jolt_shape(const ICollision_shape& shape) -> JPH::ShapeRefC
+{
+    return static_cast<const Jolt_collision_shape&>(shape).get_jolt_shape();
+}
+
+// Safe to call from multiple threads, as long as physics is not updating
+[[nodiscard]] auto cast_ray(
+    const JPH::PhysicsSystem& physics_system,
+    const Query_filters&      filters,
+    const Ray_cast&           ray,
+    Ray_hit&                  hit
+) -> bool
+{
+    hit = Ray_hit{};
+
+    const float length = glm::length(ray.direction);
+    if ((length == 0.0f) || (ray.max_distance <= 0.0f)) {
+        return false;
     }
+
+    // Jolt ray direction includes length
+    const JPH::RRayCast jolt_ray{
+        to_jolt(ray.origin),
+        to_jolt(ray.direction * (ray.max_distance / length))
+    };
+    JPH::RayCastResult result;
+    const bool is_hit = physics_system.GetNarrowPhaseQuery().CastRay(
+        jolt_ray,
+        result,
+        filters.broad_phase_layer_filter,
+        filters.object_layer_filter,
+        filters.body_filter
+    );
+    if (!is_hit) {
+        return false;
+    }
+
+    const JPH::BodyLockRead lock{physics_system.GetBodyLockInterface(), result.mBodyID};
+    if (!lock.Succeeded()) {
+        return false;
+    }
+    const JPH::Body&  body     = lock.GetBody();
+    const JPH::RVec3  position = jolt_ray.GetPointOnRay(result.mFraction);
+    hit.rigid_body = reinterpret_cast<Jolt_rigid_body*>(body.GetUserData());
+    hit.position   = from_jolt(position);
+    hit.normal     = from_jolt(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, position));
+    hit.distance   = result.mFraction * ray.max_distance;
+    return true;
 }
 
+} // anonymous namespace
+
 IWorld::~IWorld() noexcept
 {
 }
 
-auto IWorld::create() -> IWorld*
+auto IWorld::create(const Collision_layers& collision_layers) -> IWorld*
 {
-    return new Jolt_world();
+    return new Jolt_world(collision_layers);
 }
 
-auto IWorld::create_shared() -> std::shared_ptr<IWorld>
+auto IWorld::create_shared(const Collision_layers& collision_layers) -> std::shared_ptr<IWorld>
 {
-    return std::make_shared<Jolt_world>();
+    return std::make_shared<Jolt_world>(collision_layers);
 }
 
-auto IWorld::create_unique() -> std::unique_ptr<IWorld>
+auto IWorld::create_unique(const Collision_layers& collision_layers) -> std::unique_ptr<IWorld>
 {
-    return std::make_unique<Jolt_world>();
+    return std::make_unique<Jolt_world>(collision_layers);
 }
 
 //// void register_empty_shape();
@@ -190,12 +356,17 @@ Jolt_world::Initialize_first::Initialize_first()
     ////register_empty_shape();
 }
 
-Jolt_world::Jolt_world()
-    : m_temp_allocator{10 * 1024 * 1024}
-    , m_job_system    {JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, 10}
+Jolt_world::Jolt_world(const Collision_layers& collision_layers)
+    : m_collision_layers{collision_layers}
+    , m_temp_allocator  {10 * 1024 * 1024}
 {
+    ERHE_VERIFY(!m_collision_layers.broad_phase_layer_names.empty());
+    ERHE_VERIFY(m_collision_layers.broad_phase_layer_names.size() <= c_max_broad_phase_layers);
+    m_collision_layers.make_symmetric();
+    m_collision_filter.set_collision_layers(m_collision_layers);
+
     //m_debug_renderer              = std::make_unique<Jolt_debug_renderer             >();
-    m_broad_phase_layer_interface = std::make_unique<Broad_phase_layer_interface_impl>();
+    m_broad_phase_layer_interface = std::make_unique<Broad_phase_layer_interface_impl>(m_collision_layers);
     m_physics_system.Init(
         cMaxBodies,
         cNumBodyMutexes,
@@ -210,7 +381,46 @@ Jolt_world::Jolt_world()
     m_physics_system.SetContactListener(this);
 }
 
-Jolt_world::~Jolt_world() noexcept = default;
+Jolt_world::~Jolt_world() noexcept
+{
+    wait_async_update();
+}
+
+void Jolt_world::set_thread_pool(erhe::concurrency::Thread_pool* thread_pool)
+{
+    if (thread_pool == m_thread_pool) {
+        return;
+    }
+
+    end_async_update();
+    m_update_queue.reset();
+    m_job_system.reset();
+    m_thread_pool = thread_pool;
+    if (m_async_updates_enabled) {
+        m_async_updates_enabled = false;
+        enable_async_updates();
+    }
+}
+
+auto Jolt_world::get_job_system() -> JPH::JobSystem*
+{
+    if (!m_job_system) {
+        if ((m_thread_pool != nullptr) && (m_thread_pool->size() > 0)) {
+            m_job_system = std::make_unique<Jolt_job_system>(
+                *m_thread_pool,
+                JPH::cMaxPhysicsJobs,
+                JPH::cMaxPhysicsBarriers
+            );
+        } else {
+            m_job_system = std::make_unique<JPH::JobSystemThreadPool>(
+                JPH::cMaxPhysicsJobs,
+                JPH::cMaxPhysicsBarriers,
+                10
+            );
+        }
+    }
+    return m_job_system.get();
+}
 
 void Jolt_world::enable_physics_updates()
 {
@@ -236,6 +446,32 @@ void Jolt_world::update_fixed_step(const double dt)
         return;
     }
 
+    if (m_async_updates_enabled) {
+        m_pending_steps.push_back(static_cast<float>(dt));
+        return;
+    }
+
+    step(static_cast<float>(dt));
+    capture_active_body_transforms();
+    publish_active_body_transforms();
+
+    //const auto num_active_bodies = m_physics_system.GetNumActiveBodies();
+    //const auto num_bodies        = m_physics_system.GetNumBodies();
+    //// const auto body_stats = m_physics_system.GetBodyStats();
+    //log_physics_frame.info("num active bodies = {}", num_active_bodies);
+    //log_physics_frame.info("num bodies = {}", num_bodies);
+    //// info_fmt(log_physics_frame, "num active dynamic = {}\n",   body_stats.mNumActiveBodiesDynamic);
+    //// info_fmt(log_physics_frame, "num dynamic = {}\n",          body_stats.mNumBodiesDynamic);
+    //// info_fmt(log_physics_frame, "num active kinematic = {}\n", body_stats.mNumActiveBodiesKinematic);
+    //// info_fmt(log_physics_frame, "num kinematic = {}\n",        body_stats.mNumBodiesKinematic);
+    //// info_fmt(log_physics_frame, "num static = {}\n",           body_stats.mNumBodiesStatic);
+    //// info_fmt(log_physics_frame, "num bodies = {}\n",           body_stats.mNumBodies);
+}
+
+void Jolt_world::step(const float dt)
+{
+    ERHE_PROFILE_FUNCTION
+
     // If you take larger steps than 1 / 60th of a second you need to do
     // multiple collision steps in order to keep the simulation stable.
     // Do 1 collision step per 1 / 60th of a second (round up).
@@ -246,32 +482,196 @@ void Jolt_world::update_fixed_step(const double dt)
     const int cIntegrationSubSteps = 1;
 
     m_physics_system.Update(
-        static_cast<float>(dt),
+        dt,
         cCollisionSteps,
         cIntegrationSubSteps,
         &m_temp_allocator,
-        &m_job_system
+        get_job_system()
+    );
+}
+
+auto Jolt_world::is_async_updates_enabled() const -> bool
+{
+    return m_async_updates_enabled;
+}
+
+void Jolt_world::enable_async_updates()
+{
+    if (m_async_updates_enabled) {
+        return;
+    }
+    if ((m_thread_pool == nullptr) || (m_thread_pool->size() == 0)) {
+        log_physics->warn("async physics updates require thread pool, using synchronous updates");
+        return;
+    }
+
+    m_update_queue = std::make_unique<erhe::concurrency::Concurrent_queue>(
+        *m_thread_pool,
+        "physics update",
+        erhe::concurrency::Priority::HIGH
+    );
+    m_async_updates_enabled = true;
+    log_physics->trace("async physics updates enabled");
+}
+
+void Jolt_world::disable_async_updates()
+{
+    if (!m_async_updates_enabled) {
+        return;
+    }
+
+    end_async_update();
+    m_async_updates_enabled = false;
+
+    // Run steps which were queued, but not yet started
+    for (const float dt : m_pending_steps) {
+        step(dt);
+        capture_active_body_transforms();
+    }
+    m_pending_steps.clear();
+    publish_active_body_transforms();
+    log_physics->trace("async physics updates disabled");
+}
+
+void Jolt_world::begin_async_update()
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (!m_async_updates_enabled || m_pending_steps.empty()) {
+        return;
+    }
+
+    // Only one update can be running; normally end_async_update()
+    // has been called at frame start.
+    sync_body_access();
+
+    std::swap(m_running_steps, m_pending_steps);
+    m_pending_steps.clear();
+    m_async_update_running = true;
+    m_update_queue->enqueue(
+        [this]()
+        {
+            async_update();
+        }
     );
+}
+
+void Jolt_world::async_update()
+{
+    ERHE_PROFILE_FUNCTION
+
+    // Captured transforms are published by end_async_update()
+    for (const float dt : m_running_steps) {
+        step(dt);
+        capture_active_body_transforms();
+    }
+    m_running_steps.clear();
+}
+
+void Jolt_world::wait_async_update()
+{
+    if (!m_async_update_running) {
+        return;
+    }
+
+    ERHE_PROFILE_FUNCTION
+
+    m_update_queue->wait();
+    m_async_update_running = false;
+}
+
+void Jolt_world::end_async_update()
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (!m_async_update_running) {
+        return;
+    }
+
+    wait_async_update();
+    publish_active_body_transforms();
+}
+
+void Jolt_world::sync_body_access()
+{
+    if (m_async_update_running) {
+        end_async_update();
+    }
+}
+
+void Jolt_world::capture_active_body_transforms()
+{
+    ERHE_PROFILE_FUNCTION
 
+    // Sleeping bodies are skipped
     for (auto* rigid_body : m_rigid_bodies) {
-        rigid_body->update_motion_state();
+        glm::mat4 world_from_rigidbody;
+        if (rigid_body->capture_motion_state(world_from_rigidbody)) {
+            m_captured_transforms.push_back(
+                Active_body_transform{
+                    .rigid_body           = rigid_body,
+                    .motion_state         = rigid_body->get_motion_state(),
+                    .world_from_rigidbody = world_from_rigidbody
+                }
+            );
+        }
     }
+}
 
-    //const auto num_active_bodies = m_physics_system.GetNumActiveBodies();
-    //const auto num_bodies        = m_physics_system.GetNumBodies();
-    //// const auto body_stats = m_physics_system.GetBodyStats();
-    //log_physics_frame.info("num active bodies = {}", num_active_bodies);
-    //log_physics_frame.info("num bodies = {}", num_bodies);
-    //// info_fmt(log_physics_frame, "num active dynamic = {}\n",   body_stats.mNumActiveBodiesDynamic);
-    //// info_fmt(log_physics_frame, "num dynamic = {}\n",          body_stats.mNumBodiesDynamic);
-    //// info_fmt(log_physics_frame, "num active kinematic = {}\n", body_stats.mNumActiveBodiesKinematic);
-    //// info_fmt(log_physics_frame, "num kinematic = {}\n",        body_stats.mNumBodiesKinematic);
-    //// info_fmt(log_physics_frame, "num static = {}\n",           body_stats.mNumBodiesStatic);
-    //// info_fmt(log_physics_frame, "num bodies = {}\n",           body_stats.mNumBodies);
+void Jolt_world::publish_active_body_transforms()
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (m_bulk_motion_state_updates) {
+        // Keep a single, latest entry for each body
+        for (const auto& entry : m_captured_transforms) {
+            auto* const       rigid_body = static_cast<Jolt_rigid_body*>(entry.rigid_body);
+            const std::size_t index      = rigid_body->active_transform_index;
+            if (
+                (index < m_published_transforms.size()) &&
+                (m_published_transforms[index].rigid_body == rigid_body)
+            ) {
+                m_published_transforms[index].world_from_rigidbody = entry.world_from_rigidbody;
+            } else {
+                rigid_body->active_transform_index = m_published_transforms.size();
+                m_published_transforms.push_back(entry);
+            }
+        }
+    } else {
+        for (const auto& entry : m_captured_transforms) {
+            entry.motion_state->set_world_from_rigidbody(entry.world_from_rigidbody);
+        }
+    }
+    m_captured_transforms.clear();
+}
+
+void Jolt_world::set_bulk_motion_state_updates(const bool enable)
+{
+    if (m_bulk_motion_state_updates == enable) {
+        return;
+    }
+
+    end_async_update();
+    if (!enable) {
+        // Apply transforms which were not taken yet
+        for (const auto& entry : m_published_transforms) {
+            entry.motion_state->set_world_from_rigidbody(entry.world_from_rigidbody);
+        }
+        m_published_transforms.clear();
+    }
+    m_bulk_motion_state_updates = enable;
+}
+
+void Jolt_world::take_active_body_transforms(std::vector<Active_body_transform>& transforms)
+{
+    transforms.clear();
+    std::swap(transforms, m_published_transforms);
 }
 
 void Jolt_world::add_rigid_body(IRigid_body* rigid_body)
 {
+    sync_body_access();
+
     auto& body_interface  = m_physics_system.GetBodyInterface();
     auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
 
@@ -300,8 +700,48 @@ void Jolt_world::add_rigid_body(IRigid_body* rigid_body)
     }
 }
 
+void Jolt_world::add_rigid_bodies(const std::vector<IRigid_body*>& rigid_bodies)
+{
+    ERHE_PROFILE_FUNCTION
+
+    sync_body_access();
+
+    std::vector<JPH::BodyID> body_ids;
+    body_ids.reserve(rigid_bodies.size());
+    for (auto* rigid_body : rigid_bodies) {
+        auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
+        ERHE_VERIFY(jolt_rigid_body != nullptr);
+
+        auto* jolt_body = jolt_rigid_body->get_jolt_body();
+        ERHE_VERIFY(jolt_body != nullptr);
+        if (jolt_body == &JPH::Body::sFixedToWorld) {
+            continue;
+        }
+        if (jolt_body->IsInBroadPhase()) {
+            log_physics->error("rigid body {} already in world", rigid_body->get_debug_label());
+            continue;
+        }
+        body_ids.push_back(jolt_body->GetID());
+        m_rigid_bodies.push_back(jolt_rigid_body);
+    }
+    if (body_ids.empty()) {
+        return;
+    }
+
+    log_physics->trace("add {} rigid bodies", body_ids.size());
+
+    // Prepare builds broad phase trees for the whole batch (and may reorder
+    // body ids), finalize inserts the trees with a single broad phase update.
+    auto&     body_interface = m_physics_system.GetBodyInterface();
+    const int count          = static_cast<int>(body_ids.size());
+    const JPH::BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(body_ids.data(), count);
+    body_interface.AddBodiesFinalize(body_ids.data(), count, add_state, JPH::EActivation::DontActivate);
+}
+
 void Jolt_world::remove_rigid_body(IRigid_body* rigid_body)
 {
+    sync_body_access();
+
     auto& body_interface  = m_physics_system.GetBodyInterface();
     auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
 
@@ -325,11 +765,36 @@ void Jolt_world::remove_rigid_body(IRigid_body* rigid_body)
     } else {
         body_interface.RemoveBody(jolt_body->GetID());
         m_rigid_bodies.erase(i, m_rigid_bodies.end());
+        m_captured_transforms.erase(
+            std::remove_if(
+                m_captured_transforms.begin(),
+                m_captured_transforms.end(),
+                [rigid_body](const Active_body_transform& entry)
+                {
+                    return entry.rigid_body == rigid_body;
+                }
+            ),
+            m_captured_transforms.end()
+        );
+        const std::size_t index = jolt_rigid_body->active_transform_index;
+        if (
+            (index < m_published_transforms.size()) &&
+            (m_published_transforms[index].rigid_body == rigid_body)
+        ) {
+            // Swap with last, keeping index of the moved entry valid
+            m_published_transforms[index] = m_published_transforms.back();
+            m_published_transforms.pop_back();
+            if (index < m_published_transforms.size()) {
+                static_cast<Jolt_rigid_body*>(m_published_transforms[index].rigid_body)->active_transform_index = index;
+            }
+        }
     }
 }
 
 void Jolt_world::add_constraint(IConstraint* constraint)
 {
+    sync_body_access();
+
     log_physics->trace("add constraint");
     auto* jolt_constraint = reinterpret_cast<Jolt_constraint*>(constraint);
 
@@ -347,6 +812,8 @@ void Jolt_world::add_constraint(IConstraint* constraint)
 
 void Jolt_world::remove_constraint(IConstraint* constraint)
 {
+    sync_body_access();
+
     log_physics->trace("remove constraint");
     auto* jolt_constraint = reinterpret_cast<Jolt_constraint*>(constraint);
     const auto i = std::remove(
@@ -362,8 +829,177 @@ void Jolt_world::remove_constraint(IConstraint* constraint)
     }
 }
 
+auto Jolt_world::cast_ray(
+    const Ray_cast&     ray,
+    const Query_filter& filter,
+    Ray_hit&            hit
+) -> bool
+{
+    ERHE_PROFILE_FUNCTION
+
+    sync_body_access();
+
+    const Query_filters filters{m_collision_layers, filter};
+    return erhe::physics::cast_ray(m_physics_system, filters, ray, hit);
+}
+
+void Jolt_world::cast_rays(
+    const std::vector<Ray_cast>& rays,
+    const Query_filter&          filter,
+    std::vector<Ray_hit>&        hits
+)
+{
+    ERHE_PROFILE_FUNCTION
+
+    sync_body_access();
+
+    const Query_filters filters{m_collision_layers, filter};
+    hits.resize(rays.size());
+    erhe::concurrency::parallel_for(
+        m_thread_pool,
+        rays.size(),
+        256,
+        [this, &filters, &rays, &hits](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i) {
+                static_cast<void>(
+                    erhe::physics::cast_ray(m_physics_system, filters, rays[i], hits[i])
+                );
+            }
+        }
+    );
+}
+
+auto Jolt_world::cast_shape(
+    const ICollision_shape& shape,
+    const Transform&        start,
+    const glm::vec3&        displacement,
+    const Query_filter&     filter,
+    Shape_cast_hit&         hit
+) -> bool
+{
+    ERHE_PROFILE_FUNCTION
+
+    sync_body_access();
+
+    hit = Shape_cast_hit{};
+
+    const JPH::ShapeRefC  jolt_shape = get_jolt_shape(shape);
+    const Query_filters   filters{m_collision_layers, filter};
+    const JPH::RShapeCast shape_cast = JPH::RShapeCast::sFromWorldTransform(
+        jolt_shape.GetPtr(),
+        JPH::Vec3::sReplicate(1.0f),
+        get_world_transform(start),
+        to_jolt(displacement)
+    );
+    JPH::ShapeCastSettings settings;
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+    m_physics_system.GetNarrowPhaseQuery().CastShape(
+        shape_cast,
+        settings,
+        JPH::RVec3::sZero(),
+        collector,
+        filters.broad_phase_layer_filter,
+        filters.object_layer_filter,
+        filters.body_filter
+    );
+    if (!collector.HadHit()) {
+        return false;
+    }
+
+    const JPH::ShapeCastResult& result = collector.mHit;
+    const JPH::BodyLockRead lock{m_physics_system.GetBodyLockInterface(), result.mBodyID2};
+    if (!lock.Succeeded()) {
+        return false;
+    }
+
+    // Penetration axis is the direction to move hit body out of collision
+    hit.rigid_body        = reinterpret_cast<Jolt_rigid_body*>(lock.GetBody().GetUserData());
+    hit.position          = from_jolt(result.mContactPointOn2);
+    hit.normal            = from_jolt(-result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()));
+    hit.fraction          = result.mFraction;
+    hit.penetration_depth = result.mPenetrationDepth;
+    return true;
+}
+
+void Jolt_world::overlap_shape(
+    const ICollision_shape&    shape,
+    const Transform&           transform,
+    const Query_filter&        filter,
+    std::vector<IRigid_body*>& rigid_bodies
+)
+{
+    ERHE_PROFILE_FUNCTION
+
+    sync_body_access();
+
+    rigid_bodies.clear();
+
+    const JPH::ShapeRefC jolt_shape = get_jolt_shape(shape);
+    const Query_filters  filters{m_collision_layers, filter};
+    const JPH::RMat44    center_of_mass_transform = get_world_transform(transform).PreTranslated(
+        jolt_shape->GetCenterOfMass()
+    );
+    JPH::CollideShapeSettings settings;
+    JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+    m_physics_system.GetNarrowPhaseQuery().CollideShape(
+        jolt_shape.GetPtr(),
+        JPH::Vec3::sReplicate(1.0f),
+        center_of_mass_transform,
+        settings,
+        JPH::RVec3::sZero(),
+        collector,
+        filters.broad_phase_layer_filter,
+        filters.object_layer_filter,
+        filters.body_filter
+    );
+
+    // Each body can have multiple hits, one for each sub shape
+    std::vector<JPH::BodyID> body_ids;
+    body_ids.reserve(collector.mHits.size());
+    for (const JPH::CollideShapeResult& result : collector.mHits) {
+        body_ids.push_back(result.mBodyID2);
+    }
+    std::sort(body_ids.begin(), body_ids.end());
+    body_ids.erase(std::unique(body_ids.begin(), body_ids.end()), body_ids.end());
+
+    const JPH::BodyLockInterface& lock_interface = m_physics_system.GetBodyLockInterface();
+    for (const JPH::BodyID body_id : body_ids) {
+        const JPH::BodyLockRead lock{lock_interface, body_id};
+        if (lock.Succeeded()) {
+            rigid_bodies.push_back(reinterpret_cast<Jolt_rigid_body*>(lock.GetBody().GetUserData()));
+        }
+    }
+}
+
+auto Jolt_world::get_collision_layers() const -> const Collision_layers&
+{
+    return m_collision_layers;
+}
+
+void Jolt_world::set_layer_collision(
+    const Object_layer lhs,
+    const Object_layer rhs,
+    const bool         enable
+)
+{
+    // Filters are used by physics update jobs
+    sync_body_access();
+
+    log_physics->trace(
+        "set layer collision {} - {} = {}",
+        m_collision_layers.object_layers.at(lhs).name,
+        m_collision_layers.object_layers.at(rhs).name,
+        enable
+    );
+    m_collision_layers.set_layer_collision(lhs, rhs, enable);
+    m_collision_filter.set_collision_layers(m_collision_layers);
+}
+
 void Jolt_world::set_gravity(const glm::vec3& gravity)
 {
+    sync_body_access();
+
     log_physics->trace("set gravity from {} to {}", m_gravity, gravity);
     m_gravity = gravity;
     m_physics_system.SetGravity(to_jolt(gravity));
@@ -12,9 +12,17 @@
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 
+#include <glm/glm.hpp>
+
+#include <array>
 #include <memory>
 #include <vector>
 
+namespace erhe::concurrency
+{
+    class Concurrent_queue;
+}
+
 namespace erhe::physics
 {
 
@@ -23,28 +31,18 @@ class Jolt_rigid_body;
 class Jolt_constraint;
 //class Jolt_debug_renderer;
 
-// Layer that objects can be in, determines which other objects it can collide with
-// Typically you at least want to have 1 layer for moving bodies and 1 layer for static bodies, but you can have more
-// layers if you want. E.g. you could have a layer for high detail collision (which is not used by the physics simulation
-// but only if you do collision testing).
-namespace Layers
-{
-
-static constexpr uint8_t NON_MOVING    = 0u;
-static constexpr uint8_t MOVING        = 1u;
-static constexpr uint8_t NON_COLLIDING = 2u;
-static constexpr uint8_t NUM_LAYERS    = 3u;
-
-[[nodiscard]] auto get_layer(const Motion_mode motion_mode) -> uint8_t;
-
-};
-
+// Table driven object layer and broad phase layer filters, built from
+// Collision_layers. Jolt may call these concurrently from job threads;
+// tables are only modified while physics is not updating.
 class Jolt_collision_filter
     : public JPH::ObjectVsBroadPhaseLayerFilter
     , public JPH::ObjectLayerPairFilter
 {
+public:
+    void set_collision_layers(const Collision_layers& collision_layers);
+
     // Implements JPH::ObjectVsBroadPhaseLayerFilter
-	auto ShouldCollide(
+    auto ShouldCollide(
         JPH::ObjectLayer     inLayer1,
         JPH::BroadPhaseLayer inLayer2
     ) const -> bool override;
@@ -54,6 +52,11 @@ class Jolt_collision_filter
         JPH::ObjectLayer inLayer1,
         JPH::ObjectLayer inLayer2
     ) const -> bool override;
+
+private:
+    std::size_t                                m_object_layer_count{0};
+    std::array<uint32_t, c_max_object_layers> m_collision_masks        {}; // bit for each object layer
+    std::array<uint32_t, c_max_object_layers> m_broad_phase_layer_masks{}; // bit for each broad phase layer
 };
 
 class Jolt_world
@@ -62,7 +65,7 @@ class Jolt_world
     , public JPH::ContactListener
 {
 public:
-    Jolt_world();
+    explicit Jolt_world(const Collision_layers& collision_layers);
     virtual ~Jolt_world() noexcept override;
 
     // Implements IWorld
@@ -79,6 +82,22 @@ public:
     void set_debug_drawer       (IDebug_draw* debug_draw)  override;
     void debug_draw             ()                         override;
     void sanity_check           ()                         override;
+    void set_thread_pool        (erhe::concurrency::Thread_pool* thread_pool) override;
+
+    [[nodiscard]] auto is_async_updates_enabled() const -> bool override;
+    void enable_async_updates   ()                         override;
+    void disable_async_updates  ()                         override;
+    void begin_async_update     ()                         override;
+    void end_async_update       ()                         override;
+    void set_bulk_motion_state_updates(bool enable)        override;
+    void take_active_body_transforms  (std::vector<Active_body_transform>& transforms) override;
+    [[nodiscard]] auto get_collision_layers() const -> const Collision_layers& override;
+    void set_layer_collision    (Object_layer lhs, Object_layer rhs, bool enable) override;
+    void add_rigid_bodies       (const std::vector<IRigid_body*>& rigid_bodies)   override;
+    auto cast_ray     (const Ray_cast& ray, const Query_filter& filter, Ray_hit& hit) -> bool override;
+    void cast_rays    (const std::vector<Ray_cast>& rays, const Query_filter& filter, std::vector<Ray_hit>& hits) override;
+    auto cast_shape   (const ICollision_shape& shape, const Transform& start, const glm::vec3& displacement, const Query_filter& filter, Shape_cast_hit& hit) -> bool override;
+    void overlap_shape(const ICollision_shape& shape, const Transform& transform, const Query_filter& filter, std::vector<IRigid_body*>& rigid_bodies) override;
 
     // Implements BodyActivationListener
     void OnBodyActivated  (const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
@@ -97,7 +116,21 @@ public:
     // Public API
     [[nodiscard]] auto get_physics_system() -> JPH::PhysicsSystem&;
 
+    // Called by Jolt_rigid_body before it reads or modifies its Jolt body,
+    // and by world methods which access bodies. Completes a running async
+    // update like end_async_update(), including publishing transforms, so
+    // body access never overlaps a physics step. Must be called from the
+    // thread which calls begin_async_update().
+    void sync_body_access();
+
 private:
+    [[nodiscard]] auto get_job_system() -> JPH::JobSystem*;
+    void step                          (float dt);
+    void async_update                  ();
+    void wait_async_update             ();
+    void capture_active_body_transforms();
+    void publish_active_body_transforms();
+
     class Initialize_first
     {
     public:
@@ -113,10 +146,12 @@ private:
     static constexpr unsigned int cMaxBodyPairs          = 1024 * 8;
     static constexpr unsigned int cMaxContactConstraints = 1024;
 
-    const Jolt_collision_filter                    m_collision_filter;
+    Collision_layers                               m_collision_layers;
+    Jolt_collision_filter                          m_collision_filter;
 
     JPH::TempAllocatorImpl                         m_temp_allocator;
-    JPH::JobSystemThreadPool                       m_job_system;
+    erhe::concurrency::Thread_pool*                m_thread_pool{nullptr};
+    std::unique_ptr<JPH::JobSystem>                m_job_system;
     std::unique_ptr<JPH::BroadPhaseLayerInterface> m_broad_phase_layer_interface;
     JPH::PhysicsSystem                             m_physics_system;
     //std::unique_ptr<Jolt_debug_renderer>           m_debug_renderer;
@@ -126,6 +161,17 @@ private:
 
     std::vector<std::shared_ptr<ICollision_shape>> m_collision_shapes;
 
+    // Async updates
+    std::unique_ptr<erhe::concurrency::Concurrent_queue> m_update_queue;
+    bool                                                 m_async_updates_enabled{false};
+    bool                                                 m_async_update_running {false};
+    std::vector<float>                                   m_pending_steps;         // queued by update_fixed_step()
+    std::vector<float>                                   m_running_steps;         // owned by running async update
+
+    // Transforms of bodies which were active after steps
+    bool                                                 m_bulk_motion_state_updates{false};
+    std::vector<Active_body_transform>                   m_captured_transforms;  // written by steps
+    std::vector<Active_body_transform>                   m_published_transforms; // for take_active_body_transforms()
 };
 
 } // namespace erhe::physics
@@ -37,6 +37,13 @@ Null_rigid_body::Null_rigid_body(
             ? Motion_mode::e_dynamic
             : Motion_mode::e_static
     }
+    , m_object_layer{
+        create_info.object_layer.has_value()
+            ? create_info.object_layer.value()
+            : create_info.enable_collisions
+                ? Layers::get_layer(m_motion_mode)
+                : Layers::NON_COLLIDING
+    }
     , m_debug_label{create_info.debug_label}
 {
     if (create_info.inertia_override.has_value())
@@ -106,6 +113,16 @@ void Null_rigid_body::set_motion_mode(const Motion_mode motion_mode)
     m_motion_mode = motion_mode;
 }
 
+auto Null_rigid_body::get_object_layer() const -> Object_layer
+{
+    return m_object_layer;
+}
+
+void Null_rigid_body::set_object_layer(const Object_layer object_layer)
+{
+    m_object_layer = object_layer;
+}
+
 void Null_rigid_body::set_center_of_mass_transform(const Transform& transform)
 {
     // TODO
@@ -30,6 +30,7 @@ public:
     auto get_local_inertia           () const -> glm::mat4                         override;
     auto get_mass                    () const -> float                             override;
     auto get_motion_mode             () const -> Motion_mode                       override;
+    auto get_object_layer            () const -> Object_layer                      override;
     auto get_restitution             () const -> float                             override;
     auto get_world_transform         () const -> Transform                         override;
 
@@ -44,6 +45,7 @@ public:
     void set_linear_velocity         (const glm::vec3& velocity)                    override;
     void set_mass_properties         (float mass, const glm::mat4& local_inertia)   override;
     void set_motion_mode             (Motion_mode motion_mode)                      override;
+    void set_object_layer            (Object_layer object_layer)                    override;
     void set_restitution             (float restitution)                            override;
     void set_world_transform         (const Transform& transform)                   override;
 
@@ -54,6 +56,7 @@ private:
     glm::vec3                         m_angular_velocity;
     std::optional<float>              m_mass;
     Motion_mode                       m_motion_mode     {Motion_mode::e_static};
+    Object_layer                      m_object_layer    {Layers::NON_MOVING};
     float                             m_linear_damping  {0.05f};
     glm::mat4                         m_local_inertia   {0.0f};
     float                             m_angular_damping {0.05f};
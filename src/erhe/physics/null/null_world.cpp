@@ -10,25 +10,31 @@
 namespace erhe::physics
 {
 
-auto IWorld::create() -> IWorld*
+auto IWorld::create(const Collision_layers& collision_layers) -> IWorld*
 {
-    return new Null_world();
+    return new Null_world(collision_layers);
 }
 
-auto IWorld::create_shared() -> std::shared_ptr<IWorld>
+auto IWorld::create_shared(const Collision_layers& collision_layers) -> std::shared_ptr<IWorld>
 {
-    return std::make_shared<Null_world>();
+    return std::make_shared<Null_world>(collision_layers);
 }
 
-auto IWorld::create_unique() -> std::unique_ptr<IWorld>
+auto IWorld::create_unique(const Collision_layers& collision_layers) -> std::unique_ptr<IWorld>
 {
-    return std::make_unique<Null_world>();
+    return std::make_unique<Null_world>(collision_layers);
 }
 
 IWorld::~IWorld() noexcept
 {
 }
 
+Null_world::Null_world(const Collision_layers& collision_layers)
+    : m_collision_layers{collision_layers}
+{
+    m_collision_layers.make_symmetric();
+}
+
 Null_world::~Null_world() noexcept
 {
 }
@@ -58,6 +64,11 @@ void Null_world::add_rigid_body(IRigid_body* rigid_body)
     m_rigid_bodies.push_back(rigid_body);
 }
 
+void Null_world::add_rigid_bodies(const std::vector<IRigid_body*>& rigid_bodies)
+{
+    m_rigid_bodies.insert(m_rigid_bodies.end(), rigid_bodies.begin(), rigid_bodies.end());
+}
+
 void Null_world::remove_rigid_body(IRigid_body* rigid_body)
 {
     m_rigid_bodies.erase(
@@ -110,5 +121,105 @@ void Null_world::sanity_check()
 {
 }
 
+void Null_world::set_thread_pool(erhe::concurrency::Thread_pool* thread_pool)
+{
+    static_cast<void>(thread_pool);
+}
+
+auto Null_world::is_async_updates_enabled() const -> bool
+{
+    return false;
+}
+
+void Null_world::enable_async_updates()
+{
+}
+
+void Null_world::disable_async_updates()
+{
+}
+
+void Null_world::begin_async_update()
+{
+}
+
+void Null_world::end_async_update()
+{
+}
+
+void Null_world::set_bulk_motion_state_updates(const bool enable)
+{
+    static_cast<void>(enable);
+}
+
+void Null_world::take_active_body_transforms(std::vector<Active_body_transform>& transforms)
+{
+    transforms.clear();
+}
+
+auto Null_world::get_collision_layers() const -> const Collision_layers&
+{
+    return m_collision_layers;
+}
+
+void Null_world::set_layer_collision(
+    const Object_layer lhs,
+    const Object_layer rhs,
+    const bool         enable
+)
+{
+    m_collision_layers.set_layer_collision(lhs, rhs, enable);
+}
+
+auto Null_world::cast_ray(
+    const Ray_cast&     ray,
+    const Query_filter& filter,
+    Ray_hit&            hit
+) -> bool
+{
+    static_cast<void>(ray);
+    static_cast<void>(filter);
+    hit = Ray_hit{};
+    return false;
+}
+
+void Null_world::cast_rays(
+    const std::vector<Ray_cast>& rays,
+    const Query_filter&          filter,
+    std::vector<Ray_hit>&        hits
+)
+{
+    static_cast<void>(filter);
+    hits.assign(rays.size(), Ray_hit{});
+}
+
+auto Null_world::cast_shape(
+    const ICollision_shape& shape,
+    const Transform&        start,
+    const glm::vec3&        displacement,
+    const Query_filter&     filter,
+    Shape_cast_hit&         hit
+) -> bool
+{
+    static_cast<void>(shape);
+    static_cast<void>(start);
+    static_cast<void>(displacement);
+    static_cast<void>(filter);
+    hit = Shape_cast_hit{};
+    return false;
+}
+
+void Null_world::overlap_shape(
+    const ICollision_shape&    shape,
+    const Transform&           transform,
+    const Query_filter&        filter,
+    std::vector<IRigid_body*>& rigid_bodies
+)
+{
+    static_cast<void>(shape);
+    static_cast<void>(transform);
+    static_cast<void>(filter);
+    rigid_bodies.clear();
+}
 
 } // namespace erhe::physics
@@ -14,6 +14,7 @@ class Null_world
     : public IWorld
 {
 public:
+    explicit Null_world(const Collision_layers& collision_layers);
     virtual ~Null_world() noexcept override;
 
     // Implements IWorld
@@ -30,8 +31,24 @@ public:
     void set_debug_drawer          (IDebug_draw* debug_draw)  override;
     void debug_draw                ()                         override;
     void sanity_check              ()                         override;
+    void set_thread_pool           (erhe::concurrency::Thread_pool* thread_pool) override;
+    auto is_async_updates_enabled  () const -> bool           override;
+    void enable_async_updates      ()                         override;
+    void disable_async_updates     ()                         override;
+    void begin_async_update        ()                         override;
+    void end_async_update          ()                         override;
+    void set_bulk_motion_state_updates(bool enable)           override;
+    void take_active_body_transforms  (std::vector<Active_body_transform>& transforms) override;
+    auto get_collision_layers      () const -> const Collision_layers& override;
+    void set_layer_collision       (Object_layer lhs, Object_layer rhs, bool enable) override;
+    void add_rigid_bodies          (const std::vector<IRigid_body*>& rigid_bodies)   override;
+    auto cast_ray     (const Ray_cast& ray, const Query_filter& filter, Ray_hit& hit) -> bool override;
+    void cast_rays    (const std::vector<Ray_cast>& rays, const Query_filter& filter, std::vector<Ray_hit>& hits) override;
+    auto cast_shape   (const ICollision_shape& shape, const Transform& start, const glm::vec3& displacement, const Query_filter& filter, Shape_cast_hit& hit) -> bool override;
+    void overlap_shape(const ICollision_shape& shape, const Transform& transform, const Query_filter& filter, std::vector<IRigid_body*>& rigid_bodies) override;
 
 private:
+    Collision_layers          m_collision_layers;
     bool                      m_physics_enabled{false};
     glm::vec3                 m_gravity        {0.0f};
 
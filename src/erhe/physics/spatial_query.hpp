@@ -0,0 +1,53 @@
+#pragma once
+
+#include "erhe/physics/collision_layers.hpp"
+#include "erhe/physics/transform.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace erhe::physics
+{
+
+class IRigid_body;
+
+// Restricts which bodies queries can hit
+class Query_filter
+{
+public:
+    uint32_t           object_layer_mask{~uint32_t{0}}; // bit for each object layer
+    const IRigid_body* ignore_rigid_body{nullptr};
+};
+
+// Ray from origin towards direction, up to max_distance.
+// Direction does not need to be normalized.
+class Ray_cast
+{
+public:
+    glm::vec3 origin      {0.0f};
+    glm::vec3 direction   {0.0f, 0.0f, -1.0f};
+    float     max_distance{1000.0f};
+};
+
+class Ray_hit
+{
+public:
+    IRigid_body* rigid_body{nullptr}; // nullptr if ray did not hit
+    glm::vec3    position  {0.0f};
+    glm::vec3    normal    {0.0f};
+    float        distance  {0.0f};
+};
+
+// First hit of shape moving from start transform along displacement
+class Shape_cast_hit
+{
+public:
+    IRigid_body* rigid_body       {nullptr};
+    glm::vec3    position         {0.0f}; // contact point on hit body
+    glm::vec3    normal           {0.0f}; // surface normal of hit body
+    float        fraction         {0.0f}; // of displacement
+    float        penetration_depth{0.0f};
+};
+
+} // namespace erhe::physics
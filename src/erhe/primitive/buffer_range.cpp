@@ -1 +1,14 @@
 #include "erhe/primitive/buffer_range.hpp"
+#include "erhe/graphics/range_allocator.hpp"
+
+namespace erhe::primitive
+{
+
+auto Buffer_range::get_byte_offset() const -> std::size_t
+{
+    return allocation
+        ? allocation->get_byte_offset()
+        : byte_offset;
+}
+
+} // namespace erhe::primitive
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+
+namespace erhe::graphics
+{
+    class Range_allocation;
+}
 
 namespace erhe::primitive
 {
@@ -8,9 +14,16 @@ namespace erhe::primitive
 class Buffer_range
 {
 public:
+    // Returns current byte offset; ranges backed by an allocation
+    // may be moved when the buffer is compacted.
+    [[nodiscard]] auto get_byte_offset() const -> std::size_t;
+
     std::size_t count       {0};
     std::size_t element_size{0};
     std::size_t byte_offset {0};
+
+    // Keeps range allocated while any copy of this Buffer_range exists
+    std::shared_ptr<erhe::graphics::Range_allocation> allocation{};
 };
 
 } // namespace erhe::primitive
@@ -1,10 +1,13 @@
 #include "erhe/primitive/buffer_sink.hpp"
 #include "erhe/primitive/buffer_info.hpp"
 #include "erhe/primitive/buffer_writer.hpp"
+#include "erhe/primitive/primitive_log.hpp"
 #include "erhe/primitive/primitive_geometry.hpp"
 #include "erhe/graphics/buffer.hpp"
 #include "erhe/graphics/buffer_transfer_queue.hpp"
+#include "erhe/graphics/range_allocator.hpp"
 #include "erhe/raytrace/ibuffer.hpp"
+#include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 namespace erhe::primitive
@@ -14,6 +17,16 @@ Buffer_sink::~Buffer_sink() noexcept
 {
 }
 
+auto Buffer_sink::acquire_staging(
+    const std::size_t byte_count,
+    std::size_t&      staging_id
+) -> gsl::span<std::uint8_t>
+{
+    static_cast<void>(byte_count);
+    staging_id = 0;
+    return {};
+}
+
 Gl_buffer_sink::Gl_buffer_sink(
     erhe::graphics::Buffer_transfer_queue& buffer_transfer_queue,
     erhe::graphics::Buffer&                vertex_buffer,
@@ -25,20 +38,61 @@ Gl_buffer_sink::Gl_buffer_sink(
 {
 }
 
+auto Gl_buffer_sink::allocate_range(
+    erhe::graphics::Buffer& buffer,
+    const std::size_t       byte_count,
+    const std::size_t       alignment
+) -> std::shared_ptr<erhe::graphics::Range_allocation>
+{
+    auto allocation = buffer.allocate_range(byte_count, alignment);
+    if (!allocation) {
+        // This may be called from primitive builder worker threads, so
+        // compaction is deferred to compact_if_requested() on GL thread.
+        log_primitive_builder->error(
+            "Out of memory in buffer {} allocating {} bytes, {} bytes free, compaction requested",
+            buffer.debug_label(),
+            byte_count,
+            buffer.free_capacity_bytes()
+        );
+        m_compact_requested.store(true);
+    }
+    return allocation;
+}
+
+void Gl_buffer_sink::compact_if_requested()
+{
+    if (!m_compact_requested.exchange(false)) {
+        return;
+    }
+
+    ERHE_PROFILE_FUNCTION
+
+    // Pending uploads must land before ranges can be moved
+    m_buffer_transfer_queue.flush();
+    static_cast<void>(m_vertex_buffer.compact_ranges());
+    static_cast<void>(m_index_buffer .compact_ranges());
+}
+
 auto Gl_buffer_sink::allocate_vertex_buffer(
     const std::size_t vertex_count,
     const std::size_t vertex_element_size
 ) -> Buffer_range
 {
-    const auto byte_offset = m_vertex_buffer.allocate_bytes(
+    auto allocation = allocate_range(
+        m_vertex_buffer,
         vertex_count * vertex_element_size,
         vertex_element_size
     );
+    if (!allocation) {
+        return Buffer_range{};
+    }
+    const auto byte_offset = allocation->get_byte_offset();
 
     return Buffer_range{
         .count        = vertex_count,
         .element_size = vertex_element_size,
-        .byte_offset  = byte_offset
+        .byte_offset  = byte_offset,
+        .allocation   = std::move(allocation)
     };
 }
 
@@ -47,17 +101,44 @@ auto Gl_buffer_sink::allocate_index_buffer(
     const std::size_t index_element_size
 ) -> Buffer_range
 {
-    const auto index_byte_offset = m_index_buffer.allocate_bytes(index_count * index_element_size);
+    auto allocation = allocate_range(
+        m_index_buffer,
+        index_count * index_element_size,
+        64
+    );
+    if (!allocation) {
+        return Buffer_range{};
+    }
+    const auto index_byte_offset = allocation->get_byte_offset();
 
     return Buffer_range{
         .count        = index_count,
         .element_size = index_element_size,
-        .byte_offset  = index_byte_offset
+        .byte_offset  = index_byte_offset,
+        .allocation   = std::move(allocation)
     };
 }
 
+auto Gl_buffer_sink::acquire_staging(
+    const std::size_t byte_count,
+    std::size_t&      staging_id
+) -> gsl::span<std::uint8_t>
+{
+    const auto staging_range = m_buffer_transfer_queue.acquire_staging(byte_count);
+    staging_id = staging_range.id;
+    return staging_range.span;
+}
+
 void Gl_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 {
+    if (writer.staging_id != 0) {
+        m_buffer_transfer_queue.enqueue(
+            m_vertex_buffer,
+            writer.start_offset(),
+            writer.staging_id
+        );
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_vertex_buffer,
         writer.start_offset(),
@@ -67,6 +148,14 @@ void Gl_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 
 void Gl_buffer_sink::buffer_ready(Index_buffer_writer& writer) const
 {
+    if (writer.staging_id != 0) {
+        m_buffer_transfer_queue.enqueue(
+            m_index_buffer,
+            writer.start_offset(),
+            writer.staging_id
+        );
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_index_buffer,
         writer.start_offset(),
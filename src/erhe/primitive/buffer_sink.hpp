@@ -4,12 +4,14 @@
 
 #include <gsl/span>
 
+#include <atomic>
 #include <memory>
 
 namespace erhe::graphics
 {
     class Buffer;
     class Buffer_transfer_queue;
+    class Range_allocation;
 }
 
 namespace erhe::raytrace
@@ -29,6 +31,9 @@ class Buffer_sink
 public:
     virtual ~Buffer_sink() noexcept;
 
+    // Allocation functions return empty Buffer_range (count 0) if
+    // there is no space in the buffer
+
     [[nodiscard]] virtual auto allocate_vertex_buffer(
         const std::size_t vertex_count,
         const std::size_t vertex_element_size
@@ -39,6 +44,14 @@ public:
         const std::size_t index_element_size
     ) -> Buffer_range = 0;
 
+    // Optionally provides memory where writer can write data directly.
+    // Returns empty span if writer should use its own memory. staging_id
+    // is stored in the writer and passed back with buffer_ready().
+    [[nodiscard]] virtual auto acquire_staging(
+        std::size_t  byte_count,
+        std::size_t& staging_id
+    ) -> gsl::span<std::uint8_t>;
+
     virtual void buffer_ready(Vertex_buffer_writer& writer) const = 0;
     virtual void buffer_ready(Index_buffer_writer&  writer) const = 0;
 };
@@ -63,13 +76,33 @@ public:
         const std::size_t index_element_size
     ) -> Buffer_range override;
 
+    [[nodiscard]] auto acquire_staging(
+        std::size_t  byte_count,
+        std::size_t& staging_id
+    ) -> gsl::span<std::uint8_t> override;
+
     void buffer_ready(Vertex_buffer_writer& writer) const override;
     void buffer_ready(Index_buffer_writer&  writer) const override;
 
+    // Compacts vertex and index buffers, if allocation has failed since
+    // previous call. Compaction moves ranges and makes GL calls, so this
+    // must be called from GL thread, when no primitive builder is using
+    // this sink.
+    void compact_if_requested();
+
 private:
+    // Returns nullptr and requests compaction if there is no free
+    // block large enough
+    [[nodiscard]] auto allocate_range(
+        erhe::graphics::Buffer& buffer,
+        std::size_t             byte_count,
+        std::size_t             alignment
+    ) -> std::shared_ptr<erhe::graphics::Range_allocation>;
+
     erhe::graphics::Buffer_transfer_queue& m_buffer_transfer_queue;
     erhe::graphics::Buffer&                m_vertex_buffer;
     erhe::graphics::Buffer&                m_index_buffer;
+    std::atomic<bool>                      m_compact_requested{false};
 };
 
 class Raytrace_buffer_sink
@@ -10,6 +10,8 @@
 #include <glm/gtc/packing.hpp>
 #include <gsl/span>
 
+#include <cstring>
+
 namespace erhe::primitive
 {
 
@@ -157,18 +159,42 @@ Vertex_buffer_writer::Vertex_buffer_writer(
 {
     Expects(build_context.root.primitive_geometry != nullptr);
     const auto& vertex_buffer_range = build_context.root.primitive_geometry->vertex_buffer_range;
-    vertex_data.resize(vertex_buffer_range.count * vertex_buffer_range.element_size);
-    vertex_data_span = gsl::make_span(vertex_data);
+    const std::size_t byte_count = vertex_buffer_range.count * vertex_buffer_range.element_size;
+    if (byte_count == 0) {
+        return; // allocation failed
+    }
+    vertex_data_span = buffer_sink->acquire_staging(byte_count, staging_id);
+    if (staging_id != 0) {
+        // Staging memory is not cleared, unlike vector
+        memset(vertex_data_span.data(), 0, byte_count);
+    } else {
+        vertex_data.resize(byte_count);
+        vertex_data_span = gsl::make_span(vertex_data);
+    }
+}
+
+Vertex_buffer_writer::Vertex_buffer_writer(
+    Vertex_buffer_writer& parent,
+    const std::size_t     byte_offset
+)
+    : build_context      {parent.build_context}
+    , buffer_sink        {parent.buffer_sink}
+    , vertex_data_span   {parent.vertex_data_span}
+    , vertex_write_offset{parent.vertex_write_offset + byte_offset}
+    , parent             {&parent}
+{
 }
 
 Vertex_buffer_writer::~Vertex_buffer_writer() noexcept
 {
-    buffer_sink->buffer_ready(*this);
+    if ((parent == nullptr) && !vertex_data_span.empty()) {
+        buffer_sink->buffer_ready(*this);
+    }
 }
 
 auto Vertex_buffer_writer::start_offset() -> std::size_t
 {
-    return build_context.root.primitive_geometry->vertex_buffer_range.byte_offset;
+    return build_context.root.primitive_geometry->vertex_buffer_range.get_byte_offset();
 }
 
 Index_buffer_writer::Index_buffer_writer(
@@ -184,8 +210,18 @@ Index_buffer_writer::Index_buffer_writer(
     const auto& primitive_geometry = *build_context.root.primitive_geometry;
     const auto& index_buffer_range = primitive_geometry.index_buffer_range;
     const auto& mesh_info          = build_context.root.mesh_info;
-    index_data.resize(index_buffer_range.count * index_type_size);
-    index_data_span = gsl::make_span(index_data);
+    const std::size_t byte_count = index_buffer_range.count * index_type_size;
+    if (byte_count == 0) {
+        return; // allocation failed
+    }
+    index_data_span = buffer_sink->acquire_staging(byte_count, staging_id);
+    if (staging_id != 0) {
+        // Staging memory is not cleared, unlike vector
+        memset(index_data_span.data(), 0, byte_count);
+    } else {
+        index_data.resize(byte_count);
+        index_data_span = gsl::make_span(index_data);
+    }
 
     const auto& features = build_context.root.build_info.format.features;
 
@@ -215,14 +251,36 @@ Index_buffer_writer::Index_buffer_writer(
     }
 }
 
+Index_buffer_writer::Index_buffer_writer(
+    Index_buffer_writer& parent,
+    const std::size_t    first_corner_point_index,
+    const std::size_t    first_triangle
+)
+    : build_context                   {parent.build_context}
+    , buffer_sink                     {parent.buffer_sink}
+    , index_type                      {parent.index_type}
+    , index_type_size                 {parent.index_type_size}
+    , index_data_span                 {parent.index_data_span}
+    , corner_point_index_data_span    {parent.corner_point_index_data_span}
+    , triangle_fill_index_data_span   {parent.triangle_fill_index_data_span}
+    , edge_line_index_data_span       {parent.edge_line_index_data_span}
+    , polygon_centroid_index_data_span{parent.polygon_centroid_index_data_span}
+    , corner_point_indices_written    {parent.corner_point_indices_written + first_corner_point_index}
+    , triangle_indices_written        {parent.triangle_indices_written + first_triangle * 3}
+    , parent                          {&parent}
+{
+}
+
 Index_buffer_writer::~Index_buffer_writer() noexcept
 {
-    buffer_sink->buffer_ready(*this);
+    if ((parent == nullptr) && !index_data_span.empty()) {
+        buffer_sink->buffer_ready(*this);
+    }
 }
 
 auto Index_buffer_writer::start_offset() -> std::size_t
 {
-    return build_context.root.primitive_geometry->index_buffer_range.byte_offset;
+    return build_context.root.primitive_geometry->index_buffer_range.get_byte_offset();
 }
 
 void Vertex_buffer_writer::write(
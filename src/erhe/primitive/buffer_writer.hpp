@@ -32,6 +32,13 @@ public:
         Build_context&              build_context,
         gsl::not_null<Buffer_sink*> buffer_sink
     );
+
+    // Writes to memory of parent writer, starting at byte offset relative
+    // to current parent write offset. Does not notify buffer sink. Used to fill disjoint ranges concurrently.
+    Vertex_buffer_writer(
+        Vertex_buffer_writer& parent,
+        const std::size_t     byte_offset
+    );
     virtual ~Vertex_buffer_writer() noexcept;
 
     void write(const Vertex_attribute_info& attribute, const glm::vec2 value);
@@ -45,9 +52,11 @@ public:
     Build_context&              build_context;
     gsl::not_null<Buffer_sink*> buffer_sink;
     Buffer_range                buffer_range;
-    std::vector<std::uint8_t>   vertex_data;
+    std::vector<std::uint8_t>   vertex_data; // not used when writing directly to staging memory
     gsl::span<std::uint8_t>     vertex_data_span;
     std::size_t                 vertex_write_offset{0};
+    std::size_t                 staging_id         {0};
+    Vertex_buffer_writer*       parent             {nullptr};
 };
 
 /// Writes 8/16/32 -bit indices to byte buffer/memory
@@ -60,6 +69,15 @@ public:
         Build_context&              build_context,
         gsl::not_null<Buffer_sink*> buffer_sink
     );
+
+    // Writes to memory of parent writer, with corner point and triangle fill
+    // writes starting at given indices relative to current parent counts.
+    // Does not notify buffer sink.
+    Index_buffer_writer(
+        Index_buffer_writer& parent,
+        const std::size_t    first_corner_point_index,
+        const std::size_t    first_triangle
+    );
     virtual ~Index_buffer_writer() noexcept;
 
     void write_corner  (const uint32_t v0);
@@ -75,17 +93,19 @@ public:
     Buffer_range                 buffer_range;
     const gl::Draw_elements_type index_type;
     const std::size_t            index_type_size{0};
-    std::vector<std::uint8_t>    index_data;
+    std::vector<std::uint8_t>    index_data; // not used when writing directly to staging memory
     gsl::span<std::uint8_t>      index_data_span;
     gsl::span<std::uint8_t>      corner_point_index_data_span;
     gsl::span<std::uint8_t>      triangle_fill_index_data_span;
     gsl::span<std::uint8_t>      edge_line_index_data_span;
     gsl::span<std::uint8_t>      polygon_centroid_index_data_span;
 
-    std::size_t corner_point_indices_written    {0};
-    std::size_t triangle_indices_written        {0};
-    std::size_t edge_line_indices_written       {0};
-    std::size_t polygon_centroid_indices_written{0};
+    std::size_t          corner_point_indices_written    {0};
+    std::size_t          triangle_indices_written        {0};
+    std::size_t          edge_line_indices_written       {0};
+    std::size_t          polygon_centroid_indices_written{0};
+    std::size_t          staging_id                      {0};
+    Index_buffer_writer* parent                          {nullptr};
 };
 
 } // namespace erhe::primitive
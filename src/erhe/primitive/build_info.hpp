@@ -3,6 +3,11 @@
 #include "erhe/primitive/buffer_info.hpp"
 #include "erhe/primitive/format_info.hpp"
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::primitive
 {
 
@@ -18,6 +23,9 @@ public:
 
     Format_info format;
     Buffer_info buffer;
+
+    // When set, large geometries are built using multiple threads
+    erhe::concurrency::Thread_pool* thread_pool{nullptr};
 };
 
 } // namespace erhe::primitive
@@ -6,6 +6,7 @@
 #include "erhe/primitive/index_range.hpp"
 #include "erhe/primitive/primitive_log.hpp"
 #include "erhe/primitive/primitive_geometry.hpp"
+#include "erhe/concurrency/concurrent_queue.hpp"
 #include "erhe/geometry/geometry.hpp"
 #include "erhe/geometry/property_map.hpp"
 #include "erhe/gl/enum_string_functions.hpp"
@@ -25,6 +26,7 @@
 #include <glm/gtc/type_precision.hpp>
 #include <gsl/span>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <stdexcept>
@@ -342,6 +344,9 @@ void Build_context_root::allocate_vertex_buffer()
     Expects(total_vertex_count > 0);
 
     primitive_geometry->vertex_buffer_range = build_info.buffer.buffer_sink->allocate_vertex_buffer(total_vertex_count, vertex_stride);
+    if (primitive_geometry->vertex_buffer_range.count == 0) {
+        allocation_failed = true;
+    }
 }
 
 void Build_context_root::allocate_index_buffer()
@@ -364,6 +369,9 @@ void Build_context_root::allocate_index_buffer()
         total_index_count,
         index_type_size
     );
+    if (primitive_geometry->index_buffer_range.count == 0) {
+        allocation_failed = true;
+    }
 }
 
 class Geometry_point_source
@@ -451,25 +459,37 @@ void Primitive_builder::build(Primitive_geometry* primitive_geometry)
     );
     //const erhe::log::Indenter indenter;
 
-    Build_context build_context{
-        m_geometry,
-        m_build_info,
-        m_normal_style,
-        primitive_geometry
-    };
-
-    const auto& features = m_build_info.format.features;
+    bool allocation_failed{false};
+    {
+        Build_context build_context{
+            m_geometry,
+            m_build_info,
+            m_normal_style,
+            primitive_geometry
+        };
+
+        allocation_failed = build_context.root.allocation_failed;
+        if (!allocation_failed) {
+            const auto& features = m_build_info.format.features;
+
+            if (features.fill_triangles) {
+                build_context.build_polygon_fill();
+            }
 
-    if (features.fill_triangles) {
-        build_context.build_polygon_fill();
-    }
+            if (features.edge_lines) {
+                build_context.build_edge_lines();
+            }
 
-    if (features.edge_lines) {
-        build_context.build_edge_lines();
+            if (features.centroid_points) {
+                build_context.build_centroid_points();
+            }
+        }
     }
 
-    if (features.centroid_points) {
-        build_context.build_centroid_points();
+    if (allocation_failed) {
+        // Partial allocation is released here
+        log_primitive_builder->error("Buffer allocation failed for geometry {}", m_geometry.name);
+        *primitive_geometry = Primitive_geometry{};
     }
 }
 
@@ -492,10 +512,10 @@ Build_context::Build_context(
 
 Build_context::~Build_context() noexcept
 {
-    ERHE_VERIFY(vertex_index == root.total_vertex_count);
+    ERHE_VERIFY(root.allocation_failed || (vertex_index == root.total_vertex_count));
 }
 
-void Build_context::build_polygon_id()
+void Polygon_fill_builder::build_polygon_id()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -516,7 +536,7 @@ void Build_context::build_polygon_id()
     }
 }
 
-auto Build_context::get_polygon_normal() -> vec3
+auto Polygon_fill_builder::get_polygon_normal() -> vec3
 {
     vec3 polygon_normal{0.0f, 1.0f, 0.0f};
     if (property_maps.polygon_normals != nullptr) {
@@ -526,7 +546,7 @@ auto Build_context::get_polygon_normal() -> vec3
     return polygon_normal;
 }
 
-void Build_context::build_vertex_position()
+void Polygon_fill_builder::build_vertex_position()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -548,7 +568,7 @@ void Build_context::build_vertex_position()
     );
 }
 
-void Build_context::build_vertex_normal()
+void Polygon_fill_builder::build_vertex_normal()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -626,7 +646,7 @@ void Build_context::build_vertex_normal()
     }
 }
 
-void Build_context::build_vertex_tangent()
+void Polygon_fill_builder::build_vertex_tangent()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -661,7 +681,7 @@ void Build_context::build_vertex_tangent()
     vertex_writer.write(root.attributes.tangent, tangent);
 }
 
-void Build_context::build_vertex_bitangent()
+void Polygon_fill_builder::build_vertex_bitangent()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -697,7 +717,7 @@ void Build_context::build_vertex_bitangent()
     vertex_writer.write(root.attributes.bitangent, bitangent);
 }
 
-void Build_context::build_vertex_texcoord()
+void Polygon_fill_builder::build_vertex_texcoord()
 {
     ERHE_PROFILE_FUNCTION
 
@@ -751,7 +771,7 @@ void Build_context::build_vertex_texcoord()
 //
 // }
 
-void Build_context::build_vertex_color(const uint32_t /*polygon_corner_count*/)
+void Polygon_fill_builder::build_vertex_color(const uint32_t /*polygon_corner_count*/)
 {
     ERHE_PROFILE_FUNCTION
 
@@ -835,14 +855,14 @@ void Build_context::build_centroid_normal()
     }
 }
 
-void Build_context::build_corner_point_index()
+void Polygon_fill_builder::build_corner_point_index()
 {
     if (root.build_info.format.features.corner_points) {
         index_writer.write_corner(vertex_index);
     }
 }
 
-void Build_context::build_triangle_fill_index()
+void Polygon_fill_builder::build_triangle_fill_index()
 {
     if (root.build_info.format.features.fill_triangles) {
         if (previous_index != first_index) {
@@ -855,38 +875,41 @@ void Build_context::build_triangle_fill_index()
     previous_index = vertex_index;
 }
 
-void Build_context::build_polygon_fill()
+Polygon_fill_builder::Polygon_fill_builder(
+    Build_context&   build_context,
+    const Polygon_id polygon_begin,
+    const Polygon_id polygon_end,
+    const uint32_t   first_vertex,
+    const uint32_t   first_triangle
+)
+    : root           {build_context.root}
+    , property_maps  {build_context.property_maps}
+    , normal_style   {build_context.normal_style}
+    , polygon_begin  {polygon_begin}
+    , polygon_end    {polygon_end}
+    , vertex_writer  {build_context.vertex_writer, first_vertex * build_context.root.vertex_stride}
+    , index_writer   {build_context.index_writer, first_vertex, first_triangle}
+    , vertex_index   {first_vertex}
+    , primitive_index{first_triangle}
 {
-    ERHE_PROFILE_FUNCTION
-
-    // TODO property_maps.corner_indices needs to be setup
-    //      also if edge lines are wanted.
-
-    property_maps.corner_indices->clear();
+}
 
-    vertex_index  = 0;
-    polygon_index = 0;
+void Polygon_fill_builder::build()
+{
+    ERHE_PROFILE_FUNCTION
 
-    const bool any_normal_feature = root.build_info.format.features.normal =
-        root.build_info.format.features.normal      ||
-        root.build_info.format.features.normal_flat ||
-        root.build_info.format.features.normal_smooth;
+    const auto& features = root.build_info.format.features;
+    const bool any_normal_feature =
+        features.normal      ||
+        features.normal_flat ||
+        features.normal_smooth;
 
-    const Polygon_id polygon_id_end = root.geometry.get_polygon_count();
-    root.primitive_geometry->corner_to_vertex_id.resize(root.geometry.get_corner_count());
-    for (polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
+    for (polygon_id = polygon_begin; polygon_id < polygon_end; ++polygon_id) {
         const Polygon& polygon = root.geometry.polygons[polygon_id];
+        polygon_index  = static_cast<uint32_t>(polygon_id);
         first_index    = vertex_index;
         previous_index = first_index;
 
-        if (property_maps.polygon_ids_uint32 != nullptr) {
-            property_maps.polygon_ids_uint32->put(polygon_id, polygon_index);
-        }
-
-        if (property_maps.polygon_ids_vector3 != nullptr) {
-            property_maps.polygon_ids_vector3->put(polygon_id, erhe::toolkit::vec3_from_uint(polygon_index));
-        }
-
         const Polygon_corner_id polyon_corner_id_end = polygon.first_polygon_corner_id + polygon.corner_count;
         for (
             polygon_corner_id = polygon.first_polygon_corner_id;
@@ -911,16 +934,175 @@ void Build_context::build_polygon_fill()
             build_vertex_color    (polygon.corner_count);
 
             // Indices
-            property_maps.corner_indices->put(corner_id, vertex_index);
-
             build_corner_point_index();
             build_triangle_fill_index();
 
             vertex_writer.move(root.vertex_stride);
             ++vertex_index;
         }
+    }
+}
+
+namespace {
+
+// Geometries with fewer polygons than this are built on the calling thread
+constexpr Polygon_id parallel_polygon_threshold = 16384;
+constexpr Polygon_id parallel_polygon_chunk_size = 4096;
+
+}
+
+void Build_context::build_polygon_fill_property_maps()
+{
+    ERHE_PROFILE_FUNCTION
+
+    // Property maps are not safe for concurrent writes, so these
+    // are filled here, in the same order as vertices are built.
+    uint32_t corner_vertex_index{0};
+    const Polygon_id polygon_id_end = root.geometry.get_polygon_count();
+    for (Polygon_id polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
+        const Polygon& polygon       = root.geometry.polygons[polygon_id];
+        const uint32_t polygon_index = static_cast<uint32_t>(polygon_id);
+
+        if (property_maps.polygon_ids_uint32 != nullptr) {
+            property_maps.polygon_ids_uint32->put(polygon_id, polygon_index);
+        }
+
+        if (property_maps.polygon_ids_vector3 != nullptr) {
+            property_maps.polygon_ids_vector3->put(polygon_id, erhe::toolkit::vec3_from_uint(polygon_index));
+        }
+
+        const Polygon_corner_id polyon_corner_id_end = polygon.first_polygon_corner_id + polygon.corner_count;
+        for (
+            Polygon_corner_id polygon_corner_id = polygon.first_polygon_corner_id;
+            polygon_corner_id < polyon_corner_id_end;
+            ++polygon_corner_id
+        ) {
+            const Corner_id corner_id = root.geometry.polygon_corners[polygon_corner_id];
+            property_maps.corner_indices->put(corner_id, corner_vertex_index);
+            ++corner_vertex_index;
+        }
+    }
+}
+
+void Build_context::build_polygon_fill_parallel(erhe::concurrency::Thread_pool& thread_pool)
+{
+    ERHE_PROFILE_FUNCTION
+
+    const Polygon_id  polygon_count = root.geometry.get_polygon_count();
+    const std::size_t chunk_count   = (polygon_count + parallel_polygon_chunk_size - 1) / parallel_polygon_chunk_size;
+
+    // Count vertices and triangles for each chunk. Element 0 is left
+    // as zero so that inclusive sum gives first vertex of each chunk.
+    std::vector<uint32_t> chunk_vertex_offsets  (chunk_count + 1, 0);
+    std::vector<uint32_t> chunk_triangle_offsets(chunk_count + 1, 0);
+    {
+        erhe::concurrency::Concurrent_queue queue{thread_pool, "primitive build count"};
+        for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            queue.enqueue(
+                [this, chunk, polygon_count, &chunk_vertex_offsets, &chunk_triangle_offsets]()
+                {
+                    const Polygon_id begin = static_cast<Polygon_id>(chunk * parallel_polygon_chunk_size);
+                    const Polygon_id end   = std::min(begin + parallel_polygon_chunk_size, polygon_count);
+                    uint32_t vertex_count  {0};
+                    uint32_t triangle_count{0};
+                    for (Polygon_id polygon_id = begin; polygon_id < end; ++polygon_id) {
+                        const uint32_t corner_count = root.geometry.polygons[polygon_id].corner_count;
+                        vertex_count   += corner_count;
+                        triangle_count += (corner_count > 2) ? (corner_count - 2) : 0;
+                    }
+                    chunk_vertex_offsets  [chunk + 1] = vertex_count;
+                    chunk_triangle_offsets[chunk + 1] = triangle_count;
+                }
+            );
+        }
+        queue.wait();
+    }
+    for (std::size_t chunk = 1; chunk <= chunk_count; ++chunk) {
+        chunk_vertex_offsets  [chunk] += chunk_vertex_offsets  [chunk - 1];
+        chunk_triangle_offsets[chunk] += chunk_triangle_offsets[chunk - 1];
+    }
+
+    std::vector<std::unique_ptr<Polygon_fill_builder>> builders;
+    builders.reserve(chunk_count);
+    for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        const Polygon_id begin = static_cast<Polygon_id>(chunk * parallel_polygon_chunk_size);
+        const Polygon_id end   = std::min(begin + parallel_polygon_chunk_size, polygon_count);
+        builders.push_back(
+            std::make_unique<Polygon_fill_builder>(
+                *this,
+                begin,
+                end,
+                chunk_vertex_offsets  [chunk],
+                chunk_triangle_offsets[chunk]
+            )
+        );
+    }
+
+    {
+        erhe::concurrency::Concurrent_queue queue{thread_pool, "primitive build fill"};
+        for (auto& builder : builders) {
+            queue.enqueue(
+                [&builder]()
+                {
+                    builder->build();
+                }
+            );
+        }
+        queue.wait();
+    }
+
+    for (const auto& builder : builders) {
+        used_fallback_smooth_normal = used_fallback_smooth_normal || builder->used_fallback_smooth_normal;
+        used_fallback_tangent       = used_fallback_tangent       || builder->used_fallback_tangent;
+        used_fallback_bitangent     = used_fallback_bitangent     || builder->used_fallback_bitangent;
+        used_fallback_texcoord      = used_fallback_texcoord      || builder->used_fallback_texcoord;
+    }
+}
+
+void Build_context::build_polygon_fill()
+{
+    ERHE_PROFILE_FUNCTION
 
-        ++polygon_index;
+    // TODO property_maps.corner_indices needs to be setup
+    //      also if edge lines are wanted.
+
+    property_maps.corner_indices->clear();
+
+    root.build_info.format.features.normal =
+        root.build_info.format.features.normal      ||
+        root.build_info.format.features.normal_flat ||
+        root.build_info.format.features.normal_smooth;
+
+    const Polygon_id polygon_count = root.geometry.get_polygon_count();
+    root.primitive_geometry->corner_to_vertex_id.resize(root.geometry.get_corner_count());
+
+    build_polygon_fill_property_maps();
+
+    auto* const thread_pool = root.build_info.thread_pool;
+    if (
+        (thread_pool != nullptr) &&
+        (thread_pool->size() > 1) &&
+        (polygon_count >= parallel_polygon_threshold)
+    ) {
+        build_polygon_fill_parallel(*thread_pool);
+    } else {
+        Polygon_fill_builder builder{*this, 0, polygon_count, 0, 0};
+        builder.build();
+        used_fallback_smooth_normal = builder.used_fallback_smooth_normal;
+        used_fallback_tangent       = builder.used_fallback_tangent;
+        used_fallback_bitangent     = builder.used_fallback_bitangent;
+        used_fallback_texcoord      = builder.used_fallback_texcoord;
+    }
+
+    // Continue after polygon fill vertices and indices
+    const uint32_t fill_vertex_count = static_cast<uint32_t>(root.mesh_info.vertex_count_corners);
+    vertex_index = fill_vertex_count;
+    vertex_writer.move(static_cast<std::size_t>(fill_vertex_count) * root.vertex_stride);
+    if (root.build_info.format.features.corner_points) {
+        index_writer.corner_point_indices_written += fill_vertex_count;
+    }
+    if (root.build_info.format.features.fill_triangles) {
+        index_writer.triangle_indices_written += root.mesh_info.index_count_fill_triangles;
     }
 
     if (used_fallback_smooth_normal) {
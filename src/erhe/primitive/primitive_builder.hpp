@@ -22,6 +22,11 @@
 #include <memory>
 #include <string>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::graphics
 {
     class Buffer;
@@ -79,6 +84,7 @@ public:
     std::size_t                     vertex_stride     {0};
     std::size_t                     total_vertex_count{0};
     std::size_t                     total_index_count {0};
+    bool                            allocation_failed {false};
 };
 
 class Build_context
@@ -98,6 +104,49 @@ public:
 
     Build_context_root root;
 
+private:
+    friend class Polygon_fill_builder;
+
+    void build_polygon_fill_property_maps();
+    void build_polygon_fill_parallel     (erhe::concurrency::Thread_pool& thread_pool);
+
+    void build_centroid_position ();
+    void build_centroid_normal   ();
+
+    erhe::geometry::Polygon_id        polygon_id       {0};
+    uint32_t                          vertex_index     {0}; // primitive vertex index
+    Normal_style                      normal_style     {Normal_style::none};
+    Vertex_buffer_writer              vertex_writer;
+    Index_buffer_writer               index_writer;
+    Property_maps                     property_maps;
+
+    bool used_fallback_smooth_normal{false};
+    bool used_fallback_tangent      {false};
+    bool used_fallback_bitangent    {false};
+    bool used_fallback_texcoord     {false};
+};
+
+// Builds polygon fill vertices and indices for a range of polygons.
+// Each range writes to disjoint parts of vertex and index buffers,
+// so multiple Polygon_fill_builders can run concurrently.
+class Polygon_fill_builder
+{
+public:
+    Polygon_fill_builder(
+        Build_context&                   build_context,
+        const erhe::geometry::Polygon_id polygon_begin,
+        const erhe::geometry::Polygon_id polygon_end,
+        const uint32_t                   first_vertex,
+        const uint32_t                   first_triangle
+    );
+
+    void build();
+
+    bool used_fallback_smooth_normal{false};
+    bool used_fallback_tangent      {false};
+    bool used_fallback_bitangent    {false};
+    bool used_fallback_texcoord     {false};
+
 private:
     void build_polygon_id        ();
 
@@ -110,12 +159,17 @@ private:
     void build_vertex_texcoord   ();
     void build_vertex_color      (const uint32_t polygon_corner_count);
 
-    void build_centroid_position ();
-    void build_centroid_normal   ();
-
     void build_corner_point_index ();
     void build_triangle_fill_index();
 
+    Build_context_root&               root;
+    const Property_maps&              property_maps;
+    const Normal_style                normal_style;
+    const erhe::geometry::Polygon_id  polygon_begin;
+    const erhe::geometry::Polygon_id  polygon_end;
+    Vertex_buffer_writer              vertex_writer;
+    Index_buffer_writer               index_writer;
+
     erhe::geometry::Polygon_id        polygon_id       {0};
     erhe::geometry::Polygon_corner_id polygon_corner_id{0};
     erhe::geometry::Point_id          point_id         {0};
@@ -125,15 +179,6 @@ private:
     uint32_t                          previous_index   {0}; // primitive previous index  .
     uint32_t                          polygon_index    {0};
     uint32_t                          primitive_index  {0}; // triangle (TODO quad) index
-    Normal_style                      normal_style     {Normal_style::none};
-    Vertex_buffer_writer              vertex_writer;
-    Index_buffer_writer               index_writer;
-    Property_maps                     property_maps;
-
-    bool used_fallback_smooth_normal{false};
-    bool used_fallback_tangent      {false};
-    bool used_fallback_bitangent    {false};
-    bool used_fallback_texcoord     {false};
 };
 
 class Primitive_builder final
@@ -9,13 +9,13 @@ namespace erhe::primitive
 
 auto Primitive_geometry::base_vertex() const -> uint32_t
 {
-    return static_cast<uint32_t>(vertex_buffer_range.byte_offset / vertex_buffer_range.element_size);
+    return static_cast<uint32_t>(vertex_buffer_range.get_byte_offset() / vertex_buffer_range.element_size);
 }
 
 // Value that should be added in index range first index
 auto Primitive_geometry::base_index() const -> uint32_t
 {
-    return static_cast<uint32_t>(index_buffer_range.byte_offset / index_buffer_range.element_size);
+    return static_cast<uint32_t>(index_buffer_range.get_byte_offset() / index_buffer_range.element_size);
 }
 
 auto Primitive_geometry::index_range(const Primitive_mode primitive_mode) const -> Index_range
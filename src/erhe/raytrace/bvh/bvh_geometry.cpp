@@ -9,6 +9,7 @@
 #include "erhe/raytrace/bvh/bvh_geometry.hpp"
 #include "erhe/raytrace/bvh/bvh_instance.hpp"
 #include "erhe/raytrace/bvh/bvh_scene.hpp"
+#include "erhe/raytrace/bvh/bvh_thread_pool.hpp"
 #include "erhe/raytrace/bvh/glm_conversions.hpp"
 #include "erhe/raytrace/ibuffer.hpp"
 #include "erhe/raytrace/iinstance.hpp"
@@ -115,10 +116,6 @@ using PrecomputedTri = bvh::v2::PrecomputedTri<Scalar>;
 
 static constexpr bool should_permute = false; //// TODO
 
-// TODO Are these ok here?
-bvh::v2::ThreadPool thread_pool;
-bvh::v2::ParallelExecutor executor{thread_pool};
-
 void Bvh_geometry::commit()
 {
     ERHE_PROFILE_FUNCTION
@@ -217,7 +214,7 @@ void Bvh_geometry::commit()
 
                 timer.begin();
                 m_bvh = bvh::v2::DefaultBuilder<Node>::build(
-                    thread_pool,
+                    get_bvh_thread_pool(),
                     bboxes,
                     centers,
                     config
@@ -238,6 +235,7 @@ void Bvh_geometry::commit()
             ERHE_PROFILE_SCOPE("bvh precompute")
             m_precomputed_triangles.clear();
             m_precomputed_triangles.resize(tris.size());
+            bvh::v2::ParallelExecutor executor{get_bvh_thread_pool()};
             executor.for_each(
                 0,
                 tris.size(),
@@ -362,6 +360,57 @@ auto Bvh_geometry::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance
     return false;
 }
 
+auto Bvh_geometry::occluded_instance(Ray& ray) -> bool
+{
+    if (!m_enabled) {
+        return false;
+    }
+    if ((ray.mask & m_mask) == 0) {
+        return false;
+    }
+    if (m_bvh.nodes.empty()) {
+        return false;
+    }
+
+    bvh::v2::Ray<Scalar, 3> bvh_ray{
+        to_bvh(ray.origin),
+        to_bvh(ray.direction),
+        ray.t_near,
+        ray.t_far
+    };
+
+    static constexpr size_t stack_size = 64;
+    static constexpr bool   use_robust_traversal = false;
+
+    bool occluded = false;
+    bvh::v2::SmallStack<Bvh::Index, stack_size> stack;
+    m_bvh.intersect<true, use_robust_traversal>(
+        bvh_ray,
+        m_bvh.get_root().index,
+        stack,
+        [&] (const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) {
+                size_t j = should_permute ? i : m_bvh.prim_ids[i];
+                if (m_precomputed_triangles[j].intersect(bvh_ray)) {
+                    occluded = true;
+                    return true;
+                }
+            }
+            return false;
+        }
+    );
+    return occluded;
+}
+
+auto Bvh_geometry::get_bbox() const -> bvh::v2::BBox<float, 3>
+{
+    if (m_bvh.nodes.empty()) {
+        return BBox::make_empty();
+    }
+    return m_bvh.get_root().get_bbox();
+}
+
 /// auto Bvh_geometry::get_sphere() const -> const erhe::toolkit::Bounding_sphere&
 /// {
 ///     return m_bounding_sphere;
@@ -61,6 +61,8 @@ public:
 
     // Bvh_geometry public API
     auto intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance) -> bool;
+    auto occluded_instance (Ray& ray) -> bool;
+    [[nodiscard]] auto get_bbox() const -> bvh::v2::BBox<float, 3>;
     ////[[nodiscard]] auto get_sphere() const -> const erhe::toolkit::Bounding_sphere&;
 
     // Implements erhe::toolkit::Bounding_volume_source
@@ -1,5 +1,6 @@
 #include "erhe/raytrace/bvh/bvh_instance.hpp"
 #include "erhe/raytrace/bvh/bvh_scene.hpp"
+#include "erhe/raytrace/bvh/glm_conversions.hpp"
 #include "erhe/raytrace/iscene.hpp"
 #include "erhe/raytrace/ray.hpp"
 
@@ -51,12 +52,78 @@ auto Bvh_instance::is_enabled() const -> bool
 
 void Bvh_instance::set_transform(const glm::mat4 transform)
 {
-    m_transform = transform;
+    m_transform         = transform;
+    m_inverse_transform = glm::inverse(transform);
+    if (m_owner_scene != nullptr) {
+        m_owner_scene->instance_changed(this);
+    }
+}
+
+void Bvh_instance::set_owner_scene(Bvh_scene* owner_scene)
+{
+    m_owner_scene = owner_scene;
+}
+
+void Bvh_instance::set_tlas_index(const std::size_t tlas_index)
+{
+    m_tlas_index = tlas_index;
+}
+
+void Bvh_instance::set_change_pending(const bool change_pending)
+{
+    m_change_pending = change_pending;
+}
+
+auto Bvh_instance::is_change_pending() const -> bool
+{
+    return m_change_pending;
+}
+
+auto Bvh_instance::get_owner_scene() const -> Bvh_scene*
+{
+    return m_owner_scene;
+}
+
+auto Bvh_instance::get_tlas_index() const -> std::size_t
+{
+    return m_tlas_index;
+}
+
+auto Bvh_instance::get_world_bbox() const -> bvh::v2::BBox<float, 3>
+{
+    auto world_bbox = bvh::v2::BBox<float, 3>::make_empty();
+    if (m_scene == nullptr) {
+        return world_bbox;
+    }
+    const auto* bvh_scene  = reinterpret_cast<const Bvh_scene*>(m_scene);
+    const auto  local_bbox = bvh_scene->get_bbox();
+    const auto  a          = from_bvh(local_bbox.min);
+    const auto  b          = from_bvh(local_bbox.max);
+    if ((a.x > b.x) || (a.y > b.y) || (a.z > b.z)) {
+        return world_bbox;
+    }
+    const glm::vec3 corners[8] = {
+        glm::vec3{a.x, a.y, a.z},
+        glm::vec3{a.x, a.y, b.z},
+        glm::vec3{a.x, b.y, a.z},
+        glm::vec3{a.x, b.y, b.z},
+        glm::vec3{b.x, a.y, a.z},
+        glm::vec3{b.x, a.y, b.z},
+        glm::vec3{b.x, b.y, a.z},
+        glm::vec3{b.x, b.y, b.z}
+    };
+    for (const auto& corner : corners) {
+        world_bbox.extend(to_bvh(glm::vec3{m_transform * glm::vec4{corner, 1.0f}}));
+    }
+    return world_bbox;
 }
 
 void Bvh_instance::set_scene(IScene* scene)
 {
     m_scene = scene;
+    if (m_owner_scene != nullptr) {
+        m_owner_scene->instance_scene_changed(this);
+    }
 }
 
 void Bvh_instance::set_mask(const uint32_t mask)
@@ -78,26 +145,27 @@ void Bvh_instance::intersect(Ray& ray, Hit& hit)
         return;
     }
 
-    const auto transform         = get_transform();
-    const auto inverse_transform = glm::inverse(transform);
-    Ray        local_ray         = ray.transform(inverse_transform);
-    auto*      instance_scene    = get_scene();
-    auto*      bvh_scene         = reinterpret_cast<Bvh_scene*>(instance_scene);
+    Ray   local_ray      = ray.transform(m_inverse_transform);
+    auto* instance_scene = get_scene();
+    auto* bvh_scene      = reinterpret_cast<Bvh_scene*>(instance_scene);
     bvh_scene->intersect_instance(local_ray, hit, this);
     ray.t_far = local_ray.t_far;
 }
 
-#if 0
-void Bvh_instance::collect_spheres(
-    std::vector<bvh::Sphere<float>>& spheres,
-    std::vector<Bvh_instance*>&      instances
-)
+auto Bvh_instance::occluded(Ray& ray) -> bool
 {
+    if (!m_enabled) {
+        return false;
+    }
+    if ((ray.mask & m_mask) == 0) {
+        return false;
+    }
+
+    Ray   local_ray      = ray.transform(m_inverse_transform);
     auto* instance_scene = get_scene();
     auto* bvh_scene      = reinterpret_cast<Bvh_scene*>(instance_scene);
-    bvh_scene->collect_spheres(spheres, instances, this);
+    return bvh_scene->occluded_instance(local_ray, this);
 }
-#endif
 
 auto Bvh_instance::get_transform() const -> glm::mat4
 {
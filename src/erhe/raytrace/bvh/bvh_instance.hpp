@@ -4,6 +4,8 @@
 
 #include <glm/glm.hpp>
 
+#include <bvh/v2/bbox.h>
+
 #include <string>
 #include <vector>
 
@@ -35,14 +37,26 @@ public:
     [[nodiscard]] auto debug_label  () const -> std::string_view override;
 
     // Bvh_instance public API
-    void intersect(Ray& ray, Hit& hit);
+    void intersect      (Ray& ray, Hit& hit);
+    auto occluded       (Ray& ray) -> bool;
+    void set_owner_scene(Bvh_scene* owner_scene);
+    void set_tlas_index (std::size_t tlas_index);
+    void set_change_pending(bool change_pending);
+    [[nodiscard]] auto is_change_pending() const -> bool;
+    [[nodiscard]] auto get_owner_scene() const -> Bvh_scene*;
+    [[nodiscard]] auto get_tlas_index () const -> std::size_t;
+    [[nodiscard]] auto get_world_bbox () const -> bvh::v2::BBox<float, 3>;
 
 private:
-    glm::mat4   m_transform{1.0f};
-    bool        m_enabled  {true};
-    IScene*     m_scene    {nullptr};
-    uint32_t    m_mask     {0xffffffffu};
-    void*       m_user_data{nullptr};
+    glm::mat4   m_transform        {1.0f};
+    glm::mat4   m_inverse_transform{1.0f};
+    bool        m_enabled          {true};
+    IScene*     m_scene            {nullptr};
+    Bvh_scene*  m_owner_scene      {nullptr}; // Scene where this instance is attached to
+    std::size_t m_tlas_index       {0};       // Index in owner scene top level acceleration structure
+    bool        m_change_pending   {false};   // In owner scene list of changed instances
+    uint32_t    m_mask             {0xffffffffu};
+    void*       m_user_data        {nullptr};
     std::string m_debug_label;
 };
 
@@ -7,12 +7,20 @@
 #include "erhe/raytrace/bvh/bvh_scene.hpp"
 #include "erhe/raytrace/bvh/bvh_geometry.hpp"
 #include "erhe/raytrace/bvh/bvh_instance.hpp"
+#include "erhe/raytrace/bvh/bvh_thread_pool.hpp"
 #include "erhe/raytrace/bvh/glm_conversions.hpp"
 #include "erhe/raytrace/iinstance.hpp"
 #include "erhe/raytrace/raytrace_log.hpp"
 #include "erhe/raytrace/ray.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
 
 #include <bvh/v2/default_builder.h>
+#include <bvh/v2/ray.h>
+#include <bvh/v2/stack.h>
+
+#include <algorithm>
+#include <limits>
 
 namespace erhe::raytrace
 {
@@ -38,7 +46,15 @@ Bvh_scene::Bvh_scene(const std::string_view debug_label)
 {
 }
 
-Bvh_scene::~Bvh_scene() noexcept = default;
+Bvh_scene::~Bvh_scene() noexcept
+{
+    for (const auto& instance : m_instances) {
+        if (instance->get_owner_scene() == this) {
+            instance->set_owner_scene(nullptr);
+            instance->set_change_pending(false);
+        }
+    }
+}
 
 void Bvh_scene::attach(IGeometry* geometry)
 {
@@ -52,6 +68,7 @@ void Bvh_scene::attach(IGeometry* geometry)
 #endif
     {
         m_geometries.push_back(bvh_geometry);
+        m_rebuild_needed = true;
     }
 }
 
@@ -67,6 +84,8 @@ void Bvh_scene::attach(IInstance* instance)
 #endif
     {
         m_instances.push_back(bvh_instance);
+        bvh_instance->set_owner_scene(this);
+        m_rebuild_needed = true;
     }
 }
 
@@ -79,6 +98,7 @@ void Bvh_scene::detach(IGeometry* geometry)
         log_scene->error("raytrace geometry not in scene");
     } else {
         m_geometries.erase(i, m_geometries.end());
+        m_rebuild_needed = true;
     }
 }
 
@@ -91,46 +111,331 @@ void Bvh_scene::detach(IInstance* instance)
         log_scene->error("raytrace instance not in scene");
     } else {
         m_instances.erase(i, m_instances.end());
+        if (bvh_instance->is_change_pending()) {
+            m_changed_instances.erase(
+                std::remove(m_changed_instances.begin(), m_changed_instances.end(), bvh_instance),
+                m_changed_instances.end()
+            );
+            bvh_instance->set_change_pending(false);
+        }
+        if (bvh_instance->get_owner_scene() == this) {
+            bvh_instance->set_owner_scene(nullptr);
+        }
+        m_rebuild_needed = true;
     }
 }
 
-void Bvh_scene::commit()
+void Bvh_scene::instance_changed(Bvh_instance* instance)
+{
+    if (m_rebuild_needed || instance->is_change_pending()) {
+        return;
+    }
+    instance->set_change_pending(true);
+    m_changed_instances.push_back(instance);
+}
+
+void Bvh_scene::instance_scene_changed(Bvh_instance* instance)
+{
+    static_cast<void>(instance);
+
+    // Instance bounds may change arbitrarily, refit would degrade the TLAS
+    m_rebuild_needed = true;
+}
+
+void Bvh_scene::clear_changed_instances()
+{
+    for (const auto& instance : m_changed_instances) {
+        instance->set_change_pending(false);
+    }
+    m_changed_instances.clear();
+}
+
+auto Bvh_scene::get_bbox() const -> bvh::v2::BBox<float, 3>
+{
+    auto bbox = bvh::v2::BBox<float, 3>::make_empty();
+    for (const auto& geometry : m_geometries) {
+        bbox.extend(geometry->get_bbox());
+    }
+    for (const auto& instance : m_instances) {
+        bbox.extend(instance->get_world_bbox());
+    }
+    return bbox;
+}
+
+void Bvh_scene::update_primitive_bbox(const std::size_t primitive_index)
 {
-    // WIP - not really used
-#if 0
-    m_collected_spheres.clear();
-    m_collected_instances.clear();
+    const Tlas_primitive& primitive = m_tlas_primitives[primitive_index];
+    m_tlas_bboxes[primitive_index] = (primitive.instance != nullptr)
+        ? primitive.instance->get_world_bbox()
+        : primitive.geometry->get_bbox();
+}
+
+void Bvh_scene::build_tlas()
+{
+    ERHE_PROFILE_FUNCTION
 
-    collect_spheres(m_collected_spheres, m_collected_instances, nullptr);
+    m_tlas_primitives.clear();
+    m_tlas_primitives.reserve(m_instances.size() + m_geometries.size());
+    for (const auto& instance : m_instances) {
+        instance->set_tlas_index(m_tlas_primitives.size());
+        m_tlas_primitives.push_back(Tlas_primitive{.instance = instance, .geometry = nullptr});
+    }
+    for (const auto& geometry : m_geometries) {
+        m_tlas_primitives.push_back(Tlas_primitive{.instance = nullptr, .geometry = geometry});
+    }
 
-    const auto [bboxes, centers] = bvh::compute_bounding_boxes_and_centers<bvh::Sphere<float>>(
-        m_collected_spheres.data(),
-        m_collected_spheres.size()
+    const std::size_t primitive_count = m_tlas_primitives.size();
+    m_tlas_bboxes.resize(primitive_count);
+    std::vector<bvh::v2::Vec<float, 3>> centers(primitive_count);
+    m_global_bbox = bvh::v2::BBox<float, 3>::make_empty();
+    for (std::size_t i = 0; i < primitive_count; ++i) {
+        update_primitive_bbox(i);
+        centers[i] = m_tlas_bboxes[i].get_center();
+        m_global_bbox.extend(m_tlas_bboxes[i]);
+    }
+
+    clear_changed_instances();
+    m_rebuild_needed = false;
+
+    if (primitive_count == 0) {
+        m_bvh = bvh::v2::Bvh<bvh::v2::Node<float, 3>>{};
+        return;
+    }
+
+    // Instance count is small compared to triangle counts in
+    // Bvh_geometry, so the single threaded builder is used here.
+    typename bvh::v2::DefaultBuilder<bvh::v2::Node<float, 3>>::Config config;
+    config.quality = bvh::v2::DefaultBuilder<bvh::v2::Node<float, 3>>::Quality::Low;
+    m_bvh = bvh::v2::DefaultBuilder<bvh::v2::Node<float, 3>>::build(m_tlas_bboxes, centers, config);
+}
+
+void Bvh_scene::refit_tlas()
+{
+    ERHE_PROFILE_FUNCTION
+
+    for (const auto& instance : m_changed_instances) {
+        const std::size_t primitive_index = instance->get_tlas_index();
+        if (
+            (primitive_index >= m_tlas_primitives.size()) ||
+            (m_tlas_primitives[primitive_index].instance != instance)
+        ) {
+            continue;
+        }
+        update_primitive_bbox(primitive_index);
+    }
+    clear_changed_instances();
+
+    if (m_bvh.nodes.empty()) {
+        return;
+    }
+
+    m_bvh.refit(
+        [this](bvh::v2::Node<float, 3>& leaf)
+        {
+            auto bbox = bvh::v2::BBox<float, 3>::make_empty();
+            const std::size_t begin = leaf.index.first_id();
+            const std::size_t end   = begin + leaf.index.prim_count();
+            for (std::size_t i = begin; i < end; ++i) {
+                bbox.extend(m_tlas_bboxes[m_bvh.prim_ids[i]]);
+            }
+            leaf.set_bbox(bbox);
+        }
     );
-    const auto global_bbox = bvh::compute_bounding_boxes_union<float>(
-        bboxes.get(),
-        m_collected_spheres.size()
+    m_global_bbox = m_bvh.get_root().get_bbox();
+}
+
+void Bvh_scene::commit()
+{
+    if (m_rebuild_needed) {
+        build_tlas();
+    } else if (!m_changed_instances.empty()) {
+        refit_tlas();
+    }
+}
+
+void Bvh_scene::intersect(Ray& ray, Hit& hit)
+{
+    ERHE_PROFILE_FUNCTION
+
+    // Pick up attach / detach / transform changes that were
+    // made after the latest explicit commit().
+    commit();
+
+    intersect_tlas(ray, hit);
+}
+
+namespace {
+
+// Rays are processed in small packets. Each worker walks its packets
+// ray by ray, which keeps TLAS and BLAS nodes hot in cache for rays
+// that are next to each other in the input (coherent rays).
+constexpr std::size_t ray_packet_size = 16;
+
+// Below this many rays the batch is processed on the calling thread
+constexpr std::size_t parallel_ray_threshold = 4 * ray_packet_size;
+
+template <typename Fn>
+void for_each_ray_packet(const std::size_t ray_count, Fn&& fn)
+{
+    const std::size_t packet_count = (ray_count + ray_packet_size - 1) / ray_packet_size;
+    const auto packet_range = [&](const std::size_t begin_packet, const std::size_t end_packet)
+    {
+        for (std::size_t packet = begin_packet; packet < end_packet; ++packet) {
+            const std::size_t begin = packet * ray_packet_size;
+            const std::size_t end   = std::min(begin + ray_packet_size, ray_count);
+            for (std::size_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+        }
+    };
+
+    if (ray_count < parallel_ray_threshold) {
+        packet_range(0, packet_count);
+        return;
+    }
+
+    bvh::v2::ParallelExecutor executor{get_bvh_thread_pool(), 1};
+    executor.for_each(0, packet_count, packet_range);
+}
+
+}
+
+void Bvh_scene::intersect(gsl::span<Ray> rays, gsl::span<Hit> hits)
+{
+    ERHE_PROFILE_FUNCTION
+
+    ERHE_VERIFY(rays.size() == hits.size());
+
+    commit();
+
+    if (m_bvh.nodes.empty()) {
+        return;
+    }
+
+    for_each_ray_packet(
+        rays.size(),
+        [this, rays, hits](const std::size_t i)
+        {
+            intersect_tlas(rays[i], hits[i]);
+        }
     );
+}
+
+auto Bvh_scene::occluded(Ray& ray) -> bool
+{
+    ERHE_PROFILE_FUNCTION
 
-    // Create an acceleration data structure on the primitives
-    bvh::SweepSahBuilder<bvh::Bvh<float>> builder{m_bvh};
-    builder.build(
-        global_bbox,
-        bboxes.get(),
-        centers.get(),
-        m_collected_spheres.size()
+    commit();
+
+    if (occluded_tlas(ray)) {
+        ray.t_far = -std::numeric_limits<float>::infinity();
+        return true;
+    }
+    return false;
+}
+
+void Bvh_scene::occluded(gsl::span<Ray> rays)
+{
+    ERHE_PROFILE_FUNCTION
+
+    commit();
+
+    if (m_bvh.nodes.empty()) {
+        return;
+    }
+
+    for_each_ray_packet(
+        rays.size(),
+        [this, rays](const std::size_t i)
+        {
+            if (occluded_tlas(rays[i])) {
+                rays[i].t_far = -std::numeric_limits<float>::infinity();
+            }
+        }
     );
-#endif
 }
 
-void Bvh_scene::intersect(Ray& ray, Hit& hit)
+auto Bvh_scene::occluded_tlas(Ray& ray) -> bool
 {
-    for (const auto& instance : m_instances) {
-        instance->intersect(ray, hit);
+    if (m_bvh.nodes.empty()) {
+        return false;
     }
-    for (const auto& geometry : m_geometries) {
-        geometry->intersect_instance(ray, hit, nullptr);
+
+    bvh::v2::Ray<float, 3> bvh_ray{
+        to_bvh(ray.origin),
+        to_bvh(ray.direction),
+        ray.t_near,
+        ray.t_far
+    };
+
+    static constexpr std::size_t stack_size           = 64;
+    static constexpr bool        use_robust_traversal = false;
+
+    bool occluded = false;
+    bvh::v2::SmallStack<bvh::v2::Bvh<bvh::v2::Node<float, 3>>::Index, stack_size> stack;
+    m_bvh.intersect<true, use_robust_traversal>(
+        bvh_ray,
+        m_bvh.get_root().index,
+        stack,
+        [&] (const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i) {
+                const Tlas_primitive& primitive = m_tlas_primitives[m_bvh.prim_ids[i]];
+                occluded = (primitive.instance != nullptr)
+                    ? primitive.instance->occluded(ray)
+                    : primitive.geometry->occluded_instance(ray);
+                if (occluded) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    );
+    return occluded;
+}
+
+void Bvh_scene::intersect_tlas(Ray& ray, Hit& hit)
+{
+    if (m_bvh.nodes.empty()) {
+        return;
     }
+
+    bvh::v2::Ray<float, 3> bvh_ray{
+        to_bvh(ray.origin),
+        to_bvh(ray.direction),
+        ray.t_near,
+        ray.t_far
+    };
+
+    static constexpr std::size_t stack_size           = 64;
+    static constexpr bool        use_robust_traversal = false;
+
+    bvh::v2::SmallStack<bvh::v2::Bvh<bvh::v2::Node<float, 3>>::Index, stack_size> stack;
+    m_bvh.intersect<false, use_robust_traversal>(
+        bvh_ray,
+        m_bvh.get_root().index,
+        stack,
+        [&] (const std::size_t begin, const std::size_t end)
+        {
+            bool any_hit = false;
+            for (std::size_t i = begin; i < end; ++i) {
+                const Tlas_primitive& primitive = m_tlas_primitives[m_bvh.prim_ids[i]];
+                const float t_far_before = ray.t_far;
+                if (primitive.instance != nullptr) {
+                    primitive.instance->intersect(ray, hit);
+                } else {
+                    primitive.geometry->intersect_instance(ray, hit, nullptr);
+                }
+                if (ray.t_far < t_far_before) {
+                    // Shrink the traversal ray so that TLAS nodes
+                    // behind the closest hit so far get culled.
+                    bvh_ray.tmax = ray.t_far;
+                    any_hit = true;
+                }
+            }
+            return any_hit;
+        }
+    );
 }
 
 void Bvh_scene::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* in_instance)
@@ -146,32 +451,23 @@ void Bvh_scene::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* in_instance
     }
 }
 
-// WIP - not ready / used
-#if 0
-void Bvh_scene::collect_spheres(
-    std::vector<bvh::Sphere<float>>& spheres,
-    std::vector<Bvh_instance*>&      instances,
-    Bvh_instance*                    in_instance
-)
+auto Bvh_scene::occluded_instance(Ray& ray, Bvh_instance* in_instance) -> bool
 {
     if (in_instance == nullptr) {
         for (const auto& instance : m_instances) {
-            instance->collect_spheres(spheres, instances);
+            if (instance->occluded(ray)) {
+                return true;
+            }
         }
     } else {
-        const auto transform = in_instance->get_transform();
         for (const auto& geometry : m_geometries) {
-            const auto& geometry_sphere = geometry->get_sphere();
-            const auto  origin          = glm::vec3{transform * glm::vec4{geometry_sphere.center, 1.0f}};
-            spheres.emplace_back(
-                to_bvh(origin),
-                geometry_sphere.radius
-            );
-            instances.emplace_back(in_instance);
+            if (geometry->occluded_instance(ray)) {
+                return true;
+            }
         }
     }
+    return false;
 }
-#endif
 
 auto Bvh_scene::debug_label() const -> std::string_view
 {
@@ -9,7 +9,6 @@
 #include "erhe/raytrace/iscene.hpp"
 
 #include <bvh/v2/bvh.h>
-#include <bvh/v2/sphere.h>
 
 #include <string>
 #include <vector>
@@ -35,27 +34,51 @@ public:
     void detach   (IInstance* geometry) override;
     void commit   () override;
     void intersect(Ray& ray, Hit& hit) override;
+    void intersect(gsl::span<Ray> rays, gsl::span<Hit> hits) override;
+    auto occluded (Ray& ray) -> bool override;
+    void occluded (gsl::span<Ray> rays) override;
     [[nodiscard]] auto debug_label() const -> std::string_view override;
 
     // Bvh_scene public API
     void intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance);
-    //// void collect_spheres   (
-    ////     std::vector<bvh::Sphere<float>>& spheres,
-    ////     std::vector<Bvh_instance*>&      instances,
-    ////     Bvh_instance*                    instance
-    //// );
+    auto occluded_instance (Ray& ray, Bvh_instance* instance) -> bool;
+    void instance_changed      (Bvh_instance* instance);
+    void instance_scene_changed(Bvh_instance* instance);
+
+    // Returns bounding box of everything in this scene, in scene space
+    [[nodiscard]] auto get_bbox() const -> bvh::v2::BBox<float, 3>;
 
 private:
+    // Top level acceleration structure (TLAS) primitive. Either
+    // an instance, or geometry attached directly to the scene.
+    class Tlas_primitive
+    {
+    public:
+        Bvh_instance* instance{nullptr};
+        Bvh_geometry* geometry{nullptr};
+    };
+
+    void clear_changed_instances();
+    void build_tlas           ();
+    void refit_tlas           ();
+    void update_primitive_bbox(std::size_t primitive_index);
+
+    // These require up to date TLAS, and are safe to call from multiple threads
+    void intersect_tlas       (Ray& ray, Hit& hit);
+    auto occluded_tlas        (Ray& ray) -> bool;
+
     std::vector<Bvh_geometry*> m_geometries;
     std::vector<Bvh_instance*> m_instances;
     std::string                m_debug_label;
 
-    //// std::vector<bvh::Sphere<float>> m_collected_spheres;   // flat
-    std::vector<Bvh_instance*>   m_collected_instances; // flat
-    bvh::v2::BBox<float, 3>      m_global_bbox;
+    bool                                 m_rebuild_needed{true};
+    std::vector<Bvh_instance*>           m_changed_instances;
+    std::vector<Tlas_primitive>          m_tlas_primitives;
+    std::vector<bvh::v2::BBox<float, 3>> m_tlas_bboxes;
+    bvh::v2::BBox<float, 3>              m_global_bbox;
     bvh::v2::Bvh<
          bvh::v2::Node<float, 3>
-    >                            m_bvh;
+    >                                    m_bvh;
 };
 
 }
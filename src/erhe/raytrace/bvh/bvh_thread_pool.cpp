@@ -0,0 +1,12 @@
+#include "erhe/raytrace/bvh/bvh_thread_pool.hpp"
+
+namespace erhe::raytrace
+{
+
+auto get_bvh_thread_pool() -> bvh::v2::ThreadPool&
+{
+    static bvh::v2::ThreadPool thread_pool;
+    return thread_pool;
+}
+
+}
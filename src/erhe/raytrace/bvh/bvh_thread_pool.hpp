@@ -0,0 +1,12 @@
+#pragma once
+
+#include <bvh/v2/executor.h>
+#include <bvh/v2/thread_pool.h>
+
+namespace erhe::raytrace
+{
+
+// Thread pool shared by Bvh_geometry BVH builds and Bvh_scene batched queries
+[[nodiscard]] auto get_bvh_thread_pool() -> bvh::v2::ThreadPool&;
+
+}
@@ -5,6 +5,9 @@
 #include "erhe/raytrace/log.hpp"
 #include "erhe/raytrace/ray.hpp"
 #include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
 
 namespace erhe::raytrace
 {
@@ -220,12 +223,21 @@ void Embree_scene::intersect(Ray& ray, Hit& hit)
     hit.normal       = glm::vec3{ray_hit.hit.Ng_x, ray_hit.hit.Ng_y, ray_hit.hit.Ng_z};
     hit.uv           = glm::vec2{ray_hit.hit.u, ray_hit.hit.v};
     hit.primitive_id = ray_hit.hit.primID;
-    hit.geometry     = nullptr;
-    hit.instance     = nullptr;
+    resolve_hit(ray_hit.hit.geomID, ray_hit.hit.instID[0], hit);
+}
+
+void Embree_scene::resolve_hit(
+    const unsigned int geometry_id,
+    const unsigned int instance_id,
+    Hit&               hit
+)
+{
+    hit.geometry = nullptr;
+    hit.instance = nullptr;
 
-    if (ray_hit.hit.instID[0] != RTC_INVALID_GEOMETRY_ID)
+    if (instance_id != RTC_INVALID_GEOMETRY_ID)
     {
-        const auto instance_geometry = rtcGetGeometry(m_scene, ray_hit.hit.instID[0]);
+        const auto instance_geometry = rtcGetGeometry(m_scene, instance_id);
         if (instance_geometry != nullptr)
         {
             void* user_data       = rtcGetGeometryUserData(instance_geometry);
@@ -236,19 +248,148 @@ void Embree_scene::intersect(Ray& ray, Hit& hit)
                 auto* embree_instance_scene = embree_instance->get_embree_scene();
                 if (embree_instance_scene != nullptr)
                 {
-                    hit.geometry = embree_instance_scene->get_geometry_from_id(ray_hit.hit.geomID);
+                    hit.geometry = embree_instance_scene->get_geometry_from_id(geometry_id);
                 }
             }
         }
     }
     else
     {
-        hit.geometry = (ray_hit.hit.geomID != RTC_INVALID_GEOMETRY_ID)
-            ? get_geometry_from_id(ray_hit.hit.geomID)
+        hit.geometry = (geometry_id != RTC_INVALID_GEOMETRY_ID)
+            ? get_geometry_from_id(geometry_id)
             : nullptr;
     }
 }
 
+namespace {
+
+constexpr std::size_t packet_size = 16;
+
+void set_packet_ray(RTCRay16& packet, const std::size_t lane, const Ray& ray)
+{
+    packet.org_x[lane] = ray.origin.x;
+    packet.org_y[lane] = ray.origin.y;
+    packet.org_z[lane] = ray.origin.z;
+    packet.tnear[lane] = ray.t_near;
+    packet.dir_x[lane] = ray.direction.x;
+    packet.dir_y[lane] = ray.direction.y;
+    packet.dir_z[lane] = ray.direction.z;
+    packet.time [lane] = ray.time;
+    packet.tfar [lane] = ray.t_far;
+    packet.mask [lane] = ray.mask;
+    packet.id   [lane] = ray.id;
+    packet.flags[lane] = 0;
+}
+
+}
+
+void Embree_scene::intersect(gsl::span<Ray> rays, gsl::span<Hit> hits)
+{
+    ERHE_PROFILE_FUNCTION
+
+    ERHE_VERIFY(rays.size() == hits.size());
+
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    for (std::size_t begin = 0; begin < rays.size(); begin += packet_size)
+    {
+        const std::size_t count = std::min(packet_size, rays.size() - begin);
+
+        alignas(64) int valid[packet_size];
+        RTCRayHit16 ray_hit;
+        for (std::size_t lane = 0; lane < packet_size; ++lane)
+        {
+            valid[lane] = (lane < count) ? -1 : 0;
+            if (lane >= count)
+            {
+                continue;
+            }
+            set_packet_ray(ray_hit.ray, lane, rays[begin + lane]);
+            ray_hit.hit.geomID   [lane] = RTC_INVALID_GEOMETRY_ID;
+            ray_hit.hit.instID[0][lane] = RTC_INVALID_GEOMETRY_ID;
+        }
+
+        SPDLOG_LOGGER_TRACE(log_embree, "rtcIntersect16({}, {} rays)", m_debug_label, count);
+        rtcIntersect16(valid, m_scene, &context, &ray_hit);
+
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            Ray& ray = rays[begin + lane];
+            Hit& hit = hits[begin + lane];
+            ray.t_far = ray_hit.ray.tfar[lane];
+            if (ray_hit.hit.geomID[lane] == RTC_INVALID_GEOMETRY_ID)
+            {
+                continue;
+            }
+            hit.normal       = glm::vec3{ray_hit.hit.Ng_x[lane], ray_hit.hit.Ng_y[lane], ray_hit.hit.Ng_z[lane]};
+            hit.uv           = glm::vec2{ray_hit.hit.u[lane], ray_hit.hit.v[lane]};
+            hit.primitive_id = ray_hit.hit.primID[lane];
+            resolve_hit(ray_hit.hit.geomID[lane], ray_hit.hit.instID[0][lane], hit);
+        }
+    }
+}
+
+auto Embree_scene::occluded(Ray& ray) -> bool
+{
+    ERHE_PROFILE_FUNCTION
+
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    RTCRay rtc_ray{
+        .org_x = ray.origin.x,
+        .org_y = ray.origin.y,
+        .org_z = ray.origin.z,
+        .tnear = ray.t_near,
+        .dir_x = ray.direction.x,
+        .dir_y = ray.direction.y,
+        .dir_z = ray.direction.z,
+        .time  = ray.time,
+        .tfar  = ray.t_far,
+        .mask  = ray.mask,
+        .id    = ray.id,
+        .flags = 0
+    };
+    SPDLOG_LOGGER_TRACE(log_embree, "rtcOccluded1({})", m_debug_label);
+    rtcOccluded1(m_scene, &context, &rtc_ray);
+    ray.t_far = rtc_ray.tfar;
+    return ray.is_occluded();
+}
+
+void Embree_scene::occluded(gsl::span<Ray> rays)
+{
+    ERHE_PROFILE_FUNCTION
+
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    for (std::size_t begin = 0; begin < rays.size(); begin += packet_size)
+    {
+        const std::size_t count = std::min(packet_size, rays.size() - begin);
+
+        alignas(64) int valid[packet_size];
+        RTCRay16 packet;
+        for (std::size_t lane = 0; lane < packet_size; ++lane)
+        {
+            valid[lane] = (lane < count) ? -1 : 0;
+            if (lane < count)
+            {
+                set_packet_ray(packet, lane, rays[begin + lane]);
+            }
+        }
+
+        SPDLOG_LOGGER_TRACE(log_embree, "rtcOccluded16({}, {} rays)", m_debug_label, count);
+        rtcOccluded16(valid, m_scene, &context, &packet);
+
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            rays[begin + lane].t_far = packet.tfar[lane];
+        }
+    }
+}
+
 //void Embree_scene::set_dirty()
 //{
 //    m_dirty = true;
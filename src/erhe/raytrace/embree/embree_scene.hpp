@@ -47,12 +47,17 @@ public:
     // rtcGetSceneLinearBounds()
 
     void intersect(Ray& ray, Hit& out_hit) override;
+    void intersect(gsl::span<Ray> rays, gsl::span<Hit> hits) override; // rtcIntersect16()
+    auto occluded (Ray& ray) -> bool override;                          // rtcOccluded1()
+    void occluded (gsl::span<Ray> rays) override;                       // rtcOccluded16()
 
     //void set_dirty();
     auto get_rtc_scene() -> RTCScene;
     auto get_geometry_from_id(const unsigned int id) -> Embree_geometry*;
 
 private:
+    void resolve_hit(unsigned int geometry_id, unsigned int instance_id, Hit& hit);
+
     RTCScene    m_scene{nullptr};
     std::string m_debug_label;
     //bool        m_dirty{true};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <gsl/span>
 
 #include <memory>
 #include <string_view>
@@ -24,6 +25,15 @@ public:
     virtual void detach   (IInstance* instance) = 0;
     virtual void commit   () = 0;
     virtual void intersect(Ray& ray, Hit& hit) = 0;
+
+    // Batched closest hit queries. rays and hits must have the same size.
+    virtual void intersect(gsl::span<Ray> rays, gsl::span<Hit> hits) = 0;
+
+    // Occlusion (any hit) queries. Like in Embree, t_far of each
+    // occluded ray is set to -infinity, other rays are unmodified.
+    virtual auto occluded (Ray& ray) -> bool = 0;
+    virtual void occluded (gsl::span<Ray> rays) = 0;
+
     [[nodiscard]] virtual auto debug_label() const -> std::string_view = 0;
 
     [[nodiscard]] static auto create       (const std::string_view debug_label) -> IScene*;
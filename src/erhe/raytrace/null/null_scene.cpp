@@ -96,6 +96,19 @@ void Null_scene::intersect(Ray&, Hit&)
 {
 }
 
+void Null_scene::intersect(gsl::span<Ray>, gsl::span<Hit>)
+{
+}
+
+auto Null_scene::occluded(Ray&) -> bool
+{
+    return false;
+}
+
+void Null_scene::occluded(gsl::span<Ray>)
+{
+}
+
 auto Null_scene::debug_label() const -> std::string_view
 {
     return m_debug_label;
@@ -24,6 +24,9 @@ public:
     void detach   (IInstance* geometry) override;
     void commit   ()           override;
     void intersect(Ray&, Hit&) override;
+    void intersect(gsl::span<Ray>, gsl::span<Hit>) override;
+    auto occluded (Ray&) -> bool override;
+    void occluded (gsl::span<Ray>) override;
     [[nodiscard]] auto debug_label() const -> std::string_view override;
 
 private:
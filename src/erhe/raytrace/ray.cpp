@@ -1,5 +1,7 @@
 #include "erhe/raytrace/ray.hpp"
 
+#include <limits>
+
 namespace erhe::raytrace
 {
 
@@ -19,4 +21,9 @@ auto Ray::transform(
     };
 }
 
+auto Ray::is_occluded() const -> bool
+{
+    return t_far == -std::numeric_limits<float>::infinity();
+}
+
 } // namespace
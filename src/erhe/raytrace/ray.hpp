@@ -13,7 +13,8 @@ class IInstance;
 class Ray
 {
 public:
-    auto transform(const glm::mat4& matrix) const -> Ray;
+    auto transform  (const glm::mat4& matrix) const -> Ray;
+    auto is_occluded() const -> bool;
 
     glm::vec3 origin   {0.0f};
     float     t_near   {0.0f};
@@ -0,0 +1,171 @@
+#include "erhe/replication/message_stream.hpp"
+
+#include <cstring>
+
+namespace erhe::replication
+{
+
+namespace {
+
+[[nodiscard]] auto zigzag_encode(const int64_t value) -> uint64_t
+{
+    return (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63);
+}
+
+[[nodiscard]] auto zigzag_decode(const uint64_t value) -> int64_t
+{
+    return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+}
+
+} // anonymous namespace
+
+void Message_writer::clear()
+{
+    m_bytes.clear();
+}
+
+void Message_writer::reserve(const std::size_t byte_count)
+{
+    m_bytes.reserve(byte_count);
+}
+
+void Message_writer::write_u8(const uint8_t value)
+{
+    m_bytes.push_back(value);
+}
+
+void Message_writer::write_u32(const uint32_t value)
+{
+    for (unsigned int i = 0; i < 4; ++i) {
+        m_bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+    }
+}
+
+void Message_writer::write_u64(const uint64_t value)
+{
+    for (unsigned int i = 0; i < 8; ++i) {
+        m_bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+    }
+}
+
+void Message_writer::write_f32(const float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(uint32_t));
+    write_u32(bits);
+}
+
+void Message_writer::write_varuint(uint64_t value)
+{
+    while (value >= 0x80u) {
+        m_bytes.push_back(static_cast<uint8_t>(value | 0x80u));
+        value >>= 7u;
+    }
+    m_bytes.push_back(static_cast<uint8_t>(value));
+}
+
+void Message_writer::write_varint(const int64_t value)
+{
+    write_varuint(zigzag_encode(value));
+}
+
+void Message_writer::write_string(const std::string_view value)
+{
+    write_varuint(value.size());
+    m_bytes.insert(m_bytes.end(), value.begin(), value.end());
+}
+
+void Message_writer::write_bytes(const uint8_t* const data, const std::size_t byte_count)
+{
+    m_bytes.insert(m_bytes.end(), data, data + byte_count);
+}
+
+Message_reader::Message_reader(const uint8_t* const data, const std::size_t length)
+    : m_data  {data}
+    , m_length{length}
+{
+}
+
+auto Message_reader::can_read(const std::size_t byte_count) -> bool
+{
+    if (!m_ok || (m_length - m_offset < byte_count)) {
+        m_ok = false;
+        return false;
+    }
+    return true;
+}
+
+auto Message_reader::read_u8() -> uint8_t
+{
+    if (!can_read(1)) {
+        return 0;
+    }
+    return m_data[m_offset++];
+}
+
+auto Message_reader::read_u32() -> uint32_t
+{
+    if (!can_read(4)) {
+        return 0;
+    }
+    uint32_t value{0};
+    for (unsigned int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(m_data[m_offset++]) << (8u * i);
+    }
+    return value;
+}
+
+auto Message_reader::read_u64() -> uint64_t
+{
+    if (!can_read(8)) {
+        return 0;
+    }
+    uint64_t value{0};
+    for (unsigned int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(m_data[m_offset++]) << (8u * i);
+    }
+    return value;
+}
+
+auto Message_reader::read_f32() -> float
+{
+    const uint32_t bits = read_u32();
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+auto Message_reader::read_varuint() -> uint64_t
+{
+    uint64_t value{0};
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        if (!can_read(1)) {
+            return 0;
+        }
+        const uint8_t byte = m_data[m_offset++];
+        value |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+        if ((byte & 0x80u) == 0) {
+            return value;
+        }
+    }
+    m_ok = false; // too long
+    return 0;
+}
+
+auto Message_reader::read_varint() -> int64_t
+{
+    return zigzag_decode(read_varuint());
+}
+
+auto Message_reader::read_string() -> std::string
+{
+    const uint64_t length = read_varuint();
+    if (!can_read(static_cast<std::size_t>(length))) {
+        return {};
+    }
+    std::string value{reinterpret_cast<const char*>(m_data + m_offset), static_cast<std::size_t>(length)};
+    m_offset += static_cast<std::size_t>(length);
+    return value;
+}
+
+} // namespace erhe::replication
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace erhe::replication
+{
+
+// Little-endian binary message writer. Variable length integers use
+// LEB128 (7 bits per byte), signed values are zigzag encoded first so
+// that small deltas of either sign take a single byte.
+class Message_writer
+{
+public:
+    void clear  ();
+    void reserve(std::size_t byte_count);
+
+    void write_u8     (uint8_t value);
+    void write_u32    (uint32_t value);
+    void write_u64    (uint64_t value);
+    void write_f32    (float value);
+    void write_varuint(uint64_t value);
+    void write_varint (int64_t value);
+    void write_string (std::string_view value);
+    void write_bytes  (const uint8_t* data, std::size_t byte_count);
+
+    [[nodiscard]] auto data() const -> const uint8_t*              { return m_bytes.data(); }
+    [[nodiscard]] auto size() const -> std::size_t                 { return m_bytes.size(); }
+    [[nodiscard]] auto get_bytes() const -> const std::vector<uint8_t>& { return m_bytes; }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+// Reads messages written by Message_writer. All reads are bounds checked;
+// once a read fails, reader stays in failed state and further reads
+// return zero values.
+class Message_reader
+{
+public:
+    Message_reader(const uint8_t* data, std::size_t length);
+
+    [[nodiscard]] auto read_u8     () -> uint8_t;
+    [[nodiscard]] auto read_u32    () -> uint32_t;
+    [[nodiscard]] auto read_u64    () -> uint64_t;
+    [[nodiscard]] auto read_f32    () -> float;
+    [[nodiscard]] auto read_varuint() -> uint64_t;
+    [[nodiscard]] auto read_varint () -> int64_t;
+    [[nodiscard]] auto read_string () -> std::string;
+
+    [[nodiscard]] auto is_ok       () const -> bool { return m_ok; }
+    [[nodiscard]] auto is_at_end   () const -> bool { return m_offset == m_length; }
+
+private:
+    auto can_read(std::size_t byte_count) -> bool;
+
+    const uint8_t* m_data  {nullptr};
+    std::size_t    m_length{0};
+    std::size_t    m_offset{0};
+    bool           m_ok    {true};
+};
+
+} // namespace erhe::replication
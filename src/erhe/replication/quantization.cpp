@@ -0,0 +1,215 @@
+#include "erhe/replication/quantization.hpp"
+#include "erhe/replication/message_stream.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace erhe::replication
+{
+
+namespace {
+
+constexpr float    c_sqrt_half       = 0.70710678118f;
+constexpr uint32_t c_rotation_bits   = 10u;
+constexpr uint32_t c_rotation_max    = (1u << c_rotation_bits) - 1u;
+constexpr uint32_t c_rotation_mask   = c_rotation_max;
+
+[[nodiscard]] auto quantize_fixed(const float value, const float precision) -> int32_t
+{
+    return static_cast<int32_t>(std::lround(value / precision));
+}
+
+template <typename T>
+[[nodiscard]] auto is_finite(const T& v) -> bool
+{
+    for (int i = 0; i < T::length(); ++i) {
+        if (!std::isfinite(v[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+[[nodiscard]] auto quantize_rotation(glm::quat q) -> uint32_t
+{
+    q = glm::normalize(q);
+    const float components[4]{q.x, q.y, q.z, q.w};
+
+    uint32_t largest_index{0};
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[largest_index])) {
+            largest_index = i;
+        }
+    }
+
+    // q and -q are the same rotation, make the omitted component positive
+    const float sign = (components[largest_index] < 0.0f) ? -1.0f : 1.0f;
+
+    uint32_t packed = largest_index << (3u * c_rotation_bits);
+    uint32_t shift  = 2u * c_rotation_bits;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == largest_index) {
+            continue;
+        }
+        const float normalized = std::clamp((sign * components[i] / c_sqrt_half + 1.0f) * 0.5f, 0.0f, 1.0f);
+        packed |= static_cast<uint32_t>(std::lround(normalized * c_rotation_max)) << shift;
+        shift -= c_rotation_bits;
+    }
+    return packed;
+}
+
+[[nodiscard]] auto dequantize_rotation(const uint32_t packed) -> glm::quat
+{
+    const uint32_t largest_index = (packed >> (3u * c_rotation_bits)) & 3u;
+
+    float    components[4];
+    float    sum_of_squares{0.0f};
+    uint32_t shift = 2u * c_rotation_bits;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == largest_index) {
+            continue;
+        }
+        const float normalized = static_cast<float>((packed >> shift) & c_rotation_mask) / static_cast<float>(c_rotation_max);
+        components[i] = (normalized * 2.0f - 1.0f) * c_sqrt_half;
+        sum_of_squares += components[i] * components[i];
+        shift -= c_rotation_bits;
+    }
+    components[largest_index] = std::sqrt(std::max(0.0f, 1.0f - sum_of_squares));
+
+    // glm::quat constructor takes w first
+    return glm::normalize(glm::quat{components[3], components[0], components[1], components[2]});
+}
+
+} // anonymous namespace
+
+auto Quantized_transform::diff_mask(
+    const Quantized_transform& lhs,
+    const Quantized_transform& rhs
+) -> unsigned int
+{
+    unsigned int mask{0};
+    if (
+        (lhs.translation[0] != rhs.translation[0]) ||
+        (lhs.translation[1] != rhs.translation[1]) ||
+        (lhs.translation[2] != rhs.translation[2])
+    ) {
+        mask |= bit_translation;
+    }
+    if (lhs.rotation != rhs.rotation) {
+        mask |= bit_rotation;
+    }
+    if (
+        (lhs.scale[0] != rhs.scale[0]) ||
+        (lhs.scale[1] != rhs.scale[1]) ||
+        (lhs.scale[2] != rhs.scale[2])
+    ) {
+        mask |= bit_scale;
+    }
+    return mask;
+}
+
+auto quantize(
+    const glm::mat4&             transform,
+    const Quantization_settings& settings,
+    const Quantized_transform*   fallback
+) -> Quantized_transform
+{
+    glm::vec3 scale;
+    glm::quat rotation;
+    glm::vec3 translation;
+    glm::vec3 skew;
+    glm::vec4 perspective;
+    const bool decomposed = glm::decompose(transform, scale, rotation, translation, skew, perspective);
+    if (
+        !decomposed ||
+        !is_finite(scale) ||
+        !is_finite(translation) ||
+        !is_finite(glm::vec4{rotation.x, rotation.y, rotation.z, rotation.w})
+    ) {
+        if (fallback != nullptr) {
+            return *fallback;
+        }
+        const glm::vec3 origin{transform[3]};
+        translation = is_finite(origin) ? origin : glm::vec3{0.0f};
+        rotation    = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+        scale       = glm::vec3{1.0f};
+    }
+
+    Quantized_transform result;
+    for (int i = 0; i < 3; ++i) {
+        result.translation[i] = quantize_fixed(translation[i], settings.translation_precision);
+        result.scale      [i] = quantize_fixed(scale      [i], settings.scale_precision);
+    }
+    result.rotation = quantize_rotation(rotation);
+    return result;
+}
+
+auto dequantize(
+    const Quantized_transform&   transform,
+    const Quantization_settings& settings
+) -> glm::mat4
+{
+    const glm::vec3 translation{
+        static_cast<float>(transform.translation[0]) * settings.translation_precision,
+        static_cast<float>(transform.translation[1]) * settings.translation_precision,
+        static_cast<float>(transform.translation[2]) * settings.translation_precision
+    };
+    const glm::vec3 scale{
+        static_cast<float>(transform.scale[0]) * settings.scale_precision,
+        static_cast<float>(transform.scale[1]) * settings.scale_precision,
+        static_cast<float>(transform.scale[2]) * settings.scale_precision
+    };
+    return
+        glm::translate(glm::mat4{1.0f}, translation) *
+        glm::mat4_cast(dequantize_rotation(transform.rotation)) *
+        glm::scale(glm::mat4{1.0f}, scale);
+}
+
+void write_delta(
+    Message_writer&            writer,
+    const Quantized_transform& baseline,
+    const Quantized_transform& transform,
+    const unsigned int         mask
+)
+{
+    if ((mask & Quantized_transform::bit_translation) != 0) {
+        for (int i = 0; i < 3; ++i) {
+            writer.write_varint(static_cast<int64_t>(transform.translation[i]) - baseline.translation[i]);
+        }
+    }
+    if ((mask & Quantized_transform::bit_rotation) != 0) {
+        writer.write_u32(transform.rotation);
+    }
+    if ((mask & Quantized_transform::bit_scale) != 0) {
+        for (int i = 0; i < 3; ++i) {
+            writer.write_varint(static_cast<int64_t>(transform.scale[i]) - baseline.scale[i]);
+        }
+    }
+}
+
+void read_delta(
+    Message_reader&      reader,
+    Quantized_transform& transform,
+    const unsigned int   mask
+)
+{
+    if ((mask & Quantized_transform::bit_translation) != 0) {
+        for (int i = 0; i < 3; ++i) {
+            transform.translation[i] = static_cast<int32_t>(transform.translation[i] + reader.read_varint());
+        }
+    }
+    if ((mask & Quantized_transform::bit_rotation) != 0) {
+        transform.rotation = reader.read_u32();
+    }
+    if ((mask & Quantized_transform::bit_scale) != 0) {
+        for (int i = 0; i < 3; ++i) {
+            transform.scale[i] = static_cast<int32_t>(transform.scale[i] + reader.read_varint());
+        }
+    }
+}
+
+} // namespace erhe::replication
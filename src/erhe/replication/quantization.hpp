@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace erhe::replication
+{
+
+class Message_reader;
+class Message_writer;
+
+class Quantization_settings
+{
+public:
+    float translation_precision{1.0f / 1024.0f}; // in world units
+    float scale_precision      {1.0f / 1024.0f};
+};
+
+// Translation, rotation and scale of a transform, quantized. Translation
+// and scale are fixed point integers, rotation uses smallest three
+// encoding: index of largest quaternion component in 2 bits, and the
+// remaining three components in 10 bits each.
+class Quantized_transform
+{
+public:
+    static constexpr unsigned int bit_translation{1u << 0};
+    static constexpr unsigned int bit_rotation   {1u << 1};
+    static constexpr unsigned int bit_scale      {1u << 2};
+    static constexpr unsigned int bit_all        {bit_translation | bit_rotation | bit_scale};
+
+    // Returns bit mask of components which differ
+    [[nodiscard]] static auto diff_mask(
+        const Quantized_transform& lhs,
+        const Quantized_transform& rhs
+    ) -> unsigned int;
+
+    int32_t  translation[3]{0, 0, 0};
+    uint32_t rotation      {0};
+    int32_t  scale      [3]{0, 0, 0};
+};
+
+// If transform cannot be decomposed (for example zero scale), or has
+// non-finite values, returns fallback if given. Otherwise returns
+// translation of transform (or origin) with identity rotation and unit
+// scale.
+[[nodiscard]] auto quantize(
+    const glm::mat4&             transform,
+    const Quantization_settings& settings,
+    const Quantized_transform*   fallback = nullptr
+) -> Quantized_transform;
+
+[[nodiscard]] auto dequantize(
+    const Quantized_transform&   transform,
+    const Quantization_settings& settings
+) -> glm::mat4;
+
+// Writes components selected by mask, as deltas against baseline
+void write_delta(
+    Message_writer&            writer,
+    const Quantized_transform& baseline,
+    const Quantized_transform& transform,
+    unsigned int               mask
+);
+
+// Reads components selected by mask, applying deltas to transform
+void read_delta(
+    Message_reader&      reader,
+    Quantized_transform& transform,
+    unsigned int         mask
+);
+
+} // namespace erhe::replication
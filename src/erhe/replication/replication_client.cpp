@@ -0,0 +1,163 @@
+#include "erhe/replication/replication_client.hpp"
+#include "erhe/replication/replication_log.hpp"
+#include "erhe/replication/replication_protocol.hpp"
+#include "erhe/net/client.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/toolkit/profile.hpp"
+
+namespace erhe::replication
+{
+
+Replication_client::Replication_client(
+    erhe::net::Client&           client,
+    Node_factory                 node_factory,
+    const Quantization_settings& quantization
+)
+    : m_client      {client}
+    , m_node_factory{std::move(node_factory)}
+    , m_quantization{quantization}
+{
+    m_client.set_receive_handler(
+        [this](const uint8_t* data, const std::size_t length)
+        {
+            on_receive(data, length);
+        }
+    );
+}
+
+Replication_client::~Replication_client() noexcept
+{
+    m_client.set_receive_handler({});
+}
+
+void Replication_client::set_viewer_position(const glm::vec3& position)
+{
+    m_viewer_position = position;
+}
+
+auto Replication_client::get_node(const uint32_t net_id) const -> std::shared_ptr<erhe::scene::Node>
+{
+    const auto i = m_nodes.find(net_id);
+    return (i != m_nodes.end()) ? i->second.node : std::shared_ptr<erhe::scene::Node>{};
+}
+
+auto Replication_client::get_node_count() const -> std::size_t
+{
+    return m_nodes.size();
+}
+
+auto Replication_client::get_statistics() const -> const Replica_statistics&
+{
+    return m_statistics;
+}
+
+void Replication_client::on_receive(const uint8_t* data, const std::size_t length)
+{
+    ERHE_PROFILE_FUNCTION
+
+    if ((data == nullptr) || (length == 0)) {
+        return;
+    }
+
+    Message_reader reader{data, length};
+    const auto message_type = static_cast<Message_type>(reader.read_u8());
+    if (message_type != Message_type::frame) {
+        log_replication->warn("unexpected message type {} from server", static_cast<unsigned int>(message_type));
+        ++m_statistics.error_count;
+        return;
+    }
+    if (!apply_frame(reader)) {
+        log_replication->error("malformed frame from server");
+        ++m_statistics.error_count;
+        return;
+    }
+    m_statistics.last_frame_byte_count = length;
+    m_statistics.total_byte_count      += length;
+    ++m_statistics.frame_count;
+}
+
+// Changes are applied as they are decoded. A malformed frame can only
+// come from a protocol mismatch, which the stream does not recover from.
+auto Replication_client::apply_frame(Message_reader& reader) -> bool
+{
+    const uint32_t frame_number   = static_cast<uint32_t>(reader.read_varuint());
+    const uint64_t server_time_us = reader.read_u64();
+
+    const uint64_t create_count = reader.read_varuint();
+    for (uint64_t i = 0; (i < create_count) && reader.is_ok(); ++i) {
+        const uint32_t    net_id = static_cast<uint32_t>(reader.read_varuint());
+        const std::string name   = reader.read_string();
+        Quantized_transform transform{};
+        read_delta(reader, transform, Quantized_transform::bit_all);
+        if (!reader.is_ok()) {
+            break;
+        }
+
+        // Server resends creates after reconnect, existing nodes are reused
+        Replica_node& replica = m_nodes[net_id];
+        if (!replica.node && m_node_factory) {
+            replica.node = m_node_factory(net_id, name);
+        }
+        replica.transform = transform;
+        apply(replica);
+        ++m_statistics.create_count;
+    }
+
+    const uint64_t remove_count = reader.read_varuint();
+    for (uint64_t i = 0; (i < remove_count) && reader.is_ok(); ++i) {
+        const uint32_t net_id = static_cast<uint32_t>(reader.read_varuint());
+        const auto     entry  = m_nodes.find(net_id);
+        if (entry == m_nodes.end()) {
+            continue;
+        }
+        if (entry->second.node) {
+            entry->second.node->remove();
+        }
+        m_nodes.erase(entry);
+        ++m_statistics.remove_count;
+    }
+
+    const uint64_t update_count = reader.read_varuint();
+    for (uint64_t i = 0; (i < update_count) && reader.is_ok(); ++i) {
+        const uint32_t     net_id = static_cast<uint32_t>(reader.read_varuint());
+        const unsigned int mask   = reader.read_u8();
+        const auto         entry  = m_nodes.find(net_id);
+        if (entry == m_nodes.end()) {
+            return false; // deltas can not be skipped
+        }
+        read_delta(reader, entry->second.transform, mask);
+        apply(entry->second);
+        ++m_statistics.update_count;
+    }
+
+    if (!reader.is_ok() || !reader.is_at_end()) {
+        return false;
+    }
+
+    m_statistics.last_frame_number = frame_number;
+    send_ack(frame_number, server_time_us);
+    return true;
+}
+
+void Replication_client::apply(Replica_node& replica)
+{
+    if (replica.node) {
+        replica.node->set_world_from_node(dequantize(replica.transform, m_quantization));
+    }
+}
+
+void Replication_client::send_ack(const uint32_t frame_number, const uint64_t server_time_us)
+{
+    m_writer.clear();
+    m_writer.write_u8     (static_cast<uint8_t>(Message_type::ack));
+    m_writer.write_varuint(frame_number);
+    m_writer.write_u64    (server_time_us);
+    m_writer.write_f32    (m_viewer_position.x);
+    m_writer.write_f32    (m_viewer_position.y);
+    m_writer.write_f32    (m_viewer_position.z);
+    if (!m_client.send(m_writer.data(), m_writer.size())) {
+        log_replication->warn("sending ack for frame {} failed", frame_number);
+    }
+}
+
+} // namespace erhe::replication
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "erhe/replication/message_stream.hpp"
+#include "erhe/replication/quantization.hpp"
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace erhe::net
+{
+    class Client;
+}
+
+namespace erhe::scene
+{
+    class Node;
+}
+
+namespace erhe::replication
+{
+
+// Creates local node for a replicated node. May return nullptr to ignore the node.
+using Node_factory = std::function<std::shared_ptr<erhe::scene::Node>(uint32_t net_id, const std::string& name)>;
+
+class Replica_statistics
+{
+public:
+    std::size_t last_frame_byte_count{0};
+    std::size_t total_byte_count     {0};
+    std::size_t frame_count          {0};
+    std::size_t create_count         {0};
+    std::size_t remove_count         {0};
+    std::size_t update_count         {0};
+    std::size_t error_count          {0};
+    uint32_t    last_frame_number    {0};
+};
+
+// Applies frames sent by Replication_server to local nodes, and
+// acknowledges them. Quantization settings must match the server.
+class Replication_client
+{
+public:
+    Replication_client(
+        erhe::net::Client&           client,
+        Node_factory                 node_factory,
+        const Quantization_settings& quantization = {}
+    );
+    ~Replication_client() noexcept;
+    Replication_client(const Replication_client&) = delete;
+    void operator=    (const Replication_client&) = delete;
+
+    // Sent to server with acks, for interest management
+    void set_viewer_position(const glm::vec3& position);
+
+    [[nodiscard]] auto get_node      (uint32_t net_id) const -> std::shared_ptr<erhe::scene::Node>;
+    [[nodiscard]] auto get_node_count() const -> std::size_t;
+    [[nodiscard]] auto get_statistics() const -> const Replica_statistics&;
+
+private:
+    class Replica_node
+    {
+    public:
+        std::shared_ptr<erhe::scene::Node> node;
+        Quantized_transform                transform;
+    };
+
+    void on_receive (const uint8_t* data, std::size_t length);
+    auto apply_frame(Message_reader& reader) -> bool;
+    void apply      (Replica_node& replica);
+    void send_ack   (uint32_t frame_number, uint64_t server_time_us);
+
+    erhe::net::Client&                         m_client;
+    Node_factory                               m_node_factory;
+    Quantization_settings                      m_quantization;
+    glm::vec3                                  m_viewer_position{0.0f};
+    std::unordered_map<uint32_t, Replica_node> m_nodes;
+    Replica_statistics                         m_statistics;
+    Message_writer                             m_writer;
+};
+
+} // namespace erhe::replication
@@ -0,0 +1,14 @@
+#include "erhe/replication/replication_log.hpp"
+#include "erhe/log/log.hpp"
+
+namespace erhe::replication
+{
+
+std::shared_ptr<spdlog::logger> log_replication;
+
+void initialize_logging()
+{
+    log_replication = erhe::log::make_logger("erhe::replication", spdlog::level::info);
+}
+
+} // namespace erhe::replication
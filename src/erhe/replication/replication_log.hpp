@@ -0,0 +1,14 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+namespace erhe::replication
+{
+
+extern std::shared_ptr<spdlog::logger> log_replication;
+
+void initialize_logging();
+
+} // namespace erhe::replication
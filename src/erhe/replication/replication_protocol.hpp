@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+namespace erhe::replication
+{
+
+/*
+    Scene replication protocol. Each message is one erhe::net packet and
+    starts with Message_type (u8). Integers marked var are LEB128 encoded,
+    signed ones zigzag encoded. Transforms are Quantized_transform values,
+    written by write_delta().
+
+    erhe::net uses TCP, so messages arrive reliably and in order. Server
+    sends transform deltas against the last value it sent to the same
+    client, without waiting for acknowledgements.
+
+    server -> client: frame
+        var  frame number
+        u64  server time in microseconds
+        var  create count
+             var net id, string name, transform delta against zero (all components)
+        var  remove count
+             var net id
+        var  update count
+             var net id, u8 component mask, transform delta against previous
+
+    client -> server: ack
+        var  frame number
+        u64  server time, echoed from frame (for round trip time)
+        f32  x 3 viewer position, used for interest management
+*/
+enum class Message_type : uint8_t
+{
+    frame = 1,
+    ack   = 2
+};
+
+} // namespace erhe::replication
@@ -0,0 +1,421 @@
+#include "erhe/replication/replication_server.hpp"
+#include "erhe/replication/replication_log.hpp"
+#include "erhe/replication/replication_protocol.hpp"
+#include "erhe/net/server.hpp"
+#include "erhe/net/socket.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::replication
+{
+
+using erhe::scene::Node_data;
+
+namespace {
+
+void capture_node_data(Node_data& snapshot, const Node_data& node_data)
+{
+    snapshot.transforms = node_data.transforms;
+    snapshot.host       = node_data.host;
+    snapshot.depth      = node_data.depth;
+}
+
+} // anonymous namespace
+
+Replication_server::Replication_server(
+    erhe::net::Server&               server,
+    const Replication_server_config& config
+)
+    : m_server    {server}
+    , m_config    {config}
+    , m_start_time{std::chrono::steady_clock::now()}
+{
+    m_server.set_connect_handler(
+        [this](erhe::net::Socket& client)
+        {
+            on_connect(client);
+        }
+    );
+    m_server.set_disconnect_handler(
+        [this](erhe::net::Socket& client)
+        {
+            on_disconnect(client);
+        }
+    );
+    m_server.set_receive_handler(
+        [this](erhe::net::Socket& client, const uint8_t* data, const std::size_t length)
+        {
+            on_receive(client, data, length);
+        }
+    );
+    for (const auto& client : m_server.get_clients()) {
+        on_connect(*client.get());
+    }
+}
+
+Replication_server::~Replication_server() noexcept
+{
+    m_server.set_connect_handler({});
+    m_server.set_disconnect_handler({});
+    m_server.set_receive_handler(erhe::net::Client_receive_handler{});
+}
+
+auto Replication_server::add_node(const std::shared_ptr<erhe::scene::Node>& node) -> uint32_t
+{
+    ERHE_VERIFY(node);
+
+    const auto i = m_node_slots.find(node.get());
+    if (i != m_node_slots.end()) {
+        return m_nodes[i->second].net_id;
+    }
+
+    std::size_t slot;
+    if (!m_free_slots.empty()) {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+    } else {
+        slot = m_nodes.size();
+        m_nodes.emplace_back();
+        for (auto& [socket, client] : m_clients) {
+            client.nodes.emplace_back();
+        }
+    }
+
+    Node_entry& entry = m_nodes[slot];
+    entry.node          = node;
+    entry.net_id        = m_next_net_id++;
+    entry.change_serial = 1;
+    entry.removed       = false;
+    entry.quantized     = quantize(node->world_from_node(), m_config.quantization);
+    capture_node_data(entry.last_node_data, node->node_data);
+    m_node_slots.emplace(node.get(), slot);
+    return entry.net_id;
+}
+
+void Replication_server::remove_node(const erhe::scene::Node* node)
+{
+    const auto i = m_node_slots.find(node);
+    if (i == m_node_slots.end()) {
+        return;
+    }
+
+    // Slot is released once all clients have been sent the removal
+    Node_entry& entry = m_nodes[i->second];
+    entry.node.reset();
+    entry.removed = true;
+    m_node_slots.erase(i);
+}
+
+void Replication_server::set_priority_function(Priority_function priority_function)
+{
+    m_priority_function = priority_function;
+}
+
+void Replication_server::on_connect(erhe::net::Socket& client)
+{
+    log_replication->info("client {} connected", client.get_address_string());
+    Client_state& state = m_clients[&client];
+    state = Client_state{};
+    state.socket = &client;
+    state.nodes.resize(m_nodes.size());
+}
+
+void Replication_server::on_disconnect(erhe::net::Socket& client)
+{
+    log_replication->info("client {} disconnected", client.get_address_string());
+    m_clients.erase(&client);
+}
+
+void Replication_server::on_receive(
+    erhe::net::Socket& client,
+    const uint8_t*     data,
+    const std::size_t  length
+)
+{
+    const auto i = m_clients.find(&client);
+    if (i == m_clients.end()) {
+        return;
+    }
+    Client_state& state = i->second;
+
+    Message_reader reader{data, length};
+    const auto message_type = static_cast<Message_type>(reader.read_u8());
+    if (message_type != Message_type::ack) {
+        log_replication->warn("unexpected message type {} from client", static_cast<unsigned int>(message_type));
+        return;
+    }
+    const uint32_t  frame_number = static_cast<uint32_t>(reader.read_varuint());
+    const uint64_t  sent_time_us = reader.read_u64();
+    const glm::vec3 viewer_position{reader.read_f32(), reader.read_f32(), reader.read_f32()};
+    if (!reader.is_ok()) {
+        log_replication->warn("malformed ack from client");
+        return;
+    }
+
+    Client_statistics& statistics = state.statistics;
+    statistics.last_acked_frame = frame_number;
+    state.unacked_frame_count   = state.last_sent_frame - frame_number;
+    state.view.viewer_position  = viewer_position;
+
+    const float round_trip_time_ms = static_cast<float>(get_time_us() - sent_time_us) / 1000.0f;
+    statistics.round_trip_time_ms = round_trip_time_ms;
+    statistics.average_round_trip_time_ms = (statistics.average_round_trip_time_ms == 0.0f)
+        ? round_trip_time_ms
+        : statistics.average_round_trip_time_ms * 0.9f + round_trip_time_ms * 0.1f;
+}
+
+void Replication_server::update()
+{
+    ERHE_PROFILE_FUNCTION
+
+    ++m_frame_number;
+    detect_changes();
+    for (auto& [socket, client] : m_clients) {
+        send_frame(client);
+    }
+    release_removed_slots();
+}
+
+// Node_data::diff_mask() is a cheap exact check. Only nodes which pass it
+// are quantized, and only nodes with a changed quantized value get a new
+// change serial, so that sub-precision jitter is never sent.
+void Replication_server::detect_changes()
+{
+    ERHE_PROFILE_FUNCTION
+
+    for (Node_entry& entry : m_nodes) {
+        if (!entry.node) {
+            continue;
+        }
+        const Node_data& node_data = entry.node->node_data;
+        if ((Node_data::diff_mask(entry.last_node_data, node_data) & Node_data::bit_transform) == 0) {
+            continue;
+        }
+        capture_node_data(entry.last_node_data, node_data);
+
+        const Quantized_transform quantized = quantize(entry.node->world_from_node(), m_config.quantization, &entry.quantized);
+        if (Quantized_transform::diff_mask(entry.quantized, quantized) != 0) {
+            entry.quantized = quantized;
+            ++entry.change_serial;
+        }
+    }
+}
+
+auto Replication_server::get_priority(
+    const Node_entry&  entry,
+    const Client_view& view
+) const -> float
+{
+    if (m_priority_function) {
+        return m_priority_function(*entry.node.get(), view);
+    }
+    if (m_config.interest_radius <= 0.0f) {
+        return 1.0f;
+    }
+
+    // Nodes near the viewer accumulate priority faster
+    const glm::vec3 position = glm::vec3{entry.node->position_in_world()};
+    const float     distance = glm::distance(position, view.viewer_position);
+    if (distance > m_config.interest_radius) {
+        return 0.0f;
+    }
+    return 1.0f - 0.9f * (distance / m_config.interest_radius);
+}
+
+void Replication_server::send_frame(Client_state& client)
+{
+    ERHE_PROFILE_FUNCTION
+
+    Client_statistics& statistics = client.statistics;
+    statistics.last_frame_byte_count = 0;
+
+    if (client.socket->get_state() != erhe::net::Socket::State::CONNECTED) {
+        return;
+    }
+
+    // Flow control - let slow clients catch up, changes keep accumulating
+    if (
+        (client.socket->get_send_buffer_size() > m_config.max_pending_send_bytes) ||
+        (client.unacked_frame_count > m_config.max_frames_in_flight)
+    ) {
+        ++statistics.skipped_frame_count;
+        return;
+    }
+
+    m_removes.clear();
+    m_remove_slots.clear();
+    m_candidates.clear();
+    for (std::size_t slot = 0, end = m_nodes.size(); slot < end; ++slot) {
+        const Node_entry&  entry = m_nodes[slot];
+        Client_node_state& state = client.nodes[slot];
+        if (entry.removed) {
+            if (state.created) {
+                m_removes.push_back(entry.net_id);
+                m_remove_slots.push_back(slot);
+            }
+            continue;
+        }
+        if (!entry.node) {
+            continue; // free slot
+        }
+        if (state.created && (state.sent_change_serial == entry.change_serial)) {
+            continue;
+        }
+        const float weight = get_priority(entry, client.view);
+        if (weight <= 0.0f) {
+            continue;
+        }
+        state.priority += weight;
+        m_candidates.push_back(Candidate{slot, state.priority});
+    }
+
+    std::sort(
+        m_candidates.begin(),
+        m_candidates.end(),
+        [](const Candidate& lhs, const Candidate& rhs)
+        {
+            return lhs.priority > rhs.priority;
+        }
+    );
+
+    m_create_writer.clear();
+    m_update_writer.clear();
+    m_sent_slots.clear();
+    std::size_t create_count{0};
+    std::size_t update_count{0};
+    for (const Candidate& candidate : m_candidates) {
+        if (m_create_writer.size() + m_update_writer.size() >= m_config.frame_byte_budget) {
+            break;
+        }
+        const Node_entry&        entry = m_nodes[candidate.slot];
+        const Client_node_state& state = client.nodes[candidate.slot];
+        if (!state.created) {
+            m_create_writer.write_varuint(entry.net_id);
+            m_create_writer.write_string (entry.node->get_name());
+            write_delta(m_create_writer, Quantized_transform{}, entry.quantized, Quantized_transform::bit_all);
+            ++create_count;
+        } else {
+            const unsigned int mask = Quantized_transform::diff_mask(state.sent, entry.quantized);
+            if (mask != 0) {
+                m_update_writer.write_varuint(entry.net_id);
+                m_update_writer.write_u8     (static_cast<uint8_t>(mask));
+                write_delta(m_update_writer, state.sent, entry.quantized, mask);
+                ++update_count;
+            }
+        }
+        m_sent_slots.push_back(candidate.slot);
+    }
+    statistics.deferred_update_count = m_candidates.size() - m_sent_slots.size();
+
+    if ((create_count == 0) && (update_count == 0) && m_removes.empty()) {
+        commit_client_state(client); // nothing to deliver for the sent slots
+        return;
+    }
+
+    m_writer.clear();
+    m_writer.write_u8     (static_cast<uint8_t>(Message_type::frame));
+    m_writer.write_varuint(m_frame_number);
+    m_writer.write_u64    (get_time_us());
+    m_writer.write_varuint(create_count);
+    m_writer.write_bytes  (m_create_writer.data(), m_create_writer.size());
+    m_writer.write_varuint(m_removes.size());
+    for (const uint32_t net_id : m_removes) {
+        m_writer.write_varuint(net_id);
+    }
+    m_writer.write_varuint(update_count);
+    m_writer.write_bytes  (m_update_writer.data(), m_update_writer.size());
+
+    // Packet is queued to socket without further copies
+    const auto packet = std::make_shared<const erhe::net::Packet>(m_writer.data(), m_writer.size());
+    if (!client.socket->send(packet)) {
+        // Client state is left as it was, so the same creates, removes
+        // and deltas against the last delivered baseline are sent again.
+        log_replication->warn("sending frame {} to client {} failed", m_frame_number, client.socket->get_address_string());
+        return;
+    }
+
+    commit_client_state(client);
+
+    client.last_sent_frame = m_frame_number;
+    ++client.unacked_frame_count;
+    statistics.last_frame_byte_count = packet->size();
+    statistics.total_byte_count     += packet->size();
+    statistics.create_count         += create_count;
+    statistics.update_count         += update_count;
+    ++statistics.frame_count;
+}
+
+void Replication_server::commit_client_state(Client_state& client)
+{
+    for (const std::size_t slot : m_remove_slots) {
+        client.nodes[slot] = Client_node_state{};
+    }
+    for (const std::size_t slot : m_sent_slots) {
+        const Node_entry&  entry = m_nodes[slot];
+        Client_node_state& state = client.nodes[slot];
+        state.created            = true;
+        state.sent               = entry.quantized;
+        state.sent_change_serial = entry.change_serial;
+        state.priority           = 0.0f;
+    }
+}
+
+void Replication_server::release_removed_slots()
+{
+    for (std::size_t slot = 0, end = m_nodes.size(); slot < end; ++slot) {
+        Node_entry& entry = m_nodes[slot];
+        if (!entry.removed) {
+            continue;
+        }
+        const bool pending = std::any_of(
+            m_clients.begin(),
+            m_clients.end(),
+            [slot](const auto& client)
+            {
+                return client.second.nodes[slot].created;
+            }
+        );
+        if (pending) {
+            continue;
+        }
+        entry = Node_entry{};
+        for (auto& [socket, client] : m_clients) {
+            client.nodes[slot] = Client_node_state{};
+        }
+        m_free_slots.push_back(slot);
+    }
+}
+
+auto Replication_server::get_client_statistics(const erhe::net::Socket& client) const -> const Client_statistics*
+{
+    const auto i = m_clients.find(&client);
+    return (i != m_clients.end()) ? &i->second.statistics : nullptr;
+}
+
+auto Replication_server::get_client_count() const -> std::size_t
+{
+    return m_clients.size();
+}
+
+auto Replication_server::get_node_count() const -> std::size_t
+{
+    return m_node_slots.size();
+}
+
+auto Replication_server::get_frame_number() const -> uint32_t
+{
+    return m_frame_number;
+}
+
+auto Replication_server::get_time_us() const -> uint64_t
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start_time
+        ).count()
+    );
+}
+
+} // namespace erhe::replication
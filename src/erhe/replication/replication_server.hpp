@@ -0,0 +1,162 @@
+#pragma once
+
+#include "erhe/replication/message_stream.hpp"
+#include "erhe/replication/quantization.hpp"
+#include "erhe/scene/node.hpp"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::net
+{
+    class Server;
+    class Socket;
+}
+
+namespace erhe::replication
+{
+
+class Replication_server_config
+{
+public:
+    Quantization_settings quantization;
+    std::size_t           frame_byte_budget     {16 * 1024}; // per client per frame
+    std::size_t           max_pending_send_bytes{64 * 1024}; // client is skipped while it has more queued
+    uint32_t              max_frames_in_flight  {8};         // client is skipped while it has more unacknowledged
+    float                 interest_radius       {0.0f};      // around viewer, 0 for unlimited
+};
+
+// What the server knows about a client, reported in acks
+class Client_view
+{
+public:
+    glm::vec3 viewer_position{0.0f};
+};
+
+class Client_statistics
+{
+public:
+    std::size_t last_frame_byte_count     {0};
+    std::size_t total_byte_count          {0};
+    std::size_t frame_count               {0};
+    std::size_t skipped_frame_count       {0}; // by flow control
+    std::size_t create_count              {0};
+    std::size_t update_count              {0};
+    std::size_t deferred_update_count     {0}; // in last frame, by byte budget
+    uint32_t    last_acked_frame          {0};
+    float       round_trip_time_ms        {0.0f};
+    float       average_round_trip_time_ms{0.0f};
+};
+
+// Returns priority weight of node for a client, or 0 if client is not
+// interested in the node. Changed nodes accumulate their weight every
+// frame until they are sent, so low priority nodes are not starved.
+using Priority_function = std::function<float(const erhe::scene::Node& node, const Client_view& view)>;
+
+// Replicates transforms of registered nodes to all clients of a server.
+//
+// Changes are detected with Node_data::diff_mask() and quantization, and
+// sent as deltas against the value last sent to each client. Each frame,
+// changed nodes are sent in priority order until the per client byte
+// budget is used; remaining nodes are deferred to later frames.
+class Replication_server
+{
+public:
+    explicit Replication_server(
+        erhe::net::Server&               server,
+        const Replication_server_config& config = {}
+    );
+    ~Replication_server() noexcept;
+    Replication_server(const Replication_server&) = delete;
+    void operator=    (const Replication_server&) = delete;
+
+    // Returns net id of node, which identifies the node to clients
+    auto add_node             (const std::shared_ptr<erhe::scene::Node>& node) -> uint32_t;
+    void remove_node          (const erhe::scene::Node* node);
+    void set_priority_function(Priority_function priority_function);
+
+    // Detects node changes and sends one frame message to each client.
+    // Call once per frame, before Server::poll().
+    void update();
+
+    [[nodiscard]] auto get_client_statistics(const erhe::net::Socket& client) const -> const Client_statistics*;
+    [[nodiscard]] auto get_client_count     () const -> std::size_t;
+    [[nodiscard]] auto get_node_count       () const -> std::size_t;
+    [[nodiscard]] auto get_frame_number     () const -> uint32_t;
+
+private:
+    class Node_entry
+    {
+    public:
+        std::shared_ptr<erhe::scene::Node> node;
+        uint32_t                           net_id       {0};
+        uint32_t                           change_serial{0};
+        erhe::scene::Node_data             last_node_data; // transforms only, for Node_data::diff_mask()
+        Quantized_transform                quantized;
+        bool                               removed      {false};
+    };
+
+    class Client_node_state
+    {
+    public:
+        Quantized_transform sent;
+        uint32_t            sent_change_serial{0};
+        float               priority          {0.0f};
+        bool                created           {false};
+    };
+
+    class Client_state
+    {
+    public:
+        erhe::net::Socket*             socket{nullptr};
+        Client_view                    view;
+        std::vector<Client_node_state> nodes; // indexed by node slot
+        uint32_t                       last_sent_frame      {0};
+        uint32_t                       unacked_frame_count  {0};
+        Client_statistics              statistics;
+    };
+
+    class Candidate
+    {
+    public:
+        std::size_t slot;
+        float       priority;
+    };
+
+    void on_connect           (erhe::net::Socket& client);
+    void on_disconnect        (erhe::net::Socket& client);
+    void on_receive           (erhe::net::Socket& client, const uint8_t* data, std::size_t length);
+    void detect_changes       ();
+    void send_frame           (Client_state& client);
+    void commit_client_state  (Client_state& client);
+    void release_removed_slots();
+    [[nodiscard]] auto get_priority(const Node_entry& entry, const Client_view& view) const -> float;
+    [[nodiscard]] auto get_time_us () const -> uint64_t;
+
+    erhe::net::Server&                                         m_server;
+    Replication_server_config                                  m_config;
+    Priority_function                                          m_priority_function;
+    std::vector<Node_entry>                                    m_nodes; // indexed by slot
+    std::vector<std::size_t>                                   m_free_slots;
+    std::unordered_map<const erhe::scene::Node*, std::size_t>  m_node_slots;
+    std::unordered_map<const erhe::net::Socket*, Client_state> m_clients;
+    uint32_t                                                   m_next_net_id {1};
+    uint32_t                                                   m_frame_number{0};
+    std::chrono::steady_clock::time_point                      m_start_time;
+
+    // Kept to reuse allocations
+    std::vector<Candidate>                                     m_candidates;
+    std::vector<uint32_t>                                      m_removes;
+    std::vector<std::size_t>                                   m_remove_slots; // committed to client state only after send
+    std::vector<std::size_t>                                   m_sent_slots;   // committed to client state only after send
+    Message_writer                                             m_create_writer;
+    Message_writer                                             m_update_writer;
+    Message_writer                                             m_writer;
+};
+
+} // namespace erhe::replication
@@ -0,0 +1,293 @@
+#include "erhe/scene/frustum_culler.hpp"
+#include "erhe/scene/mesh.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/concurrency/task_graph.hpp"
+#include "erhe/toolkit/profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace erhe::scene
+{
+
+namespace {
+
+// Spans with fewer candidates than this are culled on the calling thread
+constexpr std::size_t parallel_cull_grain_size = 1024;
+
+// Used for meshes without bounding volume; large enough to pass every
+// plane test, small enough to not produce NaNs in the plane equations.
+constexpr float unbounded = std::numeric_limits<float>::max() / 8.0f;
+
+}
+
+Frustum::Frustum(const glm::mat4& clip_from_world)
+{
+    // Gribb & Hartmann plane extraction. glm is column major, m[c][r]
+    const glm::mat4& m = clip_from_world;
+    const glm::vec4 row0{m[0][0], m[1][0], m[2][0], m[3][0]};
+    const glm::vec4 row1{m[0][1], m[1][1], m[2][1], m[3][1]};
+    const glm::vec4 row2{m[0][2], m[1][2], m[2][2], m[3][2]};
+    const glm::vec4 row3{m[0][3], m[1][3], m[2][3], m[3][3]};
+
+    // -w <= z <= w also contains 0 <= z <= w, so this works for
+    // both clip depth conventions, and for reverse depth.
+    const std::array<glm::vec4, 6> candidates{
+        row3 + row0, // left
+        row3 - row0, // right
+        row3 + row1, // bottom
+        row3 - row1, // top
+        row3 + row2, // near
+        row3 - row2  // far
+    };
+    for (const glm::vec4& plane : candidates) {
+        const float length = glm::length(glm::vec3{plane});
+        if (length < 1e-6f) {
+            continue;
+        }
+        planes[plane_count++] = plane / length;
+    }
+}
+
+auto Frustum::intersects_sphere(const glm::vec3& center, const float radius) const -> bool
+{
+    for (std::size_t i = 0; i < plane_count; ++i) {
+        const glm::vec4& plane = planes[i];
+        if (glm::dot(glm::vec3{plane}, center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto Frustum::intersects_box(const glm::vec3& center, const glm::vec3& half_extent) const -> bool
+{
+    for (std::size_t i = 0; i < plane_count; ++i) {
+        const glm::vec4& plane  = planes[i];
+        const glm::vec3  normal{plane};
+        const float      radius = glm::dot(glm::abs(normal), half_extent);
+        if (glm::dot(normal, center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::mutex                   Frustum_culler::s_mutex;
+std::vector<Frustum_culler*> Frustum_culler::s_all_frustum_cullers;
+
+Frustum_culler::Frustum_culler(const char* label)
+    : m_label{label}
+{
+    const std::lock_guard<std::mutex> lock{s_mutex};
+
+    s_all_frustum_cullers.push_back(this);
+}
+
+Frustum_culler::~Frustum_culler() noexcept
+{
+    const std::lock_guard<std::mutex> lock{s_mutex};
+
+    s_all_frustum_cullers.erase(
+        std::remove(
+            s_all_frustum_cullers.begin(),
+            s_all_frustum_cullers.end(),
+            this
+        ),
+        s_all_frustum_cullers.end()
+    );
+}
+
+auto Frustum_culler::all_frustum_cullers() -> std::vector<Frustum_culler*>
+{
+    const std::lock_guard<std::mutex> lock{s_mutex};
+
+    return s_all_frustum_cullers;
+}
+
+void Frustum_culler::set_thread_pool(erhe::concurrency::Thread_pool* thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+auto Frustum_culler::label() const -> const char*
+{
+    return m_label;
+}
+
+auto Frustum_culler::get_stats() const -> Frustum_culler_stats
+{
+    return m_last_frame_stats;
+}
+
+void Frustum_culler::next_frame()
+{
+    m_last_frame_stats = m_frame_stats;
+    m_frame_stats = Frustum_culler_stats{};
+}
+
+void Frustum_culler::cull(
+    const Frustum&                                frustum,
+    const gsl::span<const std::shared_ptr<Mesh>>& meshes,
+    const Item_filter&                            filter,
+    std::vector<std::shared_ptr<Mesh>>&           visible_meshes
+)
+{
+    ERHE_PROFILE_FUNCTION
+
+    visible_meshes.clear();
+
+    m_candidates.clear();
+    for (std::size_t i = 0, end = meshes.size(); i < end; ++i) {
+        const auto& mesh = meshes[i];
+        if (!mesh || !filter(mesh->get_flag_bits()) || (mesh->get_node() == nullptr)) {
+            continue;
+        }
+        m_candidates.push_back(i);
+    }
+
+    const std::size_t count = m_candidates.size();
+    m_sphere_x     .resize(count);
+    m_sphere_y     .resize(count);
+    m_sphere_z     .resize(count);
+    m_sphere_radius.resize(count);
+    m_box_x        .resize(count);
+    m_box_y        .resize(count);
+    m_box_z        .resize(count);
+    m_box_extent_x .resize(count);
+    m_box_extent_y .resize(count);
+    m_box_extent_z .resize(count);
+    m_visible      .resize(count);
+
+    erhe::concurrency::parallel_for(
+        m_thread_pool,
+        count,
+        parallel_cull_grain_size,
+        [this, &frustum, &meshes](const std::size_t begin, const std::size_t end)
+        {
+            cull_range(frustum, meshes, begin, end);
+        }
+    );
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (m_visible[i] != 0) {
+            visible_meshes.push_back(meshes[m_candidates[i]]);
+        }
+    }
+
+    ++m_frame_stats.cull_count;
+    m_frame_stats.mesh_count    += count;
+    m_frame_stats.visible_count += visible_meshes.size();
+    m_frame_stats.culled_count  += count - visible_meshes.size();
+}
+
+void Frustum_culler::cull_range(
+    const Frustum&                                frustum,
+    const gsl::span<const std::shared_ptr<Mesh>>& meshes,
+    const std::size_t                             begin,
+    const std::size_t                             end
+)
+{
+    // Gather world space bounding volumes
+    for (std::size_t i = begin; i < end; ++i) {
+        const Mesh& mesh = *meshes[m_candidates[i]].get();
+
+        erhe::toolkit::Bounding_box box;
+        for (const auto& primitive : mesh.mesh_data.primitives) {
+            const auto& primitive_box = primitive.gl_primitive_geometry.bounding_box;
+            if (primitive_box.min.x > primitive_box.max.x) {
+                box = erhe::toolkit::Bounding_box{};
+                break;
+            }
+            box.min = glm::min(box.min, primitive_box.min);
+            box.max = glm::max(box.max, primitive_box.max);
+        }
+        if (box.min.x > box.max.x) {
+            m_sphere_x     [i] = 0.0f;
+            m_sphere_y     [i] = 0.0f;
+            m_sphere_z     [i] = 0.0f;
+            m_sphere_radius[i] = unbounded;
+            m_box_x        [i] = 0.0f;
+            m_box_y        [i] = 0.0f;
+            m_box_z        [i] = 0.0f;
+            m_box_extent_x [i] = unbounded;
+            m_box_extent_y [i] = unbounded;
+            m_box_extent_z [i] = unbounded;
+            continue;
+        }
+
+        const glm::mat4& world_from_node = mesh.get_node()->world_from_node_transform().matrix();
+        const glm::mat3  linear{world_from_node};
+        const glm::mat3  abs_linear{glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2])};
+        const float      max_scale = std::sqrt(
+            std::max(
+                glm::dot(linear[0], linear[0]),
+                std::max(glm::dot(linear[1], linear[1]), glm::dot(linear[2], linear[2]))
+            )
+        );
+
+        // Single primitive meshes use the primitive bounding sphere, which
+        // usually is tighter than the sphere enclosing the box.
+        const auto&     primitives   = mesh.mesh_data.primitives;
+        const glm::vec3 local_center = (primitives.size() == 1)
+            ? primitives.front().gl_primitive_geometry.bounding_sphere.center
+            : box.center();
+        const float     local_radius = (primitives.size() == 1)
+            ? primitives.front().gl_primitive_geometry.bounding_sphere.radius
+            : 0.5f * glm::length(box.diagonal());
+
+        const glm::vec3 sphere_center = glm::vec3{world_from_node * glm::vec4{local_center, 1.0f}};
+        const glm::vec3 box_center    = glm::vec3{world_from_node * glm::vec4{box.center(), 1.0f}};
+        const glm::vec3 box_extent    = abs_linear * (0.5f * box.diagonal());
+
+        m_sphere_x     [i] = sphere_center.x;
+        m_sphere_y     [i] = sphere_center.y;
+        m_sphere_z     [i] = sphere_center.z;
+        m_sphere_radius[i] = local_radius * max_scale;
+        m_box_x        [i] = box_center.x;
+        m_box_y        [i] = box_center.y;
+        m_box_z        [i] = box_center.z;
+        m_box_extent_x [i] = box_extent.x;
+        m_box_extent_y [i] = box_extent.y;
+        m_box_extent_z [i] = box_extent.z;
+    }
+
+    // Plane tests - no branches in the inner loop so that it vectorizes
+    const float* const sphere_x      = m_sphere_x     .data();
+    const float* const sphere_y      = m_sphere_y     .data();
+    const float* const sphere_z      = m_sphere_z     .data();
+    const float* const sphere_radius = m_sphere_radius.data();
+    const float* const box_x         = m_box_x        .data();
+    const float* const box_y         = m_box_y        .data();
+    const float* const box_z         = m_box_z        .data();
+    const float* const box_extent_x  = m_box_extent_x .data();
+    const float* const box_extent_y  = m_box_extent_y .data();
+    const float* const box_extent_z  = m_box_extent_z .data();
+    uint8_t*     const visible       = m_visible      .data();
+
+    for (std::size_t i = begin; i < end; ++i) {
+        visible[i] = 1;
+    }
+    for (std::size_t p = 0; p < frustum.plane_count; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        const float nx     = plane.x;
+        const float ny     = plane.y;
+        const float nz     = plane.z;
+        const float d      = plane.w;
+        const float abs_nx = std::abs(nx);
+        const float abs_ny = std::abs(ny);
+        const float abs_nz = std::abs(nz);
+        for (std::size_t i = begin; i < end; ++i) {
+            const float sphere_distance = nx * sphere_x[i] + ny * sphere_y[i] + nz * sphere_z[i] + d;
+            const float box_distance    = nx * box_x   [i] + ny * box_y   [i] + nz * box_z   [i] + d;
+            const float box_radius      = abs_nx * box_extent_x[i] + abs_ny * box_extent_y[i] + abs_nz * box_extent_z[i];
+            const uint8_t inside =
+                static_cast<uint8_t>(sphere_distance >= -sphere_radius[i]) &
+                static_cast<uint8_t>(box_distance    >= -box_radius);
+            visible[i] &= inside;
+        }
+    }
+}
+
+} // namespace erhe::scene
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "erhe/scene/item.hpp"
+
+#include <glm/glm.hpp>
+
+#include <gsl/gsl>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
+namespace erhe::scene
+{
+
+class Mesh;
+
+// View frustum as world space planes, extracted from clip_from_world.
+// Point p is inside a plane when dot(plane, vec4{p, 1}) >= 0.
+// Degenerate planes (for example infinite far plane) are dropped.
+class Frustum
+{
+public:
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& clip_from_world);
+
+    [[nodiscard]] auto intersects_sphere(const glm::vec3& center, float radius) const -> bool;
+    [[nodiscard]] auto intersects_box   (const glm::vec3& center, const glm::vec3& half_extent) const -> bool;
+
+    std::array<glm::vec4, 6> planes;
+    std::size_t              plane_count{0};
+};
+
+class Frustum_culler_stats
+{
+public:
+    std::size_t cull_count   {0}; // number of cull() calls
+    std::size_t mesh_count   {0}; // meshes tested against frustum
+    std::size_t visible_count{0};
+    std::size_t culled_count {0};
+};
+
+// Culls meshes against a view frustum.
+//
+// World space bounding spheres and boxes are gathered from mesh primitive
+// bounding volumes into contiguous arrays, and tested against frustum planes
+// in branchless loops which the compiler can vectorize. With a thread pool,
+// large mesh spans are processed in parallel ranges.
+//
+// Statistics are accumulated over a frame; next_frame() publishes them.
+class Frustum_culler
+{
+public:
+    explicit Frustum_culler(const char* label);
+    ~Frustum_culler() noexcept;
+
+    Frustum_culler(const Frustum_culler&) = delete;
+    auto operator=(const Frustum_culler&) = delete;
+    Frustum_culler(Frustum_culler&&)      = delete;
+    auto operator=(Frustum_culler&&)      = delete;
+
+    void set_thread_pool(erhe::concurrency::Thread_pool* thread_pool);
+
+    // Replaces visible_meshes with meshes that pass filter and which bounding
+    // volume intersects the frustum. Meshes without node are dropped, meshes
+    // without bounding volume are never culled. Order is preserved.
+    void cull(
+        const Frustum&                                frustum,
+        const gsl::span<const std::shared_ptr<Mesh>>& meshes,
+        const Item_filter&                            filter,
+        std::vector<std::shared_ptr<Mesh>>&           visible_meshes
+    );
+
+    void next_frame();
+
+    [[nodiscard]] auto get_stats() const -> Frustum_culler_stats;
+    [[nodiscard]] auto label    () const -> const char*;
+
+    [[nodiscard]] static auto all_frustum_cullers() -> std::vector<Frustum_culler*>;
+
+private:
+    void cull_range(
+        const Frustum&                                frustum,
+        const gsl::span<const std::shared_ptr<Mesh>>& meshes,
+        std::size_t                                   begin,
+        std::size_t                                   end
+    );
+
+    static std::mutex                   s_mutex;
+    static std::vector<Frustum_culler*> s_all_frustum_cullers;
+
+    const char*                     m_label      {nullptr};
+    erhe::concurrency::Thread_pool* m_thread_pool{nullptr};
+
+    // Structure of arrays, indexed by candidate mesh
+    std::vector<std::size_t> m_candidates; // index to meshes
+    std::vector<float>       m_sphere_x;
+    std::vector<float>       m_sphere_y;
+    std::vector<float>       m_sphere_z;
+    std::vector<float>       m_sphere_radius;
+    std::vector<float>       m_box_x;
+    std::vector<float>       m_box_y;
+    std::vector<float>       m_box_z;
+    std::vector<float>       m_box_extent_x;
+    std::vector<float>       m_box_extent_y;
+    std::vector<float>       m_box_extent_z;
+    std::vector<uint8_t>     m_visible;
+
+    Frustum_culler_stats     m_frame_stats;
+    Frustum_culler_stats     m_last_frame_stats;
+};
+
+} // namespace erhe::scene
@@ -88,6 +88,7 @@ class Item_filter
 {
 public:
     [[nodiscard]] auto operator()(uint64_t filter_bits) const -> bool;
+    [[nodiscard]] auto operator==(const Item_filter& other) const -> bool = default;
 
     uint64_t require_all_bits_set          {0};
     uint64_t require_at_least_one_bit_set  {0};
@@ -450,6 +450,10 @@ void Node::set_parent(
             ? new_parent->get_depth() + 1
             : 0
     );
+    Scene* scene = get_scene();
+    if (scene != nullptr) {
+        scene->handle_node_reparent(*this);
+    }
     handle_parent_update(old_parent, new_parent);
     // sanity_check(); we might be deleted at this point due to smart ptr
 }
@@ -592,6 +596,24 @@ void Node::update_world_from_node()
     }
 }
 
+void Node::update_world_from_node(const Node& parent_node) const
+{
+    // Caller guarantees parent_node is the parent of this node. Avoids
+    // locking parent weak_ptr when walking down the node hierarchy.
+    node_data.transforms.world_from_node.set(
+        parent_node.world_from_node() * parent_from_node(),
+        node_from_parent() * parent_node.node_from_world()
+    );
+}
+
+void Node::enqueue_transform_update()
+{
+    Scene* scene = get_scene();
+    if (scene != nullptr) {
+        scene->enqueue_transform_update(this);
+    }
+}
+
 void Node::sanity_check() const
 {
 #if 1
@@ -793,6 +815,7 @@ void Node::set_parent_from_node(const glm::mat4 parent_from_node)
     node_data.transforms.parent_from_node.set(parent_from_node);
     update_world_from_node();
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::set_parent_from_node(const Transform& parent_from_node)
@@ -802,6 +825,7 @@ void Node::set_parent_from_node(const Transform& parent_from_node)
     node_data.transforms.parent_from_node = parent_from_node;
     update_world_from_node();
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::set_node_from_parent(const glm::mat4 node_from_parent)
@@ -809,6 +833,7 @@ void Node::set_node_from_parent(const glm::mat4 node_from_parent)
     node_data.transforms.parent_from_node.set(glm::inverse(node_from_parent), node_from_parent);
     update_world_from_node();
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::set_node_from_parent(const Transform& node_from_parent)
@@ -816,6 +841,7 @@ void Node::set_node_from_parent(const Transform& node_from_parent)
     node_data.transforms.parent_from_node = Transform::inverse(node_from_parent);
     update_world_from_node();
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::set_world_from_node(const glm::mat4 world_from_node)
@@ -852,6 +878,7 @@ void Node::set_node_from_world(const glm::mat4 node_from_world)
         node_data.transforms.parent_from_node = node_data.transforms.world_from_node;
     }
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::set_node_from_world(const Transform& node_from_world)
@@ -867,6 +894,7 @@ void Node::set_node_from_world(const Transform& node_from_world)
         node_data.transforms.parent_from_node = node_data.transforms.world_from_node;
     }
     handle_transform_update(Node_transforms::get_next_serial());
+    enqueue_transform_update();
 }
 
 void Node::recursive_remove()
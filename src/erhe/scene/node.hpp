@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <string>
 #include <vector>
@@ -72,6 +73,9 @@ public:
     std::vector<std::shared_ptr<Node>>            children;
     std::vector<std::shared_ptr<Node_attachment>> attachments;
     std::size_t                                   depth {0};
+    bool                                          transform_dirty{false}; // queued in Scene dirty transform list
+    std::size_t                                   transform_level{0};                                        // Node_transform_store level
+    std::size_t                                   transform_slot {std::numeric_limits<std::size_t>::max()}; // Node_transform_store slot in level
 
     static constexpr unsigned int bit_transform   {1u << 0};
     static constexpr unsigned int bit_host        {1u << 1};
@@ -146,7 +150,9 @@ public:
     void set_parent            (const std::shared_ptr<Node>& parent, std::size_t position = 0);
     void set_depth_recursive   (std::size_t depth);
     void update_world_from_node();
+    void update_world_from_node(const Node& parent_node) const;
     void update_transform      (uint64_t serial) const;
+    void enqueue_transform_update();
     void sanity_check          () const;
     void sanity_check_root_path(const Node* node) const;
     void set_parent_from_node  (const glm::mat4 parent_from_node);
@@ -0,0 +1,329 @@
+#include "erhe/scene/node_transform_store.hpp"
+#include "erhe/scene/node.hpp"
+#include "erhe/scene/transform.hpp"
+#include "erhe/concurrency/concurrent_queue.hpp"
+#include "erhe/toolkit/profile.hpp"
+#include "erhe/toolkit/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::scene
+{
+
+namespace {
+
+// Depth levels with fewer slots than this are swept on the calling thread
+constexpr std::size_t parallel_level_threshold = 4096;
+constexpr std::size_t parallel_chunk_size      = 1024;
+
+}
+
+void Node_transform_store::clear()
+{
+    // Nodes may have been destroyed since previous rebuild; stale
+    // Node_data::transform_slot values are detected by contains().
+    m_valid = false;
+    m_size  = 0;
+    m_levels.clear();
+}
+
+auto Node_transform_store::contains(const Node& node) const -> bool
+{
+    const std::size_t level = node.node_data.transform_level;
+    const std::size_t slot  = node.node_data.transform_slot;
+    return
+        (level < m_levels.size()) &&
+        (slot  < m_levels[level].nodes.size()) &&
+        (m_levels[level].nodes[slot] == &node);
+}
+
+auto Node_transform_store::get_parent_slot(const Node& node, const std::size_t level) const -> std::size_t
+{
+    if (level == 0) {
+        return invalid_slot;
+    }
+    const auto parent = node.parent().lock();
+    if (
+        !parent ||
+        !contains(*parent.get()) ||
+        (parent->node_data.transform_level != level - 1)
+    ) {
+        return invalid_slot;
+    }
+    return parent->node_data.transform_slot;
+}
+
+void Node_transform_store::push_slot(
+    Node&             node,
+    const std::size_t level,
+    const std::size_t parent_slot
+)
+{
+    if (m_levels.size() <= level) {
+        m_levels.resize(level + 1);
+    }
+    Level& l = m_levels[level];
+    node.node_data.transform_level = level;
+    node.node_data.transform_slot  = l.nodes.size();
+    l.nodes           .push_back(&node);
+    l.parent_from_node.push_back(node.parent_from_node());
+    l.node_from_parent.push_back(node.node_from_parent());
+    l.world_from_node .push_back(node.world_from_node());
+    l.node_from_world .push_back(node.node_from_world());
+    l.parent_slot     .push_back(parent_slot);
+    l.update_serial   .push_back(node.node_data.transforms.update_serial);
+    ++m_size;
+}
+
+void Node_transform_store::erase_slot(const std::size_t level, const std::size_t slot)
+{
+    Level&      l    = m_levels[level];
+    Node* const node = l.nodes[slot];
+
+    // Children which remain in store no longer have parent in store
+    const auto set_children_parent_slot = [this, level](const Node& parent, const std::size_t parent_slot)
+    {
+        if (level + 1 >= m_levels.size()) {
+            return;
+        }
+        Level& child_level = m_levels[level + 1];
+        for (const auto& child : parent.node_data.children) {
+            if (contains(*child.get()) && (child->node_data.transform_level == level + 1)) {
+                child_level.parent_slot[child->node_data.transform_slot] = parent_slot;
+            }
+        }
+    };
+    set_children_parent_slot(*node, invalid_slot);
+    node->node_data.transform_slot = invalid_slot;
+
+    // Move last slot of the level to the erased slot
+    const std::size_t last = l.nodes.size() - 1;
+    if (slot != last) {
+        l.nodes           [slot] = l.nodes           [last];
+        l.parent_from_node[slot] = l.parent_from_node[last];
+        l.node_from_parent[slot] = l.node_from_parent[last];
+        l.world_from_node [slot] = l.world_from_node [last];
+        l.node_from_world [slot] = l.node_from_world [last];
+        l.parent_slot     [slot] = l.parent_slot     [last];
+        l.update_serial   [slot] = l.update_serial   [last];
+        Node* const moved_node = l.nodes[slot];
+        moved_node->node_data.transform_slot = slot;
+        set_children_parent_slot(*moved_node, slot);
+    }
+    l.nodes           .pop_back();
+    l.parent_from_node.pop_back();
+    l.node_from_parent.pop_back();
+    l.world_from_node .pop_back();
+    l.node_from_world .pop_back();
+    l.parent_slot     .pop_back();
+    l.update_serial   .pop_back();
+    --m_size;
+}
+
+void Node_transform_store::rebuild(
+    Node&                                     root_node,
+    const std::vector<std::shared_ptr<Node>>& nodes
+)
+{
+    ERHE_PROFILE_FUNCTION
+
+    clear();
+
+    std::vector<Node*> sorted_nodes;
+    sorted_nodes.reserve(nodes.size());
+    for (const auto& node : nodes) {
+        sorted_nodes.push_back(node.get());
+    }
+    std::stable_sort(
+        sorted_nodes.begin(),
+        sorted_nodes.end(),
+        [](const Node* lhs, const Node* rhs)
+        {
+            return lhs->get_depth() < rhs->get_depth();
+        }
+    );
+
+    push_slot(root_node, 0, invalid_slot);
+    for (Node* const node : sorted_nodes) {
+        const std::size_t level = std::max(node->get_depth(), std::size_t{1});
+        push_slot(*node, level, get_parent_slot(*node, level));
+    }
+
+    // m_swept_serial is intentionally kept, so that changes made
+    // before the rebuild are still written back by next update().
+    m_valid = true;
+}
+
+void Node_transform_store::insert(Node& node)
+{
+    if (!m_valid || contains(node)) {
+        return;
+    }
+
+    const std::size_t level       = node.get_depth();
+    const std::size_t parent_slot = get_parent_slot(node, level);
+    if (parent_slot == invalid_slot) {
+        m_valid = false;
+        return;
+    }
+    push_slot(node, level, parent_slot);
+}
+
+void Node_transform_store::remove(Node& node)
+{
+    if (!m_valid || !contains(node)) {
+        node.node_data.transform_slot = invalid_slot;
+        return;
+    }
+    erase_slot(node.node_data.transform_level, node.node_data.transform_slot);
+}
+
+void Node_transform_store::move_recursive(Node& node)
+{
+    const std::size_t new_level = node.get_depth();
+    erase_slot(node.node_data.transform_level, node.node_data.transform_slot);
+    push_slot(node, new_level, get_parent_slot(node, new_level));
+    for (const auto& child : node.node_data.children) {
+        if (contains(*child.get())) {
+            move_recursive(*child.get());
+        }
+    }
+}
+
+void Node_transform_store::move(Node& node)
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (!m_valid) {
+        return;
+    }
+
+    const std::size_t new_level   = node.get_depth();
+    const std::size_t parent_slot = get_parent_slot(node, new_level);
+    if (!contains(node) || (parent_slot == invalid_slot)) {
+        m_valid = false;
+        return;
+    }
+
+    if (node.node_data.transform_level == new_level) {
+        // Subtree stays on same levels
+        m_levels[new_level].parent_slot[node.node_data.transform_slot] = parent_slot;
+        return;
+    }
+
+    move_recursive(node);
+}
+
+void Node_transform_store::set_local_transform(
+    const Node&      node,
+    const Transform& parent_from_node,
+    const uint64_t   serial
+)
+{
+    if (!m_valid || !contains(node)) {
+        return;
+    }
+    Level&            l    = m_levels[node.node_data.transform_level];
+    const std::size_t slot = node.node_data.transform_slot;
+    l.parent_from_node[slot] = parent_from_node.matrix();
+    l.node_from_parent[slot] = parent_from_node.inverse_matrix();
+    l.update_serial   [slot] = std::max(l.update_serial[slot], serial);
+}
+
+void Node_transform_store::sweep_range(
+    const std::size_t level,
+    const std::size_t begin,
+    const std::size_t end
+)
+{
+    Level&             l            = m_levels[level];
+    const Level* const parent_level = (level > 0) ? &m_levels[level - 1] : nullptr;
+    for (std::size_t slot = begin; slot < end; ++slot) {
+        const std::size_t parent_slot = l.parent_slot[slot];
+        if (parent_slot == invalid_slot) {
+            l.world_from_node[slot] = l.parent_from_node[slot];
+            l.node_from_world[slot] = l.node_from_parent[slot];
+            continue;
+        }
+        l.world_from_node[slot] = parent_level->world_from_node[parent_slot] * l.parent_from_node[slot];
+        l.node_from_world[slot] = l.node_from_parent[slot] * parent_level->node_from_world[parent_slot];
+        l.update_serial  [slot] = std::max(l.update_serial[slot], parent_level->update_serial[parent_slot]);
+    }
+}
+
+void Node_transform_store::update(erhe::concurrency::Thread_pool* thread_pool)
+{
+    ERHE_PROFILE_FUNCTION
+
+    if (!m_valid) {
+        return;
+    }
+
+    const uint64_t previous_swept_serial = m_swept_serial;
+    m_swept_serial = Node_transforms::get_current_serial();
+
+    // Slots of each depth level only depend on slots of previous levels
+    for (std::size_t level = 0, end = m_levels.size(); level < end; ++level) {
+        const std::size_t level_size = m_levels[level].nodes.size();
+        if (
+            (thread_pool == nullptr) ||
+            (thread_pool->size() < 2) ||
+            (level_size < parallel_level_threshold)
+        ) {
+            sweep_range(level, 0, level_size);
+            continue;
+        }
+
+        ERHE_PROFILE_SCOPE("parallel sweep");
+        erhe::concurrency::Concurrent_queue queue{*thread_pool, "node transform store"};
+        for (std::size_t begin = 0; begin < level_size; begin += parallel_chunk_size) {
+            const std::size_t chunk_end = std::min(begin + parallel_chunk_size, level_size);
+            queue.enqueue(
+                [this, level, begin, chunk_end]()
+                {
+                    sweep_range(level, begin, chunk_end);
+                }
+            );
+        }
+        queue.wait();
+    }
+
+    // Write back changed world transforms and notify attachments.
+    // Level 0 is the scene root node.
+    for (std::size_t level = 1, end = m_levels.size(); level < end; ++level) {
+        const Level& l = m_levels[level];
+        for (std::size_t slot = 0, slot_end = l.nodes.size(); slot < slot_end; ++slot) {
+            const uint64_t serial = l.update_serial[slot];
+            if (serial <= previous_swept_serial) {
+                continue;
+            }
+            Node* const node = l.nodes[slot];
+            node->node_data.transforms.world_from_node.set(l.world_from_node[slot], l.node_from_world[slot]);
+            node->handle_transform_update(serial);
+        }
+    }
+}
+
+auto Node_transform_store::is_valid() const -> bool
+{
+    return m_valid;
+}
+
+auto Node_transform_store::size() const -> std::size_t
+{
+    return m_size;
+}
+
+auto Node_transform_store::world_from_node(const Node& node) const -> const glm::mat4&
+{
+    ERHE_VERIFY(contains(node));
+    return m_levels[node.node_data.transform_level].world_from_node[node.node_data.transform_slot];
+}
+
+auto Node_transform_store::node_from_world(const Node& node) const -> const glm::mat4&
+{
+    ERHE_VERIFY(contains(node));
+    return m_levels[node.node_data.transform_level].node_from_world[node.node_data.transform_slot];
+}
+
+} // namespace erhe::scene
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
+namespace erhe::scene
+{
+
+class Node;
+class Transform;
+
+// Structure of arrays storage for scene node transforms.
+//
+// Nodes are stored in one set of arrays per depth level, and refer to
+// their parent by index in previous level. World transform update is a
+// linear sweep over contiguous arrays, level by level, and each level can
+// be processed in parallel. Slot 0 of level 0 is the scene root node.
+//
+// Node stores its level and index in Node_data::transform_level and
+// Node_data::transform_slot. Adding and removing a node touches only
+// that node and its direct children; reparenting moves the subtree of
+// the node to its new levels.
+//
+// Node_data stays the normative copy of transforms, so that nodes outside
+// scenes and existing accessors keep working; changed world transforms
+// are written back after each sweep. The store is used only in
+// Transform_update_mode::linear_sweep: it pays off for large scenes where
+// many nodes change every frame, while the default dirty_subtrees mode
+// visits nothing when nothing changes.
+class Node_transform_store
+{
+public:
+    static constexpr std::size_t invalid_slot = std::numeric_limits<std::size_t>::max();
+
+    void clear  ();
+    void rebuild(Node& root_node, const std::vector<std::shared_ptr<Node>>& nodes);
+
+    // Incremental updates. These do nothing while store is not valid.
+    // Parent must be in store before child is inserted, otherwise the
+    // store is invalidated and rebuilt on next update.
+    void insert(Node& node);
+    void remove(Node& node);
+    void move  (Node& node); // after node was reparented
+
+    // Copies local (parent from node) transform of a node into its slot
+    void set_local_transform(const Node& node, const Transform& parent_from_node, uint64_t serial);
+
+    // Recomputes world transforms for all slots. Slots which changed since the
+    // previous sweep are written back to their nodes, and the nodes notified.
+    void update(erhe::concurrency::Thread_pool* thread_pool);
+
+    [[nodiscard]] auto is_valid       () const -> bool;
+    [[nodiscard]] auto contains       (const Node& node) const -> bool;
+    [[nodiscard]] auto size           () const -> std::size_t;
+    [[nodiscard]] auto world_from_node(const Node& node) const -> const glm::mat4&;
+    [[nodiscard]] auto node_from_world(const Node& node) const -> const glm::mat4&;
+
+private:
+    class Level
+    {
+    public:
+        std::vector<Node*>       nodes;
+        std::vector<glm::mat4>   parent_from_node;
+        std::vector<glm::mat4>   node_from_parent;
+        std::vector<glm::mat4>   world_from_node;
+        std::vector<glm::mat4>   node_from_world;
+        std::vector<std::size_t> parent_slot; // in previous level
+        std::vector<uint64_t>    update_serial;
+    };
+
+    [[nodiscard]] auto get_parent_slot(const Node& node, std::size_t level) const -> std::size_t;
+
+    void push_slot       (Node& node, std::size_t level, std::size_t parent_slot);
+    void erase_slot      (std::size_t level, std::size_t slot);
+    void move_recursive  (Node& node);
+    void sweep_range     (std::size_t level, std::size_t begin, std::size_t end);
+
+    bool               m_valid       {false};
+    uint64_t           m_swept_serial{0};
+    std::size_t        m_size        {0};
+    std::vector<Level> m_levels;
+};
+
+} // namespace erhe::scene
@@ -5,6 +5,7 @@
 #include "erhe/scene/node.hpp"
 #include "erhe/scene/scene_log.hpp"
 #include "erhe/scene/scene_message_bus.hpp"
+#include "erhe/concurrency/concurrent_queue.hpp"
 #include "erhe/toolkit/bit_helpers.hpp"
 #include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
@@ -280,12 +281,225 @@ void Scene::update_node_transforms()
 {
     ERHE_PROFILE_FUNCTION
 
-    if (!m_nodes_sorted) {
-        sort_transform_nodes();
+    switch (m_transform_update_mode) {
+        case Transform_update_mode::full_sweep: {
+            if (!m_nodes_sorted) {
+                sort_transform_nodes();
+            }
+
+            for (auto& node : m_flat_node_vector) {
+                node->update_transform(0);
+            }
+            break;
+        }
+
+        case Transform_update_mode::dirty_subtrees: {
+            update_dirty_node_transforms();
+            break;
+        }
+
+        case Transform_update_mode::linear_sweep: {
+            if (!m_transform_store.is_valid()) {
+                m_transform_store.rebuild(*m_root_node.get(), m_flat_node_vector);
+            }
+            m_transform_store.update(m_thread_pool);
+            break;
+        }
+
+        default: {
+            ERHE_FATAL("Bad Transform_update_mode");
+        }
+    }
+}
+
+void Scene::set_transform_update_mode(const Transform_update_mode mode)
+{
+    if (m_transform_update_mode == mode) {
+        return;
+    }
+    // Bring all nodes up to date before switching mode
+    update_node_transforms();
+
+    for (Node* node : m_dirty_transform_nodes) {
+        node->node_data.transform_dirty = false;
+    }
+    m_dirty_transform_nodes.clear();
+    m_transform_store.clear();
+    m_transform_update_mode = mode;
+}
+
+auto Scene::get_transform_update_mode() const -> Transform_update_mode
+{
+    return m_transform_update_mode;
+}
+
+auto Scene::get_transform_store() const -> const Node_transform_store&
+{
+    return m_transform_store;
+}
+
+void Scene::handle_node_reparent(Node& node)
+{
+    if (m_transform_update_mode == Transform_update_mode::linear_sweep) {
+        m_transform_store.move(node);
+    }
+}
+
+void Scene::set_thread_pool(erhe::concurrency::Thread_pool* thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+void Scene::enqueue_transform_update(Node* node)
+{
+    switch (m_transform_update_mode) {
+        case Transform_update_mode::dirty_subtrees: {
+            if (node->node_data.transform_dirty) {
+                return;
+            }
+            node->node_data.transform_dirty = true;
+            m_dirty_transform_nodes.push_back(node);
+            break;
+        }
+
+        case Transform_update_mode::linear_sweep: {
+            m_transform_store.set_local_transform(
+                *node,
+                node->node_data.transforms.parent_from_node,
+                node->node_data.transforms.update_serial
+            );
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+}
+
+namespace {
+
+// Nodes older than their parent need update. Dirty nodes are also updated,
+// as their world transform was computed when the parent may have been stale.
+[[nodiscard]] auto update_child_transform(const Node& parent_node, Node& child) -> bool
+{
+    const uint64_t parent_serial = parent_node.node_data.transforms.update_serial;
+    const uint64_t child_serial  = child.node_data.transforms.update_serial;
+    if ((child_serial >= parent_serial) && !child.node_data.transform_dirty) {
+        return false;
+    }
+    child.update_world_from_node(parent_node);
+    child.node_data.transforms.update_serial = std::max(child_serial, parent_serial);
+    return true;
+}
+
+// Updates world transforms of all descendants of parent_node. Attachments
+// are not notified here, so this is safe to run concurrently for disjoint
+// subtrees. Updated nodes are collected so that they can be notified
+// afterwards.
+void update_subtree_transforms(
+    const Node&         parent_node,
+    std::vector<Node*>& updated_nodes
+)
+{
+    for (const auto& child : parent_node.children()) {
+        if (update_child_transform(parent_node, *child.get())) {
+            updated_nodes.push_back(child.get());
+        }
+        update_subtree_transforms(*child.get(), updated_nodes);
     }
+}
 
-    for (auto& node : m_flat_node_vector) {
-        node->update_transform(0);
+[[nodiscard]] auto has_dirty_ancestor(const Node* node) -> bool
+{
+    for (
+        auto parent = node->parent().lock();
+        parent;
+        parent = parent->parent().lock()
+    ) {
+        if (parent->node_data.transform_dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parallel update is used only for scenes with at least this many nodes
+constexpr std::size_t parallel_node_count_threshold = 1024;
+
+}
+
+void Scene::update_dirty_node_transforms()
+{
+    if (m_dirty_transform_nodes.empty()) {
+        return;
+    }
+
+    // Subtree roots: dirty nodes with no dirty ancestor. Subtrees
+    // of other dirty nodes are covered by their dirty ancestor.
+    std::vector<Node*> subtree_roots;
+    for (Node* node : m_dirty_transform_nodes) {
+        if (!has_dirty_ancestor(node)) {
+            subtree_roots.push_back(node);
+        }
+    }
+
+    const bool use_thread_pool =
+        (m_thread_pool != nullptr) &&
+        (m_thread_pool->size() > 1) &&
+        (m_flat_node_vector.size() >= parallel_node_count_threshold);
+
+    // With a single (or few) dirty subtrees there is not much to run in
+    // parallel. Split the work one level down, children of subtree roots
+    // are independent of each other.
+    std::vector<const Node*> tasks;
+    std::vector<Node*>       root_updated_nodes;
+    if (use_thread_pool && (subtree_roots.size() < static_cast<std::size_t>(m_thread_pool->size()))) {
+        for (Node* root : subtree_roots) {
+            for (const auto& child : root->children()) {
+                if (update_child_transform(*root, *child.get())) {
+                    root_updated_nodes.push_back(child.get());
+                }
+                tasks.push_back(child.get());
+            }
+        }
+    } else {
+        tasks.insert(tasks.end(), subtree_roots.begin(), subtree_roots.end());
+    }
+
+    std::vector<std::vector<Node*>> updated_nodes(tasks.size());
+    if (use_thread_pool && (tasks.size() > 1)) {
+        ERHE_PROFILE_SCOPE("parallel transform update");
+        erhe::concurrency::Concurrent_queue queue{*m_thread_pool, "node transforms"};
+        for (std::size_t i = 0, end = tasks.size(); i < end; ++i) {
+            queue.enqueue(
+                [&tasks, &updated_nodes, i]()
+                {
+                    update_subtree_transforms(*tasks[i], updated_nodes[i]);
+                }
+            );
+        }
+        queue.wait();
+    } else {
+        for (std::size_t i = 0, end = tasks.size(); i < end; ++i) {
+            update_subtree_transforms(*tasks[i], updated_nodes[i]);
+        }
+    }
+
+    for (Node* node : m_dirty_transform_nodes) {
+        node->node_data.transform_dirty = false;
+    }
+    m_dirty_transform_nodes.clear();
+
+    // Attachment notifications are not thread safe; they are always
+    // delivered from this thread, in deterministic order.
+    for (Node* node : root_updated_nodes) {
+        node->handle_transform_update(node->node_data.transforms.update_serial);
+    }
+    for (const auto& task_nodes : updated_nodes) {
+        for (Node* node : task_nodes) {
+            node->handle_transform_update(node->node_data.transforms.update_serial);
+        }
     }
 }
 
@@ -353,6 +567,10 @@ void Scene::register_node(
         node->node_data.host = m_host;
         m_flat_node_vector.push_back(node);
         m_nodes_sorted = false;
+        if (m_transform_update_mode == Transform_update_mode::linear_sweep) {
+            m_transform_store.insert(*node.get());
+        }
+        enqueue_transform_update(node.get());
     }
 
     ERHE_VERIFY(!node->parent().expired());
@@ -389,6 +607,14 @@ void Scene::unregister_node(
         m_flat_node_vector.erase(i, m_flat_node_vector.end());
     }
 
+    m_transform_store.remove(*node.get());
+
+    if (node->node_data.transform_dirty) {
+        node->node_data.transform_dirty = false;
+        const auto j = std::remove(m_dirty_transform_nodes.begin(), m_dirty_transform_nodes.end(), node.get());
+        m_dirty_transform_nodes.erase(j, m_dirty_transform_nodes.end());
+    }
+
     sanity_check();
 
     if ((node->get_flag_bits() & Item_flags::no_message) == 0) {
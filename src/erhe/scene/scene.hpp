@@ -2,6 +2,7 @@
 
 #include "erhe/message_bus/message_bus.hpp"
 #include "erhe/scene/item.hpp"
+#include "erhe/scene/node_transform_store.hpp"
 #include "erhe/scene/scene_message.hpp"
 #include "erhe/toolkit/unique_id.hpp"
 
@@ -12,6 +13,11 @@
 #include <string_view>
 #include <vector>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::scene
 {
 
@@ -72,6 +78,13 @@ public:
 
 class Scene_host;
 
+enum class Transform_update_mode : unsigned int
+{
+    full_sweep     = 0, // Visit all nodes with Node::update_transform()
+    dirty_subtrees = 1, // Visit only subtrees of nodes changed with Node::set_*()
+    linear_sweep   = 2  // Sweep over Node_transform_store arrays
+};
+
 class Scene
     : public Item
 {
@@ -92,6 +105,18 @@ public:
     void sort_transform_nodes  ();
     void update_node_transforms();
 
+    // Node::set_*() functions call enqueue_transform_update(). In dirty_subtrees
+    // mode (default) update_node_transforms() only visits subtrees of enqueued
+    // nodes. In linear_sweep mode local transforms are copied to the scene
+    // Node_transform_store, which is then swept in depth order.
+    void set_transform_update_mode (Transform_update_mode mode);
+    void set_thread_pool           (erhe::concurrency::Thread_pool* thread_pool);
+    void enqueue_transform_update  (Node* node);
+    void handle_node_reparent      (Node& node);
+
+    [[nodiscard]] auto get_transform_update_mode() const -> Transform_update_mode;
+    [[nodiscard]] auto get_transform_store      () const -> const Node_transform_store&;
+
     //[[nodiscard]] auto get_node_by_id         (const erhe::toolkit::Unique_id<Node>::id_type id) const -> std::shared_ptr<Node>;
     [[nodiscard]] auto get_mesh_by_id       (erhe::toolkit::Unique_id<Node>::id_type id) const -> std::shared_ptr<Mesh>;
     [[nodiscard]] auto get_light_by_id      (erhe::toolkit::Unique_id<Node>::id_type id) const -> std::shared_ptr<Light>;
@@ -121,6 +146,8 @@ public:
     void unregister_light (const std::shared_ptr<Light>& light);
 
 private:
+    void update_dirty_node_transforms();
+
     Scene_host*                               m_host       {nullptr};
     std::shared_ptr<erhe::scene::Node>        m_root_node;
     std::vector<std::shared_ptr<Node>>        m_flat_node_vector;
@@ -128,6 +155,10 @@ private:
     std::vector<std::shared_ptr<Light_layer>> m_light_layers;
     std::vector<std::shared_ptr<Camera>>      m_cameras;
     bool                                      m_nodes_sorted{false};
+    Transform_update_mode                     m_transform_update_mode{Transform_update_mode::dirty_subtrees};
+    std::vector<Node*>                        m_dirty_transform_nodes;
+    Node_transform_store                      m_transform_store;
+    erhe::concurrency::Thread_pool*           m_thread_pool{nullptr};
 };
 
 [[nodiscard]] auto is_scene(const Item* scene_item) -> bool;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 namespace erhe::scene
@@ -17,6 +18,12 @@ enum class Scene_event_type : int
     selection_changed
 };
 
+// Receiver filter mask bit for event type
+[[nodiscard]] constexpr auto scene_event_mask(const Scene_event_type event_type) -> uint64_t
+{
+    return uint64_t{1} << static_cast<unsigned int>(event_type);
+}
+
 class Scene_message
 {
 public:
@@ -1,6 +1,19 @@
 #include "erhe/scene/scene_message_bus.hpp"
+#include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
+namespace erhe::message_bus
+{
+
+using erhe::scene::Scene_message;
+
+auto Message_traits<Scene_message>::get_type_mask(const Scene_message& message) -> uint64_t
+{
+    return erhe::scene::scene_event_mask(message.event_type);
+}
+
+} // namespace erhe::message_bus
+
 namespace erhe::scene
 {
 
@@ -23,4 +36,11 @@ void Scene_message_bus::initialize_component()
     g_scene_message_bus = this;
 }
 
+void Scene_message_bus::update_once_per_frame(const erhe::components::Time_context&)
+{
+    ERHE_PROFILE_FUNCTION
+
+    update();
+}
+
 } // namespace editor
@@ -1,15 +1,34 @@
 #pragma once
 
 #include "erhe/components/components.hpp"
-#include "erhe/message_bus/message_bus.hpp"
+#include "erhe/message_bus/concurrent_message_bus.hpp"
 #include "erhe/scene/scene_message.hpp"
 
+namespace erhe::message_bus
+{
+
+template <>
+class Message_traits<erhe::scene::Scene_message>
+{
+public:
+    [[nodiscard]] static auto get_type_mask   (const erhe::scene::Scene_message& message) -> uint64_t;
+    [[nodiscard]] static auto get_coalesce_key(const erhe::scene::Scene_message&) -> uint64_t { return 0; }
+    [[nodiscard]] static auto coalesce        (erhe::scene::Scene_message&, const erhe::scene::Scene_message&) -> bool { return false; }
+};
+
+} // namespace erhe::message_bus
+
 namespace erhe::scene
 {
 
+// Scene node add / remove messages are sent synchronously. Messages can
+// also be queued from worker threads; queued messages are dispatched once
+// per frame. Scene messages are not coalesced, as receivers may depend on
+// seeing each add / remove in order.
 class Scene_message_bus
     : public erhe::components::Component
-    , public erhe::message_bus::Message_bus<erhe::scene::Scene_message>
+    , public erhe::components::IUpdate_once_per_frame
+    , public erhe::message_bus::Concurrent_message_bus<erhe::scene::Scene_message>
 {
 public:
     static constexpr std::string_view c_type_name{"Scene_message_bus"};
@@ -27,6 +46,9 @@ public:
     // Implements Component
     [[nodiscard]] auto get_type_hash() const -> uint32_t override { return c_type_hash; }
     void initialize_component() override;
+
+    // Implements IUpdate_once_per_frame
+    void update_once_per_frame(const erhe::components::Time_context&) override;
 };
 
 extern Scene_message_bus* g_scene_message_bus;
@@ -10,6 +10,8 @@
 
 #include <imgui.h>
 
+#include <algorithm>
+
 namespace hextiles
 {
 
@@ -34,33 +36,45 @@ void Fbm_noise::imgui()
     ImGui::DragFloat2("Location",   &m_location[0], 0.1f, -1000.0f,   1000.0f);
 }
 
-auto Fbm_noise::generate(const float s, const float t, const glm::vec4 seed) -> float
+auto Fbm_noise::make_angle(const float s) -> Angle
 {
-    const float x = m_location[0] + std::cos(s * glm::two_pi<float>()) * m_frequency;
-    const float y = m_location[1] + std::cos(t * glm::two_pi<float>()) * m_frequency;
-    const float z = m_location[0] + std::sin(s * glm::two_pi<float>()) * m_frequency;
-    const float w = m_location[1] + std::sin(t * glm::two_pi<float>()) * m_frequency;
+    return Angle{
+        .cos = std::cos(s * glm::two_pi<float>()),
+        .sin = std::sin(s * glm::two_pi<float>())
+    };
+}
 
-    return generate(x, y, z, w, seed);
+auto Fbm_noise::generate(const float s, const float t, const glm::vec4 seed) -> float
+{
+    float value;
+    generate(make_angle(s), make_angle(t), &seed, 1, &value);
+    return value;
 }
 
-auto Fbm_noise::generate(float x, float y, float z, float w, const glm::vec4 seed) -> float
+void Fbm_noise::generate(
+    const Angle&           s,
+    const Angle&           t,
+    const glm::vec4* const seeds,
+    const std::size_t      seed_count,
+    float* const           out_values
+) const
 {
-    float sum = 0;
-    float amp = m_bounding;
+    glm::vec4 p{
+        m_location[0] + s.cos * m_frequency,
+        m_location[1] + t.cos * m_frequency,
+        m_location[0] + s.sin * m_frequency,
+        m_location[1] + t.sin * m_frequency
+    };
 
+    std::fill(out_values, out_values + seed_count, 0.0f);
+    float amp = m_bounding;
     for (int i = 0; i < m_octaves; i++) {
-        float noise = glm::simplex(seed + glm::vec4{x, y, z, w});
-        sum += noise * amp;
-
-        x *= m_lacunarity;
-        y *= m_lacunarity;
-        z *= m_lacunarity;
-        w *= m_lacunarity;
+        for (std::size_t j = 0; j < seed_count; ++j) {
+            out_values[j] += glm::simplex(seeds[j] + p) * amp;
+        }
+        p   *= m_lacunarity;
         amp *= m_gain;
     }
-
-    return sum;
 }
 
 } // namespace hextiles
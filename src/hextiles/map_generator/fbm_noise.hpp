@@ -2,18 +2,41 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+
 namespace hextiles
 {
 
 class Fbm_noise
 {
 public:
+    // Cosine and sine of s * 2 pi. Noise is sampled on a torus; angles
+    // only depend on tile column or row, so callers can compute them once
+    // per column / row instead of for every tile and seed.
+    class Angle
+    {
+    public:
+        float cos;
+        float sin;
+    };
+
+    [[nodiscard]] static auto make_angle(float s) -> Angle;
+
     void prepare ();
     auto generate(float s, float t, glm::vec4 seed) -> float;
     void imgui   ();
 
+    // Evaluates noise for several seeds at the same location. Octave
+    // coordinates are computed once and shared by all seeds.
+    void generate(
+        const Angle&     s,
+        const Angle&     t,
+        const glm::vec4* seeds,
+        std::size_t      seed_count,
+        float*           out_values
+    ) const;
+
 private:
-    auto generate(float x, float y, float z, float w, glm::vec4 seed) -> float;
 
     float m_bounding   {0.0f};
     float m_frequency  {0.4f};
@@ -6,18 +6,35 @@
 #include "tiles.hpp"
 
 #include "erhe/application/imgui/imgui_windows.hpp"
+#include "erhe/concurrency/task_graph.hpp"
+#include "erhe/toolkit/profile.hpp"
 #include "erhe/toolkit/verify.hpp"
 
 #include <imgui.h>
 
+#include <thread>
+
 namespace hextiles
 {
 
 Map_generator* g_map_generator{nullptr};
 
+namespace {
+
+// Columns / rows per thread pool task
+constexpr std::size_t c_grain_size{8};
+
+} // anonymous namespace
+
 Map_generator::Map_generator()
-    : Component{c_type_name}
-    , Imgui_window{c_title}
+    : Component    {c_type_name}
+    , Imgui_window {c_title}
+    , m_thread_pool{
+        std::min(
+            8U,
+            std::max(std::thread::hardware_concurrency() - 1, 1U)
+        )
+    }
 {
 }
 
@@ -176,6 +193,8 @@ void Map_generator::update_elevation_terrains()
 
 void Map_generator::generate_noise_pass(Map& map)
 {
+    ERHE_PROFILE_FUNCTION
+
     // In the first pass, we just generate noise values
     const int    width  = map.width();
     const int    height = map.height();
@@ -187,29 +206,62 @@ void Map_generator::generate_noise_pass(Map& map)
     m_temperature_generator.reset(count);
     m_humidity_generator   .reset(count);
     m_variation_generator  .reset(count);
-    const glm::vec4 elevation_seed  {12334.1f, 14378.0f, 12381.1f, 14386.9f};
-    const glm::vec4 temperature_seed{27865.9f, 24387.6f, 28726.5f, 28271.4f};
-    const glm::vec4 humidity_seed   {38760.8f, 39732.0f, 39785.6f, 32317.8f};
-    const glm::vec4 variation_seed  {41902.6f, 41986.3f, 42098.7f, 43260.9f};
+    m_elevation_generator  .resize(count);
+    m_temperature_generator.resize(count);
+    m_humidity_generator   .resize(count);
+    m_variation_generator  .resize(count);
+    const glm::vec4 seeds[4]{
+        {12334.1f, 14378.0f, 12381.1f, 14386.9f}, // elevation
+        {27865.9f, 24387.6f, 28726.5f, 28271.4f}, // temperature
+        {38760.8f, 39732.0f, 39785.6f, 32317.8f}, // humidity
+        {41902.6f, 41986.3f, 42098.7f, 43260.9f}  // variation
+    };
+
+    // Noise angles depend only on column, and on row and column parity
+    std::vector<Fbm_noise::Angle> column_angles(static_cast<std::size_t>(width));
+    std::vector<Fbm_noise::Angle> row_angles[2];
     for (coordinate_t tx = 0; tx < width; ++tx) {
-        const float x        = static_cast<float>(tx) / static_cast<float>(width);
-        const float y_offset = (tx & 1) == 1 ? -0.5f : 0.0f;
+        column_angles[tx] = Fbm_noise::make_angle(static_cast<float>(tx) / static_cast<float>(width));
+    }
+    for (int parity = 0; parity < 2; ++parity) {
+        const float y_offset = (parity == 1) ? -0.5f : 0.0f;
+        row_angles[parity].resize(static_cast<std::size_t>(height));
         for (coordinate_t ty = 0; ty < height; ++ty) {
-            const float y = (static_cast<float>(ty) + y_offset) / static_cast<float>(height);
-            const float elevation   = m_noise.generate(x, y, elevation_seed  );
-            const float temperature = m_noise.generate(x, y, temperature_seed);
-            const float humidity    = m_noise.generate(x, y, humidity_seed   );
-            const float variation   = m_noise.generate(x, y, variation_seed  );
-            m_elevation_generator  .push(elevation  );
-            m_temperature_generator.push(temperature);
-            m_humidity_generator   .push(humidity   );
-            m_variation_generator  .push(variation  );
+            row_angles[parity][ty] = Fbm_noise::make_angle((static_cast<float>(ty) + y_offset) / static_cast<float>(height));
         }
     }
+
+    // Rows are independent, values are stored row by row like Map tiles
+    erhe::concurrency::parallel_for(
+        &m_thread_pool,
+        static_cast<std::size_t>(height),
+        c_grain_size,
+        [this, width, &seeds, &column_angles, &row_angles](const std::size_t begin, const std::size_t end)
+        {
+            float values[4];
+            for (std::size_t ty = begin; ty < end; ++ty) {
+                std::size_t index = ty * static_cast<std::size_t>(width);
+                for (coordinate_t tx = 0; tx < width; ++tx, ++index) {
+                    m_noise.generate(column_angles[tx], row_angles[tx & 1][ty], seeds, 4, values);
+                    m_elevation_generator  .set(index, values[0]);
+                    m_temperature_generator.set(index, values[1]);
+                    m_humidity_generator   .set(index, values[2]);
+                    m_variation_generator  .set(index, values[3]);
+                }
+            }
+        }
+    );
+
+    m_elevation_generator  .update_value_range();
+    m_temperature_generator.update_value_range();
+    m_humidity_generator   .update_value_range();
+    m_variation_generator  .update_value_range();
 }
 
 void Map_generator::generate_base_terrain_pass(Map& map)
 {
+    ERHE_PROFILE_FUNCTION
+
     // Second pass converts noise values to terrain values based on thresholds
     m_elevation_generator.compute_threshold_values();
 
@@ -227,18 +279,26 @@ void Map_generator::generate_base_terrain_pass(Map& map)
     //    );
     //}
 
-    const int w = map.width();
-    const int h = map.height();
+    const int width = map.width();
 
-    size_t index = 0;
-    for (coordinate_t tx = 0; tx < w; ++tx) {
-        for (coordinate_t ty = 0; ty < h; ++ty) {
-            const Terrain_variation terrain_variation = m_elevation_generator.get(index);
-            const terrain_tile_t    terrain_tile      = g_tiles->get_terrain_tile_from_terrain(terrain_variation.base_terrain);
-            map.set_terrain_tile(Tile_coordinate{tx, ty}, terrain_tile);
-            ++index;
+    // Rows are split between tasks, so tasks do not share cache lines of Map
+    erhe::concurrency::parallel_for(
+        &m_thread_pool,
+        static_cast<std::size_t>(map.height()),
+        c_grain_size,
+        [this, &map, width](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t y = begin; y < end; ++y) {
+                const coordinate_t ty    = static_cast<coordinate_t>(y);
+                std::size_t        index = y * static_cast<std::size_t>(width);
+                for (coordinate_t tx = 0; tx < width; ++tx, ++index) {
+                    const Terrain_variation terrain_variation = m_elevation_generator.get(index);
+                    const terrain_tile_t    terrain_tile      = g_tiles->get_terrain_tile_from_terrain(terrain_variation.base_terrain);
+                    map.set_terrain_tile(Tile_coordinate{tx, ty}, terrain_tile);
+                }
+            }
         }
-    }
+    );
 }
 
 auto Map_generator::get_variation(
@@ -270,67 +330,114 @@ auto Map_generator::get_variation(
 
 void Map_generator::generate_variation_pass(Map& map)
 {
+    ERHE_PROFILE_FUNCTION
+
     m_temperature_generator.compute_threshold_values();
     m_humidity_generator   .compute_threshold_values();
     m_variation_generator  .compute_threshold_values();
 
-    const int width  = map.width();
-    const int height = map.height();
+    const int width = map.width();
 
-    size_t index = 0;
-    for (coordinate_t tx = 0; tx < width; ++tx) {
-        for (coordinate_t ty = 0; ty < height; ++ty) {
-            const Tile_coordinate position{tx, ty};
-            const terrain_tile_t  terrain_tile   = map.get_terrain_tile(position);
-            const terrain_t       terrain        = g_tiles->get_terrain_from_tile(terrain_tile);
-            const float           temperature    = m_temperature_generator.get_noise_value(index);
-            const float           humidity       = m_humidity_generator   .get_noise_value(index);
-            //const float           variation    = m_variation_generator  .get_noise_value(index);
-            const terrain_t       v_terrain      = get_variation(terrain, temperature, humidity);
-            const terrain_tile_t  v_terrain_tile = g_tiles->get_terrain_tile_from_terrain(v_terrain);
-            map.set_terrain_tile(position, v_terrain_tile);
-            ++index;
+    // Each tile only reads and writes itself, rows are split between tasks
+    erhe::concurrency::parallel_for(
+        &m_thread_pool,
+        static_cast<std::size_t>(map.height()),
+        c_grain_size,
+        [this, &map, width](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t y = begin; y < end; ++y) {
+                const coordinate_t ty    = static_cast<coordinate_t>(y);
+                std::size_t        index = y * static_cast<std::size_t>(width);
+                for (coordinate_t tx = 0; tx < width; ++tx, ++index) {
+                    const Tile_coordinate position{tx, ty};
+                    const terrain_tile_t  terrain_tile   = map.get_terrain_tile(position);
+                    const terrain_t       terrain        = g_tiles->get_terrain_from_tile(terrain_tile);
+                    const float           temperature    = m_temperature_generator.get_noise_value(index);
+                    const float           humidity       = m_humidity_generator   .get_noise_value(index);
+                    //const float           variation    = m_variation_generator  .get_noise_value(index);
+                    const terrain_t       v_terrain      = get_variation(terrain, temperature, humidity);
+                    const terrain_tile_t  v_terrain_tile = g_tiles->get_terrain_tile_from_terrain(v_terrain);
+                    map.set_terrain_tile(position, v_terrain_tile);
+                }
+            }
         }
-    }
+    );
 }
 
+// Rules are applied as a cellular pass: every tile is computed from the
+// terrains as they were before the pass (double buffered), so rows are
+// processed in parallel and the result does not depend on tile order.
+// A tile is replaced if it matches the rule secondary terrain condition,
+// and the tile itself or one of its neighbors has rule primary terrain.
 void Map_generator::apply_rule(
     Map&                            map,
     const Terrain_replacement_rule& rule
 )
 {
-    std::function<void(Tile_coordinate)> post_process_op =
-    [this, &rule, &map](Tile_coordinate tile_position) -> void
-    {
-        const terrain_tile_t primary_terrain_tile = map.get_terrain_tile(tile_position);
-        const terrain_t      primary_terrain      = g_tiles->get_terrain_from_tile(primary_terrain_tile);
-        if (primary_terrain != rule.primary) {
-            return;
+    ERHE_PROFILE_FUNCTION
+
+    const int         width      = map.width();
+    const int         height     = map.height();
+    const std::size_t row_length = static_cast<std::size_t>(width);
+
+    m_rule_terrains.resize(row_length * static_cast<std::size_t>(height));
+    erhe::concurrency::parallel_for(
+        &m_thread_pool,
+        static_cast<std::size_t>(height),
+        c_grain_size,
+        [this, &map, width, row_length](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t y = begin; y < end; ++y) {
+                const coordinate_t ty = static_cast<coordinate_t>(y);
+                for (coordinate_t tx = 0; tx < width; ++tx) {
+                    const terrain_tile_t terrain_tile = map.get_terrain_tile(Tile_coordinate{tx, ty});
+                    m_rule_terrains[y * row_length + static_cast<std::size_t>(tx)] = g_tiles->get_terrain_from_tile(terrain_tile);
+                }
+            }
         }
-        std::function<void(Tile_coordinate)> replace =
-        [this, &rule, &map] (Tile_coordinate position) -> void
+    );
+
+    const terrain_tile_t replacement_terrain_tile = g_tiles->get_terrain_tile_from_terrain(rule.replacement);
+    erhe::concurrency::parallel_for(
+        &m_thread_pool,
+        static_cast<std::size_t>(height),
+        c_grain_size,
+        [this, &map, &rule, width, row_length, replacement_terrain_tile](const std::size_t begin, const std::size_t end)
         {
-            const terrain_tile_t secondary_terrain_tile = map.get_terrain_tile(position);
-            const terrain_t      secondary_terrain      = g_tiles->get_terrain_from_tile(secondary_terrain_tile);
-            const bool found = std::find(
-                rule.secondary.begin(),
-                rule.secondary.end(),
-                secondary_terrain
-            ) != rule.secondary.end();
-            const bool apply = rule.equal ? found : !found;
-
-            if (apply) {
-                const terrain_tile_t replacement_terrain_tile = g_tiles->get_terrain_tile_from_terrain(rule.replacement);
-                map.set_terrain_tile(position, replacement_terrain_tile);
+            for (std::size_t y = begin; y < end; ++y) {
+                const coordinate_t ty = static_cast<coordinate_t>(y);
+                for (coordinate_t tx = 0; tx < width; ++tx) {
+                    const Tile_coordinate position{tx, ty};
+                    const terrain_t       terrain = m_rule_terrains[y * row_length + static_cast<std::size_t>(tx)];
+                    const bool found = std::find(
+                        rule.secondary.begin(),
+                        rule.secondary.end(),
+                        terrain
+                    ) != rule.secondary.end();
+                    const bool apply = rule.equal ? found : !found;
+                    if (!apply) {
+                        continue;
+                    }
+
+                    bool near_primary = (terrain == rule.primary);
+                    for (direction_t direction = direction_first; !near_primary && (direction < direction_count); ++direction) {
+                        const Tile_coordinate neighbor = map.neighbor(position, direction);
+                        const std::size_t     index    = static_cast<std::size_t>(neighbor.y) * row_length + static_cast<std::size_t>(neighbor.x);
+                        near_primary = (m_rule_terrains[index] == rule.primary);
+                    }
+                    if (near_primary) {
+                        map.set_terrain_tile(position, replacement_terrain_tile);
+                    }
+                }
             }
-        };
-        map.hex_circle(tile_position, 0, 1, replace);
-    };
-    map.for_each_tile(post_process_op);
+        }
+    );
 }
 
 void Map_generator::generate_apply_rules_pass(Map& map)
 {
+    ERHE_PROFILE_FUNCTION
+
     // Third pass does post-processing, adjusting neighoring
     // tiles based on a few rules.
 
@@ -10,9 +10,12 @@
 
 #include "erhe/application/imgui/imgui_window.hpp"
 #include "erhe/components/components.hpp"
+#include "erhe/concurrency/thread_pool.hpp"
 
 #include "etl/vector.h"
 
+#include <vector>
+
 namespace hextiles
 {
 
@@ -47,6 +50,8 @@ private:
     void generate_apply_rules_pass (Map& map);
     void generate_group_fix_pass   (Map& map);
 
+    erhe::concurrency::Thread_pool m_thread_pool; // Used by generation passes
+
     Fbm_noise          m_noise;
     Variations         m_elevation_generator;
     Variations         m_temperature_generator;
@@ -54,6 +59,7 @@ private:
     Variations         m_variation_generator;
 
     etl::vector<Biome, max_biome_count> m_biomes;
+    std::vector<terrain_t>              m_rule_terrains; // apply_rule() source buffer
 };
 
 extern Map_generator* g_map_generator;
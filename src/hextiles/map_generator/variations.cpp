@@ -23,6 +23,27 @@ void Variations::push(float value)
     m_max_value = std::max(m_max_value, value);
 }
 
+void Variations::resize(size_t count)
+{
+    m_values.resize(count);
+}
+
+void Variations::set(size_t index, float value)
+{
+    Expects(index < m_values.size());
+    m_values[index] = value;
+}
+
+void Variations::update_value_range()
+{
+    if (m_values.empty()) {
+        return;
+    }
+    const auto [min_value, max_value] = std::minmax_element(m_values.begin(), m_values.end());
+    m_min_value = *min_value;
+    m_max_value = *max_value;
+}
+
 auto Variations::get_noise_value(size_t index) const -> float
 {
     Expects(index < m_values.size());
@@ -13,6 +13,9 @@ class Variations
 public:
     void reset                   (size_t count);
     void push                    (float value);
+    void resize                  (size_t count); // for parallel generation with set()
+    void set                     (size_t index, float value);
+    void update_value_range      ();             // after set()
     auto get_noise_value         (size_t index) const -> float;
     auto normalize               ();
     void compute_threshold_values();